@@ -51,7 +51,8 @@ namespace rvs {
  *
  * @brief GPU cross-indexing utility class
  *
- * Used to quickly get GPU ID from location ID and vs. versa
+ * Used to quickly get GPU ID from location ID and vs. versa. Lookups are
+ * served from the hash indexes of the shared KFD topology snapshot.
  *
  */
 class gpulist {
@@ -70,18 +71,6 @@ class gpulist {
                                     uint16_t* pNodeID);
   static int domlocation2gpu(const uint16_t domainID, const uint16_t LocationID,
                                     uint16_t* pGPUID);
- protected:
-  //! Array of GPU location IDs
-  static std::vector<uint16_t> location_id;
-  //! Array of GPU IDs
-  static std::vector<uint16_t> gpu_id;
-  //! Array of device IDs
-  static std::vector<uint16_t> device_id;
-  //! Array of node IDs
-  static std::vector<uint16_t> node_id;
-  //! Array of domain IDs
-  static std::vector<uint16_t> domain_id;
-  static std::map<std::pair<uint16_t, uint16_t>	, uint16_t> domain_loc_map;
 };
 
 
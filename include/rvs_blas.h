@@ -90,6 +90,8 @@ class rvs_blas {
 
     bool set_callback(rvsBlasCallback_t callback, void *user_data);
 
+    bool reshape(int _m, int _n, int _k);
+
     static void hip_stream_callback (hipStream_t stream, hipError_t status, void *user_data);
 
     rvsBlasCallback_t callback;
@@ -189,6 +191,23 @@ class rvs_blas {
     //! rocBlas guard (prevents executing blass_gemm when there are mem errors)
     bool is_error;
 
+    //! transpose operations as requested at construction
+    int req_transa;
+    int req_transb;
+    //! leading dimensions as requested at construction (0 - from m, n, k)
+    rocblas_int req_lda;
+    rocblas_int req_ldb;
+    rocblas_int req_ldc;
+    //! matrix sizes (elements) the buffers were allocated for
+    size_t alloc_a;
+    size_t alloc_b;
+    size_t alloc_c;
+    size_t alloc_d;
+
+    void matrix_sizes(rocblas_int _m, rocblas_int _n, rocblas_int _k,
+                      size_t* pa, size_t* pb, size_t* pc, size_t* pd);
+    void set_ld_offsets(void);
+
     bool init_gpu_device(void);
     bool allocate_gpu_matrix_mem(void);
     void release_gpu_matrix_mem(void);
@@ -40,11 +40,20 @@
 #define RVS_CONF_LOG_LEVEL_KEY          "cli.-d"
 #define RVS_CONF_BLOCK_SIZE_KEY         "block_size"
 #define RVS_CONF_B2B_BLOCK_SIZE_KEY     "b2b_block_size"
+#define RVS_CONF_QUEUE_DEPTH_KEY        "queue_depth"
+#define RVS_CONF_ADAPTIVE_KEY           "adaptive"
+#define RVS_CONF_ADAPTIVE_CI_KEY        "adaptive_ci"
+#define RVS_CONF_EFFICIENCY_THRESHOLD_KEY "efficiency_threshold"
 #define RVS_CONF_LINK_TYPE_KEY          "link_type"
 #define RVS_CONF_MONITOR_KEY            "monitor"
+#define RVS_CONF_CPU_AFFINITY_KEY       "cpu_affinity"
+#define RVS_CONF_SWEEP_KEY              "sweep"
+#define RVS_CONF_SWEEP_MAX_PREFIX       "sweep.max."
 
 #define DEFAULT_LOG_INTERVAL (1000u)
 #define DEFAULT_DURATION (10000u)
+#define DEFAULT_ADAPTIVE_CI (0.02f)
+#define DEFAULT_EFFICIENCY_THRESHOLD (0.5f)
 #define DEFAULT_COUNT (1u)
 #define DEFAULT_WAIT (0u)
 
@@ -25,12 +25,15 @@
 #ifndef INCLUDE_RVSACTIONBASE_H_
 #define INCLUDE_RVSACTIONBASE_H_
 
+#include <stdint.h>
+
 #include <map>
 #include <string>
 #include <vector>
 #include <type_traits>
 
 #include "include/rvs_util.h"
+#include "include/rvsaffinity.h"
 
 namespace rvs {
 
@@ -45,10 +48,26 @@ enum class actionstatus {
   ACTION_ERROR
 };
 
+//! metric value published by an action (see actionbase::metric())
+typedef struct {
+  //! metric name, string literal
+  const char* name;
+  //! metric unit, string literal
+  const char* unit;
+  //! GPU id, 0 if not device specific
+  uint16_t device;
+  //! metric value
+  double value;
+  //! time the value was produced (ns since epoch)
+  uint64_t ts_ns;
+} action_metric_t;
+
 typedef struct {
   actionstate state;
   actionstatus status;
   std::string output;
+  //! metric value if this result carries one, nullptr otherwise
+  const action_metric_t* metric = nullptr;
 } action_result_t;
 
 using callback_t = std::add_pointer <void (const action_result_t *, void *)>::type;
@@ -73,12 +92,17 @@ class actionbase {
   //! Set action callback
   int callback_set(callback_t callback, void * user_param);
 
+  int metric(const char* name, const char* unit, uint16_t device,
+             double value);
+
   //! Virtual action function. To be implemented in every derived class.
   virtual int run(void) = 0;
   bool has_property(const std::string& key, std::string* pval);
   bool has_property(const std::string& key);
   int property_get_device();
   int property_get_device_index();
+  int property_get_cpu_affinity();
+  void get_cpu_affinity(uint16_t gpu_id, std::vector<int>* pcpus);
 
   /**
   * @brief Gets uint16_t list from the module's properties collection
@@ -214,6 +238,10 @@ class actionbase {
   uint64_t property_duration;
   //! logging interval
   uint64_t property_log_interval;
+  //! CPU affinity policy of worker threads
+  affinitypolicy property_cpu_affinity;
+  //! CPUs listed in 'cpu_affinity' key (affinitypolicy::CPUSET)
+  std::vector<int> property_cpu_affinity_cpus;
 
   //! data from config file
   std::map<std::string, std::string> property;
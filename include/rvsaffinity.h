@@ -0,0 +1,72 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSAFFINITY_H_
+#define INCLUDE_RVSAFFINITY_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace rvs {
+
+//! CPU affinity policy of module worker threads
+enum class affinitypolicy {
+  //! threads may run on any CPU
+  NONE,
+  //! threads run on CPUs of the NUMA node closest to their GPU
+  NUMA,
+  //! threads run on explicitly listed CPUs
+  CPUSET
+};
+
+/**
+ * @class affinity
+ * @ingroup RVS
+ *
+ * @brief CPU affinity helpers
+ *
+ * Finds the NUMA node a GPU is attached to and the CPUs of a NUMA node.
+ * The NUMA node is read from PCI sysfs ("numa_node" of the device with
+ * the KFD node's domain and location_id) or, if not known there, from the
+ * CPU node the KFD node links to. Sysfs root is the one of rvs::topology
+ * and may be redirected to a fake tree for testing.
+ *
+ */
+class affinity {
+ public:
+  static int parse(const std::string& val, affinitypolicy* ppolicy,
+                   std::vector<int>* pcpus);
+  static int parse_cpulist(const std::string& list, std::vector<int>* pcpus);
+  static std::string cpulist(const std::vector<int>& cpus);
+
+  static int device_numa_node(uint16_t gpu_id, int* pnode);
+  static int node_cpus(int node, std::vector<int>* pcpus);
+  static void allowed(std::vector<int>* pcpus);
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSAFFINITY_H_
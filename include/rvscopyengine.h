@@ -0,0 +1,130 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSCOPYENGINE_H_
+#define INCLUDE_RVSCOPYENGINE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//! copies per block size for each copy in flight when queue_depth > 1
+#define RVS_QUEUE_COPIES 4
+
+namespace rvs {
+
+/**
+ * @class copybackend
+ * @ingroup RVS
+ *
+ * @brief Asynchronous copy interface driven by rvs::copyengine
+ *
+ * Copies are identified by direction (0 - forward, 1 - reverse) and slot.
+ * Each slot has its own completion signal; a copy issued with a
+ * dependency slot starts only after the copy in that slot completes.
+ *
+ */
+class copybackend {
+ public:
+  virtual ~copybackend() {}
+
+  /**
+   * @brief Issue copy of Size bytes
+   *
+   * @param Dir direction
+   * @param Slot slot to signal on completion
+   * @param Size number of bytes to copy
+   * @param DepSlot slot of the copy this one waits for, -1 if none
+   * @return 0 - if successfull, non-zero otherwise
+   */
+  virtual int issue(int Dir, int Slot, size_t Size, int DepSlot) = 0;
+
+  /**
+   * @brief Wait for copy in a slot to complete
+   *
+   * @param Dir direction
+   * @param Slot slot
+   * @param pStart [out] copy start time in nanoseconds
+   * @param pEnd [out] copy end time in nanoseconds
+   * @return 0 - if successfull, non-zero otherwise
+   */
+  virtual int wait(int Dir, int Slot, uint64_t* pStart, uint64_t* pEnd) = 0;
+};
+
+/**
+ * @class copystats_s
+ * @ingroup RVS
+ *
+ * @brief Results of rvs::copyengine::run()
+ *
+ */
+typedef struct copystats_s {
+  //! copies completed per direction
+  unsigned int copies;
+  //! bytes per direction moved in steady state
+  size_t bytes;
+  //! time to move bytes at the average per-direction throughput (seconds)
+  double duration;
+  //! average time from start to end of a single copy (seconds)
+  double latency;
+} copystats_t;
+
+/**
+ * @class copyengine
+ * @ingroup RVS
+ *
+ * @brief Keeps a number of copies in flight per direction
+ *
+ * Copies are chained: each one depends on the previous copy in the same
+ * direction, so they run back to back while the host waits for the oldest
+ * one and issues the next. With depth copies in flight the link never
+ * waits for the host.
+ *
+ * Steady-state throughput is measured between completions of the first
+ * and the last copy, which excludes launch latency of the first one.
+ * Latency is the average start to end time of a copy.
+ *
+ * A slot is reused only when the copy depending on it has completed
+ * too, so a backend needs slots(depth) completion signals per direction.
+ *
+ */
+class copyengine {
+ public:
+  copyengine(copybackend* pBackend, unsigned int Depth);
+
+  int run(size_t Size, unsigned int Copies, bool Bidirectional,
+          copystats_t* pStats);
+
+  //! number of slots per direction needed for Depth copies in flight
+  static unsigned int slots(unsigned int Depth) { return Depth + 1; }
+
+ protected:
+  //! copy backend
+  copybackend* backend;
+  //! number of copies in flight per direction
+  unsigned int depth;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSCOPYENGINE_H_
@@ -0,0 +1,160 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSERRRING_H_
+#define INCLUDE_RVSERRRING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace rvs {
+
+/**
+ * @class errrecord_s
+ * @ingroup RVS
+ *
+ * @brief Memory error found by a test kernel
+ *
+ */
+typedef struct errrecord_s {
+  //! failing address
+  uint64_t address;
+  //! value written
+  uint64_t expected;
+  //! value read
+  uint64_t actual;
+  //! value read again when the error was recorded
+  uint64_t reread;
+} errrecord_t;
+
+/**
+ * @class errslot_s
+ * @ingroup RVS
+ *
+ * @brief Ring slot
+ *
+ */
+typedef struct errslot_s {
+  //! index + 1 of the record in the slot, written last by the producer;
+  //! 0 while the slot is being written
+  uint64_t seq;
+  //! record
+  errrecord_t rec;
+} errslot_t;
+
+/**
+ * @class errring_s
+ * @ingroup RVS
+ *
+ * @brief Header of an append-only error ring, followed in memory by
+ * capacity slots
+ *
+ * Producers (device threads) claim a record index by atomically
+ * incrementing head and write the record into slot index % capacity,
+ * publishing it by storing its sequence last. Producers never wait: when
+ * the consumer falls behind by more than capacity records, the oldest
+ * are overwritten and counted as lost, while head still counts every
+ * error.
+ *
+ */
+typedef struct errring_s {
+  //! number of records appended so far
+  uint64_t head;
+  //! number of slots (power of two)
+  uint64_t capacity;
+} errring_t;
+
+//! slot of record index idx in ring pring
+#define RVS_ERRRING_SLOT(pring, idx) \
+  (reinterpret_cast<rvs::errslot_t*>((pring) + 1) + \
+   ((idx) & ((pring)->capacity - 1)))
+
+/**
+ * @class errharvester
+ * @ingroup RVS
+ *
+ * @brief Consumer of an error ring
+ *
+ * Records are harvested in order, either on demand or by a background
+ * thread, and passed to a callback. The ring is expected in memory the
+ * producers write to directly (host memory mapped to the device), so
+ * harvesting needs no device synchronization.
+ *
+ */
+class errharvester {
+ public:
+  //! called for each harvested record
+  typedef std::function<void(const errrecord_t&)> callback_t;
+
+  static size_t size(uint64_t Capacity);
+  static void init(errring_t* pRing, uint64_t Capacity);
+  static void append(errring_t* pRing, const errrecord_t& Rec);
+
+  errharvester(errring_t* pRing, const callback_t& Callback);
+  virtual ~errharvester();
+
+  size_t harvest();
+  void start(unsigned int IntervalMs);
+  void stop();
+
+  uint64_t produced() const;
+  //! number of records passed to the callback
+  uint64_t harvested() const { return harvested_cnt; }
+  //! number of records overwritten before they were harvested
+  uint64_t lost() const { return lost_cnt; }
+
+ protected:
+  void worker(unsigned int IntervalMs);
+
+ protected:
+  //! ring
+  errring_t* ring;
+  //! record callback
+  callback_t callback;
+  //! index of the next record to harvest
+  uint64_t tail;
+  //! number of records harvested
+  uint64_t harvested_cnt;
+  //! number of records lost
+  uint64_t lost_cnt;
+  //! serializes harvesting
+  std::mutex mtx;
+  //! guards brun
+  std::mutex mtx_run;
+  //! signaled on stop
+  std::condition_variable cv;
+  //! true while the background thread should keep running
+  bool brun;
+  //! background thread
+  std::thread thrd;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSERRRING_H_
@@ -33,13 +33,20 @@
 #include <cctype>
 #include <sstream>
 #include <limits>
+#include <map>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <iomanip>
 
 #include "hsa/hsa.h"
 #include "hsa/hsa_ext_amd.h"
 
+#include "include/rvscopyengine.h"
+#include "include/rvslinkmodel.h"
+#include "include/rvsxfercache.h"
+
 using std::string;
 using std::vector;
 
@@ -68,6 +75,9 @@ typedef struct linkinfo_s {
   hsa_amd_link_info_type_t etype;
 } linkinfo_t;
 
+//! statistics of the rvs::hsa transfer buffer cache
+typedef xfercachestats_t hsacachestats_t;
+
 /**
  * @class hsa
  * @ingroup RVS
@@ -75,7 +85,7 @@ typedef struct linkinfo_s {
  * @brief Wrapper class for HSA functionality needed for rvs tests
  *
  */
-class hsa {
+class hsa : public xferallocator {
  public:
   //! Default constructor
   hsa();
@@ -108,9 +118,40 @@ class hsa {
     vector<size_t>                max_size_list;
   };
 
+  /**
+   * @brief Buffers and signals of one (src, dst, direction) transfer
+   *
+   * Kept in the transfer cache between SendTraffic() calls so that
+   * allocation, access grants and signal creation are done once.
+   * Allocated through the xferallocator interface.
+   */
+  struct transfer_t {
+    //! capacity of each buffer in bytes
+    size_t size = 0;
+    //! forward transfer source buffer
+    void* src_fwd = nullptr;
+    //! forward transfer destination buffer
+    void* dst_fwd = nullptr;
+    //! forward transfer completion signal
+    hsa_signal_t signal_fwd = {0};
+    //! reverse transfer source buffer
+    void* src_rev = nullptr;
+    //! reverse transfer destination buffer
+    void* dst_rev = nullptr;
+    //! reverse transfer completion signal
+    hsa_signal_t signal_rev = {0};
+    //! forward completion signals of SendTrafficQueued() slots
+    vector<hsa_signal_t> queue_fwd;
+    //! reverse completion signals of SendTrafficQueued() slots
+    vector<hsa_signal_t> queue_rev;
+  };
+
   //! constant for "no connection" distance value
   static const uint32_t NO_CONN = 0xFFFFFFFF;
 
+  //! default limit of bytes kept in cached transfer buffers
+  static const size_t CACHE_MAX_SIZE = 4ull * 1024 * 1024 * 1024;
+
   //! list of test transfer sizes
   const uint32_t DEFAULT_SIZE_LIST[20] = {  1 * 1024,
                                             2 * 1024,
@@ -157,6 +198,15 @@ class hsa {
   int SendTraffic(uint32_t SrcNode, uint32_t DstNode,
                   size_t   Size,    bool     bidirectional,
                   double*  Duration);
+  int SendTrafficQueued(uint32_t SrcNode, uint32_t DstNode,
+                        size_t   Size,    bool     bidirectional,
+                        unsigned int Depth, unsigned int Copies,
+                        copystats_t* pStats);
+  int Reserve(uint32_t SrcNode, uint32_t DstNode,
+              size_t   Size,    bool     bidirectional);
+  void ReleaseCache();
+  void SetCacheLimit(size_t Bytes);
+  void GetCacheStats(hsacachestats_t* pStats);
 
   int GetPeerStatus(uint32_t SrcNode, uint32_t DstNode);
   int GetPeerStatusAgent(const AgentInformation& SrcAgent,
@@ -176,6 +226,8 @@ class hsa {
                                 hsa_status_t st);
   static bool check_link_type(const std::vector<rvs::linkinfo_t>& arrLinkInfo,
                               int LinkType);
+  static void get_link_types(const std::vector<rvs::linkinfo_t>& arrLinkInfo,
+                             std::vector<rvs::linktype>* pTypes);
 
   void PrintTopology();
 
@@ -185,9 +237,26 @@ class hsa {
   static hsa_status_t ProcessAgent(hsa_agent_t agent, void* data);
   static hsa_status_t ProcessMemPool(hsa_amd_memory_pool_t pool, void* data);
 
+  int AcquireTransfer(uint32_t SrcNode, uint32_t DstNode,
+                      size_t Size, bool bidirectional,
+                      xferlease_t* pLease, transfer_t** ppTransfer);
+  void ReleaseTransfer(xferlease_t* pLease);
+  int AllocTransfer(int SrcAgent, int DstAgent, size_t Size,
+                    bool bidirectional, transfer_t* pTransfer);
+  void FreeTransfer(transfer_t* pTransfer);
+  int AllocQueueSignals(bool bidirectional, unsigned int Slots,
+                        transfer_t* pTransfer);
+
+  int xfer_alloc(const xferkey_t& Key, size_t Size,
+                 void** ppData, size_t* pBytes) override;
+  void xfer_free(void* pData) override;
+
  protected:
   //! pointer to RVS HSA singleton
   static rvs::hsa* pDsc;
+
+  //! cached transfer buffers and signals
+  xfercache transfers;
 };
 
 }  // namespace rvs
@@ -47,8 +47,15 @@ typedef void* (*t_cbCreateNode)(void* Parent, const char* Name);
 typedef void  (*t_cbAddString)(void* Parent, const char* Key, const char* Val);
 typedef void  (*t_cbAddInt)(void* Parent, const char* Key, const int Val);
 typedef void  (*t_cbAddNode)(void* Parent, void* Child);
+typedef void  (*t_cbAddDouble)(void* Parent, const char* Key, const double Val);
+typedef void  (*t_cbAddUInt64)(void* Parent, const char* Key,
+                               const uint64_t Val);
+typedef void  (*t_cbAddBool)(void* Parent, const char* Key, const bool Val);
+typedef int   (*t_cbLogLevel)(void);
+typedef void  (*t_cbMetric)(uint16_t Metric, uint16_t Device, double Val);
 typedef void  (*t_cbStop)(uint16_t flags);
 typedef bool  (*t_cbStopping)(void);
+typedef bool  (*t_cbWaitStop)(unsigned int ms);
 typedef int   (*t_rvs_module_err)(const char*, const char*, const char*);
 
 
@@ -86,6 +93,18 @@ typedef struct tag_module_init {
   t_cbStopping         cbStopping;
   //! pointer to rvs::logger::Err() function
   t_rvs_module_err     cbErr;
+  //! pointer to rvs::logger::AddDouble() function
+  t_cbAddDouble        cbAddDouble;
+  //! pointer to rvs::logger::AddUInt64() function
+  t_cbAddUInt64        cbAddUInt64;
+  //! pointer to rvs::logger::AddBool() function
+  t_cbAddBool          cbAddBool;
+  //! pointer to rvs::logger::log_level() function
+  t_cbLogLevel         cbLogLevel;
+  //! pointer to rvs::metriclog::sample() function
+  t_cbMetric           cbMetric;
+  //! pointer to rvs::logger::WaitStop() function
+  t_cbWaitStop         cbWaitStop;
 } T_MODULE_INIT;
 
 #ifdef __cplusplus
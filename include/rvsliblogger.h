@@ -27,7 +27,11 @@
 
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include "include/rvsliblog.h"
+#include "include/rvslogsink.h"
+#include "include/rvslogring.h"
 
 
 namespace rvs {
@@ -43,10 +47,14 @@ namespace rvs {
 class logger {
  public:
   static  void  log_level(const int level);
+  static  int   log_level();
 
   static  void  to_json(const bool flag);
   static  bool  to_json();
 
+  static  int   set_ndjson_file(const std::string& fname);
+  static  bool  ndjson();
+
   static  void  append(const bool flag);
   static  bool  append();
 
@@ -59,6 +67,8 @@ class logger {
 
   static  int    init_log_file();
   static  int    terminate();
+  static  void   flush();
+  static  void   reset();
 
   static  int    log(const std::string& Message, const int level = 1);
   static  int    Log(const char* Message, const int level);
@@ -75,41 +85,66 @@ class logger {
   static  void*  CreateNode(void* Parent, const char* Name);
   static  void   AddString(void* Parent, const char* Key, const char* Val);
   static  void   AddInt(void* Parent, const char* Key, const int Val);
+  static  void   AddDouble(void* Parent, const char* Key, const double Val);
+  static  void   AddUInt64(void* Parent, const char* Key, const uint64_t Val);
+  static  void   AddBool(void* Parent, const char* Key, const bool Val);
   static  void   AddNode(void* Parent, void* Child);
   static  int    JsonPatchAppend(int*);
   static  void   Stop(uint16_t flags);
   static  bool   Stopping(void);
+  static  bool   WaitStop(unsigned int ms);
+  static  void   NotifyStop();
+  static  void   Interrupt();
+  static  void   set_cancel_flag(std::atomic<bool>* pflag);
+  static  std::atomic<bool>* cancel_flag();
   static  int    Err(const char *Message,
                    const char *Module = nullptr, const char *Action = nullptr);
+  static  void   sink_stats(logsink::stats_t* pstats);
+  static  void   rotation(uint64_t max_bytes, unsigned int max_age,
+                          unsigned int generations);
 
  protected:
-  static  int    ToFile(const std::string& Row ,  bool json = false);
+  static  int    ToFile(const std::string& Row ,  bool json = false,
+                         unsigned int tag = 0);
+  static  logring& ring();
+  static  void   ring_output(const logring::entry_t* const* entries,
+                             size_t count);
 
   //! Current logging level (0..5)
-  static  int    loglevel_m;
+  static  std::atomic<int>   loglevel_m;
   //! 'true' if JSON output is requested
-  static  bool   tojson_m;
+  static  std::atomic<bool>  tojson_m;
+  //! 'true' if JSON records are written one per line (NDJSON)
+  static  std::atomic<bool>  ndjson_m;
   //! 'true' if append to existing log file is requested
-  static  bool   append_m;
+  static  std::atomic<bool>  append_m;
   //! 'true' if the incoming record is the first record in this rvs invocation
-  static  bool   isfirstrecord_m;
+  static  std::atomic<bool>  isfirstrecord_m;
+  //! 'true' until the first action list is started in JSON document
+  static  bool   isfirstaction_m;
   //! Array of C std::strings representing logging level names
   static  const char*   loglevelname[6];
   //! Mutex to synchronize cout output
   static std::mutex cout_mutex;
-  //! Mutex to synchronize log file output
-  static std::mutex log_mutex;
   //! Mutex to synchronize json log file output
   static std::mutex json_log_mutex;
   //! flag indicating stop loging was requested
-  static bool bStop;
+  static std::atomic<bool> bStop;
+  //! stop request of the session the calling thread works for
+  static thread_local std::atomic<bool>* pcancel;
   //! stop flags
-  static uint16_t stop_flags;
+  static std::atomic<uint16_t> stop_flags;
+  //! guards stop_cv waits against missed notifications
+  static std::mutex stop_mutex;
+  //! notified on stop requests (see WaitStop())
+  static std::condition_variable stop_cv;
   //! logging file
   static char log_file[1024];
   static std::string json_log_file;
   //! quiet mode
-  static bool b_quiet;
+  static std::atomic<bool> b_quiet;
+  //! asynchronous writer for log and json files
+  static logsink sink;
 };
 
 }  // namespace rvs
@@ -0,0 +1,115 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLINKMODEL_H_
+#define INCLUDE_RVSLINKMODEL_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace rvs {
+
+//! type of a link hop
+enum class linktype {
+  UNKNOWN,
+  PCIE,
+  XGMI
+};
+
+/**
+ * @class linkhop_s
+ * @ingroup RVS
+ *
+ * @brief One hop of a transfer path
+ *
+ */
+typedef struct linkhop_s {
+  //! link type
+  linktype type;
+  //! PCIe transfer rate per lane (GT/s)
+  double speed;
+  //! PCIe lanes
+  unsigned int width;
+  //! bandwidth per direction (bytes/s) when known as a whole, e.g. XGMI
+  double bandwidth;
+} linkhop_t;
+
+/**
+ * @class linkestimate_s
+ * @ingroup RVS
+ *
+ * @brief Theoretical bandwidth of a transfer path
+ *
+ */
+typedef struct linkestimate_s {
+  //! bandwidth per direction of the path as trained (bytes/s)
+  double expected;
+  //! bandwidth per direction at full capability over a direct link
+  double capable;
+  //! number of hops of the path
+  unsigned int hops;
+  //! why the path falls short of its capability, empty if it does not
+  std::string limit;
+} linkestimate_t;
+
+/**
+ * @class linkmodel
+ * @ingroup RVS
+ *
+ * @brief Theoretical link bandwidth from PCIe generation, encoding and
+ * width, or XGMI link bandwidth, and hop count
+ *
+ * PCIe bandwidth per direction is transfer rate times lanes times
+ * encoding efficiency (8b/10b up to 5 GT/s, 128b/130b up to 32 GT/s,
+ * 242B/256B FLIT above). Protocol (TLP) overhead is not modelled, so
+ * efficiency of a healthy link is somewhat below 100%. A path is as
+ * fast as its slowest hop.
+ *
+ */
+class linkmodel {
+ public:
+  static double encoding(double Speed);
+  static double hop_bandwidth(const linkhop_t& Hop);
+  static void estimate(const std::vector<linkhop_t>& Path,
+                       const std::vector<linkhop_t>& Capable,
+                       linkestimate_t* pEstimate);
+  static double efficiency(const linkestimate_t& Estimate, double Bandwidth,
+                           bool Bidir, std::string* pText);
+
+  static double speed_from_code(unsigned int Code);
+  static int parse_speed(const std::string& Val, double* pSpeed);
+  static int parse_width(const std::string& Val, unsigned int* pWidth);
+
+  static int pcie_hop(uint16_t GpuId, linkhop_t* pCur, linkhop_t* pCap);
+  static int xgmi_hop(uint16_t SrcNode, uint16_t DstNode, linkhop_t* pHop);
+  static int path_estimate(uint16_t SrcNode, uint16_t DstNode,
+                           const std::vector<linktype>& Hops,
+                           linkestimate_t* pEstimate);
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLINKMODEL_H_
@@ -0,0 +1,121 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGFRAME_H_
+#define INCLUDE_RVSLOGFRAME_H_
+
+#include <string>
+
+namespace rvs {
+
+/**
+ * @class logframe
+ * @ingroup Launcher
+ *
+ * @brief Keeps track of document structure for log file rotation
+ *
+ * Sees every row written to a log file (on the sink writer thread) and, when
+ * the file is rotated, provides the text which closes the current file and
+ * the text which opens the next one, so that each file is a complete
+ * document on its own.
+ *
+ */
+class logframe {
+ public:
+  virtual ~logframe() {}
+
+  /**
+   * @brief Account for row about to be written
+   *
+   * @param tag row kind, as given to logsink::post()
+   * @param prow [in,out] row text, may be adjusted for the current file
+   *
+   */
+  virtual void row(unsigned int tag, std::string* prow) = 0;
+
+  /**
+   * @brief Text which closes the current file
+   *
+   */
+  virtual std::string trailer() = 0;
+
+  /**
+   * @brief Start new file
+   *
+   * @return text which opens the new file
+   *
+   */
+  virtual std::string segment() = 0;
+};
+
+/**
+ * @class logjsonframe
+ * @ingroup Launcher
+ *
+ * @brief Framer for JSON log files
+ *
+ * JSON file consists of a module object holding one list of records per
+ * action. When the file is rotated in the middle of it, open list and object
+ * are closed and then reopened at the start of the next file. Leading ","
+ * separator is removed from the first action and the first record in the
+ * new file.
+ *
+ */
+class logjsonframe : public logframe {
+ public:
+  //! JSON row kinds
+  enum tag_t {
+    tag_none = 0,
+    tag_doc_start,
+    tag_list_start,
+    tag_record,
+    tag_list_end,
+    tag_doc_end
+  };
+
+  logjsonframe();
+  virtual ~logjsonframe() {}
+
+  virtual void row(unsigned int tag, std::string* prow);
+  virtual std::string trailer();
+  virtual std::string segment();
+
+ protected:
+  //! row which opened the current document
+  std::string doc_head;
+  //! row which opened the current list (without separator)
+  std::string list_head;
+  //! 'true' while inside document
+  bool in_doc;
+  //! 'true' while inside list
+  bool in_list;
+  //! 'true' once a list was written to the current file
+  bool seg_list;
+  //! 'true' once a record of the current list was written to the current file
+  bool seg_rec;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGFRAME_H_
@@ -0,0 +1,206 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGJSONREC_H_
+#define INCLUDE_RVSLOGJSONREC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/rvslognodebase.h"
+
+//! size of one arena chunk (bytes)
+#define RVS_LOGARENA_CHUNK      4096
+//! number of released records kept for reuse by each thread
+#define RVS_LOGJSON_POOL_SIZE   16
+
+namespace rvs {
+
+/**
+ * @class LogArena
+ * @ingroup Launcher
+ *
+ * @brief Bump allocator used for intermediate nodes of one log record
+ *
+ * Memory is taken from a list of chunks and is never freed individually.
+ * reset() releases everything in one step and keeps the first chunk
+ * so a reused record does not allocate again.
+ *
+ */
+class LogArena {
+ public:
+  LogArena();
+  ~LogArena();
+
+  void*        alloc(size_t size);
+  const char*  copy(const char* str);
+  void         reset();
+
+ protected:
+  //! memory chunk; data follows the header
+  struct chunk_t {
+    //! next chunk in the list
+    chunk_t* next;
+    //! usable size
+    size_t size;
+    //! bytes used so far
+    size_t used;
+  };
+
+  //! first chunk (kept on reset)
+  chunk_t* head;
+  //! chunk allocations are currently served from
+  chunk_t* cur;
+};
+
+class LogJsonRec;
+
+/**
+ * @brief Intermediate node created through CreateNode()
+ *
+ * Every handle passed to modules points to one of these. Nodes live in
+ * the arena of the record they belong to and are serialized when the
+ * record is flushed; the record itself is represented by its root node.
+ */
+struct LogJsonNode {
+  //! node type
+  T_LNTYPE type;
+  //! record the node belongs to
+  LogJsonRec* rec;
+  //! node name (key)
+  const char* name;
+  //! next sibling
+  LogJsonNode* next;
+  //! first child (List only)
+  LogJsonNode* first;
+  //! last child (List only)
+  LogJsonNode* last;
+  //! string value (String only)
+  const char* sval;
+  //! value of Integer, UInt64 and Bool nodes
+  uint64_t ival;
+  //! value of Double nodes
+  double dval;
+};
+
+/**
+ * @class LogJsonRec
+ * @ingroup Launcher
+ *
+ * @brief Streaming JSON log record
+ *
+ * Replaces the LogNodeRec/MinNode tree for records created through
+ * logger::LogRecordCreate(). Fields added directly to the record are
+ * written into the record buffer as they arrive. Nested nodes are kept
+ * in the per-record arena and spliced into the output when the record
+ * is serialized. Output is identical to LogNodeRec::ToJson("  ")
+ * (or MinNode::ToJson("  ") for minimal records).
+ *
+ * Released records are kept in a small per-thread pool so their buffers
+ * and arena chunks are reused by subsequent records.
+ *
+ * Compact records are written on a single line, start with module,
+ * action, level and time fields and have string values escaped, so that
+ * each one is a self-contained NDJSON line.
+ *
+ */
+class LogJsonRec {
+ public:
+  static LogJsonRec*  Create(int LogLevel, unsigned Sec, unsigned uSec,
+                             bool Minimal, bool Discard,
+                             const char* Module = nullptr,
+                             const char* Action = nullptr);
+  static void         Release(LogJsonRec* pRec);
+  static LogJsonRec*  FromHandle(void* Handle);
+
+  static void*  CreateNode(void* Parent, const char* Name);
+  static void   AddString(void* Parent, const char* Key, const char* Val);
+  static void   AddInt(void* Parent, const char* Key, const int Val);
+  static void   AddDouble(void* Parent, const char* Key, const double Val);
+  static void   AddUInt64(void* Parent, const char* Key, const uint64_t Val);
+  static void   AddBool(void* Parent, const char* Key, const bool Val);
+  static void   AddNode(void* Parent, void* Child);
+
+  //! returns handle passed to modules
+  void*  Handle() { return static_cast<void*>(&root); }
+  //! logging level given at creation
+  int    LogLevel() const { return Level; }
+  void   ToJson(std::string* pOut) const;
+
+ protected:
+  LogJsonRec();
+  ~LogJsonRec();
+
+  void   Init(int LogLevel, unsigned Sec, unsigned uSec,
+              bool Minimal, bool Discard,
+              const char* Module, const char* Action);
+  void   OpenField(const char* Key);
+  static void  StringToJson(std::string* pOut, const char* Str,
+                            bool Escape);
+  static void  AddValue(void* Parent, const char* Key, T_LNTYPE Type,
+                        uint64_t IVal, double DVal);
+  static void  ValueToJson(std::string* pOut, T_LNTYPE Type,
+                           uint64_t IVal, double DVal);
+  static void  NodeToJson(std::string* pOut, const LogJsonNode* pNode,
+                          size_t Lead, bool Compact);
+  static LogJsonNode*  NewNode(LogJsonRec* pRec, T_LNTYPE Type,
+                               const char* Name);
+  static void  Link(LogJsonNode* pParent, LogJsonNode* pChild);
+
+  //! per-thread pool of released records
+  struct pool_t {
+    ~pool_t();
+    //! released records
+    std::vector<LogJsonRec*> free;
+  };
+  static pool_t& pool();
+
+ protected:
+  //! handle given out for the record itself (type Record)
+  LogJsonNode root;
+  //! logging level
+  int Level;
+  //! 'true' for records created with minimal flag
+  bool bMinimal;
+  //! 'true' if record will not be written (fields are ignored)
+  bool bDiscard;
+  //! 'true' for single line (NDJSON) record
+  bool bCompact;
+  //! number of top level fields written so far
+  int nFields;
+  //! serialized record body (without closing brace)
+  std::string buff;
+  //! nested nodes to be inserted at given buffer offsets
+  std::vector<std::pair<size_t, LogJsonNode*>> splice;
+  //! storage for nested nodes
+  LogArena arena;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGJSONREC_H_
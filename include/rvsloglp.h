@@ -25,25 +25,45 @@
 #ifndef INCLUDE_RVSLOGLP_H_
 #define INCLUDE_RVSLOGLP_H_
 
+#include <stdarg.h>
+
 #include <string>
 
 #include "include/rvsliblog.h"
 
+//! 'true' if messages of level LEVEL are output by the logger
+#define RVSLOG_ENABLED(LEVEL) ((LEVEL) <= rvs::lp::LogLevel())
+
+//! printf-style logging; arguments are neither evaluated nor formatted
+//! when LEVEL is not enabled
+#define RVSLOGF(LEVEL, ...) \
+do { \
+  if (RVSLOG_ENABLED(LEVEL)) \
+    rvs::lp::Logf((LEVEL), __VA_ARGS__); \
+} while (0)
+
+//! same as RVSLOGF() with explicit timestamp
+#define RVSLOGF_EXT(LEVEL, SEC, USEC, ...) \
+do { \
+  if (RVSLOG_ENABLED(LEVEL)) \
+    rvs::lp::LogfExt((LEVEL), (SEC), (USEC), __VA_ARGS__); \
+} while (0)
+
 #define RVSDEBUG_(ATTR, VAL) \
-{std::string msg = std::string(__FILE__)+"   "+__func__+":" \
-+std::to_string(__LINE__) + "\n" + std::string(ATTR) + ": " + \
-std::string(VAL); \
-rvs::lp::Log(msg, rvs::logdebug); \
-}
+do { \
+  if (RVSLOG_ENABLED(rvs::logdebug)) { \
+    std::string msg = std::string(__FILE__)+"   "+__func__+":" \
+    +std::to_string(__LINE__) + "\n" + std::string(ATTR) + ": " + \
+    std::string(VAL); \
+    rvs::lp::Log(msg, rvs::logdebug); \
+  } \
+} while (0)
 
 #ifdef RVS_DO_TRACE
-  #define RVSTRACE_ rvs::lp::Log(std::string(__FILE__)+"   "+__func__+":"\
-  +std::to_string(__LINE__), rvs::logtrace);
-  #define RVSDEBUG(x, y) rvs::lp::Log(std::string(__FILE__)+"   "\
-  +__func__+":" + std::to_string(__LINE__)\
-  + "   attr: " + std::string(x) \
-  + "  val: " + std::string(y) \
-  , rvs::logdebug);
+  #define RVSTRACE_ RVSLOGF(rvs::logtrace, "%s   %s:%d", __FILE__, __func__, \
+  __LINE__);
+  #define RVSDEBUG(x, y) RVSLOGF(rvs::logdebug, "%s   %s:%d   attr: %s  val: %s", \
+  __FILE__, __func__, __LINE__, std::string(x).c_str(), std::string(y).c_str());
 #else
   #define RVSTRACE_
   #define RVSDEBUG(x, y)
@@ -66,6 +86,12 @@ class lp {
   static int   Log(const std::string& Msg, const int level);
   static int   Log(const std::string& Msg, const int LogLevel,
                    const unsigned int Sec, const unsigned int uSec);
+  static int   Logf(const int level, const char* pFormat, ...)
+                   __attribute__((format(printf, 2, 3)));
+  static int   LogfExt(const int level, const unsigned int Sec,
+                       const unsigned int uSec, const char* pFormat, ...)
+                   __attribute__((format(printf, 4, 5)));
+  static int   LogLevel();
   static int   Initialize(const T_MODULE_INIT* pMi);
   static void* LogRecordCreate(const char* Module, const char* Action,
                                const int LogLevel, const unsigned int Sec,
@@ -80,15 +106,24 @@ class lp {
                          const std::string& Val);
   static void  AddString(void* Parent, const char* Key, const char* Val);
   static void  AddInt(void* Parent, const char* Key, const int Val);
+  static void  AddDouble(void* Parent, const char* Key, const double Val);
+  static void  AddUInt64(void* Parent, const char* Key, const uint64_t Val);
+  static void  AddBool(void* Parent, const char* Key, const bool Val);
   static void  AddNode(void* Parent, void* Child);
+  static void  Metric(uint16_t Metric, uint16_t Device, double Val);
   static bool  get_ticks(unsigned int* psec, unsigned int* pusec);
   static void  Stop(uint16_t flags);
   static bool  Stopping();
+  static bool  WaitStop(unsigned int ms);
   static int   Err(const std::string &Msg, const std::string &Module);
   static int   Err(const std::string &Msg, const std::string &Module,
                    const std::string &Action);
 
  protected:
+  static int   Logv(const int level, const bool bExt, const unsigned int Sec,
+                    const unsigned int uSec, const char* pFormat,
+                    va_list args);
+
   //! Module init structure passed through Initialize() method
   static T_MODULE_INIT mi;
 };
@@ -37,7 +37,10 @@ typedef enum eLN {
   List    = 1,
   String  = 2,
   Integer = 3,
-  Record  = 4
+  Record  = 4,
+  Double  = 5,
+  UInt64  = 6,
+  Bool    = 7
 } T_LNTYPE;
 
 /**
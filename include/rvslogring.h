@@ -0,0 +1,166 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGRING_H_
+#define INCLUDE_RVSLOGRING_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! number of entries in each per-thread ring (power of 2)
+#define RVS_LOGRING_SIZE        1024
+//! maximum time drain thread sleeps when there is nothing to do (ms)
+#define RVS_LOGRING_IDLE_WAIT   50
+//! cache line size used to keep producer and consumer indexes apart
+#define RVS_CACHE_LINE          64
+
+namespace rvs {
+
+/**
+ * @class logring
+ * @ingroup Launcher
+ *
+ * @brief Per-thread log message rings with a single drain thread
+ *
+ * Every producer thread gets its own single-producer/single-consumer ring
+ * the first time it posts a message, so posting does not take any lock
+ * shared with other producers. One drain thread takes available entries
+ * from all rings, merges them by timestamp and passes them in batches to
+ * the output callback. A producer blocks only when its own ring is full.
+ *
+ */
+class logring {
+ public:
+  //! single log message
+  typedef struct {
+    //! timestamp (microseconds)
+    uint64_t ts;
+    //! seconds part of timestamp as given by producer
+    uint32_t sec;
+    //! microseconds part of timestamp as given by producer
+    uint32_t usec;
+    //! logging level
+    int level;
+    //! message text
+    std::string msg;
+  } entry_t;
+
+  //! output callback; receives entries ordered by timestamp
+  typedef void (*output_t)(const entry_t* const* entries, size_t count);
+
+  //! ring statistics
+  typedef struct {
+    //! number of entries posted
+    uint64_t posted;
+    //! number of times a producer found its ring full
+    uint64_t stalled;
+    //! number of producer rings created so far
+    uint64_t rings;
+  } stats_t;
+
+  explicit logring(output_t cb);
+  ~logring();
+
+  void  post(uint32_t sec, uint32_t usec, int level, const char* msg);
+  void  flush();
+  void  get_stats(stats_t* pstats);
+
+ protected:
+  //! single-producer/single-consumer ring
+  struct ring_t {
+    ring_t();
+
+    //! consumer index (written by drain thread only)
+    alignas(RVS_CACHE_LINE) std::atomic<uint64_t> head;
+    //! producer index (written by owning thread only)
+    alignas(RVS_CACHE_LINE) std::atomic<uint64_t> tail;
+    //! set when owning thread exits
+    alignas(RVS_CACHE_LINE) std::atomic<bool> closed;
+    //! ring entries
+    entry_t slot[RVS_LOGRING_SIZE];
+  };
+
+  //! per-thread reference to its ring
+  struct holder_t {
+    ~holder_t();
+    //! logring the ring belongs to
+    logring* owner = nullptr;
+    //! producer ring
+    std::shared_ptr<ring_t> ring;
+  };
+
+  ring_t* get_ring();
+  void    run();
+  size_t  drain_once();
+  void    wait_space(ring_t* r, uint64_t t);
+
+ protected:
+  //! output callback
+  output_t output;
+  //! drain thread
+  std::thread drainer;
+  //! registered rings
+  std::vector<std::shared_ptr<ring_t>> rings;
+  //! protects rings list; also serializes synchronous output on shutdown
+  std::mutex reg_mutex;
+  //! protects control members below
+  std::mutex mtx;
+  //! wakes drain thread
+  std::condition_variable cv_work;
+  //! signaled when drain pass completes (room made, flush done)
+  std::condition_variable cv_done;
+  //! 'true' while drain thread waits for work
+  std::atomic<bool> idle;
+  //! 'true' when drain thread is requested to exit
+  bool bquit;
+  //! 'true' once drain thread has exited; entries are output synchronously
+  std::atomic<bool> bshutdown;
+  //! number of producers between bshutdown check and publishing an entry
+  std::atomic<int> inflight;
+  //! last requested flush sequence number
+  uint64_t flush_req;
+  //! last completed flush sequence number
+  uint64_t flush_done;
+  //! merge buffer (under reg_mutex)
+  std::vector<const entry_t*> merged;
+
+  //! statistics
+  std::atomic<uint64_t> st_posted;
+  std::atomic<uint64_t> st_stalled;
+  std::atomic<uint64_t> st_rings;
+
+  //! ring used by the calling thread
+  static thread_local holder_t tl_ring;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGRING_H_
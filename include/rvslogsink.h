@@ -0,0 +1,207 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGSINK_H_
+#define INCLUDE_RVSLOGSINK_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+//! default capacity of the record queue (number of records)
+#define RVS_LOGSINK_QUEUE_DEPTH     8192
+//! default interval between two periodic flushes (ms)
+#define RVS_LOGSINK_FLUSH_INTERVAL  200
+//! buffered bytes per target which trigger an immediate write
+#define RVS_LOGSINK_WRITE_THRESHOLD (64 * 1024)
+
+namespace rvs {
+
+class logframe;
+
+/**
+ * @class logsink
+ * @ingroup Launcher
+ *
+ * @brief Asynchronous log file writer
+ *
+ * Keeps log files open for the duration of the run and receives rows from
+ * producer threads through a bounded queue. A dedicated writer thread
+ * concatenates queued rows into per-file buffers and writes them out in
+ * large chunks, either when the buffer grows over
+ * RVS_LOGSINK_WRITE_THRESHOLD, when the flush interval elapses or when
+ * flush() is called explicitly.
+ *
+ * Files can optionally be rotated once they grow over a size limit or get
+ * older than an age limit. Rotation is performed by the writer thread so
+ * producers never wait on rename() or file creation.
+ *
+ */
+class logsink {
+ public:
+  //! output files served by the sink
+  enum target_t {
+    target_text = 0,
+    target_json = 1,
+    target_max
+  };
+
+  //! behavior when the queue is full
+  enum overflow_t {
+    //! producer waits for the writer to make room
+    overflow_block = 0,
+    //! record is discarded
+    overflow_drop
+  };
+
+  //! sink statistics
+  typedef struct {
+    //! records accepted into the queue
+    uint64_t records;
+    //! bytes written to files
+    uint64_t bytes;
+    //! number of write() batches
+    uint64_t batches;
+    //! records discarded because the queue was full
+    uint64_t dropped;
+    //! producer waits because the queue was full
+    uint64_t stalled;
+    //! number of file rotations
+    uint64_t rotations;
+  } stats_t;
+
+  //! rotation policy (zero limits disable rotation)
+  typedef struct {
+    //! rotate once the file would grow over this size (bytes)
+    uint64_t max_bytes;
+    //! rotate once the file is older than this (seconds)
+    unsigned int max_age;
+    //! number of rotated files to keep (<name>.1 .. <name>.N)
+    unsigned int generations;
+  } rotation_t;
+
+  logsink();
+  ~logsink();
+
+  int   set_file(target_t target, const std::string& fname);
+  int   post(target_t target, const std::string& row, unsigned int tag = 0);
+  void  flush();
+  void  close();
+  void  get_stats(stats_t* pstats);
+
+  void  set_queue_depth(size_t depth);
+  void  set_flush_interval(unsigned int ms);
+  void  set_overflow(overflow_t policy);
+  void  set_rotation(target_t target, const rotation_t& policy);
+  void  set_framer(target_t target, logframe* framer);
+
+ protected:
+  //! single queued row
+  typedef struct {
+    //! output target
+    target_t target;
+    //! 'true' if row holds new file name for the target
+    bool bctl;
+    //! row kind, passed on to the framer
+    unsigned int tag;
+    //! row text (or file name)
+    std::string row;
+  } record_t;
+
+  void  start();
+  void  run();
+  void  write_out(int target);
+  void  append(int target, record_t* prec);
+  void  rotate(int target);
+  void  close_files();
+
+ protected:
+  //! writer thread
+  std::thread writer;
+  //! protects queue and control members below
+  std::mutex mtx;
+  //! signaled when queue gets a record or a flush/quit is requested
+  std::condition_variable cv_work;
+  //! signaled when room is made in the queue or a flush completes
+  std::condition_variable cv_done;
+  //! pending records
+  std::deque<record_t> queue;
+  //! maximum number of pending records
+  size_t queue_depth;
+  //! periodic flush interval (ms)
+  unsigned int flush_interval;
+  //! overflow policy
+  overflow_t overflow;
+  //! 'true' once writer thread is running
+  bool brunning;
+  //! 'true' when writer thread is requested to exit
+  bool bquit;
+  //! 'true' once sink is destroyed; rows are then written synchronously
+  bool bshutdown;
+  //! last requested flush sequence number
+  uint64_t flush_req;
+  //! last completed flush sequence number
+  uint64_t flush_done;
+  //! rotation policy per target
+  rotation_t rotation[target_max];
+  //! framer per target (nullptr - rows are written as they are)
+  logframe* framer[target_max];
+
+  //! open file descriptors (owned by writer thread)
+  int fd[target_max];
+  //! names of currently open files (owned by writer thread)
+  std::string fd_name[target_max];
+  //! pending output (owned by writer thread)
+  std::string buffer[target_max];
+  //! 'true' once size and age of the current file are known (writer thread)
+  bool seg_known[target_max];
+  //! bytes in the current file, including buffered ones (writer thread)
+  uint64_t seg_bytes[target_max];
+  //! number of rows in the current file (writer thread)
+  uint64_t seg_rows[target_max];
+  //! time the current file was started (writer thread)
+  std::chrono::steady_clock::time_point seg_start[target_max];
+  //! rotation policy in effect (copy owned by writer thread)
+  rotation_t seg_policy[target_max];
+  //! framer in effect (copy owned by writer thread)
+  logframe* seg_framer[target_max];
+
+  //! statistics
+  std::atomic<uint64_t> st_records;
+  std::atomic<uint64_t> st_bytes;
+  std::atomic<uint64_t> st_batches;
+  std::atomic<uint64_t> st_dropped;
+  std::atomic<uint64_t> st_stalled;
+  std::atomic<uint64_t> st_rotations;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGSINK_H_
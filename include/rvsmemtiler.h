@@ -0,0 +1,136 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSMEMTILER_H_
+#define INCLUDE_RVSMEMTILER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+namespace rvs {
+
+/**
+ * @class memallocator
+ * @ingroup RVS
+ *
+ * @brief Device memory allocation interface driven by rvs::memtiler
+ *
+ */
+class memallocator {
+ public:
+  virtual ~memallocator() {}
+
+  /**
+   * @brief Allocate Size bytes
+   *
+   * @param Size number of bytes
+   * @return address of the allocation, nullptr if it failed
+   */
+  virtual void* alloc(size_t Size) = 0;
+
+  /**
+   * @brief Free allocation
+   *
+   * @param Ptr address returned by alloc()
+   */
+  virtual void free(void* Ptr) = 0;
+
+  /**
+   * @brief Memory currently free for allocation
+   *
+   * @return number of bytes, SIZE_MAX if not known
+   */
+  virtual size_t available() = 0;
+};
+
+/**
+ * @class memtile_s
+ * @ingroup RVS
+ *
+ * @brief One allocation of a rvs::memtiler
+ *
+ */
+typedef struct memtile_s {
+  //! start address
+  void* ptr;
+  //! size in bytes
+  size_t size;
+} memtile_t;
+
+/**
+ * @class memtiler
+ * @ingroup RVS
+ *
+ * @brief Covers a target amount of memory with as few allocations as
+ * possible
+ *
+ * The largest allocatable size is found by bisection between one
+ * granule and the size still to be covered (limited to free memory
+ * less headroom), so a size is found in about log2(size / granularity)
+ * attempts. When the largest allocation falls short of the target, e.g.
+ * because of fragmentation or a per-allocation limit, further tiles are
+ * allocated the same way until the target is covered, no granule can be
+ * allocated or the tile limit is reached. All sizes are multiples of
+ * the granularity.
+ *
+ */
+class memtiler {
+ public:
+  memtiler(memallocator* pAllocator, size_t Granularity, size_t Headroom,
+           unsigned int MaxTiles);
+  virtual ~memtiler();
+
+  size_t probe(size_t High, void** pPtr);
+  size_t tile(size_t Target);
+  void release();
+
+  //! allocated tiles, in order of allocation
+  const std::vector<memtile_t>& tiles() const { return tile_list; }
+  //! number of bytes covered by tiles
+  size_t covered() const { return covered_size; }
+  //! number of allocation attempts made so far
+  unsigned int attempts() const { return alloc_attempts; }
+
+ protected:
+  //! memory allocator
+  memallocator* allocator;
+  //! allocation granularity (bytes)
+  size_t granularity;
+  //! free memory left unallocated (bytes)
+  size_t headroom;
+  //! maximum number of tiles
+  unsigned int max_tiles;
+  //! allocated tiles
+  std::vector<memtile_t> tile_list;
+  //! number of bytes covered by tiles
+  size_t covered_size;
+  //! number of allocation attempts
+  unsigned int alloc_attempts;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSMEMTILER_H_
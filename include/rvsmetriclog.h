@@ -0,0 +1,185 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSMETRICLOG_H_
+#define INCLUDE_RVSMETRICLOG_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//! metrics file signature
+#define RVS_METRICLOG_MAGIC           "RVSMETR"
+//! metrics file format version
+#define RVS_METRICLOG_VERSION         1
+//! number of samples buffered before they are written out
+#define RVS_METRICLOG_BUFFER          4096
+//! maximum time samples stay buffered (ms)
+#define RVS_METRICLOG_FLUSH_INTERVAL  1000
+
+namespace rvs {
+
+//! metric identifiers stored in metrics file
+enum metric_t {
+  metric_none = 0,
+  //! GPU temperature (C)
+  metric_temperature,
+  //! average GPU power (W)
+  metric_power,
+  //! GPU clock (MHz)
+  metric_sclk,
+  //! memory clock (MHz)
+  metric_mclk,
+  //! fan speed (%)
+  metric_fan,
+  //! GEMM throughput (GFLOPS)
+  metric_gflops,
+  //! transfer bandwidth (GB/s)
+  metric_bandwidth,
+  metric_max
+};
+
+/**
+ * @brief Metrics file header
+ *
+ * Followed by an array of metric_record_t reaching to the end of file.
+ */
+typedef struct {
+  //! RVS_METRICLOG_MAGIC
+  char magic[8];
+  //! RVS_METRICLOG_VERSION
+  uint32_t version;
+  //! sizeof(metric_record_t)
+  uint32_t record_size;
+  //! wall clock time the file was started (ns since epoch)
+  uint64_t start_ns;
+  //! reserved, zero
+  uint64_t reserved[5];
+} metric_header_t;
+
+/**
+ * @brief Single sample in metrics file
+ */
+typedef struct {
+  //! time since metric_header_t::start_ns (ns)
+  uint64_t time_ns;
+  //! metric (metric_t or module specific id)
+  uint16_t metric;
+  //! device (GPU ID)
+  uint16_t device;
+  //! sample value
+  float value;
+} metric_record_t;
+
+/**
+ * @class metriclog
+ * @ingroup Launcher
+ *
+ * @brief Binary time-series sink for periodic numeric samples
+ *
+ * Samples are kept as fixed size records in memory and appended to the
+ * metrics file in large writes, either when RVS_METRICLOG_BUFFER samples
+ * are collected or when RVS_METRICLOG_FLUSH_INTERVAL elapses. The file is
+ * a header followed by a plain array of records so it can be mapped into
+ * memory by readers (see metricreader and rvs-logdump).
+ *
+ */
+class metriclog {
+ public:
+  static  int   open(const std::string& fname);
+  static  void  sample(uint16_t metric, uint16_t device, double value);
+  static  void  flush();
+  static  void  close();
+  //! returns 'true' if samples are being recorded
+  static  bool  active() { return bactive.load(std::memory_order_relaxed); }
+
+  static  const char*  metric_name(uint16_t metric);
+  static  int          metric_id(const std::string& name);
+
+ protected:
+  static  int   write_out(std::unique_lock<std::mutex>* plk,
+                          bool nowait = false);
+
+ protected:
+  //! 'true' while metrics file is open
+  static std::atomic<bool> bactive;
+  //! protects buffer and file descriptor
+  static std::mutex mtx;
+  //! serializes writes so that buffers reach the file in order
+  static std::mutex io_mtx;
+  //! metrics file descriptor
+  static int fd;
+  //! samples collected so far
+  static std::vector<metric_record_t> buffer;
+  //! buffer being written out (protected by io_mtx)
+  static std::vector<metric_record_t> spare;
+  //! time the file was started
+  static std::chrono::steady_clock::time_point start;
+  //! time of the last write
+  static std::chrono::steady_clock::time_point last_write;
+};
+
+/**
+ * @class metricreader
+ * @ingroup Launcher
+ *
+ * @brief Read access to metrics file through memory mapping
+ *
+ */
+class metricreader {
+ public:
+  metricreader();
+  ~metricreader();
+
+  int   open(const std::string& fname);
+  void  close();
+
+  //! wall clock time the file was started (ns since epoch)
+  uint64_t start_ns() const { return header ? header->start_ns : 0; }
+  //! number of complete records in the file
+  size_t count() const { return nrecords; }
+  //! records in the file
+  const metric_record_t* records() const { return data; }
+
+ protected:
+  //! mapped file
+  void* map;
+  //! mapped size
+  size_t map_size;
+  //! file header (in mapping)
+  const metric_header_t* header;
+  //! first record (in mapping)
+  const metric_record_t* data;
+  //! number of complete records
+  size_t nrecords;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSMETRICLOG_H_
@@ -0,0 +1,67 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSROUNDPLAN_H_
+#define INCLUDE_RVSROUNDPLAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace rvs {
+
+/**
+ * @class roundplan
+ * @ingroup RVS
+ *
+ * @brief Splits a set of transfers into contention-free rounds
+ *
+ * Each transfer lists the resources it occupies (its GPUs and, optionally,
+ * the links it shares with other transfers). Transfers in one round
+ * never share a resource, so all of them can run at the same time
+ * without competing for bandwidth.
+ *
+ * With GPUs as the only resources this is edge colouring of the peer
+ * graph: N GPUs with all pairs as peers take about N rounds instead of
+ * N * (N - 1) / 2 transfers run one by one.
+ *
+ */
+class roundplan {
+ public:
+  //! resources used by one transfer
+  typedef std::vector<uint64_t> resources_t;
+
+  static void plan(const std::vector<resources_t>& Transfers,
+                   std::vector<std::vector<size_t>>* pRounds);
+  static bool valid(const std::vector<resources_t>& Transfers,
+                    const std::vector<std::vector<size_t>>& Rounds);
+
+  static uint64_t gpu_resource(uint16_t GpuId);
+  static uint64_t link_resource(int NodeA, int NodeB);
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSROUNDPLAN_H_
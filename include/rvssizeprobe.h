@@ -0,0 +1,144 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSSIZEPROBE_H_
+#define INCLUDE_RVSSIZEPROBE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace rvs {
+
+/**
+ * @class runstats
+ * @ingroup RVS
+ *
+ * @brief Running mean and variance of a series of samples (Welford)
+ *
+ */
+class runstats {
+ public:
+  void add(double Value);
+
+  //! number of samples
+  unsigned int count() const { return n; }
+  //! mean of samples
+  double mean() const { return avg; }
+  double stddev() const;
+  double ci95() const;
+  double rel_ci95() const;
+
+ protected:
+  //! number of samples
+  unsigned int n = 0;
+  //! running mean
+  double avg = 0;
+  //! running sum of squared differences from the mean
+  double m2 = 0;
+};
+
+/**
+ * @class alphabeta_s
+ * @ingroup RVS
+ *
+ * @brief Transfer time model t(size) = alpha + size / beta
+ *
+ */
+typedef struct alphabeta_s {
+  //! latency (seconds)
+  double alpha;
+  //! asymptotic bandwidth (bytes per second)
+  double beta;
+  //! coefficient of determination of the fit
+  double r2;
+} alphabeta_t;
+
+int fit_alphabeta(const std::vector<double>& Sizes,
+                  const std::vector<double>& Times, alphabeta_t* pFit);
+
+/**
+ * @class sizeprobe
+ * @ingroup RVS
+ *
+ * @brief Chooses transfer sizes for an adaptive bandwidth sweep
+ *
+ * Starts with sizes four times apart between MinSize and MaxSize. Each
+ * size is measured until the 95% confidence interval of its mean time is
+ * within RelCI of the mean (or MaxSamples is reached). Then a size half
+ * way (on a log scale) is added between neighbours whose bandwidth
+ * differs by more than a tenth of the best bandwidth, which refines the
+ * sweep around the knee where bandwidth saturates and leaves the flat
+ * latency and bandwidth bound ends alone.
+ *
+ * Usage:
+ * @code
+ *   while (probe.next(&size)) {
+ *     probe.add(size, measure(size));
+ *   }
+ *   probe.fit(&model);
+ * @endcode
+ *
+ */
+class sizeprobe {
+ public:
+  //! measured size
+  struct point_t {
+    //! transfer size (bytes)
+    size_t size;
+    //! transfer time samples (seconds)
+    runstats time;
+  };
+
+  sizeprobe(size_t MinSize, size_t MaxSize, double RelCI,
+            unsigned int MinSamples = 3, unsigned int MaxSamples = 50,
+            unsigned int MaxPoints = 32);
+
+  bool next(size_t* pSize);
+  void add(size_t Size, double Seconds);
+
+  //! measured sizes, ascending
+  const std::vector<point_t>& points() const { return pts; }
+  int fit(alphabeta_t* pFit) const;
+
+ protected:
+  bool converged(const point_t& Point) const;
+  bool refine();
+
+  //! measured sizes, ascending
+  std::vector<point_t> pts;
+  //! target relative half width of the confidence interval
+  double rel_ci;
+  //! samples taken at each size before checking convergence
+  unsigned int min_samples;
+  //! samples after which a size is given up on
+  unsigned int max_samples;
+  //! limit of measured sizes
+  unsigned int max_points;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSSIZEPROBE_H_
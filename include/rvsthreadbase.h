@@ -26,6 +26,8 @@
 #define INCLUDE_RVSTHREADBASE_H_
 
 #include <thread>
+#include <atomic>
+#include <vector>
 
 namespace rvs {
 
@@ -46,6 +48,7 @@ class ThreadBase {
   virtual void detach();
   virtual void join();
   virtual void sleep(const unsigned int ms);
+  void set_cpu_affinity(const std::vector<int>& cpus);
 
  protected:
   void runinternal(void);
@@ -56,6 +59,10 @@ class ThreadBase {
  protected:
   //! Underlaying std::thread object.
   std::thread t;
+  //! session stop request flag inherited from the thread calling start()
+  std::atomic<bool>* pcancel;
+  //! CPUs the thread may run on (empty - no restriction)
+  std::vector<int> cpu_affinity;
 };
 
 }  // namespace rvs
@@ -25,9 +25,11 @@
 #ifndef INCLUDE_RVSTIMER_H_
 #define INCLUDE_RVSTIMER_H_
 
-#include <chrono>
+#include <stdint.h>
 
-#include "include/rvsthreadbase.h"
+#include <atomic>
+
+#include "include/rvstimerservice.h"
 
 namespace rvs {
 
@@ -41,12 +43,13 @@ namespace rvs {
  * It accepts parameter T which is a class which member function will
  * be called upon expiration of timer interval.
  *
- * Timer resolution is 1ms
+ * Timers are kept by rvs::timerservice; callback is called on one of its
+ * threads at the deadline rather than polled for.
  *
  */
 
 template<class T>
-class timer : public ThreadBase {
+class timer {
  public:
   //! helper typedef to simplify member declaration of callback function
   typedef void (T::*timerfunc_t)();
@@ -58,7 +61,8 @@ class timer : public ThreadBase {
  * back
  *
  */
-  timer(timerfunc_t cbFunc, T* cbArg) {
+  timer(timerfunc_t cbFunc, T* cbArg) : brun(false), brunonce(false),
+                                        timeset(0), id(0) {
     cbfunc = cbFunc;
     cbarg = cbArg;
   }
@@ -71,79 +75,43 @@ class timer : public ThreadBase {
   /**
   * @brief Start timer
   *
+  * Restarts the timer if already running.
+  *
   * @param Interval Timer interval in ms
   * @param RunOnce 'true' if timer is to fire only once
   *
   * */
   void start(int Interval, bool RunOnce = false) {
+    stop();
     brunonce = RunOnce;
     timeset = Interval;
-    end_time = std::chrono::system_clock::now() +
-               std::chrono::milliseconds(timeset);
-    // recalculate the end time and only if thread is not started start it
-    if (brun == false) {
-      brun = true;
-      rvs::ThreadBase::start();
-    }
+    brun = true;
+    id = timerservice::get().add(timeset, brunonce, [this]() {
+      (cbarg->*cbfunc)();
+      if (brunonce) {
+        brun = false;
+      }
+    });
   }
 
 
 /**
  * @brief Stop timer
  *
- * Sets brun member to FALSE thus signaling end of processing.
- * Then it waits for std::thread to exit before returning.
+ * Cancels the timer. Callback is not called once this returns.
  *
  * */
   void stop() {
-    // signal thread to exit
     brun = false;
-
-    // wait a bit to make sure thread has exited
-    std::this_thread::yield();
-
-    try {
-      if (t.joinable())
-        t.join();
-    } catch(...) {
+    if (id) {
+      timerservice::get().cancel(id);
+      id = 0;
     }
   }
 
-
-/**
- * @brief Timer internal thread function (called from ThreadBase)
- *
- * */
-  virtual void run() {
-    do {
-      std::chrono::time_point<std::chrono::system_clock> curr_time;
-      // wait for time to ellsapse (or for timer to be stopped)
-      while (brun) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        curr_time = std::chrono::system_clock::now();
-        if (std::chrono::duration_cast<std::chrono::milliseconds>
-                                         (curr_time - end_time).count() >= 0) {
-          break;
-        }
-      }
-
-      // if timer is not stopped, call the callback function
-      if (brun) {
-        (cbarg->*cbfunc)();
-      }
-
-      if (brunonce) {
-        brun = false;
-      } else {
-        end_time = std::chrono::system_clock::now() +
-                   std::chrono::milliseconds(timeset);
-      }
-    } while (brun);
-  }
-
  protected:
   //! true for the duration of timer activity
-  bool        brun;
+  std::atomic<bool> brun;
   //! true if timer is to fire only once
   bool        brunonce;
   //! timer interval (ms)
@@ -152,8 +120,8 @@ class timer : public ThreadBase {
   timerfunc_t cbfunc;
   //! ptr to instance of a class to be called-back through cbfunc.
   T*          cbarg;
-  //! time when timer will expire
-  std::chrono::time_point<std::chrono::system_clock> end_time;
+  //! ID of the timer in timer service (0 - not started)
+  uint64_t    id;
 };
 
 }  // namespace rvs
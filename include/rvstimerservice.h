@@ -0,0 +1,128 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSTIMERSERVICE_H_
+#define INCLUDE_RVSTIMERSERVICE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! number of threads calling timer callbacks
+#define RVS_TIMER_DISPATCH_THREADS  4
+
+namespace rvs {
+
+/**
+ * @class timerservice
+ * @ingroup RVS
+ *
+ * @brief Process wide timer service
+ *
+ * Keeps all timers in a single queue ordered by deadline (steady clock).
+ * A scheduler thread sleeps on a condition variable until the earliest
+ * deadline and hands expired timers to a small pool of dispatch threads
+ * which call the callbacks. Callbacks of one timer never overlap;
+ * callbacks of different timers may run concurrently.
+ *
+ */
+class timerservice {
+ public:
+  //! timer callback
+  typedef std::function<void()> callback_t;
+  //! monotonic clock timers are based on
+  typedef std::chrono::steady_clock clock_t;
+
+  static timerservice& get();
+
+  uint64_t add(unsigned int interval_ms, bool once, const callback_t& cb);
+  void     cancel(uint64_t id);
+  bool     active(uint64_t id);
+  size_t   size();
+
+  ~timerservice();
+
+ protected:
+  timerservice();
+
+  //! single timer
+  typedef struct {
+    //! interval between callbacks
+    clock_t::duration interval;
+    //! true if the timer fires only once
+    bool once;
+    //! callback function
+    callback_t cb;
+    //! current (or last) deadline
+    clock_t::time_point when;
+    //! position in deadlines if scheduled
+    std::multimap<clock_t::time_point, uint64_t>::iterator deadline;
+    //! true if deadline is valid (not yet expired or being dispatched)
+    bool scheduled;
+    //! session stop request flag of the thread which added the timer
+    std::atomic<bool>* pcancel;
+  } entry_t;
+
+  void schedule(uint64_t id, entry_t* pentry, clock_t::time_point when);
+  void scheduler();
+  void dispatcher();
+
+ protected:
+  //! guards all members below
+  std::mutex mtx;
+  //! signaled when the earliest deadline changes or on shutdown
+  std::condition_variable cv_sched;
+  //! signaled when expired timers are queued for dispatch
+  std::condition_variable cv_due;
+  //! signaled when a callback returns
+  std::condition_variable cv_done;
+  //! timers by ID
+  std::map<uint64_t, entry_t> timers;
+  //! IDs of scheduled timers ordered by deadline
+  std::multimap<clock_t::time_point, uint64_t> deadlines;
+  //! IDs of expired timers waiting for a dispatch thread
+  std::deque<uint64_t> due;
+  //! thread currently running callback of a timer, by timer ID
+  std::map<uint64_t, std::thread::id> running;
+  //! last ID assigned
+  uint64_t last_id;
+  //! true while service threads should keep running
+  bool brun;
+  //! scheduler thread
+  std::thread sched_thread;
+  //! dispatch threads
+  std::vector<std::thread> pool;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSTIMERSERVICE_H_
@@ -0,0 +1,147 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSTOPOLOGY_H_
+#define INCLUDE_RVSTOPOLOGY_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! default root of the sysfs tree topology is read from
+#define RVS_SYSFS_ROOT                  "/sys"
+
+//! KFD topology nodes, relative to sysfs root
+#define RVS_KFD_NODES_PATH              "/class/kfd/kfd/topology/nodes"
+
+//! PCI devices, relative to sysfs root
+#define RVS_PCI_DEVICES_PATH            "/bus/pci/devices"
+
+namespace rvs {
+
+//! "name value" pairs of a KFD properties file, in file order
+typedef std::vector<std::pair<std::string, std::string>> topoprops;
+
+/**
+ * @brief KFD io_link of a topology node
+ */
+struct topolink {
+  //! link index (io_links/<id>)
+  uint16_t id;
+  //! node the link leads to
+  uint16_t node_to;
+  //! link properties
+  topoprops properties;
+
+  bool get(const std::string& name, uint64_t* pval) const;
+};
+
+/**
+ * @brief KFD topology node (CPU or GPU)
+ */
+struct toponode {
+  //! KFD node ID
+  uint16_t node;
+  //! KFD gpu_id, 0 for CPU nodes
+  uint16_t gpu_id;
+  //! PCI location ID (bus << 8 | device << 3 | function)
+  uint16_t location_id;
+  //! PCI device ID
+  uint16_t device_id;
+  //! PCI domain
+  uint16_t domain;
+  //! node properties
+  topoprops properties;
+  //! io_links ordered by link index
+  std::vector<topolink> io_links;
+
+  bool get(const std::string& name, uint64_t* pval) const;
+  std::string bdf() const;
+};
+
+/**
+ * @class topology
+ * @ingroup RVS
+ *
+ * @brief KFD topology snapshot
+ *
+ * Reads every node of the KFD topology, its properties and io_links in a
+ * single pass and indexes GPU nodes by gpu_id, node ID, location ID and
+ * domain:location (BDF). The process wide snapshot is shared by all
+ * users and replaced as a whole by refresh(); sysfs root may be
+ * redirected to a fake tree for testing.
+ *
+ */
+class topology {
+ public:
+  int load(const std::string& root);
+
+  //! all nodes ordered by node ID
+  const std::vector<toponode>& nodes() const { return nodelist; }
+  void gpus(std::vector<uint16_t>* pgpus) const;
+
+  const toponode* by_gpu(uint16_t gpu_id) const;
+  const toponode* by_node(uint16_t node) const;
+  const toponode* by_location(uint16_t location_id) const;
+  const toponode* by_bdf(uint16_t domain, uint16_t location_id) const;
+
+  static std::shared_ptr<const topology> snapshot();
+  static int refresh();
+
+  static void set_sysfs_root(const std::string& root);
+  static std::string sysfs_root();
+
+ protected:
+  static int load_props(const std::string& path, topoprops* pprops);
+  const toponode* find(const std::unordered_map<uint32_t, size_t>& index,
+                       uint32_t key) const;
+
+ protected:
+  //! all nodes ordered by node ID
+  std::vector<toponode> nodelist;
+  //! GPU nodes by gpu_id
+  std::unordered_map<uint32_t, size_t> gpu_index;
+  //! all nodes by node ID
+  std::unordered_map<uint32_t, size_t> node_index;
+  //! GPU nodes by location ID
+  std::unordered_map<uint32_t, size_t> location_index;
+  //! GPU nodes by domain << 16 | location ID
+  std::unordered_map<uint32_t, size_t> bdf_index;
+
+  //! sysfs root directory
+  static std::string root;
+  //! process wide snapshot, built on first use
+  static std::shared_ptr<const topology> current;
+  //! protects root and current
+  static std::mutex mtx;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSTOPOLOGY_H_
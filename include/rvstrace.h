@@ -28,11 +28,12 @@
 #include <iostream>
 #include <string>
 
-/*
- // uncomment to enable tracing
- #define DTRACE_ std::cout << __FILE__ << " " << __func__<<":"\
- << std::to_string(__LINE__) << std::endl;
-*/
+// define RVS_DO_DTRACE (e.g. -DRVS_DO_DTRACE) to enable logger tracing
+// to stdout; otherwise DTRACE_ compiles to nothing
+#if defined(RVS_DO_DTRACE) && !defined(DTRACE_)
+  #define DTRACE_ std::cout << __FILE__ << " " << __func__<<":"\
+  << std::to_string(__LINE__) << std::endl;
+#endif
 
 #ifndef DTRACE_
   #define DTRACE_
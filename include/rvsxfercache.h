@@ -0,0 +1,167 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSXFERCACHE_H_
+#define INCLUDE_RVSXFERCACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace rvs {
+
+//! transfer cache key: source node, destination node, bidirectional
+typedef std::tuple<uint32_t, uint32_t, bool> xferkey_t;
+
+/**
+ * @class xferallocator
+ * @ingroup RVS
+ *
+ * @brief Transfer buffer allocation interface driven by rvs::xfercache
+ *
+ */
+class xferallocator {
+ public:
+  virtual ~xferallocator() {}
+
+  /**
+   * @brief Allocate buffers and signals for transfers up to Size bytes
+   *
+   * @param Key transfer the buffers are for
+   * @param Size size of each buffer
+   * @param ppData [out] allocated transfer
+   * @param pBytes [out] bytes held by the allocation
+   * @return 0 - if successfull, non-zero otherwise (nothing allocated)
+   */
+  virtual int xfer_alloc(const xferkey_t& Key, size_t Size,
+                         void** ppData, size_t* pBytes) = 0;
+
+  /**
+   * @brief Free transfer returned by xfer_alloc()
+   *
+   * @param pData allocated transfer
+   */
+  virtual void xfer_free(void* pData) = 0;
+};
+
+/**
+ * @class xfercachestats_s
+ * @ingroup RVS
+ *
+ * @brief Statistics of a rvs::xfercache
+ *
+ */
+typedef struct xfercachestats_s {
+  //! transfers served from cached buffers
+  uint64_t hits;
+  //! transfers which allocated buffers
+  uint64_t misses;
+  //! cached transfers released to stay within cache limit
+  uint64_t evictions;
+  //! bytes currently allocated in cached buffers
+  size_t bytes;
+} xfercachestats_t;
+
+/**
+ * @class xferlease_s
+ * @ingroup RVS
+ *
+ * @brief Transfer handed out by rvs::xfercache::acquire()
+ *
+ */
+typedef struct xferlease_s {
+  //! allocated transfer
+  void* data;
+  //! cache entry, nullptr for temporary transfer
+  void* entry;
+} xferlease_t;
+
+/**
+ * @class xfercache
+ * @ingroup RVS
+ *
+ * @brief Cache of transfer buffers keyed by (src, dst, direction)
+ *
+ * A cached transfer is leased to one caller at a time and reused if large
+ * enough, otherwise it is reallocated to the requested size. A caller
+ * finding it leased to another one gets a temporary transfer, freed on
+ * release. Idle transfers are freed least recently used first while
+ * cached bytes exceed the limit.
+ *
+ * Allocation happens outside of the cache lock so that transfers of other
+ * keys proceed meanwhile.
+ *
+ * The destructor does not free anything as the allocator may already be
+ * gone; owner calls clear() first.
+ *
+ */
+class xfercache {
+ public:
+  xfercache(xferallocator* pAllocator, size_t Limit);
+
+  int acquire(const xferkey_t& Key, size_t Size, xferlease_t* pLease);
+  void release(xferlease_t* pLease);
+  void clear();
+  void set_limit(size_t Bytes);
+  void get_stats(xfercachestats_t* pStats);
+
+ protected:
+  void evict();
+
+  /**
+   * @brief Cached transfer
+   */
+  struct entry_t {
+    //! allocated transfer, nullptr if none
+    void* data = nullptr;
+    //! capacity of each buffer in bytes
+    size_t size = 0;
+    //! bytes held by the allocation
+    size_t bytes = 0;
+    //! 'true' while leased
+    bool busy = false;
+    //! last use tick (for LRU eviction)
+    uint64_t last_use = 0;
+  };
+
+  //! transfer allocator
+  xferallocator* allocator;
+  //! cached transfers
+  std::map<xferkey_t, entry_t> entries;
+  //! protects entries, stats, limit and tick
+  std::mutex mtx;
+  //! cache statistics
+  xfercachestats_t stats;
+  //! limit of bytes kept in cached transfers
+  size_t limit;
+  //! use counter for LRU eviction
+  uint64_t tick;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSXFERCACHE_H_
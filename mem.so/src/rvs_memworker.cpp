@@ -0,0 +1,319 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <unistd.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <memory>
+#include <iostream>
+#include <sys/time.h>
+#include <mutex>
+#include <vector>
+
+#include "hip/hip_runtime.h"
+#include "include/rvs_memworker.h"
+#include "include/rvs_memtest.h"
+#include "include/rvsloglp.h"
+#include "include/rvsmemtiler.h"
+
+using std::string;
+
+extern void allocate_small_mem(void);
+bool MemWorker::bjson = false;
+extern rvs_memdata   memdata;
+ 
+
+
+MemWorker::MemWorker() {}
+MemWorker::~MemWorker() {}
+
+rvs_memtest_t rvs_memtests[]={
+    {test0, (char*)" Test1   [Walking 1 bit]",		       	  1},
+    {test1, (char*)" Test2   [Own address test]",		  1},
+    {test2, (char*)" Test3   [Moving inversions, ones&zeros]",	  1},
+    {test3, (char*)" Test4   [Moving inversions, 8 bit pat]",	  1},
+    {test4, (char*)" Test5   [Moving inversions, random pattern]",1},
+    {test5, (char*)" Test6   [Block move, 64 moves]",		  1},
+    {test6, (char*)" Test7   [Moving inversions, 32 bit pat]",	  1},
+    {test7, (char*)" Test8   [Random number sequence]",		  1},
+    {test8, (char*)" Test9   [Modulo 20, random pattern]",	  1},
+    {test9, (char*)" Test10  [Bit fade test]",			  0},
+    {test10, (char*)"Test11  [Memory stress test]",		  1},
+};
+
+void MemWorker::init_tests(const std::vector<uint32_t>& exclude_list){
+	for(const auto& testidx : exclude_list){
+		rvs_memtests[testidx].enabled = 0;
+	}
+}
+#if 0
+void MemWorker::allocate_small_mem(void)
+{
+    //Initialize memory
+    HIP_CHECK(hipMalloc((void**)&ptCntOfError, sizeof(unsigned int) )); 
+    HIP_CHECK(hipMemset(ptCntOfError, 0, sizeof(unsigned int) )); 
+
+    HIP_CHECK(hipMalloc((void**)&ptFailedAdress, sizeof(unsigned long) * MAX_ERR_RECORD_COUNT));
+    HIP_CHECK(hipMemset(ptFailedAdress, 0, sizeof(unsigned long) * MAX_ERR_RECORD_COUNT));
+
+    HIP_CHECK(hipMalloc((void**)&ptExpectedValue, sizeof(unsigned long) * MAX_ERR_RECORD_COUNT));
+    HIP_CHECK(hipMemset(ptExpectedValue, 0, sizeof(unsigned long) * MAX_ERR_RECORD_COUNT));
+
+    HIP_CHECK(hipMalloc((void**)&ptCurrentValue, sizeof(unsigned long) * MAX_ERR_RECORD_COUNT));
+    HIP_CHECK(hipMemset(ptCurrentValue, 0, sizeof(unsigned long) * MAX_ERR_RECORD_COUNT));
+
+    HIP_CHECK(hipMalloc((void**)&ptValueOfSecondRead, sizeof(unsigned long) * MAX_ERR_RECORD_COUNT));
+    HIP_CHECK(hipMemset(ptValueOfSecondRead, 0, sizeof(unsigned long) * MAX_ERR_RECORD_COUNT));
+}
+
+void MemWorker::free_small_mem(void)
+{
+    //Initialize memory
+    hipFree((void*)&ptCntOfError);
+
+    hipFree((void*)ptFailedAdress);
+
+    hipFree((void*)ptExpectedValue);
+
+    hipFree((void*)ptCurrentValue);
+
+    hipFree((void*)ptValueOfSecondRead);
+}
+#endif
+
+void MemWorker::Initialization(void)
+{
+    memdata.threadsPerBlock = get_threads_per_block();
+    memdata.blocks = get_num_mem_blocks();
+    memdata.num_passes = get_num_passes();
+    memdata.global_pattern = 0;
+    memdata.global_pattern_long = 0;
+    memdata.action_name = action_name;
+    memdata.gpu_idx = gpu_id;
+    memdata.num_iterations = num_iterations;
+}
+ 
+void MemWorker::run_tests(char* ptr, uint64_t tot_num_blocks)
+{
+    struct timeval  t0, t1;
+    unsigned int i;
+    std::string msg;
+    rvs::action_result_t action_result;
+
+    Initialization();
+
+    for (i = 0; i < DIM(rvs_memtests); i++){
+          gettimeofday(&t0, NULL);
+          rvs_memtests[i].func(ptr, tot_num_blocks);
+          gettimeofday(&t1, NULL);
+          msg = "[" + action_name + "] " + MODULE_NAME + " " +
+                   std::to_string(gpu_id) + " To run memtest time taken: " + std::to_string(TDIFF(t1, t0)) + " seconds with " + std::to_string(i) + " passes ";
+          rvs::lp::Log(msg, rvs::loginfo);
+     }//for
+
+     msg = "[" + action_name + "] " + MODULE_NAME + " " +
+                   std::to_string(gpu_id) + " " + " Memory tests : " + std::to_string(i) + " tests complete \n";
+     rvs::lp::Log(msg, rvs::loginfo);
+     
+
+      action_result.state = rvs::actionstate::ACTION_RUNNING;
+      action_result.status = rvs::actionstatus::ACTION_SUCCESS;
+      action_result.output = msg.c_str();
+      action.action_callback(&action_result);
+}
+
+
+namespace {
+
+/**
+ * Allocates device memory, or host memory mapped to the device, with
+ * failures reported instead of aborting, so that rvs::memtiler can probe
+ * for the largest allocation.
+ */
+class hipallocator : public rvs::memallocator {
+ public:
+  explicit hipallocator(bool Mapped) : mapped(Mapped) {}
+
+  void* alloc(size_t Size) override {
+    void* ptr = nullptr;
+    if (!mapped) {
+      if (hipMalloc(&ptr, Size) != hipSuccess) {
+        hipGetLastError();
+        return nullptr;
+      }
+      return ptr;
+    }
+
+    void* host = nullptr;
+    if (hipHostMalloc(&host, Size,
+                      hipHostMallocWriteCombined | hipHostMallocMapped)
+        != hipSuccess) {
+      hipGetLastError();
+      return nullptr;
+    }
+    if (hipHostGetDevicePointer(&ptr, host, 0) != hipSuccess) {
+      hipGetLastError();
+      hipHostFree(host);
+      return nullptr;
+    }
+    host_ptr[ptr] = host;
+    return ptr;
+  }
+
+  void free(void* Ptr) override {
+    if (!mapped) {
+      hipFree(Ptr);
+      return;
+    }
+    hipHostFree(host_ptr[Ptr]);
+    host_ptr.erase(Ptr);
+  }
+
+  size_t available() override {
+    size_t free_mem;
+    size_t total_mem;
+    if (mapped || hipMemGetInfo(&free_mem, &total_mem) != hipSuccess) {
+      return SIZE_MAX;
+    }
+    return free_mem;
+  }
+
+ private:
+  //! 'true' for host memory mapped to the device
+  bool mapped;
+  //! host addresses of mapped allocations by device address
+  std::map<void*, void*> host_ptr;
+};
+
+}  // namespace
+
+/**
+ * @brief performs the stress test on the given GPU
+ *
+ * Memory to test (coverage percentage of the total, or 'mem_blocks'
+ * blocks, or all free memory) is covered by as few allocations as
+ * possible; tests run on each of them in turn.
+ */
+void MemWorker::run() {
+    hipDeviceProp_t props;
+    string          msg;
+    size_t          free;
+    size_t          total;
+    size_t          target;
+    int             deviceId;
+    char            buff[128];
+
+    // log MEM stress test - start message
+    msg = "[" + action_name + "] " + MODULE_NAME + " " +
+            std::to_string(gpu_id) + " "  + " Starting the Memory stress test "; 
+    rvs::lp::Log(msg, rvs::loginfo);
+
+    deviceId  = get_gpu_device_index();
+
+    HIP_CHECK(hipGetDeviceProperties(&props, deviceId));
+
+    msg = "[" + action_name + "] " + MODULE_NAME + " " +
+            std::to_string(gpu_id) + " " + "Total Global Memory" + " " +
+            std::to_string(props.totalGlobalMem); 
+    rvs::lp::Log(msg, rvs::logtrace);
+
+    HIP_CHECK(hipSetDevice(deviceId));
+
+    hipDeviceSynchronize();
+
+    HIP_CHECK(hipMemGetInfo(&free, &total));
+
+    msg = "[" + action_name + "] " + MODULE_NAME + " " +
+            std::to_string(gpu_id) + " " + "Total Memory from hipMemGetInfo " + " " +
+            std::to_string(total) + " " + " Free Memory from hipMemGetInfo " + " " + 
+            std::to_string(free);
+    rvs::lp::Log(msg, rvs::logtrace);
+
+    allocate_small_mem();
+
+    if (coverage > 0) {
+        target = static_cast<size_t>(total * (coverage / 100));
+    } else if (max_num_blocks != 0) {
+        target = max_num_blocks * BLOCKSIZE;
+    } else {
+        target = free;
+    }
+    target = target / BLOCKSIZE * BLOCKSIZE;
+
+    msg = "[" + action_name + "] " + MODULE_NAME + " " +
+            std::to_string(gpu_id) + " " + "Use mapped memory  " + " " +
+            std::to_string(useMappedMemory) + " Block Size: " +  std::to_string(BLOCKSIZE) +
+            " Memory to be allocated: " + std::to_string(target);
+    rvs::lp::Log(msg, rvs::loginfo);
+
+    //need to leave a little headroom or later calls will fail
+    hipallocator allocator(useMappedMemory);
+    rvs::memtiler tiler(&allocator, BLOCKSIZE, MEM_NUM_SAVE_BLOCKS * BLOCKSIZE,
+                        MEM_MAX_TILES);
+
+    if (tiler.tile(target) == 0) {
+        msg = "[" + action_name + "] " + MODULE_NAME + " " +
+                std::to_string(gpu_id) + " " + " Total Number of blocks is zero, cant allocate memory";
+        rvs::lp::Log(msg, rvs::logerror);
+        free_small_mem();
+        return;
+    }
+
+    // report covered address ranges
+    const std::vector<rvs::memtile_t>& tiles = tiler.tiles();
+    for (size_t i = 0; i < tiles.size(); i++) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(tiles[i].ptr);
+        snprintf(buff, sizeof(buff), "0x%" PRIxPTR " - 0x%" PRIxPTR,
+                 base, base + tiles[i].size);
+        msg = "[" + action_name + "] " + MODULE_NAME + " " +
+                std::to_string(gpu_id) + " Memory range " + std::to_string(i) +
+                ": " + buff + " (" + std::to_string(tiles[i].size / BLOCKSIZE) +
+                " blocks)";
+        rvs::lp::Log(msg, rvs::loginfo);
+    }
+    snprintf(buff, sizeof(buff), "%.1f%%", 100.0 * tiler.covered() / total);
+    msg = "[" + action_name + "] " + MODULE_NAME + " " +
+            std::to_string(gpu_id) + " Memory covered: " +
+            std::to_string(tiler.covered()) + " bytes (" + buff + " of total) in " +
+            std::to_string(tiles.size()) + " allocations, " +
+            std::to_string(tiler.attempts()) + " allocation attempts";
+    rvs::lp::Log(msg, rvs::loginfo);
+
+    for (size_t i = 0; i < tiles.size(); i++) {
+        uint64_t tot_num_blocks = tiles[i].size / BLOCKSIZE;
+
+        msg = "[" + action_name + "] " + MODULE_NAME + " " + std::to_string(gpu_id) + " " + "Starting running tests " + " " + 
+                      "Total Num of blocks " + std::to_string(tot_num_blocks) +
+                      " in memory range " + std::to_string(i);
+        rvs::lp::Log(msg, rvs::logtrace);
+
+        run_tests(static_cast<char*>(tiles[i].ptr), tot_num_blocks);
+    }
+
+    tiler.release();
+    free_small_mem();
+}
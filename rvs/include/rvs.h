@@ -39,7 +39,8 @@ typedef enum {
   RVS_STATUS_INVALID_ARGUMENT = -2, /*!< Invalid argument to function */
   RVS_STATUS_INVALID_STATE = -3, /*!< Invalid RVS state */
   RVS_STATUS_INVALID_SESSION = -4, /*!< Invalid session */
-  RVS_STATUS_INVALID_SESSION_STATE = -5 /*!< Invalid session state */
+  RVS_STATUS_INVALID_SESSION_STATE = -5, /*!< Invalid session state */
+  RVS_STATUS_TIMEOUT = -6 /*!< Session did not complete in time */
 /*
  * Not Supported,
  * Module not found
@@ -138,6 +139,24 @@ typedef struct {
  */
 typedef void (*rvs_session_callback) (rvs_session_id_t session_id, const rvs_results_t *results);
 
+/*! \struct rvs_metric_t
+ *  \brief Metric value produced by a session action.
+ */
+typedef struct {
+  const char *name; /*!< Metric name (e.g. "bandwidth") */
+  const char *unit; /*!< Metric unit (e.g. "GB/s") */
+  unsigned int device; /*!< GPU id, 0 if metric is not device specific */
+  double value; /*!< Metric value */
+  unsigned long long timestamp_ns; /*!< Time value was produced (ns since epoch) */
+} rvs_metric_t;
+
+/*!
+ * RVS session metric callback function pointer. Receives metric values in
+ * batches; the array and the strings it points to are valid only during the
+ * call.
+ */
+typedef void (*rvs_metric_callback) (rvs_session_id_t session_id, const rvs_metric_t *metrics, unsigned int count);
+
 /**
  * Initialize RVS(ROCMm Validation Suite) component. 
  * @param None 
@@ -164,6 +183,16 @@ rvs_status_t rvs_session_create(rvs_session_id_t *session_id, rvs_session_callba
  */
 rvs_status_t rvs_session_set_property(rvs_session_id_t session_id, rvs_session_property_t *session_property);
 
+/**
+ * Set callback receiving metric values (bandwidth, GFLOPS, ...) produced
+ * while session runs.
+ * @param[in] session_id - Session identifier
+ * @param[in] metric_cb - Metric callback function handler, NULL to disable
+ * @return RVS_STATUS_SUCCESS - Successfully set callback
+ * @return RVS_STATUS_INVALID_SESSION_STATE - Session is running
+ */
+rvs_status_t rvs_session_set_metric_callback(rvs_session_id_t session_id, rvs_metric_callback metric_cb);
+
 /**
  * Execute session test routine based on property set in RVS.
  * @param[in] session_id - Session identifier 
@@ -172,6 +201,45 @@ rvs_status_t rvs_session_set_property(rvs_session_id_t session_id, rvs_session_p
  */
 rvs_status_t rvs_session_execute(rvs_session_id_t session_id);
 
+/**
+ * Start session test routine based on property set in RVS and return
+ * immediately. Session runs on its own worker thread, concurrently with
+ * other sessions.
+ * @param[in] session_id - Session identifier
+ * @return RVS_STATUS_SUCCESS - Successfully started session
+ * @return RVS_STATUS_FAILED - Failed to start session
+ */
+rvs_status_t rvs_session_execute_async(rvs_session_id_t session_id);
+
+/**
+ * Wait for session started by rvs_session_execute_async() to complete.
+ * @param[in] session_id - Session identifier
+ * @param[in] timeout_ms - Maximum wait time in milliseconds, negative to
+ * wait indefinitely
+ * @return RVS_STATUS_SUCCESS - Session completed successfully
+ * @return RVS_STATUS_FAILED - Session completed with failure
+ * @return RVS_STATUS_TIMEOUT - Session still running after timeout_ms
+ */
+rvs_status_t rvs_session_wait(rvs_session_id_t session_id, int timeout_ms);
+
+/**
+ * Ask running session to stop. Actions not yet started are skipped and
+ * running actions stop at their next check. Does not wait for completion.
+ * @param[in] session_id - Session identifier
+ * @return RVS_STATUS_SUCCESS - Stop requested
+ * @return RVS_STATUS_INVALID_SESSION_STATE - Session is not running
+ */
+rvs_status_t rvs_session_cancel(rvs_session_id_t session_id);
+
+/**
+ * Query current session state.
+ * @param[in] session_id - Session identifier
+ * @param[out] state - Current session state
+ * @return RVS_STATUS_SUCCESS - State returned
+ * @return RVS_STATUS_INVALID_SESSION - Invalid session
+ */
+rvs_status_t rvs_session_get_state(rvs_session_id_t session_id, rvs_session_state_t *state);
+
 /**
  * Destroy/Free session after completion of test routine.
  * @param[in] session_id - Session identifier
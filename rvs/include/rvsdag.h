@@ -0,0 +1,102 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSDAG_H_
+#define RVS_INCLUDE_RVSDAG_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace rvs {
+
+/**
+ * @class actiondag
+ * @ingroup Launcher
+ *
+ * @brief Dependency graph of configuration file actions.
+ *
+ * Actions are added in configuration file order. An action without explicit
+ * dependencies depends on all actions of the previous stage, where a stage is
+ * either a single action or a run of consecutive actions sharing the same
+ * parallel group. Without any groups or dependencies actions thus run
+ * strictly one after another, as before.
+ *
+ */
+class actiondag {
+ public:
+  //! action execution state
+  enum state_t {
+    state_pending,
+    state_running,
+    state_done,
+    state_failed,
+    state_cancelled
+  };
+
+  //! executes action with the given index, returns 0 on success
+  typedef std::function<int(size_t)> run_t;
+  //! reports completion status of the action with the given index
+  typedef std::function<void(size_t, int)> done_t;
+
+  size_t add(const std::string& name, const std::string& group,
+             const std::vector<std::string>& depends_on);
+  int    build(std::string* perr);
+  int    run(unsigned int max_parallel, run_t run_action, done_t done);
+
+  //! number of actions in graph
+  size_t size() const { return nodes.size(); }
+  //! name of action with the given index
+  const std::string& name(size_t i) const { return nodes[i].name; }
+  //! execution state of action with the given index
+  state_t state(size_t i) const { return nodes[i].state; }
+  //! indexes of actions the given action waits for (valid after build())
+  const std::vector<size_t>& preds(size_t i) const { return nodes[i].preds; }
+
+ protected:
+  //! graph node
+  struct node_t {
+    //! action name
+    std::string name;
+    //! parallel group name, empty if none
+    std::string group;
+    //! names of actions or groups given in depends_on
+    std::vector<std::string> depends_on;
+    //! indexes of predecessors
+    std::vector<size_t> preds;
+    //! indexes of successors
+    std::vector<size_t> succs;
+    //! number of predecessors not yet completed
+    size_t waiting;
+    //! execution state
+    state_t state;
+  };
+
+  //! graph nodes in configuration file order
+  std::vector<node_t> nodes;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSDAG_H_
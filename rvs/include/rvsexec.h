@@ -27,8 +27,13 @@
 
 #include <string>
 #include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
 #include "include/rvs.h"
 #include "include/rvsactionbase.h"
+#include "include/rvsmetricq.h"
+#include "include/rvsjournal.h"
 #include "yaml-cpp/node/node.h"
 
 
@@ -62,11 +67,27 @@ class exec {
   /* Set Application callback */
   int set_callback(void (*callback)(const rvs_results_t * results, int user_param), int user_param);
 
+  /* Set Application metric callback */
+  int set_metric_callback(rvs_metric_callback callback);
+
   static void action_callback(const action_result_t * result, void * user_param);
+  static void metric_deliver(const rvs_metric_t * recs, unsigned int count,
+                             void * user_param);
 
   void callback(const action_result_t * result);
   void callback(const rvs_results_t * result);
 
+  void cancel(const bool flag = true);
+
+  //! context of a running action passed to its callback
+  typedef struct {
+    exec* pexec;
+    //! metric summary of the action, nullptr if not collected
+    journal::summary* psummary;
+    //! metric summary of the running sweep point, nullptr if not a sweep
+    journal::summary* ppoint;
+  } action_ctx_t;
+
  protected:
   void  do_help(void);
   void  do_version(void);
@@ -74,6 +95,11 @@ class exec {
 
   int   do_yaml(const std::string& config_file);
   int   do_yaml(yaml_data_type_t data_type, const std::string& data);
+  int   do_yaml_action(const YAML::Node& action, std::string* perr,
+                       journal::summary* psummary = nullptr);
+  int   do_yaml_sweep(const YAML::Node& action, if1* pif1,
+                      action_ctx_t* pctx, std::string* perr);
+  int   do_journal(const std::string& config_file);
   int   do_yaml_properties(const YAML::Node& node,
                            const std::string& module_name, if1* pif1);
   bool  is_yaml_properties_collection(const std::string& module_name,
@@ -85,6 +111,18 @@ class exec {
   /* Application Callback */
   void (*app_callback)(const rvs_results_t * results, int user_param);
   int user_param;
+  /* Application metric callback */
+  rvs_metric_callback metric_callback;
+  //! queue of metric values on their way to metric_callback
+  std::unique_ptr<metricqueue> metrics;
+  //! serializes application callbacks from concurrently running actions
+  std::mutex callback_mutex;
+  //! serializes module loading and action object creation/destruction
+  std::mutex module_mutex;
+  //! 'true' when actions of this executor were asked to stop
+  std::atomic<bool> stop_requested;
+  //! checkpoint journal of completed actions (command line runs only)
+  journal checkpoint;
 };
 
 }  // namespace rvs
@@ -25,6 +25,7 @@
 
 #include <include/rvs.h>
 #include <include/rvsexec.h>
+#include <thread>
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,7 +34,7 @@ extern "C" {
 /*! \def RVS_MAX_SESSIONS
  * Maximum session supported in RVS at once.
  */
-#define RVS_MAX_SESSIONS 1
+#define RVS_MAX_SESSIONS 8
 
 /*! \enum rvs_state_t
  * RVS states.
@@ -50,8 +51,12 @@ typedef struct rvs_session_ {
   rvs_session_id_t id;/*!< Unique session id */
   rvs_session_state_t state;/*!< Current session state */
   rvs_session_callback callback;/*!< Session callback */
+  rvs_metric_callback metric_callback;/*!< Session metric callback */
   rvs_session_property_t property;/*!< Session property */
   rvs::exec *executor;/*!< Session executor instance */
+  std::thread *worker;/*!< Thread executing the session */
+  bool running;/*!< Session execution not yet finished */
+  rvs_status_t status;/*!< Status of the last execution */
 } rvs_session_t;
 
 #ifdef __cplusplus
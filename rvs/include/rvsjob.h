@@ -0,0 +1,149 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSJOB_H_
+#define RVS_INCLUDE_RVSJOB_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//! environment variable overriding rvsd socket path
+#define RVSD_SOCKET_ENV   "RVSD_SOCKET"
+//! rvsd socket name within $XDG_RUNTIME_DIR or RVSD_SOCKET_DIR
+#define RVSD_SOCKET_NAME  "rvsd.sock"
+//! private rvsd socket directory if XDG_RUNTIME_DIR is not set, %u is
+//! replaced by user ID
+#define RVSD_SOCKET_DIR   "/tmp/rvsd-%u"
+//! maximum size of a single request message
+#define RVSD_MAX_MSG      65536
+//! size of output chunks streamed back to client
+#define RVSD_OUTPUT_CHUNK 4096
+
+namespace rvs {
+
+class exec;
+
+/**
+ * @class job
+ * @ingroup Launcher
+ *
+ * @brief rvsd job protocol
+ *
+ * Client and rvsd exchange messages over a Unix stream socket. Each
+ * message is a header (type and payload size) followed by the payload.
+ * The client sends its working directory and command line arguments, then
+ * msg_run. The daemon streams console output of the job back in msg_output
+ * messages and ends with msg_status carrying the job return value.
+ * Either side talks only to a peer running under its own user ID.
+ *
+ */
+class job {
+ public:
+  //! message type
+  typedef enum {
+    msg_cwd = 1,
+    msg_arg,
+    msg_run,
+    msg_output,
+    msg_status
+  } msg_t;
+
+  //! message header
+  typedef struct {
+    uint32_t type;
+    uint32_t size;
+  } header_t;
+
+  static std::string socket_path();
+  static bool same_user(int fd);
+  static int send_msg(int fd, msg_t type, const void* data, size_t size);
+  static int recv_msg(int fd, msg_t* ptype, std::string* pdata);
+};
+
+/**
+ * @class jobserver
+ * @ingroup Launcher
+ *
+ * @brief rvsd job server
+ *
+ * Accepts jobs on a Unix socket and runs them one at a time in this
+ * process, so loaded modules and initialized runtimes are reused by
+ * subsequent jobs. Only clients running under the same user ID as the
+ * server are served. If the client disconnects, the running job is asked
+ * to stop.
+ *
+ */
+class jobserver {
+ public:
+  jobserver();
+  virtual ~jobserver();
+
+  int  listen(const std::string& path);
+  int  serve();
+  void stop();
+  //! number of jobs served
+  unsigned int jobs() { return njobs; }
+
+ protected:
+  virtual int  execute(int argc, char** argv);
+  virtual void cancel();
+
+  int  do_job(int fd);
+  void forward(int out_fd, int client_fd);
+
+  //! listening socket
+  int lfd;
+  //! socket path
+  std::string path;
+  //! 'true' when server was asked to stop
+  std::atomic<bool> bstop;
+  //! number of jobs served
+  std::atomic<unsigned int> njobs;
+  //! executor of the running job
+  exec* pexec;
+  //! protects pexec
+  std::mutex mtx;
+};
+
+/**
+ * @class jobclient
+ * @ingroup Launcher
+ *
+ * @brief Runs command line in rvsd
+ *
+ */
+class jobclient {
+ public:
+  static int run(int argc, char** argv, int* pstatus);
+  static int run(const std::string& path, int argc, char** argv,
+                 int out_fd, int* pstatus);
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSJOB_H_
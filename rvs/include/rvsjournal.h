@@ -0,0 +1,114 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSJOURNAL_H_
+#define RVS_INCLUDE_RVSJOURNAL_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+//! default journal file name
+#define RVS_JOURNAL_FILE     "rvs.journal"
+//! journal format identifier written on the first line
+#define RVS_JOURNAL_VERSION  "rvs-journal 1"
+
+namespace rvs {
+
+/**
+ * @class journal
+ * @ingroup Launcher
+ *
+ * @brief Checkpoint journal of completed actions
+ *
+ * One line is appended (and synced to disk) as each action of a
+ * configuration file completes, so an interrupted run can be resumed
+ * skipping actions already done. The first line identifies the
+ * configuration (hash of its contents) and the device set the journal
+ * was written for; a journal is only reused when both match.
+ *
+ */
+class journal {
+ public:
+  /**
+   * @class summary
+   *
+   * @brief Summary of metric values published by one action
+   *
+   */
+  class summary {
+   public:
+    void add(const char* name, const char* unit, double value);
+    std::string str();
+    std::map<std::string, double> averages();
+
+   protected:
+    //! running statistics of one metric
+    typedef struct {
+      std::string unit;
+      uint64_t count;
+      double min;
+      double max;
+      double sum;
+    } stat_t;
+
+    //! statistics per metric name
+    std::map<std::string, stat_t> stats;
+    //! values are added from module worker threads
+    std::mutex mtx;
+  };
+
+  journal();
+  ~journal();
+
+  int  open(const std::string& fname, uint64_t config_hash,
+            const std::string& devices, bool resume);
+  void close();
+  bool is_open() { return pfile != nullptr; }
+
+  bool completed(size_t index, const std::string& name);
+  int  record(size_t index, const std::string& name, int result,
+              const std::string& metrics);
+  //! number of completed actions loaded from an earlier run
+  size_t resumed() { return done.size(); }
+
+  static uint64_t hash(const char* data, size_t size);
+
+ protected:
+  int  load(const std::string& fname, const std::string& header);
+
+  //! journal file
+  FILE* pfile;
+  //! names of successfully completed actions, by action index
+  std::map<size_t, std::string> done;
+  //! serializes records of concurrently completing actions
+  std::mutex mtx;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSJOURNAL_H_
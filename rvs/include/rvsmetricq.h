@@ -0,0 +1,124 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSMETRICQ_H_
+#define RVS_INCLUDE_RVSMETRICQ_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "include/rvs.h"
+
+//! default number of records in metric queue (power of 2)
+#define RVS_METRICQ_SIZE        4096
+//! interval at which queued records are delivered (ms)
+#define RVS_METRICQ_INTERVAL    20
+//! cache line size used to keep producer and consumer indexes apart
+#define RVS_METRICQ_CACHE_LINE  64
+
+namespace rvs {
+
+/**
+ * @class metricqueue
+ * @ingroup Launcher
+ *
+ * @brief Lock-free queue delivering metric records in batches
+ *
+ * Any number of threads post records into a bounded ring of preallocated
+ * slots, claiming a slot with a single atomic operation. One delivery
+ * thread passes runs of ready slots to the delivery callback in place, so
+ * records are neither allocated nor copied once posted. A producer waits
+ * only when the ring is full.
+ *
+ */
+class metricqueue {
+ public:
+  //! delivery callback; records are valid only during the call
+  typedef void (*deliver_t)(const rvs_metric_t* recs, unsigned int count,
+                            void* user_param);
+
+  //! queue statistics
+  typedef struct {
+    //! number of records posted
+    uint64_t posted;
+    //! number of callback invocations
+    uint64_t batches;
+    //! number of times a producer found the ring full
+    uint64_t stalled;
+  } stats_t;
+
+  metricqueue(deliver_t cb, void* user_param,
+              size_t size = RVS_METRICQ_SIZE);
+  ~metricqueue();
+
+  static void* operator new(size_t size);
+  static void  operator delete(void* ptr);
+
+  void  post(const char* name, const char* unit, unsigned int device,
+             double value, uint64_t ts_ns);
+  void  get_stats(stats_t* pstats);
+
+ protected:
+  void    run();
+  size_t  drain_once();
+
+ protected:
+  //! delivery callback
+  deliver_t deliver;
+  //! delivery callback user parameter
+  void* user_param;
+  //! ring size minus one
+  uint64_t mask;
+  //! record slots
+  std::vector<rvs_metric_t> rec;
+  //! per slot sequence number: position + 1 when record is ready
+  std::unique_ptr<std::atomic<uint64_t>[]> seq;
+  //! next position to be claimed by a producer
+  alignas(RVS_METRICQ_CACHE_LINE) std::atomic<uint64_t> tail;
+  //! next position to be delivered (written by delivery thread only)
+  alignas(RVS_METRICQ_CACHE_LINE) std::atomic<uint64_t> head;
+  //! delivery thread
+  std::thread deliverer;
+  //! protects bquit and serializes wakeups
+  std::mutex mtx;
+  //! wakes delivery thread
+  std::condition_variable cv;
+  //! 'true' when delivery thread is requested to exit
+  bool bquit;
+
+  //! statistics
+  std::atomic<uint64_t> st_posted;
+  std::atomic<uint64_t> st_batches;
+  std::atomic<uint64_t> st_stalled;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSMETRICQ_H_
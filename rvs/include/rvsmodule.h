@@ -29,6 +29,7 @@
 #include <utility>
 #include <string>
 #include <memory>
+#include <mutex>
 
 #include "yaml-cpp/yaml.h"
 
@@ -71,6 +72,12 @@ typedef std::pair<std::string, module*> t_mmpair;
   //! short name -> .so filename mapping
   static std::map<std::string, std::string> filemap;
 
+  //! protects module collection against concurrent sessions
+  static std::mutex mtx;
+
+  //! number of initialize() calls not yet matched by terminate()
+  static int users;
+
  protected:
   module(const char* pModuleName, void* pSoLib);
   //! Destructor
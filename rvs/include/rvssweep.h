@@ -0,0 +1,97 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSSWEEP_H_
+#define RVS_INCLUDE_RVSSWEEP_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/node/node.h"
+
+//! maximum number of points a sweep may expand to
+#define RVS_SWEEP_MAX_POINTS  4096
+
+namespace rvs {
+
+/**
+ * @class sweep
+ * @ingroup Launcher
+ *
+ * @brief Parameter sweep of a single action
+ *
+ * Expands the "sweep" key of an action into a list of points. Each entry
+ * of the key maps property names to a list of values or to a numeric range
+ * (start, stop and either step or factor). Several properties separated by
+ * commas take the same value. Points are the cartesian product of all
+ * entries, the first entry varying slowest:
+ *
+ *     sweep:
+ *       matrix_size_a,matrix_size_b,matrix_size_c: [4864, 8640]
+ *       ops_type: [sgemm, dgemm]
+ *       block_size: {start: 4096, stop: 1048576, factor: 4}
+ *
+ * Results of the points are collected into a single table keyed by the
+ * swept properties.
+ *
+ */
+class sweep {
+ public:
+  //! property values of a single point
+  typedef std::map<std::string, std::string> point_t;
+
+  int parse(const YAML::Node& node, std::string* perr);
+
+  //! number of points
+  size_t size() { return pts.size(); }
+  //! property values of the given point
+  const point_t& point(size_t i) { return pts[i]; }
+  //! swept properties, in declaration order
+  const std::vector<std::string>& properties() { return props; }
+  std::map<std::string, std::string> max();
+
+  void add_result(size_t i, int sts,
+                  const std::map<std::string, double>& metrics);
+  std::vector<std::string> table();
+
+ protected:
+  int  parse_values(const std::string& key, const YAML::Node& node,
+                    std::vector<std::string>* pvalues, std::string* perr);
+
+  //! swept properties
+  std::vector<std::string> props;
+  //! expanded points
+  std::vector<point_t> pts;
+  //! result of each point run so far (0 - success)
+  std::map<size_t, int> results;
+  //! metric averages of each point run so far
+  std::map<size_t, std::map<std::string, double>> metrics;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSSWEEP_H_
@@ -33,15 +33,68 @@
  * so that modules can print on screen of in the log file.
  */
 
+#include <signal.h>
+#include <unistd.h>
+
 #include <iostream>
+#include <thread>
 
 #include "include/rvscli.h"
 #include "include/rvsexec.h"
+#include "include/rvsjob.h"
+#include "include/rvsoptions.h"
 #include "include/rvsliblogger.h"
 #include "include/rvstrace.h"
 
 #define MODULE_NAME_CAPS "CLI"
 
+//! self-pipe written to by the signal handler and read by signal watcher
+static int sigpipe[2] = {-1, -1};
+
+//! Forwards SIGINT/SIGTERM to signal watcher thread
+static void on_signal(int sig) {
+  // second signal terminates the process the default way
+  signal(sig, SIG_DFL);
+
+  unsigned char b = static_cast<unsigned char>(sig);
+  if (write(sigpipe[1], &b, 1) < 0) {
+    return;
+  }
+}
+
+/**
+ * @brief Installs SIGINT/SIGTERM handling for local runs
+ *
+ * On signal, running actions are asked to stop through rvs::logger so that
+ * workers sleeping in rvs::lp::WaitStop() return at once, results logged so
+ * far are flushed and the log file is properly terminated on the way out.
+ * A second signal kills the process.
+ *
+ */
+static void watch_signals() {
+  if (pipe(sigpipe)) {
+    return;
+  }
+
+  std::thread([]() {
+    unsigned char b;
+    if (read(sigpipe[0], &b, 1) != 1) {
+      return;
+    }
+
+    char buff[128];
+    snprintf(buff, sizeof(buff), "interrupted by signal %d, stopping",
+             static_cast<int>(b));
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+
+    rvs::logger::Interrupt();
+    rvs::logger::flush();
+  }).detach();
+
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+}
+
 /**
  *
  * @ingroup Launcher
@@ -71,8 +124,14 @@ int main(int Argc, char**Argv) {
 #endif
   }
 
-  rvs::exec executor;
-  sts = executor.run();
+  // hand the job over to rvsd if it is running, run it here otherwise
+  if (rvs::options::has_option("--noDaemon") ||
+      rvs::options::has_option("-h") || rvs::options::has_option("-ver") ||
+      rvs::jobclient::run(Argc, Argv, &sts)) {
+    watch_signals();
+    rvs::exec executor;
+    sts = executor.run();
+  }
 
 #ifdef RVS_INVERT_RETURN_STATUS
   DTRACE_
@@ -29,6 +29,9 @@
 #include <include/rvsexec.h>
 #include <map>
 #include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +42,11 @@ extern "C" {
 */
 std::mutex rvs_mutex;
 
+/*! \var std::condition_variable rvs_cv
+    \brief Signalled (with rvs_mutex) when a session completes execution
+*/
+std::condition_variable rvs_cv;
+
 /*! \var rvs_state_t rvs_state
     \brief RVS current state
 */
@@ -52,6 +60,9 @@ rvs_session_t rvs_session[RVS_MAX_SESSIONS];
 rvs_status_t rvs_get_session_instance(unsigned int *session_idx);
 rvs_status_t rvs_validate_session(rvs_session_id_t session_id, unsigned int *session_idx);
 void rvs_callback(const rvs_results_t * results, int user_param);
+void rvs_session_worker(unsigned int session_idx, rvs::exec *executor,
+    std::map<std::string, std::string> opt);
+void rvs_session_join(unsigned int session_idx);
 
 /**
  * Initialize RVS(ROCm Validation Suite) component. 
@@ -143,6 +154,10 @@ rvs_status_t rvs_session_set_property(rvs_session_id_t session_id, rvs_session_p
         return RVS_STATUS_INVALID_SESSION_STATE;
       }
 
+      if(rvs_session[session_idx].running) {
+        return RVS_STATUS_INVALID_SESSION_STATE;
+      }
+
       rvs_session[session_idx].state = RVS_SESSION_STATE_READY;
 
       memset(&(rvs_session[session_idx].property), 0, sizeof(rvs_session_property_t));
@@ -157,6 +172,36 @@ rvs_status_t rvs_session_set_property(rvs_session_id_t session_id, rvs_session_p
   return RVS_STATUS_SUCCESS;
 }
 
+/**
+ * Set callback receiving metric values produced while session runs.
+ * @param[in] session_id - Session identifier
+ * @param[in] metric_cb - Metric callback function handler, NULL to disable
+ * @return RVS_STATUS_SUCCESS - Successfully set callback
+ * @return RVS_STATUS_INVALID_SESSION_STATE - Session is running
+ */
+rvs_status_t rvs_session_set_metric_callback(rvs_session_id_t session_id, rvs_metric_callback metric_cb) {
+
+  unsigned int session_idx;
+
+  std::lock_guard<std::mutex> rvs_lg(rvs_mutex);
+
+  if (RVS_STATE_INITIALIZED != rvs_state) {
+    return RVS_STATUS_INVALID_STATE;
+  }
+
+  if (RVS_STATUS_SUCCESS != rvs_validate_session(session_id, &session_idx)) {
+    return RVS_STATUS_INVALID_SESSION;
+  }
+
+  if(rvs_session[session_idx].running) {
+    return RVS_STATUS_INVALID_SESSION_STATE;
+  }
+
+  rvs_session[session_idx].metric_callback = metric_cb;
+
+  return RVS_STATUS_SUCCESS;
+}
+
 /**
  * Execute session test routine based on property set in RVS.
  * @param[in] session_id - Session identifier 
@@ -165,6 +210,24 @@ rvs_status_t rvs_session_set_property(rvs_session_id_t session_id, rvs_session_p
  */
 rvs_status_t rvs_session_execute(rvs_session_id_t session_id) {
 
+  rvs_status_t status = rvs_session_execute_async(session_id);
+
+  if (RVS_STATUS_SUCCESS != status) {
+    return status;
+  }
+
+  return rvs_session_wait(session_id, -1);
+}
+
+/**
+ * Start session test routine based on property set in RVS and return
+ * immediately.
+ * @param[in] session_id - Session identifier
+ * @return RVS_STATUS_SUCCESS - Successfully started session
+ * @return RVS_STATUS_FAILED - Failed to start session
+ */
+rvs_status_t rvs_session_execute_async(rvs_session_id_t session_id) {
+
   unsigned int session_idx;
   std::map<std::string, std::string> opt;
 
@@ -178,7 +241,8 @@ rvs_status_t rvs_session_execute(rvs_session_id_t session_id) {
     return RVS_STATUS_INVALID_SESSION;
   }
 
-  if(RVS_SESSION_STATE_READY != rvs_session[session_idx].state) {
+  if((RVS_SESSION_STATE_READY != rvs_session[session_idx].state) ||
+      rvs_session[session_idx].running) {
     return RVS_STATUS_INVALID_SESSION_STATE;
   }
 
@@ -236,13 +300,125 @@ rvs_status_t rvs_session_execute(rvs_session_id_t session_id) {
   }
 
   rvs_session[session_idx].executor->set_callback(rvs_callback, (int)session_id);
-  if(rvs_session[session_idx].executor->run(opt)) {
-    return RVS_STATUS_FAILED;
+  rvs_session[session_idx].executor->set_metric_callback(
+      rvs_session[session_idx].metric_callback);
+  rvs_session[session_idx].executor->cancel(false);
+
+  // previous execution of this session has already finished
+  rvs_session_join(session_idx);
+
+  rvs_session[session_idx].running = true;
+  rvs_session[session_idx].status = RVS_STATUS_FAILED;
+  rvs_session[session_idx].worker = new std::thread(rvs_session_worker,
+      session_idx, rvs_session[session_idx].executor, opt);
+
+  return RVS_STATUS_SUCCESS;
+}
+
+/**
+ * Wait for session started by rvs_session_execute_async() to complete.
+ * @param[in] session_id - Session identifier
+ * @param[in] timeout_ms - Maximum wait time in milliseconds, negative to
+ * wait indefinitely
+ * @return RVS_STATUS_SUCCESS - Session completed successfully
+ * @return RVS_STATUS_FAILED - Session completed with failure
+ * @return RVS_STATUS_TIMEOUT - Session still running after timeout_ms
+ */
+rvs_status_t rvs_session_wait(rvs_session_id_t session_id, int timeout_ms) {
+
+  unsigned int session_idx;
+
+  std::unique_lock<std::mutex> rvs_lk(rvs_mutex);
+
+  if (RVS_STATE_INITIALIZED != rvs_state) {
+    return RVS_STATUS_INVALID_STATE;
+  }
+
+  if (RVS_STATUS_SUCCESS != rvs_validate_session(session_id, &session_idx)) {
+    return RVS_STATUS_INVALID_SESSION;
+  }
+
+  if((!rvs_session[session_idx].running) &&
+      (RVS_SESSION_STATE_COMPLETED != rvs_session[session_idx].state)) {
+    return RVS_STATUS_INVALID_SESSION_STATE;
+  }
+
+  auto completed = [session_idx] {
+    return !rvs_session[session_idx].running;
+  };
+
+  if (timeout_ms < 0) {
+    rvs_cv.wait(rvs_lk, completed);
+  } else if (!rvs_cv.wait_for(rvs_lk, std::chrono::milliseconds(timeout_ms),
+                              completed)) {
+    return RVS_STATUS_TIMEOUT;
+  }
+
+  rvs_session_join(session_idx);
+
+  return rvs_session[session_idx].status;
+}
+
+/**
+ * Ask running session to stop.
+ * @param[in] session_id - Session identifier
+ * @return RVS_STATUS_SUCCESS - Stop requested
+ * @return RVS_STATUS_INVALID_SESSION_STATE - Session is not running
+ */
+rvs_status_t rvs_session_cancel(rvs_session_id_t session_id) {
+
+  unsigned int session_idx;
+
+  std::lock_guard<std::mutex> rvs_lg(rvs_mutex);
+
+  if (RVS_STATE_INITIALIZED != rvs_state) {
+    return RVS_STATUS_INVALID_STATE;
+  }
+
+  if (RVS_STATUS_SUCCESS != rvs_validate_session(session_id, &session_idx)) {
+    return RVS_STATUS_INVALID_SESSION;
+  }
+
+  if(!rvs_session[session_idx].running) {
+    return RVS_STATUS_INVALID_SESSION_STATE;
+  }
+
+  rvs_session[session_idx].executor->cancel();
+
+  return RVS_STATUS_SUCCESS;
+}
+
+/**
+ * Query current session state.
+ * @param[in] session_id - Session identifier
+ * @param[out] state - Current session state
+ * @return RVS_STATUS_SUCCESS - State returned
+ * @return RVS_STATUS_INVALID_SESSION - Invalid session
+ */
+rvs_status_t rvs_session_get_state(rvs_session_id_t session_id, rvs_session_state_t *state) {
+
+  unsigned int session_idx;
+
+  if (NULL == state) {
+    return RVS_STATUS_INVALID_ARGUMENT;
+  }
+
+  std::lock_guard<std::mutex> rvs_lg(rvs_mutex);
+
+  if (RVS_STATE_INITIALIZED != rvs_state) {
+    return RVS_STATUS_INVALID_STATE;
   }
 
+  if (RVS_STATUS_SUCCESS != rvs_validate_session(session_id, &session_idx)) {
+    return RVS_STATUS_INVALID_SESSION;
+  }
+
+  *state = rvs_session[session_idx].state;
+
   return RVS_STATUS_SUCCESS;
 }
 
+
 /**
  * Destroy/Free session after completion of test routine.
  * @param[in] session_id - Session identifier
@@ -263,13 +439,17 @@ rvs_status_t rvs_session_destroy(rvs_session_id_t session_id){
     return RVS_STATUS_INVALID_SESSION;
   }
 
-  if(RVS_SESSION_STATE_INPROGRESS == rvs_session[session_idx].state) {
+  if((RVS_SESSION_STATE_INPROGRESS == rvs_session[session_idx].state) ||
+      rvs_session[session_idx].running) {
     return RVS_STATUS_INVALID_SESSION_STATE;
   }
 
+  rvs_session_join(session_idx);
+
   rvs_session[session_idx].id = 0;
   rvs_session[session_idx].state = RVS_SESSION_STATE_IDLE;
   rvs_session[session_idx].callback = nullptr;
+  rvs_session[session_idx].metric_callback = nullptr;
   delete rvs_session[session_idx].executor;
   rvs_session[session_idx].executor = nullptr;
   memset(&(rvs_session[session_idx].property), 0, sizeof(rvs_session_property_t));
@@ -290,6 +470,17 @@ rvs_status_t rvs_terminate(void) {
   if (RVS_STATE_INITIALIZED != rvs_state) {
     return RVS_STATUS_INVALID_STATE;
   }
+
+  for (unsigned int i = 0; i < RVS_MAX_SESSIONS; i++) {
+    if (rvs_session[i].running) {
+      return RVS_STATUS_INVALID_SESSION_STATE;
+    }
+  }
+
+  for (unsigned int i = 0; i < RVS_MAX_SESSIONS; i++) {
+    rvs_session_join(i);
+  }
+
   rvs_state = RVS_STATE_UNINITIALIZED;
 
   return RVS_STATUS_SUCCESS;
@@ -328,13 +519,59 @@ rvs_status_t rvs_validate_session(rvs_session_id_t session_id, unsigned int *ses
 void rvs_callback(const rvs_results_t * results, int user_param) {
 
   unsigned int session_idx = 0;
+  rvs_session_callback session_cb;
+
+  {
+    std::lock_guard<std::mutex> rvs_lg(rvs_mutex);
+
+    if (RVS_STATUS_SUCCESS != rvs_validate_session((rvs_session_id_t)user_param, &session_idx)) {
+      return;
+    }
+
+    rvs_session[session_idx].state = results->state;
+    session_cb = rvs_session[session_idx].callback;
+  }
+
+  // called without rvs_mutex so that application may query the session
+  session_cb((rvs_session_id_t)user_param, results);
+}
+
+/**
+ * Session worker thread function: runs session executor and signals
+ * completion to rvs_session_wait().
+ * @param[in] session_idx - Session index
+ * @param[in] executor - Session executor
+ * @param[in] opt - Executor options
+ */
+void rvs_session_worker(unsigned int session_idx, rvs::exec *executor,
+    std::map<std::string, std::string> opt) {
+
+  int sts = executor->run(opt);
+
+  std::lock_guard<std::mutex> rvs_lg(rvs_mutex);
+
+  rvs_session[session_idx].status = sts ? RVS_STATUS_FAILED : RVS_STATUS_SUCCESS;
+  rvs_session[session_idx].state = RVS_SESSION_STATE_COMPLETED;
+  rvs_session[session_idx].running = false;
+  rvs_cv.notify_all();
+}
+
+/**
+ * Join worker thread of a finished session, if any. Called with rvs_mutex
+ * held; worker no longer needs the mutex once running is cleared.
+ * @param[in] session_idx - Session index
+ */
+void rvs_session_join(unsigned int session_idx) {
+
+  std::thread *worker = rvs_session[session_idx].worker;
 
-  if (RVS_STATUS_SUCCESS != rvs_validate_session((rvs_session_id_t)user_param, &session_idx)) {
+  if (nullptr == worker) {
     return;
   }
 
-  rvs_session[session_idx].state = results->state;
-  rvs_session[session_idx].callback((rvs_session_id_t)user_param, results);
+  rvs_session[session_idx].worker = nullptr;
+  worker->join();
+  delete worker;
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,205 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+/**
+ * @ingroup Launcher
+ *
+ * @brief rvs-logdump utility
+ *
+ * Converts binary metrics file written by RVS (--metricsFile option) to
+ * CSV or JSON, optionally keeping only samples of given metrics and
+ * devices.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "include/rvsmetriclog.h"
+
+//! Prints usage information
+static void usage() {
+  printf("Usage: rvs-logdump [options] <metrics file>\n\n");
+  printf("Options:\n\n");
+  printf("-f <format>   Output format: csv (default) or json.\n");
+  printf("-m <metrics>  Comma separated list of metric names or ids to "
+         "output.\n");
+  printf("              Known metrics: ");
+  for (int i = rvs::metric_none + 1; i < rvs::metric_max; i++) {
+    printf("%s%s", rvs::metriclog::metric_name(i),
+           i + 1 < rvs::metric_max ? ", " : "\n");
+  }
+  printf("-d <devices>  Comma separated list of device (GPU) ids to "
+         "output.\n");
+  printf("-h            Display usage information and exit.\n");
+}
+
+/**
+ * @brief Parse comma separated list of ids
+ *
+ * @param list comma separated list
+ * @param bmetric 'true' if list items are metric names
+ * @param pset [out] ids
+ * @return 0 - success, non-zero if list contains invalid item
+ *
+ */
+static int parse_list(const char* list, bool bmetric,
+                      std::set<uint16_t>* pset) {
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty()) {
+      continue;
+    }
+    // devices are given by id only
+    int id = -1;
+    if (bmetric || item.find_first_not_of("0123456789") == std::string::npos) {
+      id = rvs::metriclog::metric_id(item);
+    }
+    if (id < 0) {
+      fprintf(stderr, "rvs-logdump: invalid %s: %s\n",
+              bmetric ? "metric" : "device", item.c_str());
+      return -1;
+    }
+    pset->insert(id);
+  }
+  return 0;
+}
+
+/**
+ * @brief Output metric name or id
+ *
+ */
+static void print_metric(uint16_t metric, bool bquote) {
+  const char* name = rvs::metriclog::metric_name(metric);
+  if (name) {
+    printf(bquote ? "\"%s\"" : "%s", name);
+  } else {
+    printf("%u", metric);
+  }
+}
+
+/**
+ *
+ * @brief Main method
+ *
+ * @param Argc standard C argc parameter to main()
+ * @param Argv standard C argv parameter to main()
+ * @return 0 - all OK, non-zero error
+ *
+ * */
+int main(int Argc, char** Argv) {
+  bool bjson = false;
+  std::set<uint16_t> metrics;
+  std::set<uint16_t> devices;
+  int opt;
+
+  while ((opt = getopt(Argc, Argv, "f:m:d:h")) != -1) {
+    switch (opt) {
+    case 'f':
+      if (std::string(optarg) == "json") {
+        bjson = true;
+      } else if (std::string(optarg) != "csv") {
+        fprintf(stderr, "rvs-logdump: unknown format: %s\n", optarg);
+        return 1;
+      }
+      break;
+    case 'm':
+      if (parse_list(optarg, true, &metrics)) {
+        return 1;
+      }
+      break;
+    case 'd':
+      if (parse_list(optarg, false, &devices)) {
+        return 1;
+      }
+      break;
+    case 'h':
+      usage();
+      return 0;
+    default:
+      usage();
+      return 1;
+    }
+  }
+
+  if (optind != Argc - 1) {
+    usage();
+    return 1;
+  }
+
+  rvs::metricreader reader;
+  if (reader.open(Argv[optind])) {
+    fprintf(stderr, "rvs-logdump: not a metrics file: %s\n", Argv[optind]);
+    return 1;
+  }
+
+  if (bjson) {
+    printf("[");
+  } else {
+    printf("time,metric,device,value\n");
+  }
+
+  const rvs::metric_record_t* r = reader.records();
+  bool bfirst = true;
+  char value[32];
+  for (size_t i = 0; i < reader.count(); i++, r++) {
+    if (!metrics.empty() && !metrics.count(r->metric)) {
+      continue;
+    }
+    if (!devices.empty() && !devices.count(r->device)) {
+      continue;
+    }
+
+    uint64_t t = reader.start_ns() + r->time_ns;
+    if (std::isfinite(r->value)) {
+      snprintf(value, sizeof(value), "%.7g", r->value);
+    } else {
+      snprintf(value, sizeof(value), "%s", bjson ? "null" : "nan");
+    }
+    if (bjson) {
+      printf("%s\n  {\"time\":%" PRIu64 ".%09" PRIu64 ",\"metric\":",
+             bfirst ? "" : ",", t / 1000000000, t % 1000000000);
+      print_metric(r->metric, true);
+      printf(",\"device\":%u,\"value\":%s}", r->device, value);
+    } else {
+      printf("%" PRIu64 ".%09" PRIu64 ",", t / 1000000000, t % 1000000000);
+      print_metric(r->metric, false);
+      printf(",%u,%s\n", r->device, value);
+    }
+    bfirst = false;
+  }
+
+  if (bjson) {
+    printf("\n]\n");
+  }
+
+  return 0;
+}
@@ -158,10 +158,40 @@ void rvs::cli::init_grammar() {
   grammar.insert(gpair("-j", sp));
   grammar.insert(gpair("--json", sp));
 
+  sp = std::make_shared<optbase>("--ndjson", command, value);
+  grammar.insert(gpair("--ndjson", sp));
+
+  sp = std::make_shared<optbase>("--metricsFile", command, value);
+  grammar.insert(gpair("--metricsFile", sp));
+
   sp = std::make_shared<optbase>("-l", command, value);
   grammar.insert(gpair("-l", sp));
   grammar.insert(gpair("--debugLogFile", sp));
 
+  sp = std::make_shared<optbase>("--logMaxSize", command, value);
+  grammar.insert(gpair("--logMaxSize", sp));
+
+  sp = std::make_shared<optbase>("--logMaxAge", command, value);
+  grammar.insert(gpair("--logMaxAge", sp));
+
+  sp = std::make_shared<optbase>("--logGenerations", command, value);
+  grammar.insert(gpair("--logGenerations", sp));
+
+  sp = std::make_shared<optbase>("--parallel", command, value);
+  grammar.insert(gpair("--parallel", sp));
+
+  sp = std::make_shared<optbase>("--stopOnFailure", command);
+  grammar.insert(gpair("--stopOnFailure", sp));
+
+  sp = std::make_shared<optbase>("--journal", command, value);
+  grammar.insert(gpair("--journal", sp));
+
+  sp = std::make_shared<optbase>("--resume", command);
+  grammar.insert(gpair("--resume", sp));
+
+  sp = std::make_shared<optbase>("--noDaemon", command);
+  grammar.insert(gpair("--noDaemon", sp));
+
   sp = std::make_shared<optbase>("-q", command);
   grammar.insert(gpair("-q", sp));
   grammar.insert(gpair("--quiet", sp));
@@ -209,6 +239,8 @@ void rvs::cli::init_grammar() {
 int rvs::cli::parse(int Argc, char** Argv) {
   init_grammar();
 
+  // options of a previous command line (rvsd job) do not carry over
+  options::opt.clear();
   extract_path();
 
   argc = Argc;
@@ -0,0 +1,143 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+/**
+ * @ingroup Launcher
+ *
+ * @brief rvsd resident daemon
+ *
+ * Keeps RVS modules loaded and initialized and runs jobs submitted by
+ * rvs over a Unix socket, so that short periodic checks do not pay for
+ * module loading and runtime initialization on every invocation.
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+#include "include/rvscli.h"
+#include "include/rvsjob.h"
+#include "include/rvsliblogger.h"
+#include "include/rvsmodule.h"
+#include "include/rvsoptions.h"
+
+#define MODULE_NAME_CAPS "RVSD"
+
+//! server asked to stop on SIGINT/SIGTERM
+static rvs::jobserver* pserver = nullptr;
+
+//! Prints usage information
+static void usage() {
+  printf("Usage: rvsd [options]\n\n");
+  printf("Runs jobs submitted by rvs in this process, keeping modules "
+         "loaded between jobs.\n");
+  printf("rvs uses rvsd automatically while it is running (see rvs "
+         "--noDaemon).\n\n");
+  printf("Options:\n\n");
+  printf("-s <socket>   Socket to listen on. The default is $%s, or %s\n",
+         RVSD_SOCKET_ENV, RVSD_SOCKET_NAME);
+  printf("              in $XDG_RUNTIME_DIR or else in %s (%%u - user id).\n",
+         RVSD_SOCKET_DIR);
+  printf("-h            Display usage information and exit.\n");
+}
+
+//! Stops server
+static void on_signal(int) {
+  if (pserver) {
+    pserver->stop();
+  }
+}
+
+/**
+ *
+ * @ingroup Launcher
+ * @brief Main method
+ *
+ * @param Argc standard C argc parameter to main()
+ * @param Argv standard C argv parameter to main()
+ * @return 0 - all OK, non-zero error
+ *
+ * */
+int main(int Argc, char** Argv) {
+  std::string sock = rvs::job::socket_path();
+  int opt;
+
+  while ((opt = getopt(Argc, Argv, "s:h")) != -1) {
+    switch (opt) {
+      case 's':
+        sock = optarg;
+        break;
+      case 'h':
+        usage();
+        return 0;
+      default:
+        usage();
+        return -1;
+    }
+  }
+
+  // locate executable ("pwd" option)
+  rvs::cli cli;
+  cli.parse(1, Argv);
+  std::string path;
+  rvs::options::has_option("pwd", &path);
+
+  // modules stay loaded while this reference is held
+  std::string val = path +
+                    "../share/rocm-validation-suite/conf/.rvsmodules.config";
+  std::ifstream conf_file(val);
+  if (!conf_file.good()) {
+    val = path + ".rvsmodules.config";
+  }
+  conf_file.close();
+  if (rvs::module::initialize(val.c_str())) {
+    return 1;
+  }
+
+  rvs::jobserver server;
+  if (server.listen(sock)) {
+    rvs::module::terminate();
+    return 1;
+  }
+
+  pserver = &server;
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+  signal(SIGPIPE, SIG_IGN);
+
+  printf("rvsd: serving jobs on %s\n", sock.c_str());
+  fflush(stdout);
+
+  int sts = server.serve();
+
+  printf("rvsd: %u job(s) served\n", server.jobs());
+  pserver = nullptr;
+  rvs::module::terminate();
+  rvs::logger::terminate();
+
+  return sts;
+}
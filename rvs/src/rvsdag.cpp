@@ -0,0 +1,260 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsdag.h"
+
+#include <stdio.h>
+
+#include <map>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+/**
+ * @brief Add action to graph
+ *
+ * @param name action name
+ * @param group parallel group name, empty if none
+ * @param depends_on names of actions (or parallel groups) this action waits
+ * for; if empty, action waits for the previous stage
+ * @return index of the action
+ *
+ */
+size_t rvs::actiondag::add(const std::string& name, const std::string& group,
+                           const std::vector<std::string>& depends_on) {
+  node_t node;
+  node.name = name;
+  node.group = group;
+  node.depends_on = depends_on;
+  node.waiting = 0;
+  node.state = state_pending;
+  nodes.push_back(node);
+
+  return nodes.size() - 1;
+}
+
+/**
+ * @brief Resolve dependencies and check the graph is acyclic
+ *
+ * @param perr [out] error description if graph is not valid
+ * @return 0 - OK, non-zero if a dependency is unknown or ambiguous or
+ * if dependencies form a cycle
+ *
+ */
+int rvs::actiondag::build(std::string* perr) {
+  char buff[1024];
+  std::map<std::string, std::vector<size_t>> byname;
+  std::map<std::string, std::vector<size_t>> bygroup;
+
+  for (size_t i = 0; i < nodes.size(); i++) {
+    byname[nodes[i].name].push_back(i);
+    if (!nodes[i].group.empty()) {
+      bygroup[nodes[i].group].push_back(i);
+    }
+    nodes[i].preds.clear();
+    nodes[i].succs.clear();
+  }
+
+  std::vector<size_t> prev_stage;
+  std::vector<size_t> cur_stage;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    node_t& node = nodes[i];
+
+    // consecutive actions of the same group form one stage
+    if (node.group.empty() || i == 0 || node.group != nodes[i-1].group) {
+      prev_stage = cur_stage;
+      cur_stage.clear();
+    }
+    cur_stage.push_back(i);
+
+    std::set<size_t> preds;
+    if (node.depends_on.empty()) {
+      preds.insert(prev_stage.begin(), prev_stage.end());
+    }
+
+    for (const std::string& dep : node.depends_on) {
+      auto it = byname.find(dep);
+      if (it != byname.end()) {
+        if (it->second.size() > 1) {
+          snprintf(buff, sizeof(buff),
+                   "action '%s' depends on ambiguous action name '%s'",
+                   node.name.c_str(), dep.c_str());
+          *perr = buff;
+          return -1;
+        }
+        preds.insert(it->second[0]);
+        continue;
+      }
+      it = bygroup.find(dep);
+      if (it != bygroup.end()) {
+        preds.insert(it->second.begin(), it->second.end());
+        continue;
+      }
+      snprintf(buff, sizeof(buff),
+               "action '%s' depends on unknown action '%s'",
+               node.name.c_str(), dep.c_str());
+      *perr = buff;
+      return -1;
+    }
+
+    for (size_t p : preds) {
+      node.preds.push_back(p);
+      nodes[p].succs.push_back(i);
+    }
+  }
+
+  // topological sort to detect cycles
+  std::vector<size_t> waiting(nodes.size());
+  std::deque<size_t> ready;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    waiting[i] = nodes[i].preds.size();
+    if (waiting[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+  size_t sorted = 0;
+  while (!ready.empty()) {
+    size_t i = ready.front();
+    ready.pop_front();
+    sorted++;
+    for (size_t s : nodes[i].succs) {
+      if (--waiting[s] == 0) {
+        ready.push_back(s);
+      }
+    }
+  }
+  if (sorted != nodes.size()) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+      if (waiting[i]) {
+        snprintf(buff, sizeof(buff),
+                 "dependency cycle involving action '%s'",
+                 nodes[i].name.c_str());
+        *perr = buff;
+        break;
+      }
+    }
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Execute actions in dependency order
+ *
+ * Actions whose predecessors completed successfully are executed on a pool
+ * of worker threads. Once an action fails no further actions are started;
+ * actions already running are left to complete and the ones not started
+ * are marked cancelled.
+ *
+ * @param max_parallel maximum number of concurrently running actions,
+ * 0 for no limit
+ * @param run_action function executing an action
+ * @param done function called on action completion, before any of its
+ * successors is started
+ * @return 0 - all actions succeeded, otherwise status of the first failed action
+ *
+ */
+int rvs::actiondag::run(unsigned int max_parallel, run_t run_action,
+                        done_t done) {
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::deque<size_t> ready;
+  size_t running = 0;
+  int sts = 0;
+
+  for (size_t i = 0; i < nodes.size(); i++) {
+    nodes[i].waiting = nodes[i].preds.size();
+    nodes[i].state = state_pending;
+    if (nodes[i].waiting == 0) {
+      ready.push_back(i);
+    }
+  }
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lk(mtx);
+    for (;;) {
+      // nothing ready and nothing running means nothing more to do
+      cv.wait(lk, [&]{ return !ready.empty() || running == 0; });
+      if (ready.empty()) {
+        break;
+      }
+
+      size_t i = ready.front();
+      ready.pop_front();
+      nodes[i].state = state_running;
+      running++;
+      lk.unlock();
+
+      int action_sts = run_action(i);
+      done(i, action_sts);
+
+      lk.lock();
+      running--;
+      if (action_sts) {
+        nodes[i].state = state_failed;
+        if (!sts) {
+          sts = action_sts;
+        }
+        for (size_t r : ready) {
+          nodes[r].state = state_cancelled;
+        }
+        ready.clear();
+      } else {
+        nodes[i].state = state_done;
+        if (!sts) {
+          for (size_t s : nodes[i].succs) {
+            if (--nodes[s].waiting == 0) {
+              ready.push_back(s);
+            }
+          }
+        }
+      }
+      cv.notify_all();
+    }
+  };
+
+  size_t nworkers = nodes.size();
+  if (max_parallel && max_parallel < nworkers) {
+    nworkers = max_parallel;
+  }
+
+  std::vector<std::thread> workers;
+  for (size_t w = 0; w < nworkers; w++) {
+    workers.push_back(std::thread(worker));
+  }
+  for (auto& t : workers) {
+    t.join();
+  }
+
+  for (auto& node : nodes) {
+    if (node.state == state_pending) {
+      node.state = state_cancelled;
+    }
+  }
+
+  return sts;
+}
@@ -29,6 +29,9 @@
 #include <memory>
 #include <string>
 #include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <vector>
 #include "yaml-cpp/yaml.h"
 
 #include "include/rvsif0.h"
@@ -36,8 +39,10 @@
 #include "include/rvsaction.h"
 #include "include/rvsmodule.h"
 #include "include/rvsliblogger.h"
+#include "include/rvsmetriclog.h"
 #include "include/rvsoptions.h"
 #include "include/rvstrace.h"
+#include "include/gpu_util.h"
 
 #define MODULE_NAME_CAPS "CLI"
 
@@ -45,8 +50,44 @@ using std::string;
 using std::cout;
 using std::endl;
 
+//! default number of rotated log files kept
+#define RVS_LOG_GENERATIONS 5
+
+/**
+ * @brief Fetch non-negative integer value of a log rotation option
+ *
+ * @param opt option name
+ * @param pval [out] option value, unchanged if option is not given
+ * @return 0 - OK (or option not given), non-zero if value is not valid
+ *
+ */
+static int log_rotation_option(const char* opt, unsigned int* pval) {
+  string val;
+  if (!rvs::options::has_option(opt, &val)) {
+    return 0;
+  }
+
+  int ival = -1;
+  try {
+    ival = std::stoi(val);
+  }
+  catch(...) {
+  }
+  if (ival < 0) {
+    char buff[1024];
+    snprintf(buff, sizeof(buff),
+              "%s value not a non-negative integer: %s", opt, val.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  *pval = ival;
+  return 0;
+}
+
 //! Default constructor
-rvs::exec::exec():app_callback(nullptr), user_param(0) {
+rvs::exec::exec():app_callback(nullptr), user_param(0),
+                  metric_callback(nullptr), stop_requested(false) {
 }
 
 //! Default destructor
@@ -113,17 +154,58 @@ int rvs::exec::run() {
     logger::append(true);
   }
 
+  // resumed run continues the logs of the interrupted one
+  if (rvs::options::has_option("--resume")) {
+    logger::append(true);
+  }
+
   // check -l option
   std::string s_log_file;
   if (rvs::options::has_option("-l", &s_log_file)) {
     logger::set_log_file(s_log_file);
   }
 
+  // check log rotation options
+  unsigned int max_size = 0;
+  unsigned int max_age = 0;
+  unsigned int generations = RVS_LOG_GENERATIONS;
+  if (log_rotation_option("--logMaxSize", &max_size) ||
+      log_rotation_option("--logMaxAge", &max_age) ||
+      log_rotation_option("--logGenerations", &generations)) {
+    return -1;
+  }
+  if (max_size || max_age) {
+    logger::rotation(static_cast<uint64_t>(max_size) * 1024 * 1024,
+                     max_age * 60, generations);
+  }
+
   // check -j option
   if (rvs::options::has_option("-j", &val)) {
     logger::to_json(true);
   }
 
+  // check --ndjson option
+  if (rvs::options::has_option("--ndjson", &val)) {
+    if (logger::set_ndjson_file(val)) {
+      char buff[1024];
+      snprintf(buff, sizeof(buff),
+                "could not open NDJSON file: %s", val.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+  }
+
+  // check --metricsFile option
+  if (rvs::options::has_option("--metricsFile", &val)) {
+    if (rvs::metriclog::open(val)) {
+      char buff[1024];
+      snprintf(buff, sizeof(buff),
+                "could not create metrics file: %s", val.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+  }
+
   string config_file;
   if (rvs::options::has_option("-c", &val)) {
     config_file = val;
@@ -190,6 +272,12 @@ int rvs::exec::run() {
     return sts;
   }
 
+  if (do_journal(config_file)) {
+    rvs::module::terminate();
+    logger::terminate();
+    return -1;
+  }
+
   DTRACE_
   try {
     sts = do_yaml(yaml_data_type_t::YAML_FILE, config_file);
@@ -204,7 +292,9 @@ int rvs::exec::run() {
     rvs::logger::Err(buff, MODULE_NAME_CAPS);
   }
 
+  checkpoint.close();
   rvs::module::terminate();
+  rvs::metriclog::close();
   logger::terminate();
 
   DTRACE_
@@ -242,6 +332,18 @@ int rvs::exec::set_callback(void (*callback)(const rvs_results_t * results, int
   return 0;
 }
 
+/**
+ * @brief Set application metric callback function
+ * @param callback Application metric callback function pointer, called with
+ * batches of metric values published by actions
+ * @return 0 - success. non-zero otherwise
+ */
+int rvs::exec::set_metric_callback(rvs_metric_callback callback) {
+
+  this->metric_callback = callback;
+  return 0;
+}
+
 /**
  * @brief Main executor method.
  *
@@ -370,8 +472,9 @@ int rvs::exec::run(std::map<std::string, std::string>& opt) {
       rvs::logger::Err(buff, MODULE_NAME_CAPS);
     }
 
+  // logger is shared with concurrently running sessions
   rvs::module::terminate();
-  logger::terminate();
+  logger::flush();
 
   DTRACE_
     if (sts) {
@@ -380,7 +483,7 @@ int rvs::exec::run(std::map<std::string, std::string>& opt) {
     }
 
   // if stop was requested
-  if (rvs::logger::Stopping()) {
+  if (rvs::logger::Stopping() || stop_requested) {
     DTRACE_
       return -1;
   }
@@ -421,10 +524,48 @@ void rvs::exec::do_help() {
   cout << "                   every action in the configuration file, "
                               "including the ‘all’ value.\n";
   cout << "-j --json          Output should use the JSON format.\n";
+  cout << "   --ndjson        Append JSON records to the given file, one "
+                              "record per line,\n";
+  cout << "                   instead of the -j per-module document.\n";
+  cout << "   --metricsFile   Record periodic samples (temperature, clocks, "
+                              "power, GFLOPS,\n";
+  cout << "                   bandwidth) in the given binary file. Use "
+                              "rvs-logdump to convert it.\n";
   cout << "-l --debugLogFile  Specify the logfile for debug information. "
                               "This will produce a log\n";
   cout << "                   file intended for post-run analysis after "
                               "an error.\n";
+  cout << "   --logMaxSize    Rotate log files once they grow over the given "
+                              "size (MB).\n";
+  cout << "   --logMaxAge     Rotate log files once they get older than the "
+                              "given number\n";
+  cout << "                   of minutes.\n";
+  cout << "   --logGenerations Number of rotated log files to keep "
+                              "(<file>.1 .. <file>.N).\n";
+  cout << "                   The default is 5.\n";
+  cout << "   --parallel      Maximum number of actions running at the "
+                              "same time when\n";
+  cout << "                   actions use depends_on or parallel_group. "
+                              "The default is no\n";
+  cout << "                   limit. Overrides max_parallel in the "
+                              "configuration file.\n";
+  cout << "   --stopOnFailure Ask running actions to stop as soon as one "
+                              "action fails.\n";
+  cout << "                   Actions not yet started are never started "
+                              "after a failure.\n";
+  cout << "   --journal       Record completed actions in this checkpoint "
+                              "journal file.\n";
+  cout << "   --resume        Skip actions the journal records as completed "
+                              "for the same\n";
+  cout << "                   configuration file and devices, and append to "
+                              "the existing logs.\n";
+  cout << "                   The journal is rvs.journal in the current "
+                              "directory unless\n";
+  cout << "                   --journal is given. Fails if it was written "
+                              "for another\n";
+  cout << "                   configuration file or device set.\n";
+  cout << "   --noDaemon      Run in this process even if rvsd is "
+                              "running.\n";
   cout << "   --quiet         No console output given. See logs and return "
                               "code for errors.\n";
   cout << "-m --modulepath    Specify a custom path for the RVS modules.\n";
@@ -486,20 +627,132 @@ int rvs::exec::do_gpu_list() {
   return sts;
 }
 
+/**
+ * @brief Opens checkpoint journal for configuration file
+ *
+ * The journal is tied to the contents of the configuration file and to
+ * the set of devices (GPU IDs present and --indexes option) actions run
+ * on. With --resume, actions this journal records as completed are
+ * skipped.
+ *
+ * @param config_file configuration file
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::exec::do_journal(const std::string& config_file) {
+  char buff[1024];
+
+  std::ifstream in(config_file);
+  std::string data((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+
+  std::vector<uint16_t> gpus;
+  gpu_get_all_gpu_id(&gpus);
+  std::sort(gpus.begin(), gpus.end());
+
+  std::string devices;
+  for (auto it = gpus.begin(); it != gpus.end(); ++it) {
+    devices += (devices.empty() ? "" : ",") + std::to_string(*it);
+  }
+  string indexes;
+  if (rvs::options::has_option("-i", &indexes) && !indexes.empty()) {
+    devices += " indexes=" + indexes;
+  }
+
+  string fname(RVS_JOURNAL_FILE);
+  bool journal = rvs::options::has_option("--journal", &fname);
+  bool resume = rvs::options::has_option("--resume");
+
+  // no checkpoints unless asked for
+  if (!journal && !resume) {
+    return 0;
+  }
+
+  int sts = checkpoint.open(fname, journal::hash(data.data(), data.size()),
+                            devices, resume);
+  if (sts == -2) {
+    snprintf(buff, sizeof(buff),
+              "can not resume: journal file %s was not written for this "
+              "configuration file and device set", fname.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+  if (sts) {
+    snprintf(buff, sizeof(buff),
+              "could not open journal file: %s", fname.c_str());
+    // checkpoints are optional unless resuming
+    if (resume) {
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+    rvs::logger::log(buff, rvs::loginfo);
+    return 0;
+  }
+
+  if (resume) {
+    snprintf(buff, sizeof(buff),
+              "resuming: %zu action(s) completed by an earlier run",
+              checkpoint.resumed());
+    rvs::logger::log(buff, rvs::logresults);
+  }
+
+  return 0;
+}
+
 void rvs::exec::action_callback(const action_result_t * result, void * user_param) {
 
   if((nullptr == result)||(nullptr == user_param)) {
     return;
   }
 
-  static_cast<rvs::exec *>(user_param)->callback(result);
+  action_ctx_t* pctx = static_cast<action_ctx_t *>(user_param);
+
+  if(nullptr != result->metric) {
+    if(nullptr != pctx->psummary) {
+      pctx->psummary->add(result->metric->name, result->metric->unit,
+                          result->metric->value);
+    }
+    if(nullptr != pctx->ppoint) {
+      pctx->ppoint->add(result->metric->name, result->metric->unit,
+                        result->metric->value);
+    }
+  }
+
+  pctx->pexec->callback(result);
+
+}
+
+/**
+ * @brief Metric queue delivery function
+ *
+ * Passes a batch of queued metric values to the application.
+ *
+ */
+void rvs::exec::metric_deliver(const rvs_metric_t * recs, unsigned int count,
+                               void * user_param) {
+
+  rvs::exec* pexec = static_cast<rvs::exec *>(user_param);
 
+  if(nullptr != pexec->metric_callback) {
+    (*pexec->metric_callback)((rvs_session_id_t)pexec->user_param,
+                              recs, count);
+  }
 }
 
 void rvs::exec::callback(const action_result_t * result) {
 
   rvs_results_t rvs_result;
 
+  // typed metric values go to the metric queue, if anybody listens
+  if (nullptr != result->metric) {
+    if (metrics) {
+      metrics->post(result->metric->name, result->metric->unit,
+                    result->metric->device, result->metric->value,
+                    result->metric->ts_ns);
+    }
+    return;
+  }
+
   rvs_result.status = RVS_STATUS_FAILED;
 
   switch (result->status) {
@@ -520,6 +773,7 @@ void rvs::exec::callback(const action_result_t * result) {
   rvs_result.state = RVS_SESSION_STATE_INPROGRESS;
   rvs_result.output_log = result->output.c_str();
 
+  std::lock_guard<std::mutex> lk(callback_mutex);
   if(nullptr != app_callback) {
     (*app_callback)(&rvs_result, user_param);
   }
@@ -527,8 +781,28 @@ void rvs::exec::callback(const action_result_t * result) {
 
 void rvs::exec::callback(const rvs_results_t * result) {
 
+  std::lock_guard<std::mutex> lk(callback_mutex);
   if(nullptr != app_callback) {
     (*app_callback)(result, user_param);
   }
 }
 
+/**
+ * @brief Asks actions of this executor to stop
+ *
+ * Actions not yet started are not started and running actions observe
+ * the request through rvs::lp::Stopping(). Other executors running
+ * concurrently are not affected.
+ *
+ * @param flag 'true' to request stop, 'false' to clear the request
+ *
+ */
+void rvs::exec::cancel(const bool flag) {
+  stop_requested = flag;
+
+  // wake up workers of this executor sleeping in rvs::lp::WaitStop()
+  if (flag) {
+    rvs::logger::NotifyStop();
+  }
+}
+
@@ -26,6 +26,7 @@
 #include <memory>
 #include <string>
 #include <algorithm>
+#include <vector>
 
 #include "include/rvsexec.h"
 #include "yaml-cpp/yaml.h"
@@ -37,6 +38,9 @@
 #include "include/rvsliblogger.h"
 #include "include/rvsoptions.h"
 #include "include/rvs_util.h"
+#include "include/rvsdag.h"
+#include "include/rvssweep.h"
+#include "include/rvs_key_def.h"
 
 #define MODULE_NAME_CAPS "CLI"
 
@@ -54,6 +58,19 @@ actions:
   module: gpup
   device: all
 
+Actions sharing parallel_group run concurrently once the previous stage is
+done; depends_on lists actions (or groups) to wait for instead:
+
+- name: monitor
+  module: gm
+  parallel_group: stress
+- name: gemm
+  module: gst
+  parallel_group: stress
+- name: pcie
+  module: peqt
+  depends_on: [action_1]
+
 ***/
 
 
@@ -140,13 +157,17 @@ int rvs::exec::do_yaml(const std::string& config_file) {
     }
 
     // Set Callback
+    action_ctx_t ctx = {this, nullptr, nullptr};
     if(nullptr != app_callback) {
-      pif1->callback_set(&rvs::exec::action_callback, (void *)this);
+      pif1->callback_set(&rvs::exec::action_callback, (void *)&ctx);
     }
 
     // execute action
     sts = pif1->run();
 
+    // make sure action output is out before the next action starts
+    rvs::logger::flush();
+
     // processing finished, release action object
     module::action_destroy(pa);
 
@@ -187,12 +208,86 @@ int rvs::exec::do_yaml(yaml_data_type_t data_type, const std::string& data) {
   // find "actions" map
   const YAML::Node& actions = config["actions"];
 
-
-  // for all actions...
+  // build action dependency graph
+  rvs::actiondag dag;
+  std::vector<YAML::Node> action_nodes;
   for (YAML::const_iterator it = actions.begin(); it != actions.end(); ++it) {
     const YAML::Node& action = *it;
 
-    rvs::logger::log("Action name :" + action["name"].as<std::string>(), rvs::logresults);
+    std::string group;
+    if (action["parallel_group"]) {
+      group = action["parallel_group"].as<std::string>();
+    }
+
+    std::vector<std::string> depends_on;
+    if (action["depends_on"]) {
+      const YAML::Node& deps = action["depends_on"];
+      if (deps.IsSequence()) {
+        for (auto dit = deps.begin(); dit != deps.end(); ++dit) {
+          depends_on.push_back(dit->as<std::string>());
+        }
+      } else if (deps.IsScalar()) {
+        std::string s = deps.as<std::string>();
+        std::replace(s.begin(), s.end(), ',', ' ');
+        depends_on = str_split(s, " ");
+      }
+    }
+
+    dag.add(action["name"].as<std::string>(), group, depends_on);
+    action_nodes.push_back(action);
+  }
+
+  std::string dag_err;
+  if (dag.build(&dag_err)) {
+    rvs::logger::Err(dag_err.c_str(), MODULE_NAME_CAPS);
+    result.output_log = dag_err.c_str();
+    callback(&result);
+    return -1;
+  }
+
+  // concurrency limit and failure policy, command line takes precedence
+  unsigned int max_parallel = 0;
+  bool stop_on_failure = false;
+  std::string val;
+  if (config["max_parallel"]) {
+    val = config["max_parallel"].as<std::string>();
+  }
+  rvs::options::has_option("--parallel", &val);
+  if (!val.empty() && rvs_util_parse(val, &max_parallel)) {
+    char buff[1024];
+    snprintf(buff, sizeof(buff),
+        "parallel action limit not a non-negative integer: %s", val.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    result.output_log = buff;
+    callback(&result);
+    return -1;
+  }
+  if (config["stop_on_failure"]) {
+    rvs_util_parse(config["stop_on_failure"].as<std::string>(),
+                   &stop_on_failure);
+  }
+  if (rvs::options::has_option("--stopOnFailure")) {
+    stop_on_failure = true;
+  }
+
+  // first failure is reported again when the session completes
+  std::string first_err;
+  std::mutex err_mutex;
+
+  // metric summaries of actions for the checkpoint journal
+  std::unique_ptr<rvs::journal::summary[]> summaries;
+  std::vector<char> skipped(dag.size(), 0);
+  if (checkpoint.is_open()) {
+    summaries.reset(new rvs::journal::summary[dag.size()]);
+  }
+
+  auto run_action = [&](size_t i) {
+    const YAML::Node& action = action_nodes[i];
+    std::string err;
+    int action_sts;
+
+    // this thread (and threads it starts) now works for this session
+    rvs::logger::set_cancel_flag(&stop_requested);
 
     // if stop was requested
     if (rvs::logger::Stopping()) {
@@ -200,11 +295,115 @@ int rvs::exec::do_yaml(yaml_data_type_t data_type, const std::string& data) {
       snprintf(buff, sizeof(buff),
           "action '%s' was requested to stop",
           action["name"].as<std::string>().c_str());
-      result.output_log = buff;
-      callback(&result);
-      return -1;
+      err = buff;
+      action_sts = -1;
+    } else if (checkpoint.is_open() &&
+               checkpoint.completed(i, dag.name(i))) {
+      char buff[1024];
+      snprintf(buff, sizeof(buff),
+          "action '%s' completed by an earlier run, skipped",
+          dag.name(i).c_str());
+      rvs::logger::log(buff, rvs::logresults);
+      skipped[i] = 1;
+      action_sts = 0;
+    } else {
+      action_sts = do_yaml_action(action, &err,
+                                  summaries ? &summaries[i] : nullptr);
     }
 
+    if (action_sts) {
+      std::lock_guard<std::mutex> lk(err_mutex);
+      if (first_err.empty()) {
+        first_err = err;
+      }
+    }
+    return action_sts;
+  };
+
+  auto action_done = [&](size_t i, int action_sts) {
+    rvs_results_t action_result = {RVS_STATUS_SUCCESS,
+                                   RVS_SESSION_STATE_INPROGRESS,
+                                   (const char *)NULL};
+    char buff[1024];
+
+    if (action_sts) {
+      // ask concurrently running actions to stop
+      if (stop_on_failure) {
+        cancel();
+      }
+      snprintf(buff, sizeof(buff),
+          "action '%s' failed with error !", dag.name(i).c_str());
+      action_result.status = RVS_STATUS_FAILED;
+    } else {
+      snprintf(buff, sizeof(buff),
+          "action '%s' completed", dag.name(i).c_str());
+    }
+    action_result.output_log = buff;
+    callback(&action_result);
+
+    // record completion in the checkpoint journal
+    if (summaries && !skipped[i]) {
+      checkpoint.record(i, dag.name(i), action_sts, summaries[i].str());
+    }
+  };
+
+  // metric values published by actions are delivered in batches
+  if (nullptr != metric_callback) {
+    metrics.reset(new rvs::metricqueue(&rvs::exec::metric_deliver, this));
+  }
+
+  sts = dag.run(max_parallel, run_action, action_done);
+
+  // deliver remaining metric values before session completion is reported
+  metrics.reset();
+
+  // report actions never started because of a failure
+  for (size_t i = 0; i < dag.size(); i++) {
+    if (dag.state(i) == rvs::actiondag::state_cancelled) {
+      char buff[1024];
+      snprintf(buff, sizeof(buff),
+          "action '%s' was not started", dag.name(i).c_str());
+      rvs::logger::log(buff, rvs::logresults);
+    }
+  }
+
+  if (sts) {
+    result.output_log = first_err.c_str();
+    callback(&result);
+    return sts;
+  }
+
+  result.status = RVS_STATUS_SUCCESS;
+  result.output_log = "RVS session successfully completed.";
+  callback(&result);
+  return 0;
+}
+
+/**
+ * @brief Creates, configures and executes single action.
+ *
+ * May be called concurrently for different actions.
+ *
+ * @param action action node from .conf file
+ * @param perr [out] error description on failure
+ * @param psummary [out] summary of metrics published by the action,
+ * nullptr if not needed
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::exec::do_yaml_action(const YAML::Node& action, std::string* perr,
+                              journal::summary* psummary) {
+  int sts = 0;
+  char buff[1024];
+  rvs::action* pa;
+  if1* pif1;
+  action_ctx_t ctx = {this, psummary, nullptr};
+
+  {
+    std::lock_guard<std::mutex> lk(module_mutex);
+
+    rvs::logger::log("Action name :" + action["name"].as<std::string>(), rvs::logresults);
+
     // find module name
     std::string rvsmodule;
     try {
@@ -215,46 +414,43 @@ int rvs::exec::do_yaml(yaml_data_type_t data_type, const std::string& data) {
     // not found or empty
     if (rvsmodule == "") {
       // report error and go to next action
-      char buff[1024];
       snprintf(buff, sizeof(buff), "action '%s' does not specify module.",
           action["name"].as<std::string>().c_str());
       rvs::logger::Err(buff, MODULE_NAME_CAPS);
-
-      result.output_log = buff;
-      callback(&result);
+      *perr = buff;
       return -1;
     }
 
     // create action executor in .so
-    rvs::action* pa = module::action_create(rvsmodule.c_str());
+    pa = module::action_create(rvsmodule.c_str());
     if (!pa) {
-      char buff[1024];
       snprintf(buff, sizeof(buff),
           "action '%s' could not create action object in module '%s'",
           action["name"].as<std::string>().c_str(),
           rvsmodule.c_str());
       rvs::logger::Err(buff, MODULE_NAME_CAPS);
-      result.output_log = buff;
-      callback(&result);
+      *perr = buff;
       return -1;
     }
 
-    if1* pif1 = dynamic_cast<if1*>(pa->get_interface(1));
+    pif1 = dynamic_cast<if1*>(pa->get_interface(1));
     if (!pif1) {
-      char buff[1024];
       snprintf(buff, sizeof(buff),
           "action '%s' could not obtain interface if1",
           action["name"].as<std::string>().c_str());
       module::action_destroy(pa);
-      result.output_log = buff;
-      callback(&result);
+      *perr = buff;
       return -1;
     }
 
     // load action properties from yaml file
     sts += do_yaml_properties(action, rvsmodule, pif1);
     if (sts) {
+      snprintf(buff, sizeof(buff),
+          "action '%s' has invalid properties",
+          action["name"].as<std::string>().c_str());
       module::action_destroy(pa);
+      *perr = buff;
       return sts;
     }
 
@@ -267,35 +463,108 @@ int rvs::exec::do_yaml(yaml_data_type_t data_type, const std::string& data) {
     }
 
     // Set Callback
-    if(nullptr != app_callback) {
-      pif1->callback_set(&rvs::exec::action_callback, (void *)this);
+    if((nullptr != app_callback) || (nullptr != metric_callback) ||
+       (nullptr != psummary) || action[RVS_CONF_SWEEP_KEY]) {
+      pif1->callback_set(&rvs::exec::action_callback, (void *)&ctx);
     }
+  }
 
-    // execute action
+  // execute action, once per point if parameters are swept
+  if (action[RVS_CONF_SWEEP_KEY]) {
+    sts = do_yaml_sweep(action, pif1, &ctx, perr);
+  } else {
     sts = pif1->run();
+  }
 
-    // processing finished, release action object
+  // make sure action output is out before the next action starts
+  rvs::logger::flush();
+
+  // processing finished, release action object
+  {
+    std::lock_guard<std::mutex> lk(module_mutex);
     module::action_destroy(pa);
+  }
 
-    // errors?
-    if (sts) {
+  if (sts && perr->empty()) {
+    snprintf(buff, sizeof(buff),
+        "action '%s' failed with error !",
+        action["name"].as<std::string>().c_str());
+    *perr = buff;
+  }
 
-      char buff[1024];
-      snprintf(buff, sizeof(buff),
-          "action '%s' failed with error !",
-          action["name"].as<std::string>().c_str());
-      result.output_log = buff;
-      callback(&result);
-      // cancel actions and return
-      return sts;
+  return sts;
+}
+
+/**
+ * @brief Runs action once for each point of its parameter sweep
+ *
+ * All points run in the same action object, so modules may keep their
+ * setup (device buffers, BLAS handles) between points. Before the first
+ * point the largest value of each numeric swept property is passed to the
+ * module as "sweep.max.<property>". Results of all points are logged as
+ * a single table.
+ *
+ * @param action action node from .conf file
+ * @param pif1 interface of the action object
+ * @param pctx action callback context
+ * @param perr [out] error description on failure
+ * @return 0 if all points succeeded, non-zero otherwise
+ *
+ */
+int rvs::exec::do_yaml_sweep(const YAML::Node& action, if1* pif1,
+                             action_ctx_t* pctx, std::string* perr) {
+  std::string name = action["name"].as<std::string>();
+  rvs::sweep sw;
+  char buff[1024];
+
+  if (sw.parse(action[RVS_CONF_SWEEP_KEY], perr)) {
+    *perr = "action '" + name + "': " + *perr;
+    rvs::logger::Err(perr->c_str(), MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  std::map<std::string, std::string> vmax = sw.max();
+  for (auto it = vmax.begin(); it != vmax.end(); ++it) {
+    pif1->property_set(RVS_CONF_SWEEP_MAX_PREFIX + it->first, it->second);
+  }
+
+  int sts = 0;
+  for (size_t i = 0; i < sw.size(); i++) {
+    if (rvs::logger::Stopping()) {
+      sts = sts ? sts : -1;
+      break;
     }
 
+    std::string desc;
+    const rvs::sweep::point_t& point = sw.point(i);
+    for (auto it = point.begin(); it != point.end(); ++it) {
+      pif1->property_set(it->first, it->second);
+      desc += " " + it->first + "=" + it->second;
+    }
+    snprintf(buff, sizeof(buff), "action '%s' sweep point %zu/%zu:%s",
+        name.c_str(), i + 1, sw.size(), desc.c_str());
+    rvs::logger::log(buff, rvs::logresults);
+
+    journal::summary point_summary;
+    pctx->ppoint = &point_summary;
+    int point_sts = pif1->run();
+    pctx->ppoint = nullptr;
+    rvs::logger::flush();
+
+    sw.add_result(i, point_sts, point_summary.averages());
+    if (point_sts && !sts) {
+      sts = point_sts;
+    }
   }
 
-  result.status = RVS_STATUS_SUCCESS;
-  result.output_log = "RVS session successfully completed.";
-  callback(&result);
-  return 0;
+  snprintf(buff, sizeof(buff), "action '%s' sweep results:", name.c_str());
+  rvs::logger::log(buff, rvs::logresults);
+  std::vector<std::string> lines = sw.table();
+  for (auto it = lines.begin(); it != lines.end(); ++it) {
+    rvs::logger::log("  " + *it, rvs::logresults);
+  }
+
+  return sts;
 }
 
 /**
@@ -318,6 +587,13 @@ int rvs::exec::do_yaml_properties(const YAML::Node& node,
 
   // for all child nodes
   for (YAML::const_iterator it = node.begin(); it != node.end(); it++) {
+    // scheduling keys are handled by executor
+    if (it->first.as<std::string>() == "depends_on" ||
+        it->first.as<std::string>() == "parallel_group" ||
+        it->first.as<std::string>() == RVS_CONF_SWEEP_KEY) {
+      continue;
+    }
+
     // if property is collection of module specific properties,
     if (is_yaml_properties_collection(module_name,
         it->first.as<std::string>())) {
@@ -0,0 +1,283 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsjob.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "include/rvsliblogger.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+/**
+ * @brief Writes whole buffer to socket
+ *
+ * @param fd socket
+ * @param data data to write
+ * @param size data size in bytes
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+static int send_all(int fd, const void* data, size_t size) {
+  const char* p = static_cast<const char*>(data);
+  while (size) {
+    ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    p += n;
+    size -= n;
+  }
+  return 0;
+}
+
+/**
+ * @brief Reads given number of bytes from socket
+ *
+ * @param fd socket
+ * @param data [out] buffer
+ * @param size number of bytes to read
+ * @return 0 if successful, non-zero on error or end of stream
+ *
+ */
+static int recv_all(int fd, void* data, size_t size) {
+  char* p = static_cast<char*>(data);
+  while (size) {
+    ssize_t n = ::recv(fd, p, size, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return -1;
+    }
+    p += n;
+    size -= n;
+  }
+  return 0;
+}
+
+/**
+ * @brief Get rvsd socket path
+ *
+ * @return value of RVSD_SOCKET environment variable if set, otherwise
+ * socket in $XDG_RUNTIME_DIR or, if that is not set either, in a private
+ * per user directory in /tmp
+ *
+ */
+std::string rvs::job::socket_path() {
+  const char* env = getenv(RVSD_SOCKET_ENV);
+  if (env && *env) {
+    return env;
+  }
+
+  env = getenv("XDG_RUNTIME_DIR");
+  if (env && *env) {
+    return std::string(env) + "/" RVSD_SOCKET_NAME;
+  }
+
+  char buff[PATH_MAX];
+  snprintf(buff, sizeof(buff), RVSD_SOCKET_DIR "/" RVSD_SOCKET_NAME,
+           static_cast<unsigned int>(geteuid()));
+  return buff;
+}
+
+/**
+ * @brief Checks that peer of a connected socket runs under the effective
+ * user ID of this process
+ *
+ * @param fd socket
+ * @return 'true' if it does, 'false' otherwise or if unknown
+ *
+ */
+bool rvs::job::same_user(int fd) {
+  struct ucred cred;
+  socklen_t len = sizeof(cred);
+  return ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 &&
+         cred.uid == ::geteuid();
+}
+
+/**
+ * @brief Sends message
+ *
+ * @param fd socket
+ * @param type message type
+ * @param data message payload
+ * @param size payload size in bytes
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::job::send_msg(int fd, msg_t type, const void* data, size_t size) {
+  header_t h = {static_cast<uint32_t>(type), static_cast<uint32_t>(size)};
+
+  if (size > RVSD_MAX_MSG) {
+    return -1;
+  }
+  if (send_all(fd, &h, sizeof(h))) {
+    return -1;
+  }
+  return size ? send_all(fd, data, size) : 0;
+}
+
+/**
+ * @brief Receives message
+ *
+ * @param fd socket
+ * @param ptype [out] message type
+ * @param pdata [out] message payload
+ * @return 0 if successful, non-zero on error or end of stream
+ *
+ */
+int rvs::job::recv_msg(int fd, msg_t* ptype, std::string* pdata) {
+  header_t h;
+
+  if (recv_all(fd, &h, sizeof(h)) || h.size > RVSD_MAX_MSG) {
+    return -1;
+  }
+
+  pdata->resize(h.size);
+  if (h.size && recv_all(fd, &(*pdata)[0], h.size)) {
+    return -1;
+  }
+
+  *ptype = static_cast<msg_t>(h.type);
+  return 0;
+}
+
+/**
+ * @brief Runs command line in rvsd listening on the default socket
+ *
+ * Console output of the job is written to standard output.
+ *
+ * @param argc standard C argc
+ * @param argv standard C argv
+ * @param pstatus [out] job return value
+ * @return 0 if job was run by rvsd, non-zero if rvsd is not running
+ *
+ */
+int rvs::jobclient::run(int argc, char** argv, int* pstatus) {
+  return run(job::socket_path(), argc, argv, STDOUT_FILENO, pstatus);
+}
+
+/**
+ * @brief Runs command line in rvsd
+ *
+ * @param path rvsd socket path
+ * @param argc standard C argc
+ * @param argv standard C argv
+ * @param out_fd descriptor console output of the job is written to
+ * @param pstatus [out] job return value
+ * @return 0 if job was handed over to rvsd, non-zero if rvsd is not
+ * running or the socket belongs to another user (job may be run locally)
+ *
+ */
+int rvs::jobclient::run(const std::string& path, int argc, char** argv,
+                        int out_fd, int* pstatus) {
+  struct sockaddr_un addr;
+
+  if (path.size() >= sizeof(addr.sun_path)) {
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                sizeof(addr))) {
+    ::close(fd);
+    return -1;
+  }
+
+  // whoever listens gets the command line and reports the results: it
+  // has to be a daemon of this user
+  if (!job::same_user(fd)) {
+    rvs::logger::Err("rvsd socket owned by another user ignored",
+                     MODULE_NAME_CAPS);
+    ::close(fd);
+    return -1;
+  }
+
+  // job runs in the directory rvs was invoked from
+  char cwd[PATH_MAX];
+  if (!getcwd(cwd, sizeof(cwd)) ||
+      job::send_msg(fd, job::msg_cwd, cwd, strlen(cwd))) {
+    ::close(fd);
+    return -1;
+  }
+  for (int i = 1; i < argc; i++) {
+    if (job::send_msg(fd, job::msg_arg, argv[i], strlen(argv[i]))) {
+      ::close(fd);
+      return -1;
+    }
+  }
+  if (job::send_msg(fd, job::msg_run, nullptr, 0)) {
+    ::close(fd);
+    return -1;
+  }
+
+  // from now on the job belongs to rvsd
+  *pstatus = -1;
+  job::msg_t type;
+  std::string data;
+  while (job::recv_msg(fd, &type, &data) == 0) {
+    if (type == job::msg_output) {
+      const char* p = data.data();
+      size_t size = data.size();
+      while (size) {
+        ssize_t n = ::write(out_fd, p, size);
+        if (n < 0 && errno == EINTR) {
+          continue;
+        }
+        if (n <= 0) {
+          break;
+        }
+        p += n;
+        size -= n;
+      }
+    } else if (type == job::msg_status && data.size() == sizeof(int32_t)) {
+      int32_t sts;
+      memcpy(&sts, data.data(), sizeof(sts));
+      *pstatus = sts;
+      ::close(fd);
+      return 0;
+    }
+  }
+
+  rvs::logger::Err("connection to rvsd lost", MODULE_NAME_CAPS);
+  ::close(fd);
+  return 0;
+}
@@ -0,0 +1,382 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsjob.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <thread>
+
+#include "include/rvscli.h"
+#include "include/rvsexec.h"
+#include "include/rvsliblogger.h"
+
+#define MODULE_NAME_CAPS "RVSD"
+
+//! Default constructor
+rvs::jobserver::jobserver()
+: lfd(-1), bstop(false), njobs(0), pexec(nullptr) {
+}
+
+//! Destructor, removes socket
+rvs::jobserver::~jobserver() {
+  if (lfd >= 0) {
+    ::close(lfd);
+    ::unlink(path.c_str());
+  }
+}
+
+/**
+ * @brief Prepares directory of the socket
+ *
+ * A missing directory is created accessible by the owner only. An existing
+ * one must belong to this user or to root, otherwise its owner could
+ * replace the socket.
+ *
+ * @param dir directory
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+static int socket_dir(const std::string& dir) {
+  struct stat st;
+
+  if (::mkdir(dir.c_str(), 0700) && errno != EEXIST) {
+    return -1;
+  }
+  if (::lstat(dir.c_str(), &st) || !S_ISDIR(st.st_mode)) {
+    return -1;
+  }
+  if (st.st_uid != ::geteuid() && st.st_uid != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Creates listening socket
+ *
+ * A stale socket left behind by a terminated server is replaced. The
+ * socket is accessible by the owner only; its directory is created if
+ * missing.
+ *
+ * @param sock_path socket path
+ * @return 0 if successful, non-zero otherwise (e.g. server already running)
+ *
+ */
+int rvs::jobserver::listen(const std::string& sock_path) {
+  struct sockaddr_un addr;
+  char buff[1024];
+
+  if (sock_path.size() >= sizeof(addr.sun_path)) {
+    snprintf(buff, sizeof(buff), "socket path too long: %s",
+             sock_path.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, sock_path.c_str(), sizeof(addr.sun_path) - 1);
+
+  size_t slash = sock_path.rfind('/');
+  if (slash != std::string::npos && slash > 0 &&
+      socket_dir(sock_path.substr(0, slash))) {
+    snprintf(buff, sizeof(buff), "unusable socket directory for %s",
+             sock_path.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    rvs::logger::Err("could not create socket", MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  // somebody listening already?
+  if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                sizeof(addr)) == 0) {
+    snprintf(buff, sizeof(buff), "rvsd already running on %s",
+             sock_path.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    ::close(fd);
+    return -1;
+  }
+  ::close(fd);
+  ::unlink(sock_path.c_str());
+
+  fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  mode_t mask = ::umask(0077);
+  int sts = fd < 0 ? -1 : ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                                 sizeof(addr));
+  ::umask(mask);
+  if (sts || ::listen(fd, 8)) {
+    snprintf(buff, sizeof(buff), "could not listen on %s: %s",
+             sock_path.c_str(), strerror(errno));
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    return -1;
+  }
+
+  lfd = fd;
+  path = sock_path;
+  return 0;
+}
+
+/**
+ * @brief Serves jobs until stop() is called
+ *
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::jobserver::serve() {
+  while (!bstop) {
+    int fd = ::accept4(lfd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (bstop) {
+        break;
+      }
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      rvs::logger::Err("accept failed", MODULE_NAME_CAPS);
+      return -1;
+    }
+
+    // jobs run with rights of this process, serve its owner only
+    if (!job::same_user(fd)) {
+      rvs::logger::Err("job from another user rejected", MODULE_NAME_CAPS);
+      ::close(fd);
+      continue;
+    }
+
+    do_job(fd);
+    ::close(fd);
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Asks server to stop
+ *
+ * The job being run, if any, is completed first. May be called from a
+ * signal handler.
+ *
+ */
+void rvs::jobserver::stop() {
+  bstop = true;
+  if (lfd >= 0) {
+    ::shutdown(lfd, SHUT_RDWR);
+  }
+}
+
+/**
+ * @brief Receives and runs a single job
+ *
+ * @param fd client socket
+ * @return 0 if job was run, non-zero otherwise
+ *
+ */
+int rvs::jobserver::do_job(int fd) {
+  std::string cwd;
+  std::vector<std::string> args;
+  job::msg_t type;
+  std::string data;
+
+  for (;;) {
+    if (job::recv_msg(fd, &type, &data)) {
+      return -1;
+    }
+    if (type == job::msg_cwd) {
+      cwd = data;
+    } else if (type == job::msg_arg) {
+      args.push_back(data);
+    } else if (type == job::msg_run) {
+      break;
+    }
+  }
+
+  // argv[0] is not used, "pwd" option points to this executable
+  std::vector<char*> argv;
+  argv.push_back(const_cast<char*>("rvs"));
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    argv.push_back(const_cast<char*>(it->c_str()));
+  }
+  argv.push_back(nullptr);
+
+  char home[PATH_MAX];
+  if (!getcwd(home, sizeof(home))) {
+    home[0] = '\0';
+  }
+
+  int32_t sts = -1;
+  int pfd[2];
+  if (cwd.empty() || ::chdir(cwd.c_str())) {
+    std::string msg = "rvsd could not change directory to " + cwd + "\n";
+    job::send_msg(fd, job::msg_output, msg.data(), msg.size());
+  } else if (::pipe2(pfd, O_CLOEXEC) == 0) {
+    // console output of the job goes to the client
+    std::cout.flush();
+    fflush(stdout);
+    fflush(stderr);
+    int saved_out = ::fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, 0);
+    int saved_err = ::fcntl(STDERR_FILENO, F_DUPFD_CLOEXEC, 0);
+    ::dup2(pfd[1], STDOUT_FILENO);
+    ::dup2(pfd[1], STDERR_FILENO);
+    ::close(pfd[1]);
+
+    std::thread fwd(&rvs::jobserver::forward, this, pfd[0], fd);
+
+    sts = execute(static_cast<int>(argv.size()) - 1, argv.data());
+
+    rvs::logger::flush();
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(stdout);
+    fflush(stderr);
+    ::dup2(saved_out, STDOUT_FILENO);
+    ::dup2(saved_err, STDERR_FILENO);
+    ::close(saved_out);
+    ::close(saved_err);
+
+    // forwarder ends once all output is passed on
+    fwd.join();
+    ::close(pfd[0]);
+    njobs++;
+  }
+
+  if (home[0] && ::chdir(home)) {
+    rvs::logger::Err("could not restore working directory", MODULE_NAME_CAPS);
+  }
+
+  return job::send_msg(fd, job::msg_status, &sts, sizeof(sts));
+}
+
+/**
+ * @brief Forwards job output to the client
+ *
+ * Runs until the job output is closed. If the client goes away, the job is
+ * asked to stop and remaining output is discarded.
+ *
+ * @param out_fd read end of job output pipe
+ * @param client_fd client socket
+ *
+ */
+void rvs::jobserver::forward(int out_fd, int client_fd) {
+  char buff[RVSD_OUTPUT_CHUNK];
+  bool bclient = true;
+  struct pollfd p[2] = {{out_fd, POLLIN, 0}, {client_fd, POLLIN, 0}};
+
+  for (;;) {
+    if (::poll(p, bclient ? 2 : 1, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    // client sends nothing while job runs, so it has disconnected
+    if (bclient && p[1].revents) {
+      char c;
+      ssize_t n = ::recv(client_fd, &c, 1, MSG_DONTWAIT);
+      if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+        bclient = false;
+        cancel();
+      }
+    }
+
+    if (p[0].revents) {
+      ssize_t n = ::read(out_fd, buff, sizeof(buff));
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        break;
+      }
+      if (bclient && job::send_msg(client_fd, job::msg_output, buff, n)) {
+        bclient = false;
+        cancel();
+      }
+    }
+  }
+}
+
+/**
+ * @brief Runs command line of a job
+ *
+ * Logging settings of the previous job are discarded and the command line
+ * is handled the same way as in rvs.
+ *
+ * @param argc standard C argc
+ * @param argv standard C argv
+ * @return job return value
+ *
+ */
+int rvs::jobserver::execute(int argc, char** argv) {
+  rvs::logger::reset();
+
+  rvs::cli cli;
+  if (cli.parse(argc, argv)) {
+    char buff[1024];
+    snprintf(buff, sizeof(buff),
+             "error parsing command line: %s", cli.get_error_string());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  rvs::exec executor;
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    pexec = &executor;
+  }
+
+  int sts = executor.run();
+
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    pexec = nullptr;
+  }
+
+  return sts;
+}
+
+//! Asks the running job to stop
+void rvs::jobserver::cancel() {
+  std::lock_guard<std::mutex> lk(mtx);
+  if (pexec) {
+    pexec->cancel();
+  }
+}
@@ -0,0 +1,283 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsjournal.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include <cerrno>
+
+#include <fstream>
+#include <vector>
+
+#include "include/rvs_util.h"
+
+/**
+ * @brief Adds metric value to the summary
+ *
+ * @param name metric name
+ * @param unit metric unit
+ * @param value metric value
+ *
+ */
+void rvs::journal::summary::add(const char* name, const char* unit,
+                                double value) {
+  std::lock_guard<std::mutex> lk(mtx);
+
+  auto it = stats.find(name);
+  if (it == stats.end()) {
+    stats[name] = {unit ? unit : "", 1, value, value, value};
+    return;
+  }
+
+  stat_t& s = it->second;
+  s.count++;
+  s.sum += value;
+  if (value < s.min) {
+    s.min = value;
+  }
+  if (value > s.max) {
+    s.max = value;
+  }
+}
+
+/**
+ * @brief Formats the summary for the journal
+ *
+ * @return "name[unit] n=count min=.. avg=.. max=.." for each metric,
+ * separated by "; ", or "-" if no metric was published
+ *
+ */
+std::string rvs::journal::summary::str() {
+  std::lock_guard<std::mutex> lk(mtx);
+  std::string s;
+  char buff[256];
+
+  for (auto it = stats.begin(); it != stats.end(); ++it) {
+    const stat_t& st = it->second;
+    snprintf(buff, sizeof(buff),
+             "%s%s[%s] n=%" PRIu64 " min=%.3f avg=%.3f max=%.3f",
+             s.empty() ? "" : "; ", it->first.c_str(), st.unit.c_str(),
+             st.count, st.min, st.sum / st.count, st.max);
+    s += buff;
+  }
+
+  return s.empty() ? "-" : s;
+}
+
+/**
+ * @brief Average of each metric
+ *
+ * @return "name[unit]" -> average value
+ *
+ */
+std::map<std::string, double> rvs::journal::summary::averages() {
+  std::lock_guard<std::mutex> lk(mtx);
+  std::map<std::string, double> m;
+
+  for (auto it = stats.begin(); it != stats.end(); ++it) {
+    m[it->first + "[" + it->second.unit + "]"] =
+      it->second.sum / it->second.count;
+  }
+
+  return m;
+}
+
+//! Default constructor
+rvs::journal::journal() : pfile(nullptr) {
+}
+
+//! Destructor
+rvs::journal::~journal() {
+  close();
+}
+
+/**
+ * @brief Opens journal
+ *
+ * When resuming, actions recorded as completed by an earlier run of the
+ * same configuration on the same devices are loaded and new records are
+ * appended. A journal which does not match is left untouched. Otherwise
+ * (or if there is no journal yet) the journal is started anew.
+ *
+ * @param fname journal file name
+ * @param config_hash hash of the configuration file contents
+ * @param devices description of the device set
+ * @param resume 'true' to load completed actions of an earlier run
+ * @return 0 if successful, -1 if the journal can not be written,
+ * -2 if resuming and the existing journal can not be read or was written
+ * for another configuration or device set
+ *
+ */
+int rvs::journal::open(const std::string& fname, uint64_t config_hash,
+                       const std::string& devices, bool resume) {
+  char header[1024];
+
+  close();
+  done.clear();
+
+  snprintf(header, sizeof(header), "%s\tconfig=%016" PRIx64 "\tdevices=%s",
+           RVS_JOURNAL_VERSION, config_hash, devices.c_str());
+
+  if (resume) {
+    int sts = load(fname, header);
+    if (sts == 0) {
+      pfile = fopen(fname.c_str(), "a");
+      return pfile ? 0 : -1;
+    }
+    if (sts < 0) {
+      return -2;
+    }
+  }
+
+  pfile = fopen(fname.c_str(), "w");
+  if (!pfile) {
+    return -1;
+  }
+
+  fprintf(pfile, "%s\n", header);
+  fflush(pfile);
+  fsync(fileno(pfile));
+
+  return 0;
+}
+
+/**
+ * @brief Loads completed actions from existing journal
+ *
+ * Later records of an action override earlier ones, so an action which
+ * failed and then completed on resume is done.
+ *
+ * @param fname journal file name
+ * @param header expected first line
+ * @return 0 if journal matches, 1 if there is no journal file,
+ * -1 if it can not be read or does not match
+ *
+ */
+int rvs::journal::load(const std::string& fname, const std::string& header) {
+  struct stat st;
+  if (stat(fname.c_str(), &st) && errno == ENOENT) {
+    return 1;
+  }
+
+  std::ifstream in(fname);
+  std::string line;
+
+  if (!in.good() || !std::getline(in, line) || line != header) {
+    return -1;
+  }
+
+  while (std::getline(in, line)) {
+    // index, name, result, metrics summary
+    std::vector<std::string> f = str_split(line, "\t");
+    size_t index;
+    int result;
+    if (f.size() < 3 || rvs_util_parse(f[0], &index)) {
+      continue;
+    }
+    try {
+      result = std::stoi(f[2]);
+    } catch(...) {
+      continue;
+    }
+    if (result == 0) {
+      done[index] = f[1];
+    } else {
+      done.erase(index);
+    }
+  }
+
+  return 0;
+}
+
+//! Closes journal
+void rvs::journal::close() {
+  std::lock_guard<std::mutex> lk(mtx);
+  if (pfile) {
+    fclose(pfile);
+    pfile = nullptr;
+  }
+}
+
+/**
+ * @brief Checks if action was completed by an earlier run
+ *
+ * @param index index of the action in configuration file
+ * @param name action name
+ * @return 'true' if completed, 'false' otherwise
+ *
+ */
+bool rvs::journal::completed(size_t index, const std::string& name) {
+  std::lock_guard<std::mutex> lk(mtx);
+  auto it = done.find(index);
+  return it != done.end() && it->second == name;
+}
+
+/**
+ * @brief Records completed action
+ *
+ * The record is on disk once this function returns.
+ *
+ * @param index index of the action in configuration file
+ * @param name action name
+ * @param result action result (0 - success)
+ * @param metrics summary of metrics published by the action
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::journal::record(size_t index, const std::string& name, int result,
+                         const std::string& metrics) {
+  std::lock_guard<std::mutex> lk(mtx);
+
+  if (!pfile) {
+    return -1;
+  }
+
+  fprintf(pfile, "%zu\t%s\t%d\t%s\n", index, name.c_str(), result,
+          metrics.c_str());
+  if (fflush(pfile) || fsync(fileno(pfile))) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Computes 64-bit FNV-1a hash
+ *
+ * @param data data to hash
+ * @param size data size in bytes
+ * @return hash value
+ *
+ */
+uint64_t rvs::journal::hash(const char* data, size_t size) {
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; i++) {
+    h ^= static_cast<unsigned char>(data[i]);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
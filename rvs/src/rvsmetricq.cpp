@@ -0,0 +1,227 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsmetricq.h"
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <new>
+
+/**
+ * @brief Constructor; starts delivery thread
+ *
+ * @param cb delivery callback
+ * @param param user parameter passed to delivery callback
+ * @param size number of record slots, rounded up to power of 2
+ *
+ */
+rvs::metricqueue::metricqueue(deliver_t cb, void* param, size_t size)
+: deliver(cb), user_param(param), tail(0), head(0), bquit(false),
+  st_posted(0), st_batches(0), st_stalled(0) {
+  size_t n = 2;
+  while (n < size) {
+    n <<= 1;
+  }
+  mask = n - 1;
+  rec.resize(n);
+  seq.reset(new std::atomic<uint64_t>[n]);
+  for (size_t i = 0; i < n; i++) {
+    seq[i].store(i, std::memory_order_relaxed);
+  }
+
+  deliverer = std::thread(&rvs::metricqueue::run, this);
+}
+
+/**
+ * @brief Destructor; delivers all posted records and stops delivery thread
+ *
+ */
+rvs::metricqueue::~metricqueue() {
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    bquit = true;
+  }
+  cv.notify_one();
+  deliverer.join();
+}
+
+/**
+ * @brief Allocates queue aligned to cache line
+ *
+ * Plain operator new does not honor alignment of tail and head before
+ * C++17, which would defeat their padding.
+ *
+ * @param size object size
+ * @return allocated memory
+ *
+ */
+void* rvs::metricqueue::operator new(size_t size) {
+  void* p = nullptr;
+  if (posix_memalign(&p, RVS_METRICQ_CACHE_LINE, size)) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+//! Frees queue allocated by operator new
+void rvs::metricqueue::operator delete(void* ptr) {
+  free(ptr);
+}
+
+/**
+ * @brief Post metric record
+ *
+ * Lock-free unless the ring is full, in which case the caller yields until
+ * the delivery thread makes room.
+ *
+ * @param name metric name, must stay valid until delivered
+ * @param unit metric unit, must stay valid until delivered
+ * @param device GPU id
+ * @param value metric value
+ * @param ts_ns timestamp (ns since epoch)
+ *
+ */
+void rvs::metricqueue::post(const char* name, const char* unit,
+                            unsigned int device, double value,
+                            uint64_t ts_ns) {
+  uint64_t pos = tail.load(std::memory_order_relaxed);
+  bool stalled = false;
+
+  for (;;) {
+    uint64_t s = seq[pos & mask].load(std::memory_order_acquire);
+    int64_t dif = static_cast<int64_t>(s) - static_cast<int64_t>(pos);
+    if (dif == 0) {
+      // slot free, try to claim it
+      if (tail.compare_exchange_weak(pos, pos + 1,
+                                     std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (dif < 0) {
+      // ring full, let delivery thread catch up
+      if (!stalled) {
+        stalled = true;
+        st_stalled++;
+        cv.notify_one();
+      }
+      std::this_thread::yield();
+      pos = tail.load(std::memory_order_relaxed);
+    } else {
+      // another producer claimed this slot
+      pos = tail.load(std::memory_order_relaxed);
+    }
+  }
+
+  rvs_metric_t& r = rec[pos & mask];
+  r.name = name;
+  r.unit = unit;
+  r.device = device;
+  r.value = value;
+  r.timestamp_ns = ts_ns;
+  seq[pos & mask].store(pos + 1, std::memory_order_release);
+
+  st_posted++;
+
+  // wake delivery thread early once ring is half full
+  if (pos + 1 - head.load(std::memory_order_relaxed) > (mask + 1) / 2) {
+    cv.notify_one();
+  }
+}
+
+/**
+ * @brief Deliver ready records in place
+ *
+ * Delivers a contiguous run of ready slots (up to the end of the ring)
+ * and releases the slots to producers afterwards.
+ *
+ * @return number of records delivered
+ *
+ */
+size_t rvs::metricqueue::drain_once() {
+  uint64_t h = head.load(std::memory_order_relaxed);
+  size_t n = 0;
+
+  for (;;) {
+    uint64_t pos = h + n;
+    if (seq[pos & mask].load(std::memory_order_acquire) != pos + 1) {
+      break;
+    }
+    n++;
+    // stop at the end of the ring so that records stay contiguous
+    if (((pos + 1) & mask) == 0) {
+      break;
+    }
+  }
+
+  if (n == 0) {
+    return 0;
+  }
+
+  (*deliver)(&rec[h & mask], static_cast<unsigned int>(n), user_param);
+  st_batches++;
+
+  for (size_t i = 0; i < n; i++) {
+    seq[(h + i) & mask].store(h + i + mask + 1, std::memory_order_release);
+  }
+  head.store(h + n, std::memory_order_relaxed);
+
+  return n;
+}
+
+/**
+ * @brief Delivery thread function
+ *
+ * Delivers records every RVS_METRICQ_INTERVAL milliseconds, or sooner if
+ * the ring fills up. Records posted before the destructor was called are
+ * delivered before the thread exits.
+ *
+ */
+void rvs::metricqueue::run() {
+  for (;;) {
+    while (drain_once()) {
+    }
+
+    std::unique_lock<std::mutex> lk(mtx);
+    if (bquit) {
+      // pick up records posted while the last pass was running
+      lk.unlock();
+      while (drain_once()) {
+      }
+      break;
+    }
+    cv.wait_for(lk, std::chrono::milliseconds(RVS_METRICQ_INTERVAL));
+  }
+}
+
+/**
+ * @brief Get queue statistics
+ *
+ * @param pstats [out] statistics
+ *
+ */
+void rvs::metricqueue::get_stats(stats_t* pstats) {
+  pstats->posted = st_posted;
+  pstats->batches = st_batches;
+  pstats->stalled = st_stalled;
+}
@@ -35,6 +35,7 @@
 #include <fstream>
 
 #include "include/rvsliblogger.h"
+#include "include/rvsmetriclog.h"
 #include "include/rvsif0.h"
 #include "include/rvsif1.h"
 #include "include/rvsaction.h"
@@ -46,6 +47,8 @@
 std::map<std::string, rvs::module*> rvs::module::modulemap;
 std::map<std::string, std::string>  rvs::module::filemap;
 YAML::Node rvs::module::config;
+std::mutex rvs::module::mtx;
+int rvs::module::users(0);
 
 using std::string;
 
@@ -70,13 +73,16 @@ rvs::module::~module() {
  * @brief Module manager initialization method
  *
  * Reads module name -> .so file mapping from configuration file name
- * specified by pConfig
+ * specified by pConfig. May be called by several sessions, each successful
+ * call has to be matched by terminate().
  *
  * @param pConfig Name of configuration file
  * @return 0 - success, non-zero otherwise
  *
  */
 int rvs::module::initialize(const char* pConfig) {
+  std::lock_guard<std::mutex> lk(mtx);
+
   // Check if pConfig file exists
   std::ifstream file(pConfig);
 
@@ -124,6 +130,8 @@ int rvs::module::initialize(const char* pConfig) {
     filemap.insert(std::pair<string, string>(key, value));
   }
 
+  users++;
+
   return 0;
 }
 
@@ -262,6 +270,12 @@ int rvs::module::initialize() {
   d.cbStop                      = rvs::logger::Stop;
   d.cbStopping                  = rvs::logger::Stopping;
   d.cbErr                       = rvs::logger::Err;
+  d.cbAddDouble                 = rvs::logger::AddDouble;
+  d.cbAddUInt64                 = rvs::logger::AddUInt64;
+  d.cbAddBool                   = rvs::logger::AddBool;
+  d.cbLogLevel                  = rvs::logger::log_level;
+  d.cbMetric                    = rvs::metriclog::sample;
+  d.cbWaitStop                  = rvs::logger::WaitStop;
 
   return (*rvs_module_init)(reinterpret_cast<void*>(&d));
 }
@@ -275,6 +289,8 @@ int rvs::module::initialize() {
  *
  */
 rvs::action* rvs::module::action_create(const char* name) {
+  std::lock_guard<std::mutex> lk(mtx);
+
   // find module
   rvs::module* m = module::find_create_module(name);
   if (!m) {
@@ -340,6 +356,8 @@ void* rvs::module::action_create() {
  *
  */
 int rvs::module::action_destroy(rvs::action* paction) {
+  std::lock_guard<std::mutex> lk(mtx);
+
   // find module
   rvs::module* m = module::find_create_module(paction->name.c_str());
   if (!m)
@@ -367,10 +385,21 @@ int rvs::module::action_destroy_internal(rvs::action* paction) {
 /**
  * @brief Cleanup module manager
  *
+ * Modules are unloaded only once the last session using them terminates.
+ *
  * @return 0 - success, non-zero otherwise
  *
  */
 int rvs::module::terminate() {
+  std::lock_guard<std::mutex> lk(mtx);
+
+  // modules are still used by other sessions
+  if (users > 1) {
+    users--;
+    return 0;
+  }
+  users = 0;
+
   for (auto it = rvs::module::modulemap.begin();
        it != rvs::module::modulemap.end(); it++) {
     it->second->terminate_internal();
@@ -0,0 +1,296 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvssweep.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <set>
+
+#include "yaml-cpp/yaml.h"
+
+#include "include/rvs_util.h"
+
+/**
+ * @brief Expands sweep key of an action into points
+ *
+ * @param node value of the "sweep" key
+ * @param perr [out] error description on failure
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::sweep::parse(const YAML::Node& node, std::string* perr) {
+  props.clear();
+  pts.clear();
+  results.clear();
+  metrics.clear();
+
+  if (!node.IsMap() || node.size() == 0) {
+    *perr = "sweep has to map property names to values";
+    return -1;
+  }
+
+  pts.push_back(point_t());
+  for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+    std::string key = it->first.as<std::string>();
+    key.erase(std::remove(key.begin(), key.end(), ' '), key.end());
+    std::vector<std::string> names = str_split(key, ",");
+    if (names.empty()) {
+      *perr = "sweep property name missing";
+      return -1;
+    }
+
+    for (auto nit = names.begin(); nit != names.end(); ++nit) {
+      if (std::find(props.begin(), props.end(), *nit) != props.end()) {
+        *perr = "property '" + *nit + "' swept more than once";
+        return -1;
+      }
+      props.push_back(*nit);
+    }
+
+    std::vector<std::string> values;
+    if (parse_values(key, it->second, &values, perr)) {
+      return -1;
+    }
+
+    if (pts.size() * values.size() > RVS_SWEEP_MAX_POINTS) {
+      *perr = "sweep expands to more than " +
+              std::to_string(RVS_SWEEP_MAX_POINTS) + " points";
+      return -1;
+    }
+
+    // every point so far combined with every value of this entry
+    std::vector<point_t> next;
+    for (auto pit = pts.begin(); pit != pts.end(); ++pit) {
+      for (auto vit = values.begin(); vit != values.end(); ++vit) {
+        point_t p(*pit);
+        for (auto nit = names.begin(); nit != names.end(); ++nit) {
+          p[*nit] = *vit;
+        }
+        next.push_back(p);
+      }
+    }
+    pts.swap(next);
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Parses values of a single sweep entry
+ *
+ * @param key entry key (for error messages)
+ * @param node list of values, single value or range
+ * @param pvalues [out] values
+ * @param perr [out] error description on failure
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::sweep::parse_values(const std::string& key, const YAML::Node& node,
+                             std::vector<std::string>* pvalues,
+                             std::string* perr) {
+  if (node.IsScalar()) {
+    pvalues->push_back(node.as<std::string>());
+    return 0;
+  }
+
+  if (node.IsSequence()) {
+    for (auto it = node.begin(); it != node.end(); ++it) {
+      if (!it->IsScalar()) {
+        *perr = "sweep of '" + key + "' lists a non-scalar value";
+        return -1;
+      }
+      pvalues->push_back(it->as<std::string>());
+    }
+    if (pvalues->empty()) {
+      *perr = "sweep of '" + key + "' has no values";
+      return -1;
+    }
+    return 0;
+  }
+
+  if (!node.IsMap()) {
+    *perr = "sweep of '" + key + "' has to be a list or a range";
+    return -1;
+  }
+
+  // range: start, stop and step or factor
+  uint64_t start, stop, step = 0, factor = 0;
+  if (!node["start"] || !node["stop"] ||
+      rvs_util_parse(node["start"].as<std::string>(), &start) ||
+      rvs_util_parse(node["stop"].as<std::string>(), &stop) || stop < start) {
+    *perr = "sweep range of '" + key +
+            "' needs non-negative integer start <= stop";
+    return -1;
+  }
+  if (node["step"] && node["factor"]) {
+    *perr = "sweep range of '" + key + "' has both step and factor";
+    return -1;
+  }
+  if (node["step"]) {
+    if (rvs_util_parse(node["step"].as<std::string>(), &step) || !step) {
+      *perr = "sweep range of '" + key + "' needs positive integer step";
+      return -1;
+    }
+  } else if (node["factor"]) {
+    if (rvs_util_parse(node["factor"].as<std::string>(), &factor) ||
+        factor < 2 || !start) {
+      *perr = "sweep range of '" + key +
+              "' needs integer factor >= 2 and start > 0";
+      return -1;
+    }
+  } else {
+    *perr = "sweep range of '" + key + "' needs step or factor";
+    return -1;
+  }
+
+  for (uint64_t v = start; v <= stop;) {
+    if (pvalues->size() >= RVS_SWEEP_MAX_POINTS) {
+      *perr = "sweep range of '" + key + "' has too many values";
+      return -1;
+    }
+    pvalues->push_back(std::to_string(v));
+    uint64_t next = step ? v + step : v * factor;
+    if (next <= v) {
+      break;  // overflow
+    }
+    v = next;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Largest value of each swept property
+ *
+ * Lets a module size its resources for the largest point up front.
+ *
+ * @return property name -> largest value, for properties with
+ * non-negative integer values only
+ *
+ */
+std::map<std::string, std::string> rvs::sweep::max() {
+  std::map<std::string, std::string> m;
+
+  for (auto it = props.begin(); it != props.end(); ++it) {
+    uint64_t vmax = 0;
+    bool bnumeric = true;
+    for (auto pit = pts.begin(); pit != pts.end() && bnumeric; ++pit) {
+      uint64_t v;
+      if (rvs_util_parse(pit->at(*it), &v)) {
+        bnumeric = false;
+      } else if (v > vmax) {
+        vmax = v;
+      }
+    }
+    if (bnumeric) {
+      m[*it] = std::to_string(vmax);
+    }
+  }
+
+  return m;
+}
+
+/**
+ * @brief Stores result of a point
+ *
+ * @param i point index
+ * @param sts point result (0 - success)
+ * @param point_metrics average of each metric published while point ran
+ *
+ */
+void rvs::sweep::add_result(size_t i, int sts,
+                            const std::map<std::string, double>& point_metrics) {
+  results[i] = sts;
+  metrics[i] = point_metrics;
+}
+
+/**
+ * @brief Formats results as a table
+ *
+ * One row per point with the values of swept properties, the result and
+ * the average of each metric. Points not run show "-".
+ *
+ * @return table lines, header first
+ *
+ */
+std::vector<std::string> rvs::sweep::table() {
+  std::vector<std::vector<std::string>> cells;
+
+  std::set<std::string> metric_names;
+  for (auto it = metrics.begin(); it != metrics.end(); ++it) {
+    for (auto mit = it->second.begin(); mit != it->second.end(); ++mit) {
+      metric_names.insert(mit->first);
+    }
+  }
+
+  std::vector<std::string> row(props);
+  row.push_back("result");
+  row.insert(row.end(), metric_names.begin(), metric_names.end());
+  cells.push_back(row);
+
+  for (size_t i = 0; i < pts.size(); i++) {
+    row.clear();
+    for (auto it = props.begin(); it != props.end(); ++it) {
+      row.push_back(pts[i][*it]);
+    }
+    auto rit = results.find(i);
+    row.push_back(rit == results.end() ? "-" : (rit->second ? "fail" : "pass"));
+    for (auto it = metric_names.begin(); it != metric_names.end(); ++it) {
+      char buff[64] = "-";
+      auto pit = metrics.find(i);
+      if (pit != metrics.end()) {
+        auto mit = pit->second.find(*it);
+        if (mit != pit->second.end()) {
+          snprintf(buff, sizeof(buff), "%.3f", mit->second);
+        }
+      }
+      row.push_back(buff);
+    }
+    cells.push_back(row);
+  }
+
+  // align columns
+  std::vector<size_t> width(cells[0].size(), 0);
+  for (auto it = cells.begin(); it != cells.end(); ++it) {
+    for (size_t c = 0; c < it->size(); c++) {
+      width[c] = std::max(width[c], (*it)[c].size());
+    }
+  }
+
+  std::vector<std::string> lines;
+  for (auto it = cells.begin(); it != cells.end(); ++it) {
+    std::string line;
+    for (size_t c = 0; c < it->size(); c++) {
+      line += (*it)[c];
+      if (c + 1 < it->size()) {
+        line += std::string(width[c] - (*it)[c].size() + 2, ' ');
+      }
+    }
+    lines.push_back(line);
+  }
+
+  return lines;
+}
@@ -0,0 +1,197 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsdag.h"
+
+namespace {
+
+//! records execution order and peak concurrency of test actions
+struct tracker {
+  std::mutex mtx;
+  std::vector<size_t> started;
+  std::vector<size_t> finished;
+  int running = 0;
+  int peak = 0;
+
+  int run(size_t i, int sleep_ms, int sts) {
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      started.push_back(i);
+      if (++running > peak) {
+        peak = running;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms));
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      running--;
+      finished.push_back(i);
+    }
+    return sts;
+  }
+
+  size_t pos(const std::vector<size_t>& v, size_t i) {
+    for (size_t k = 0; k < v.size(); k++) {
+      if (v[k] == i) {
+        return k;
+      }
+    }
+    return v.size();
+  }
+};
+
+void nodone(size_t, int) {
+}
+
+}  // namespace
+
+TEST(ActionDag, sequential_by_default) {
+  rvs::actiondag dag;
+  tracker t;
+  for (int i = 0; i < 4; i++) {
+    dag.add("a" + std::to_string(i), "", {});
+  }
+  std::string err;
+  ASSERT_EQ(dag.build(&err), 0);
+
+  EXPECT_EQ(dag.run(0, [&](size_t i) { return t.run(i, 5, 0); }, nodone), 0);
+  EXPECT_EQ(t.peak, 1);
+  EXPECT_EQ(t.started, std::vector<size_t>({0, 1, 2, 3}));
+  for (size_t i = 0; i < dag.size(); i++) {
+    EXPECT_EQ(dag.state(i), rvs::actiondag::state_done);
+  }
+}
+
+TEST(ActionDag, parallel_group) {
+  rvs::actiondag dag;
+  tracker t;
+  dag.add("first", "", {});
+  dag.add("gm", "stress", {});
+  dag.add("gst", "stress", {});
+  dag.add("babel", "stress", {});
+  dag.add("last", "", {});
+  std::string err;
+  ASSERT_EQ(dag.build(&err), 0);
+  EXPECT_EQ(dag.preds(4), std::vector<size_t>({1, 2, 3}));
+
+  EXPECT_EQ(dag.run(0, [&](size_t i) { return t.run(i, 50, 0); }, nodone), 0);
+  EXPECT_EQ(t.peak, 3);
+  EXPECT_EQ(t.started.front(), 0u);
+  EXPECT_EQ(t.started.back(), 4u);
+  EXPECT_EQ(t.finished.back(), 4u);
+}
+
+TEST(ActionDag, depends_on) {
+  rvs::actiondag dag;
+  tracker t;
+  dag.add("stress", "", {});
+  dag.add("peqt", "", {"setup"});
+  dag.add("smqt", "", {"setup"});
+  dag.add("setup", "", {"stress"});
+  dag.add("report", "", {"peqt", "smqt"});
+  std::string err;
+  ASSERT_EQ(dag.build(&err), 0);
+
+  EXPECT_EQ(dag.run(0, [&](size_t i) { return t.run(i, 20, 0); }, nodone), 0);
+  EXPECT_LT(t.pos(t.finished, 0), t.pos(t.started, 3));
+  EXPECT_LT(t.pos(t.finished, 3), t.pos(t.started, 1));
+  EXPECT_LT(t.pos(t.finished, 3), t.pos(t.started, 2));
+  EXPECT_LT(t.pos(t.finished, 1), t.pos(t.started, 4));
+  EXPECT_LT(t.pos(t.finished, 2), t.pos(t.started, 4));
+  EXPECT_EQ(t.peak, 2);
+}
+
+TEST(ActionDag, concurrency_limit) {
+  rvs::actiondag dag;
+  tracker t;
+  for (int i = 0; i < 8; i++) {
+    dag.add("a" + std::to_string(i), "all", {});
+  }
+  std::string err;
+  ASSERT_EQ(dag.build(&err), 0);
+
+  EXPECT_EQ(dag.run(3, [&](size_t i) { return t.run(i, 20, 0); }, nodone), 0);
+  EXPECT_EQ(t.peak, 3);
+  EXPECT_EQ(t.finished.size(), 8u);
+}
+
+TEST(ActionDag, failure_cancels_pending) {
+  rvs::actiondag dag;
+  tracker t;
+  dag.add("fail", "g", {});
+  dag.add("slow", "g", {});
+  dag.add("after", "", {});
+  std::string err;
+  ASSERT_EQ(dag.build(&err), 0);
+
+  std::vector<size_t> done_order;
+  std::mutex done_mtx;
+  int sts = dag.run(0,
+    [&](size_t i) { return t.run(i, i == 0 ? 5 : 50, i == 0 ? -3 : 0); },
+    [&](size_t i, int) {
+      std::lock_guard<std::mutex> lk(done_mtx);
+      done_order.push_back(i);
+    });
+
+  EXPECT_EQ(sts, -3);
+  EXPECT_EQ(dag.state(0), rvs::actiondag::state_failed);
+  // already running action is left to complete
+  EXPECT_EQ(dag.state(1), rvs::actiondag::state_done);
+  EXPECT_EQ(dag.state(2), rvs::actiondag::state_cancelled);
+  EXPECT_EQ(done_order, std::vector<size_t>({0, 1}));
+  EXPECT_EQ(t.started.size(), 2u);
+}
+
+TEST(ActionDag, invalid_graph) {
+  std::string err;
+
+  rvs::actiondag unknown;
+  unknown.add("a", "", {"b"});
+  EXPECT_NE(unknown.build(&err), 0);
+  EXPECT_NE(err.find("unknown action 'b'"), std::string::npos);
+
+  rvs::actiondag ambiguous;
+  ambiguous.add("a", "", {});
+  ambiguous.add("a", "", {});
+  ambiguous.add("b", "", {"a"});
+  EXPECT_NE(ambiguous.build(&err), 0);
+  EXPECT_NE(err.find("ambiguous"), std::string::npos);
+
+  rvs::actiondag cycle;
+  cycle.add("a", "", {"c"});
+  cycle.add("b", "", {"a"});
+  cycle.add("c", "", {"b"});
+  EXPECT_NE(cycle.build(&err), 0);
+  EXPECT_NE(err.find("cycle"), std::string::npos);
+}
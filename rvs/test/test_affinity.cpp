@@ -0,0 +1,190 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsaffinity.h"
+#include "include/rvstopology.h"
+#include "include/rvsthreadbase.h"
+
+// fake sysfs tree: two NUMA nodes (KFD CPU nodes 0 and 1) and two GPUs,
+// one with PCI numa_node set and one with PCI numa_node -1
+class AffinityTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/rvs_sysfs_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(tmpl));
+    root = tmpl;
+
+    std::string nodes = "/class/kfd/kfd/topology/nodes/";
+    put(nodes + "0/gpu_id", "0");
+    put(nodes + "0/properties", "cpu_cores_count 8\nsimd_count 0\n");
+    put(nodes + "1/gpu_id", "0");
+    put(nodes + "1/properties", "cpu_cores_count 4\nsimd_count 0\n");
+    put(nodes + "2/gpu_id", "1234");
+    put(nodes + "2/properties", "simd_count 256\nlocation_id 768\n"
+                                "domain 0\n");
+    put(nodes + "2/io_links/0/properties", "type 2\nnode_from 2\n"
+                                           "node_to 0\n");
+    put(nodes + "3/gpu_id", "5678");
+    put(nodes + "3/properties", "simd_count 256\nlocation_id 41009\n"
+                                "domain 1\n");
+    put(nodes + "3/io_links/0/properties", "type 2\nnode_from 3\n"
+                                           "node_to 1\n");
+    put("/bus/pci/devices/0000:03:00.0/numa_node", "1");
+    put("/bus/pci/devices/0001:a0:06.1/numa_node", "-1");
+    put("/devices/system/node/node0/cpulist", "0-3,8-11");
+    put("/devices/system/node/node1/cpulist", "4-7");
+
+    rvs::topology::set_sysfs_root(root);
+  }
+
+  void TearDown() override {
+    rvs::topology::set_sysfs_root("");
+    std::string cmd = "rm -rf " + root;
+    EXPECT_EQ(0, system(cmd.c_str()));
+  }
+
+  void put(const std::string& path, const std::string& content) {
+    std::string dir = root + path.substr(0, path.rfind('/'));
+    std::string cmd = "mkdir -p " + dir;
+    ASSERT_EQ(0, system(cmd.c_str()));
+    std::ofstream f(root + path);
+    f << content << "\n";
+  }
+
+  std::string root;
+};
+
+TEST(Affinity, cpulist) {
+  std::vector<int> cpus;
+
+  EXPECT_EQ(0, rvs::affinity::parse_cpulist("8-11, 0-3,2", &cpus));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 9, 10, 11}), cpus);
+  EXPECT_EQ("0-3,8-11", rvs::affinity::cpulist(cpus));
+  EXPECT_EQ("5", rvs::affinity::cpulist({5}));
+  EXPECT_EQ("1,3-4,6", rvs::affinity::cpulist({1, 3, 4, 6}));
+
+  EXPECT_NE(0, rvs::affinity::parse_cpulist("3-1", &cpus));
+  EXPECT_NE(0, rvs::affinity::parse_cpulist("a", &cpus));
+  EXPECT_NE(0, rvs::affinity::parse_cpulist("1-2-3", &cpus));
+  EXPECT_NE(0, rvs::affinity::parse_cpulist("100000", &cpus));
+}
+
+TEST(Affinity, policy) {
+  rvs::affinitypolicy policy;
+  std::vector<int> cpus;
+
+  EXPECT_EQ(0, rvs::affinity::parse("none", &policy, &cpus));
+  EXPECT_EQ(rvs::affinitypolicy::NONE, policy);
+  EXPECT_EQ(0, rvs::affinity::parse("numa", &policy, &cpus));
+  EXPECT_EQ(rvs::affinitypolicy::NUMA, policy);
+  EXPECT_EQ(0, rvs::affinity::parse("2,4-5", &policy, &cpus));
+  EXPECT_EQ(rvs::affinitypolicy::CPUSET, policy);
+  EXPECT_EQ(std::vector<int>({2, 4, 5}), cpus);
+  EXPECT_NE(0, rvs::affinity::parse("local", &policy, &cpus));
+  EXPECT_NE(0, rvs::affinity::parse("", &policy, &cpus));
+}
+
+TEST_F(AffinityTest, numa_node_from_pci) {
+  int node = -1;
+  std::vector<int> cpus;
+
+  // PCI numa_node wins over the KFD io_link
+  ASSERT_EQ(0, rvs::affinity::device_numa_node(1234, &node));
+  EXPECT_EQ(1, node);
+  ASSERT_EQ(0, rvs::affinity::node_cpus(node, &cpus));
+  EXPECT_EQ(std::vector<int>({4, 5, 6, 7}), cpus);
+}
+
+TEST_F(AffinityTest, numa_node_from_kfd_link) {
+  int node = -1;
+  std::vector<int> cpus;
+
+  // PCI numa_node of 0001:a0:06.1 is -1, CPU node the GPU links to is used
+  ASSERT_EQ(0, rvs::affinity::device_numa_node(5678, &node));
+  EXPECT_EQ(1, node);
+
+  put("/class/kfd/kfd/topology/nodes/3/io_links/0/properties", "node_to 0");
+  // KFD topology is a snapshot, re-read it
+  rvs::topology::refresh();
+  ASSERT_EQ(0, rvs::affinity::device_numa_node(5678, &node));
+  EXPECT_EQ(0, node);
+  ASSERT_EQ(0, rvs::affinity::node_cpus(node, &cpus));
+  EXPECT_EQ("0-3,8-11", rvs::affinity::cpulist(cpus));
+}
+
+TEST_F(AffinityTest, unknown) {
+  int node = -1;
+  std::vector<int> cpus;
+
+  EXPECT_NE(0, rvs::affinity::device_numa_node(999, &node));
+  EXPECT_NE(0, rvs::affinity::device_numa_node(0, &node));
+  EXPECT_NE(0, rvs::affinity::node_cpus(7, &cpus));
+}
+
+class pinned_thread : public rvs::ThreadBase {
+ public:
+  cpu_set_t set;
+  void run() {
+    CPU_ZERO(&set);
+    pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+};
+
+TEST(Affinity, thread_pinned) {
+  std::vector<int> cpus;
+  cpu_set_t set;
+
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(set), &set));
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+      break;
+    }
+  }
+  ASSERT_EQ(1u, cpus.size());
+
+  pinned_thread t;
+  t.set_cpu_affinity(cpus);
+  t.start();
+  t.join();
+  EXPECT_EQ(1, CPU_COUNT(&t.set));
+  EXPECT_TRUE(CPU_ISSET(cpus[0], &t.set));
+
+  // no restriction by default
+  pinned_thread u;
+  u.start();
+  u.join();
+  EXPECT_EQ(CPU_COUNT(&set), CPU_COUNT(&u.set));
+}
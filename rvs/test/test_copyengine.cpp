@@ -0,0 +1,206 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvscopyengine.h"
+
+namespace {
+
+/**
+ * Simulated DMA link: copies in one direction run one at a time at a fixed
+ * rate, a copy starts no earlier than launch_ns after it is issued and
+ * after its dependency, the host needs wake_ns to notice a completion.
+ */
+class fakelink : public rvs::copybackend {
+ public:
+  fakelink(double ns_per_byte, uint64_t launch_ns, uint64_t wake_ns)
+    : ns_per_byte(ns_per_byte), launch_ns(launch_ns), wake_ns(wake_ns) {}
+
+  int issue(int Dir, int Slot, size_t Size, int DepSlot) override {
+    if (fail_at >= 0 && static_cast<int>(copies[Dir].size()) == fail_at) {
+      return -1;
+    }
+
+    slot_t& s = slots[Dir][Slot];
+    // copy issued after the previous use of this slot depends on its
+    // signal and must be done before the signal is re-armed
+    if (s.seq >= 0) {
+      EXPECT_TRUE(copies[Dir][s.seq].waited) << "slot " << Slot;
+      if (s.seq + 1 < static_cast<int>(copies[Dir].size())) {
+        EXPECT_TRUE(copies[Dir][s.seq + 1].waited) << "slot " << Slot;
+      }
+    }
+
+    copy_t c;
+    c.start = host + launch_ns;
+    if (DepSlot >= 0) {
+      const copy_t& dep = copies[Dir][slots[Dir][DepSlot].seq];
+      EXPECT_EQ(copies[Dir].size() - 1, slots[Dir][DepSlot].seq);
+      c.start = std::max(c.start, dep.end);
+    } else {
+      EXPECT_TRUE(copies[Dir].empty());
+    }
+    c.start = std::max(c.start, engine_free[Dir]);
+    c.end = c.start + static_cast<uint64_t>(Size * ns_per_byte);
+    engine_free[Dir] = c.end;
+
+    s.seq = copies[Dir].size();
+    copies[Dir].push_back(c);
+    in_flight[Dir]++;
+    max_in_flight = std::max(max_in_flight, in_flight[Dir]);
+    return 0;
+  }
+
+  int wait(int Dir, int Slot, uint64_t* pStart, uint64_t* pEnd) override {
+    copy_t& c = copies[Dir][slots[Dir][Slot].seq];
+    EXPECT_FALSE(c.waited);
+    c.waited = true;
+    in_flight[Dir]--;
+    host = std::max(host, c.end) + wake_ns;
+    *pStart = c.start;
+    *pEnd = c.end;
+    return 0;
+  }
+
+  struct copy_t {
+    uint64_t start = 0;
+    uint64_t end = 0;
+    bool waited = false;
+  };
+  struct slot_t {
+    int seq = -1;
+  };
+
+  double ns_per_byte;
+  uint64_t launch_ns;
+  uint64_t wake_ns;
+  uint64_t host = 0;
+  uint64_t engine_free[2] = {0, 0};
+  slot_t slots[2][64];
+  std::vector<copy_t> copies[2];
+  int in_flight[2] = {0, 0};
+  int max_in_flight = 0;
+  int fail_at = -1;
+};
+
+// 10 GB/s link, 5 us launch latency, 2 us host wake up
+const double kNsPerByte = 0.1;
+const uint64_t kLaunch = 5000;
+const uint64_t kWake = 2000;
+
+}  // namespace
+
+TEST(CopyEngine, depth_one_measures_launch_latency) {
+  fakelink link(kNsPerByte, kLaunch, kWake);
+  rvs::copyengine engine(&link, 1);
+  rvs::copystats_t stats;
+
+  ASSERT_EQ(0, engine.run(64 * 1024, 100, false, &stats));
+  EXPECT_EQ(1, link.max_in_flight);
+  EXPECT_EQ(100u, link.copies[0].size());
+
+  // every copy waits for the host: 6.5 us copy + 7 us launch and wake up
+  double gbps = stats.bytes / stats.duration / 1e9;
+  EXPECT_LT(gbps, 5.0);
+  EXPECT_NEAR(6.5536e-6, stats.latency, 1e-9);
+}
+
+TEST(CopyEngine, depth_keeps_link_busy) {
+  for (unsigned int depth : {4u, 16u}) {
+    fakelink link(kNsPerByte, kLaunch, kWake);
+    rvs::copyengine engine(&link, depth);
+    rvs::copystats_t stats;
+
+    ASSERT_EQ(0, engine.run(64 * 1024, 100, false, &stats));
+    EXPECT_EQ(static_cast<int>(depth), link.max_in_flight);
+    EXPECT_EQ(100u, link.copies[0].size());
+    EXPECT_EQ(100u, stats.copies);
+    EXPECT_EQ(99u * 64 * 1024, stats.bytes);
+
+    // copies run back to back, throughput is that of the link
+    double gbps = stats.bytes / stats.duration / 1e9;
+    EXPECT_NEAR(10.0, gbps, 0.01) << "depth " << depth;
+    EXPECT_NEAR(6.5536e-6, stats.latency, 1e-9);
+  }
+}
+
+TEST(CopyEngine, throughput_grows_with_depth) {
+  double last = 0;
+  for (unsigned int depth = 1; depth <= 4; depth++) {
+    fakelink link(kNsPerByte, kLaunch, kWake);
+    rvs::copyengine engine(&link, depth);
+    rvs::copystats_t stats;
+
+    ASSERT_EQ(0, engine.run(64 * 1024, 100, false, &stats));
+    double gbps = stats.bytes / stats.duration / 1e9;
+    EXPECT_GE(gbps, last) << "depth " << depth;
+    last = gbps;
+  }
+}
+
+TEST(CopyEngine, bidirectional) {
+  fakelink link(kNsPerByte, kLaunch, kWake);
+  rvs::copyengine engine(&link, 4);
+  rvs::copystats_t stats;
+
+  ASSERT_EQ(0, engine.run(1024 * 1024, 20, true, &stats));
+  EXPECT_EQ(20u, link.copies[0].size());
+  EXPECT_EQ(20u, link.copies[1].size());
+  for (int dir = 0; dir < 2; dir++) {
+    for (const auto& c : link.copies[dir]) {
+      EXPECT_TRUE(c.waited);
+    }
+  }
+  // per direction throughput
+  EXPECT_NEAR(10.0, stats.bytes / stats.duration / 1e9, 0.01);
+}
+
+TEST(CopyEngine, single_copy) {
+  fakelink link(kNsPerByte, kLaunch, kWake);
+  rvs::copyengine engine(&link, 8);
+  rvs::copystats_t stats;
+
+  ASSERT_EQ(0, engine.run(1000000, 1, false, &stats));
+  EXPECT_EQ(1000000u, stats.bytes);
+  EXPECT_NEAR(100e-6, stats.duration, 1e-9);
+  EXPECT_NEAR(100e-6, stats.latency, 1e-9);
+
+  EXPECT_NE(0, engine.run(1000000, 0, false, &stats));
+}
+
+TEST(CopyEngine, error_drains_copies_in_flight) {
+  fakelink link(kNsPerByte, kLaunch, kWake);
+  link.fail_at = 10;
+  rvs::copyengine engine(&link, 4);
+  rvs::copystats_t stats;
+
+  EXPECT_NE(0, engine.run(4096, 100, true, &stats));
+  EXPECT_EQ(10u, link.copies[0].size());
+  EXPECT_EQ(0, link.in_flight[0]);
+  EXPECT_EQ(0, link.in_flight[1]);
+}
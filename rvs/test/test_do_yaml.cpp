@@ -0,0 +1,89 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsexec.h"
+
+namespace {
+
+//! exposes do_yaml() to the test
+class exec_yaml : public rvs::exec {
+ public:
+  using rvs::exec::do_yaml;
+};
+
+std::string last_log;
+
+void results_cb(const rvs_results_t* results, int) {
+  if (results->output_log) {
+    last_log = results->output_log;
+  }
+}
+
+}  // namespace
+
+TEST(DoYaml, action_without_depends_on) {
+  // first action has no depends_on key; the second one names an unknown
+  // action so the run ends at dependency resolution, before any module
+  // is loaded
+  const char* config =
+    "actions:\n"
+    "- name: first\n"
+    "  module: gpup\n"
+    "- name: second\n"
+    "  module: gpup\n"
+    "  depends_on: [ghost]\n";
+
+  exec_yaml e;
+  e.set_callback(results_cb, 0);
+  last_log.clear();
+
+  int sts = 0;
+  EXPECT_NO_THROW(sts = e.do_yaml(rvs::yaml_data_type_t::YAML_STRING, config));
+  EXPECT_NE(sts, 0);
+  EXPECT_NE(last_log.find("ghost"), std::string::npos) << last_log;
+}
+
+TEST(DoYaml, scalar_depends_on) {
+  const char* config =
+    "actions:\n"
+    "- name: first\n"
+    "  module: gpup\n"
+    "- name: second\n"
+    "  module: gpup\n"
+    "  depends_on: first, ghost\n";
+
+  exec_yaml e;
+  e.set_callback(results_cb, 0);
+  last_log.clear();
+
+  int sts = 0;
+  EXPECT_NO_THROW(sts = e.do_yaml(rvs::yaml_data_type_t::YAML_STRING, config));
+  EXPECT_NE(sts, 0);
+  EXPECT_NE(last_log.find("ghost"), std::string::npos) << last_log;
+}
@@ -0,0 +1,165 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvserrring.h"
+
+namespace {
+
+// ring in heap memory standing in for host memory mapped to the device
+class ErrRingTest : public ::testing::Test {
+ protected:
+  void make(uint64_t capacity) {
+    mem.assign(rvs::errharvester::size(capacity) / sizeof(uint64_t), 0);
+    ring = reinterpret_cast<rvs::errring_t*>(mem.data());
+    rvs::errharvester::init(ring, capacity);
+  }
+
+  static rvs::errrecord_t rec(uint64_t n) {
+    return rvs::errrecord_t{0x7f0000000000ull + n * 8, n, ~n, n};
+  }
+
+  std::vector<uint64_t> mem;
+  rvs::errring_t* ring = nullptr;
+};
+
+}  // namespace
+
+TEST_F(ErrRingTest, order) {
+  make(16);
+  std::vector<rvs::errrecord_t> got;
+  rvs::errharvester h(ring, [&](const rvs::errrecord_t& r) {
+    got.push_back(r);
+  });
+
+  EXPECT_EQ(0u, h.harvest());
+  for (uint64_t n = 0; n < 10; n++) {
+    rvs::errharvester::append(ring, rec(n));
+  }
+  EXPECT_EQ(10u, h.produced());
+  EXPECT_EQ(10u, h.harvest());
+  ASSERT_EQ(10u, got.size());
+  for (uint64_t n = 0; n < 10; n++) {
+    EXPECT_EQ(rec(n).address, got[n].address);
+    EXPECT_EQ(n, got[n].expected);
+    EXPECT_EQ(~n, got[n].actual);
+    EXPECT_EQ(n, got[n].reread);
+  }
+
+  // slots are reused once harvested
+  for (uint64_t n = 10; n < 30; n++) {
+    rvs::errharvester::append(ring, rec(n));
+    if (n % 8 == 0) {
+      h.harvest();
+    }
+  }
+  h.harvest();
+  EXPECT_EQ(30u, h.harvested());
+  EXPECT_EQ(0u, h.lost());
+  EXPECT_EQ(rec(29).address, got.back().address);
+}
+
+// producers never wait: the oldest records are lost, the count is exact
+TEST_F(ErrRingTest, overflow) {
+  make(8);
+  std::vector<uint64_t> got;
+  rvs::errharvester h(ring, [&](const rvs::errrecord_t& r) {
+    got.push_back(r.expected);
+  });
+
+  for (uint64_t n = 0; n < 20; n++) {
+    rvs::errharvester::append(ring, rec(n));
+  }
+  EXPECT_EQ(8u, h.harvest());
+  EXPECT_EQ(20u, h.produced());
+  EXPECT_EQ(12u, h.lost());
+  EXPECT_EQ((std::vector<uint64_t>{12, 13, 14, 15, 16, 17, 18, 19}), got);
+}
+
+// a claimed but unpublished record stops harvesting until published
+TEST_F(ErrRingTest, unpublished) {
+  make(8);
+  size_t cnt = 0;
+  rvs::errharvester h(ring, [&](const rvs::errrecord_t&) { cnt++; });
+
+  rvs::errharvester::append(ring, rec(0));
+  ring->head++;  // record 1 claimed
+  rvs::errharvester::append(ring, rec(2));
+  EXPECT_EQ(1u, h.harvest());
+
+  rvs::errslot_t* slot = RVS_ERRRING_SLOT(ring, 1);
+  slot->rec = rec(1);
+  slot->seq = 2;
+  EXPECT_EQ(2u, h.harvest());
+  EXPECT_EQ(3u, cnt);
+  EXPECT_EQ(0u, h.lost());
+}
+
+// concurrent producers with the background harvester: every record is
+// either harvested once or counted as lost
+TEST_F(ErrRingTest, concurrent) {
+  const int producers = 8;
+  const uint64_t per_producer = 20000;
+
+  for (uint64_t capacity : {1024ull, 1024ull * 1024}) {
+    make(capacity);
+    std::set<uint64_t> seen;
+    bool bad = false;
+    rvs::errharvester h(ring, [&](const rvs::errrecord_t& r) {
+      // fields of a record must not mix
+      bad |= r.actual != ~r.expected || r.reread != r.expected;
+      bad |= !seen.insert(r.expected).second;
+    });
+
+    h.start(1);
+    std::vector<std::thread> thrds;
+    for (int p = 0; p < producers; p++) {
+      thrds.push_back(std::thread([&, p] {
+        for (uint64_t k = 0; k < per_producer; k++) {
+          rvs::errharvester::append(ring, rec((uint64_t(p) << 32) | k));
+        }
+      }));
+    }
+    for (auto& t : thrds) {
+      t.join();
+    }
+    h.stop();
+
+    EXPECT_FALSE(bad);
+    EXPECT_EQ(producers * per_producer, h.produced());
+    EXPECT_EQ(h.produced(), h.harvested() + h.lost());
+    if (capacity >= producers * per_producer) {
+      EXPECT_EQ(0u, h.lost());
+    }
+  }
+}
@@ -23,11 +23,16 @@
  *
  *******************************************************************************/
 
+#include <stdlib.h>
+
+#include <fstream>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
 
 #include "include/gpu_util.h"
+#include "include/rvstopology.h"
 #include "include/rvs_unit_testing_defs.h"
 
 using rvs::gpulist;
@@ -39,14 +44,41 @@ class GpuUtilTest : public ::testing::Test , public rvs::gpulist {
     gpu_id      = {1, 2, 5, 4, 9, 7};
     device_id   = {3, 0, 2, 7, 5, 1};
     node_id     = {2, 1, 3, 7, 4, 9};
+
+    // fake KFD topology holding the GPUs above
+    char tmpl[] = "/tmp/rvs_sysfs_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(tmpl));
+    root = tmpl;
+    for (size_t i = 0; i < gpu_id.size(); i++) {
+      std::string node = root + RVS_KFD_NODES_PATH + "/" +
+                         std::to_string(node_id[i]);
+      std::string cmd = "mkdir -p " + node;
+      ASSERT_EQ(0, system(cmd.c_str()));
+      std::ofstream(node + "/gpu_id") << gpu_id[i] << "\n";
+      std::ofstream(node + "/properties")
+        << "location_id " << location_id[i] << "\n"
+        << "device_id " << device_id[i] << "\n";
+    }
+    rvs::topology::set_sysfs_root(root);
+    ASSERT_EQ(0, Initialize());
   }
 
   void TearDown() override {
+    rvs::topology::set_sysfs_root("");
+    std::string cmd = "rm -rf " + root;
+    EXPECT_EQ(0, system(cmd.c_str()));
+
     location_id.clear();
     gpu_id.clear();
     device_id.clear();
     node_id.clear();
   }
+
+  std::vector<uint16_t> location_id;
+  std::vector<uint16_t> gpu_id;
+  std::vector<uint16_t> device_id;
+  std::vector<uint16_t> node_id;
+  std::string root;
 };
 
 TEST_F(GpuUtilTest, gpu_util) {
@@ -0,0 +1,273 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsjob.h"
+
+namespace {
+
+//! job server running fake jobs instead of rvs command lines
+class testserver : public rvs::jobserver {
+ public:
+  testserver() : block(false), cancelled(false) {}
+
+  //! 'true' to block jobs until cancelled
+  std::atomic<bool> block;
+  std::atomic<bool> cancelled;
+
+ protected:
+  int execute(int argc, char** argv) override {
+    printf("job");
+    for (int i = 1; i < argc; i++) {
+      printf(" %s", argv[i]);
+    }
+    printf("\n");
+    fflush(stdout);
+    fprintf(stderr, "done\n");
+    while (block && !cancelled) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return argc - 1;
+  }
+
+  void cancel() override {
+    cancelled = true;
+  }
+};
+
+//! reads everything written to file so far
+std::string contents(int fd) {
+  std::string s;
+  char buff[256];
+  ssize_t n;
+  lseek(fd, 0, SEEK_SET);
+  while ((n = read(fd, buff, sizeof(buff))) > 0) {
+    s.append(buff, n);
+  }
+  return s;
+}
+
+}  // namespace
+
+class JobServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = "/tmp/rvsd_test_" + std::to_string(getpid()) + ".sock";
+    ASSERT_EQ(server.listen(path), 0);
+    thread = std::thread([this] { server.serve(); });
+  }
+
+  void TearDown() override {
+    server.stop();
+    thread.join();
+  }
+
+  std::string path;
+  testserver server;
+  std::thread thread;
+};
+
+TEST_F(JobServerTest, runs_jobs_and_streams_output) {
+  char tmpl[] = "/tmp/rvsd_test_out_XXXXXX";
+  int out_fd = mkstemp(tmpl);
+  ASSERT_GE(out_fd, 0);
+  unlink(tmpl);
+
+  const char* args1[] = {"rvs", "-c", "conf/gpup_single.conf"};
+  const char* args2[] = {"rvs", "-c", "conf/peqt_single.conf", "-d", "3"};
+  int status = 0;
+
+  ASSERT_EQ(rvs::jobclient::run(path, 3, const_cast<char**>(args1), out_fd,
+                                &status), 0);
+  EXPECT_EQ(status, 2);
+  ASSERT_EQ(rvs::jobclient::run(path, 5, const_cast<char**>(args2), out_fd,
+                                &status), 0);
+  EXPECT_EQ(status, 4);
+
+  // both jobs ran in the same server
+  EXPECT_EQ(server.jobs(), 2u);
+  EXPECT_EQ(contents(out_fd),
+            "job -c conf/gpup_single.conf\ndone\n"
+            "job -c conf/peqt_single.conf -d 3\ndone\n");
+  close(out_fd);
+}
+
+TEST_F(JobServerTest, second_server_refused) {
+  rvs::jobserver other;
+  EXPECT_NE(other.listen(path), 0);
+}
+
+TEST_F(JobServerTest, client_gone_cancels_job) {
+  server.block = true;
+
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_EQ(connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                    sizeof(addr)), 0);
+  ASSERT_EQ(rvs::job::send_msg(fd, rvs::job::msg_cwd, "/", 1), 0);
+  ASSERT_EQ(rvs::job::send_msg(fd, rvs::job::msg_run, nullptr, 0), 0);
+
+  // wait for the job to start, then go away
+  rvs::job::msg_t type;
+  std::string data;
+  ASSERT_EQ(rvs::job::recv_msg(fd, &type, &data), 0);
+  EXPECT_EQ(type, rvs::job::msg_output);
+  close(fd);
+
+  for (int i = 0; i < 5000 && !server.cancelled; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(server.cancelled);
+}
+
+TEST(JobClient, no_server) {
+  const char* args[] = {"rvs"};
+  int status = 0;
+  EXPECT_NE(rvs::jobclient::run("/tmp/rvsd_test_none.sock", 1,
+                                const_cast<char**>(args), STDOUT_FILENO,
+                                &status), 0);
+}
+
+TEST(JobClient, socket_path) {
+  const char* sock = getenv(RVSD_SOCKET_ENV);
+  const char* xdg = getenv("XDG_RUNTIME_DIR");
+  std::string saved_sock = sock ? sock : "";
+  std::string saved_xdg = xdg ? xdg : "";
+
+  unsetenv(RVSD_SOCKET_ENV);
+  setenv("XDG_RUNTIME_DIR", "/run/user/1000", 1);
+  EXPECT_EQ(rvs::job::socket_path(), "/run/user/1000/rvsd.sock");
+
+  // never directly in world writable /tmp
+  unsetenv("XDG_RUNTIME_DIR");
+  EXPECT_EQ(rvs::job::socket_path(),
+            "/tmp/rvsd-" + std::to_string(geteuid()) + "/rvsd.sock");
+
+  setenv(RVSD_SOCKET_ENV, "/tmp/x.sock", 1);
+  EXPECT_EQ(rvs::job::socket_path(), "/tmp/x.sock");
+
+  if (sock) {
+    setenv(RVSD_SOCKET_ENV, saved_sock.c_str(), 1);
+  } else {
+    unsetenv(RVSD_SOCKET_ENV);
+  }
+  if (xdg) {
+    setenv("XDG_RUNTIME_DIR", saved_xdg.c_str(), 1);
+  }
+}
+
+TEST(JobServer, private_socket_dir) {
+  std::string dir = "/tmp/rvsd_test_dir_" + std::to_string(getpid());
+  struct stat st;
+
+  {
+    rvs::jobserver server;
+    ASSERT_EQ(server.listen(dir + "/rvsd.sock"), 0);
+    ASSERT_EQ(stat(dir.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0700u);
+  }
+  EXPECT_EQ(rmdir(dir.c_str()), 0);
+
+  // directory of another user is refused
+  if (geteuid() != 0) {
+    return;
+  }
+  ASSERT_EQ(mkdir(dir.c_str(), 0777), 0);
+  ASSERT_EQ(chown(dir.c_str(), 65534, 65534), 0);
+  {
+    rvs::jobserver server;
+    EXPECT_NE(server.listen(dir + "/rvsd.sock"), 0);
+  }
+  EXPECT_EQ(rmdir(dir.c_str()), 0);
+}
+
+// socket bound by another user first: client must not hand the job over
+TEST(JobClient, foreign_server_ignored) {
+  if (geteuid() != 0) {
+    GTEST_SKIP() << "needs root to run a server as another user";
+  }
+
+  char tmpl[] = "/tmp/rvsd_test_foreign_XXXXXX";
+  ASSERT_NE(mkdtemp(tmpl), nullptr);
+  ASSERT_EQ(chmod(tmpl, 0777), 0);
+  std::string path = std::string(tmpl) + "/rvsd.sock";
+
+  int ready[2];
+  ASSERT_EQ(pipe(ready), 0);
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // fake daemon reporting success for whatever it gets
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (setuid(65534) ||
+        bind(lfd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) ||
+        listen(lfd, 1) || write(ready[1], "x", 1) != 1) {
+      _exit(1);
+    }
+    int fd = accept(lfd, nullptr, nullptr);
+    int32_t sts = 0;
+    rvs::job::send_msg(fd, rvs::job::msg_status, &sts, sizeof(sts));
+    close(fd);
+    _exit(0);
+  }
+
+  char c;
+  ASSERT_EQ(read(ready[0], &c, 1), 1);
+  const char* args[] = {"rvs"};
+  int status = 1;
+  EXPECT_NE(rvs::jobclient::run(path, 1, const_cast<char**>(args),
+                                STDOUT_FILENO, &status), 0);
+  EXPECT_EQ(status, 1);
+
+  int wsts;
+  waitpid(pid, &wsts, 0);
+  close(ready[0]);
+  close(ready[1]);
+  unlink(path.c_str());
+  rmdir(tmpl);
+}
@@ -0,0 +1,148 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsjournal.h"
+
+class JournalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/rvs_journal_XXXXXX";
+    int fd = mkstemp(tmpl);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    fname = tmpl;
+  }
+
+  void TearDown() override {
+    unlink(fname.c_str());
+  }
+
+  size_t lines() {
+    std::ifstream in(fname);
+    std::string line;
+    size_t n = 0;
+    while (std::getline(in, line)) {
+      n++;
+    }
+    return n;
+  }
+
+  std::string fname;
+};
+
+TEST_F(JournalTest, resume_skips_completed) {
+  rvs::journal j;
+
+  ASSERT_EQ(j.open(fname, 0x1234, "1,2", false), 0);
+  EXPECT_EQ(j.record(0, "action_1", 0, "-"), 0);
+  EXPECT_EQ(j.record(1, "action_2", 0, "-"), 0);
+  EXPECT_EQ(j.record(2, "action_3", 1, "-"), 0);
+  j.close();
+
+  ASSERT_EQ(j.open(fname, 0x1234, "1,2", true), 0);
+  EXPECT_EQ(j.resumed(), 2u);
+  EXPECT_TRUE(j.completed(0, "action_1"));
+  EXPECT_TRUE(j.completed(1, "action_2"));
+  EXPECT_FALSE(j.completed(2, "action_3"));
+  EXPECT_FALSE(j.completed(3, "action_4"));
+  // same index, different action
+  EXPECT_FALSE(j.completed(1, "action_x"));
+
+  // failed action completes on resume, records are appended
+  EXPECT_EQ(j.record(2, "action_3", 0, "-"), 0);
+  j.close();
+  EXPECT_EQ(lines(), 5u);
+
+  ASSERT_EQ(j.open(fname, 0x1234, "1,2", true), 0);
+  EXPECT_TRUE(j.completed(2, "action_3"));
+}
+
+TEST_F(JournalTest, mismatch_refused) {
+  rvs::journal j;
+
+  ASSERT_EQ(j.open(fname, 0x1234, "1,2", false), 0);
+  EXPECT_EQ(j.record(0, "action_1", 0, "-"), 0);
+  j.close();
+
+  // different configuration: journal is kept as it is
+  EXPECT_EQ(j.open(fname, 0x5678, "1,2", true), -2);
+  EXPECT_FALSE(j.is_open());
+  EXPECT_EQ(j.resumed(), 0u);
+  EXPECT_EQ(lines(), 2u);
+
+  // different devices
+  EXPECT_EQ(j.open(fname, 0x1234, "1", true), -2);
+  EXPECT_EQ(lines(), 2u);
+
+  // not resuming: journal is started anew
+  ASSERT_EQ(j.open(fname, 0x5678, "1", false), 0);
+  EXPECT_FALSE(j.completed(0, "action_1"));
+  j.close();
+  EXPECT_EQ(lines(), 1u);
+
+  // empty file is not a journal either
+  { std::ofstream trunc(fname, std::ios::trunc); }
+  EXPECT_EQ(j.open(fname, 0x5678, "1", true), -2);
+}
+
+TEST_F(JournalTest, resume_without_journal) {
+  rvs::journal j;
+
+  unlink(fname.c_str());
+  ASSERT_EQ(j.open(fname, 0x1234, "1,2", true), 0);
+  EXPECT_EQ(j.resumed(), 0u);
+  EXPECT_EQ(j.record(0, "action_1", 0, "-"), 0);
+  j.close();
+  EXPECT_EQ(lines(), 2u);
+}
+
+TEST_F(JournalTest, metric_summary) {
+  rvs::journal::summary s;
+  EXPECT_EQ(s.str(), "-");
+
+  s.add("gflops", "GFLOPS", 2);
+  s.add("gflops", "GFLOPS", 4);
+  s.add("bandwidth", "GB/s", 10);
+  EXPECT_EQ(s.str(),
+            "bandwidth[GB/s] n=1 min=10.000 avg=10.000 max=10.000; "
+            "gflops[GFLOPS] n=2 min=2.000 avg=3.000 max=4.000");
+}
+
+TEST_F(JournalTest, hash) {
+  const char a[] = "actions:\n- name: action_1\n";
+  const char b[] = "actions:\n- name: action_2\n";
+  EXPECT_EQ(rvs::journal::hash(a, sizeof(a)), rvs::journal::hash(a, sizeof(a)));
+  EXPECT_NE(rvs::journal::hash(a, sizeof(a)), rvs::journal::hash(b, sizeof(b)));
+  // FNV-1a reference value
+  EXPECT_EQ(rvs::journal::hash("a", 1), 0xaf63dc4c8601ec8cULL);
+}
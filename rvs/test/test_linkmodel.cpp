@@ -0,0 +1,270 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvslinkmodel.h"
+#include "include/rvstopology.h"
+
+// link speed strings recorded from pci_caps and sysfs on Gen3, Gen4 and
+// Gen5 systems
+TEST(linkmodel, parse) {
+  double speed;
+  unsigned int width;
+
+  EXPECT_EQ(0, rvs::linkmodel::parse_speed("16 GT/s", &speed));
+  EXPECT_DOUBLE_EQ(16, speed);
+  EXPECT_EQ(0, rvs::linkmodel::parse_speed("32.0 GT/s PCIe", &speed));
+  EXPECT_DOUBLE_EQ(32, speed);
+  EXPECT_EQ(0, rvs::linkmodel::parse_speed("2.5 GT/s", &speed));
+  EXPECT_DOUBLE_EQ(2.5, speed);
+  EXPECT_NE(0, rvs::linkmodel::parse_speed("Unknown speed", &speed));
+  EXPECT_NE(0, rvs::linkmodel::parse_speed("8", &speed));
+
+  EXPECT_EQ(0, rvs::linkmodel::parse_width("x16", &width));
+  EXPECT_EQ(16u, width);
+  EXPECT_EQ(0, rvs::linkmodel::parse_width("8", &width));
+  EXPECT_EQ(8u, width);
+  EXPECT_NE(0, rvs::linkmodel::parse_width("x0", &width));
+  EXPECT_NE(0, rvs::linkmodel::parse_width("", &width));
+
+  EXPECT_DOUBLE_EQ(2.5, rvs::linkmodel::speed_from_code(1));
+  EXPECT_DOUBLE_EQ(16, rvs::linkmodel::speed_from_code(4));
+  EXPECT_DOUBLE_EQ(64, rvs::linkmodel::speed_from_code(6));
+  EXPECT_DOUBLE_EQ(0, rvs::linkmodel::speed_from_code(7));
+}
+
+TEST(linkmodel, pcie_bandwidth) {
+  auto bw = [](double speed, unsigned int width) {
+    rvs::linkhop_t hop{rvs::linktype::PCIE, speed, width, 0};
+    return rvs::linkmodel::hop_bandwidth(hop);
+  };
+
+  EXPECT_DOUBLE_EQ(4e9, bw(2.5, 16));
+  EXPECT_DOUBLE_EQ(8e9, bw(5, 16));
+  EXPECT_NEAR(15.754e9, bw(8, 16), 1e6);
+  EXPECT_NEAR(31.508e9, bw(16, 16), 1e6);
+  EXPECT_NEAR(15.754e9, bw(16, 8), 1e6);
+  EXPECT_NEAR(63.015e9, bw(32, 16), 1e6);
+  EXPECT_DOUBLE_EQ(121e9, bw(64, 16));
+
+  rvs::linkhop_t xgmi{rvs::linktype::XGMI, 0, 0, 50e9};
+  EXPECT_DOUBLE_EQ(50e9, rvs::linkmodel::hop_bandwidth(xgmi));
+  rvs::linkhop_t unknown{rvs::linktype::UNKNOWN, 0, 0, 0};
+  EXPECT_DOUBLE_EQ(0, rvs::linkmodel::hop_bandwidth(unknown));
+}
+
+TEST(linkmodel, estimate) {
+  rvs::linkhop_t gen4x16{rvs::linktype::PCIE, 16, 16, 0};
+  rvs::linkhop_t gen4x8{rvs::linktype::PCIE, 16, 8, 0};
+  rvs::linkhop_t gen3x16{rvs::linktype::PCIE, 8, 16, 0};
+  rvs::linkestimate_t est;
+
+  // healthy path: the slowest hop limits both estimates equally
+  rvs::linkmodel::estimate({gen4x16, gen3x16}, {gen4x16, gen3x16}, &est);
+  EXPECT_NEAR(15.754e9, est.expected, 1e6);
+  EXPECT_DOUBLE_EQ(est.expected, est.capable);
+  EXPECT_EQ(2u, est.hops);
+  EXPECT_EQ("", est.limit);
+
+  // Gen4 x16 device trained at x8
+  rvs::linkmodel::estimate({gen4x8}, {gen4x16}, &est);
+  EXPECT_NEAR(15.754e9, est.expected, 1e6);
+  EXPECT_NEAR(31.508e9, est.capable, 1e6);
+  EXPECT_EQ("x8 of x16", est.limit);
+
+  // Gen4 x16 device trained at Gen3 x8
+  rvs::linkhop_t gen3x8{rvs::linktype::PCIE, 8, 8, 0};
+  rvs::linkmodel::estimate({gen3x8}, {gen4x16}, &est);
+  EXPECT_NEAR(7.877e9, est.expected, 1e6);
+  EXPECT_EQ("x8 of x16, 8 GT/s of 16 GT/s", est.limit);
+
+  // XGMI peer reached through another GPU
+  rvs::linkhop_t xgmi{rvs::linktype::XGMI, 0, 0, 50e9};
+  rvs::linkmodel::estimate({xgmi, xgmi}, {xgmi}, &est);
+  EXPECT_DOUBLE_EQ(50e9, est.expected);
+  EXPECT_DOUBLE_EQ(50e9, est.capable);
+  EXPECT_EQ(2u, est.hops);
+  EXPECT_EQ("2 hops", est.limit);
+}
+
+// measured bandwidth against capability, per direction
+TEST(linkmodel, efficiency) {
+  rvs::linkestimate_t est{25e9, 50e9, 1, "x8 of x16"};
+  std::string text = "12.500 GBps";
+
+  EXPECT_DOUBLE_EQ(0.25, rvs::linkmodel::efficiency(est, 12.5, false, &text));
+  EXPECT_EQ("12.500 GBps  efficiency: 25.0% of 50.000 GBps", text);
+
+  // bidirectional bandwidth sums both directions
+  text.clear();
+  EXPECT_DOUBLE_EQ(0.5, rvs::linkmodel::efficiency(est, 50, true, &text));
+  EXPECT_EQ("  efficiency: 50.0% of 50.000 GBps", text);
+
+  // not measured, or capability unknown: no efficiency
+  text.clear();
+  EXPECT_EQ(-1, rvs::linkmodel::efficiency(est, 0, false, &text));
+  est.capable = 0;
+  EXPECT_EQ(-1, rvs::linkmodel::efficiency(est, 12.5, false, &text));
+  EXPECT_EQ("", text);
+}
+
+// fake sysfs tree: CPU node 0, GPU nodes 1-3 (Gen4 x16, Gen4 trained at x8,
+// Gen5 x16); GPUs 1 and 2 linked by XGMI, GPU 3 reaches them through GPU 1
+class LinkModelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/rvs_sysfs_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(tmpl));
+    root = tmpl;
+
+    std::string nodes = std::string(RVS_KFD_NODES_PATH) + "/";
+    put(nodes + "0/gpu_id", "0");
+    put(nodes + "0/properties", "cpu_cores_count 8\nsimd_count 0\n");
+    gpu(nodes, 1, 0x0300, "16.0 GT/s PCIe", "16", "16.0 GT/s PCIe", "16");
+    gpu(nodes, 2, 0x4300, "16.0 GT/s PCIe", "8", "16.0 GT/s PCIe", "16");
+    gpu(nodes, 3, 0x8300, "32.0 GT/s PCIe", "16", "32.0 GT/s PCIe", "16");
+    put(nodes + "1/io_links/1/properties", "type 11\nnode_from 1\n"
+                                           "node_to 2\nmax_bandwidth 50000\n");
+    put(nodes + "1/io_links/2/properties", "type 11\nnode_from 1\n"
+                                           "node_to 3\nmax_bandwidth 50000\n");
+    put(nodes + "2/io_links/1/properties", "type 11\nnode_from 2\n"
+                                           "node_to 1\nmax_bandwidth 50000\n");
+    put(nodes + "3/io_links/1/properties", "type 11\nnode_from 3\n"
+                                           "node_to 1\nmax_bandwidth 50000\n");
+
+    rvs::topology::set_sysfs_root(root);
+  }
+
+  void TearDown() override {
+    rvs::topology::set_sysfs_root("");
+    std::string cmd = "rm -rf " + root;
+    EXPECT_EQ(0, system(cmd.c_str()));
+  }
+
+  void gpu(const std::string& nodes, int node, uint16_t location,
+           const char* cur_speed, const char* cur_width,
+           const char* max_speed, const char* max_width) {
+    std::string n = nodes + std::to_string(node) + "/";
+    put(n + "gpu_id", std::to_string(1000 + node));
+    put(n + "properties", "simd_count 256\nlocation_id " +
+        std::to_string(location) + "\ndomain 0\n");
+    put(n + "io_links/0/properties", "type 2\nnode_from " +
+        std::to_string(node) + "\nnode_to 0\n");
+
+    char bdf[16];
+    snprintf(bdf, sizeof(bdf), "0000:%02x:%02x.%x", location >> 8,
+             (location >> 3) & 0x1f, location & 0x7);
+    std::string dev = std::string(RVS_PCI_DEVICES_PATH) + "/" + bdf + "/";
+    put(dev + "current_link_speed", cur_speed);
+    put(dev + "current_link_width", cur_width);
+    put(dev + "max_link_speed", max_speed);
+    put(dev + "max_link_width", max_width);
+  }
+
+  void put(const std::string& path, const std::string& content) {
+    std::string dir = root + path.substr(0, path.rfind('/'));
+    std::string cmd = "mkdir -p " + dir;
+    ASSERT_EQ(0, system(cmd.c_str()));
+    std::ofstream f(root + path);
+    f << content << "\n";
+  }
+
+  std::string root;
+};
+
+TEST_F(LinkModelTest, pcie) {
+  rvs::linkhop_t cur, cap;
+  rvs::linkestimate_t est;
+
+  ASSERT_EQ(0, rvs::linkmodel::pcie_hop(1001, &cur, &cap));
+  EXPECT_DOUBLE_EQ(16, cur.speed);
+  EXPECT_EQ(16u, cur.width);
+  rvs::linkmodel::estimate({cur}, {cap}, &est);
+  EXPECT_NEAR(31.508e9, est.expected, 1e6);
+  EXPECT_EQ("", est.limit);
+
+  ASSERT_EQ(0, rvs::linkmodel::pcie_hop(1002, &cur, &cap));
+  rvs::linkmodel::estimate({cur}, {cap}, &est);
+  EXPECT_NEAR(15.754e9, est.expected, 1e6);
+  EXPECT_NEAR(31.508e9, est.capable, 1e6);
+  EXPECT_EQ("x8 of x16", est.limit);
+
+  // Gen5 source to degraded Gen4 destination through the host
+  rvs::linkhop_t cur3, cap3;
+  ASSERT_EQ(0, rvs::linkmodel::pcie_hop(1003, &cur3, &cap3));
+  rvs::linkmodel::estimate({cur3, cur}, {cap3, cap}, &est);
+  EXPECT_NEAR(15.754e9, est.expected, 1e6);
+  EXPECT_NEAR(31.508e9, est.capable, 1e6);
+  EXPECT_EQ("x8 of x16", est.limit);
+
+  EXPECT_NE(0, rvs::linkmodel::pcie_hop(999, &cur, &cap));
+}
+
+TEST_F(LinkModelTest, xgmi) {
+  rvs::linkhop_t hop;
+
+  ASSERT_EQ(0, rvs::linkmodel::xgmi_hop(1, 2, &hop));
+  EXPECT_EQ(rvs::linktype::XGMI, hop.type);
+  EXPECT_DOUBLE_EQ(50e9, hop.bandwidth);
+
+  // no direct link between GPUs 2 and 3
+  ASSERT_EQ(1, rvs::linkmodel::xgmi_hop(2, 3, &hop));
+  EXPECT_DOUBLE_EQ(50e9, hop.bandwidth);
+
+  // CPU node has no XGMI link
+  EXPECT_EQ(-1, rvs::linkmodel::xgmi_hop(0, 1, &hop));
+}
+
+TEST_F(LinkModelTest, path) {
+  rvs::linkestimate_t est;
+
+  // host to degraded GPU
+  ASSERT_EQ(0, rvs::linkmodel::path_estimate(0, 2,
+                                             {rvs::linktype::PCIE}, &est));
+  EXPECT_NEAR(15.754e9, est.expected, 1e6);
+  EXPECT_EQ("x8 of x16", est.limit);
+
+  // XGMI peers through GPU 1
+  ASSERT_EQ(0, rvs::linkmodel::path_estimate(2, 3,
+               {rvs::linktype::XGMI, rvs::linktype::XGMI}, &est));
+  EXPECT_DOUBLE_EQ(50e9, est.expected);
+  EXPECT_EQ(2u, est.hops);
+  EXPECT_EQ("2 hops", est.limit);
+
+  // GPUs without direct link talking over PCIe
+  ASSERT_EQ(0, rvs::linkmodel::path_estimate(3, 2,
+               {rvs::linktype::PCIE, rvs::linktype::PCIE}, &est));
+  EXPECT_NEAR(15.754e9, est.expected, 1e6);
+  EXPECT_NEAR(31.508e9, est.capable, 1e6);
+
+  EXPECT_NE(0, rvs::linkmodel::path_estimate(0, 7,
+                                             {rvs::linktype::PCIE}, &est));
+}
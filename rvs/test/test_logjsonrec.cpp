@@ -0,0 +1,253 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvslognode.h"
+#include "include/rvslognodestring.h"
+#include "include/rvslognodeint.h"
+#include "include/rvslognodedouble.h"
+#include "include/rvslognodeuint64.h"
+#include "include/rvslognodebool.h"
+#include "include/rvslognoderec.h"
+#include "include/rvsminnode.h"
+#include "include/rvslogjsonrec.h"
+
+#define BENCH_RECORDS 200000
+
+// builds typical module record using node tree
+static std::string tree_record(int i) {
+  rvs::LogNodeRec* rec = new rvs::LogNodeRec("act", 3, 12, i);
+  rec->Add(new rvs::LogNodeString("action", "act", rec));
+  rec->Add(new rvs::LogNodeString("module", "gst", rec));
+  rec->Add(new rvs::LogNodeString("loglevelname", "INFO  ", rec));
+  rec->Add(new rvs::LogNodeString("gpu_id", "3241", rec));
+  rec->Add(new rvs::LogNodeString("gflops", "12345.678", rec));
+  rec->Add(new rvs::LogNodeInt("index", i, rec));
+  rvs::LogNode* n = new rvs::LogNode("link", rec);
+  rec->Add(n);
+  n->Add(new rvs::LogNodeInt("weight", -20, n));
+  n->Add(new rvs::LogNodeString("type", "XGMI", n));
+  rec->Add(new rvs::LogNodeString("pass", "true", rec));
+  std::string s = rec->ToJson("  ");
+  delete rec;
+  return s;
+}
+
+// builds the same record using streaming writer
+static void stream_record(int i, std::string* out) {
+  rvs::LogJsonRec* rec = rvs::LogJsonRec::Create(3, 12, i, false, false);
+  void* r = rec->Handle();
+  rvs::LogJsonRec::AddString(r, "action", "act");
+  rvs::LogJsonRec::AddString(r, "module", "gst");
+  rvs::LogJsonRec::AddString(r, "loglevelname", "INFO  ");
+  rvs::LogJsonRec::AddString(r, "gpu_id", "3241");
+  rvs::LogJsonRec::AddString(r, "gflops", "12345.678");
+  rvs::LogJsonRec::AddInt(r, "index", i);
+  void* n = rvs::LogJsonRec::CreateNode(r, "link");
+  rvs::LogJsonRec::AddNode(r, n);
+  rvs::LogJsonRec::AddInt(n, "weight", -20);
+  rvs::LogJsonRec::AddString(n, "type", "XGMI");
+  rvs::LogJsonRec::AddString(r, "pass", "true");
+  rec->ToJson(out);
+  rvs::LogJsonRec::Release(rec);
+}
+
+TEST(LogJsonRecTest, same_as_tree) {
+  for (int i = 0; i < 3; i++) {
+    std::string s;
+    stream_record(i, &s);
+    EXPECT_EQ(s, tree_record(i));
+  }
+}
+
+TEST(LogJsonRecTest, nested_after_add) {
+  rvs::LogNodeRec* tree = new rvs::LogNodeRec("act", 4, 1, 2);
+  rvs::LogNode* t1 = new rvs::LogNode("l1", tree);
+  tree->Add(t1);
+  rvs::LogNode* t2 = new rvs::LogNode("l2", t1);
+  t1->Add(t2);
+  t2->Add(new rvs::LogNodeInt("deep", 7, t2));
+  t1->Add(new rvs::LogNodeString("k", "v", t1));
+  tree->Add(new rvs::LogNode("empty", tree));
+  std::string expected = tree->ToJson("  ");
+  delete tree;
+
+  // fields are added to nodes after nodes are attached, as gpup does
+  rvs::LogJsonRec* rec = rvs::LogJsonRec::Create(4, 1, 2, false, false);
+  void* r = rec->Handle();
+  void* s1 = rvs::LogJsonRec::CreateNode(r, "l1");
+  rvs::LogJsonRec::AddNode(r, s1);
+  void* s2 = rvs::LogJsonRec::CreateNode(s1, "l2");
+  rvs::LogJsonRec::AddNode(s1, s2);
+  rvs::LogJsonRec::AddInt(s2, "deep", 7);
+  rvs::LogJsonRec::AddString(s1, "k", "v");
+  rvs::LogJsonRec::AddNode(r, rvs::LogJsonRec::CreateNode(r, "empty"));
+  std::string s;
+  rec->ToJson(&s);
+  rvs::LogJsonRec::Release(rec);
+
+  EXPECT_EQ(s, expected);
+}
+
+TEST(LogJsonRecTest, typed_values) {
+  rvs::LogNodeRec* tree = new rvs::LogNodeRec("act", 3, 5, 6);
+  tree->Add(new rvs::LogNodeDouble("gflops", 12345.678, tree));
+  tree->Add(new rvs::LogNodeUInt64("bytes", 18446744073709551615ull, tree));
+  tree->Add(new rvs::LogNodeBool("pass", true, tree));
+  rvs::LogNode* t = new rvs::LogNode("sub", tree);
+  tree->Add(t);
+  t->Add(new rvs::LogNodeDouble("nan", 0.0 / 0.0, t));
+  t->Add(new rvs::LogNodeBool("fail", false, t));
+  t->Add(new rvs::LogNodeDouble("small", 1.5e-9, t));
+  std::string expected = tree->ToJson("  ");
+  delete tree;
+
+  EXPECT_NE(expected.find("\"gflops\" : 12345.678,"), std::string::npos);
+  EXPECT_NE(expected.find("\"bytes\" : 18446744073709551615,"),
+            std::string::npos);
+  EXPECT_NE(expected.find("\"pass\" : true,"), std::string::npos);
+  EXPECT_NE(expected.find("\"nan\" : null,"), std::string::npos);
+  EXPECT_NE(expected.find("\"fail\" : false,"), std::string::npos);
+  EXPECT_NE(expected.find("\"small\" : 1.5e-09"), std::string::npos);
+
+  rvs::LogJsonRec* rec = rvs::LogJsonRec::Create(3, 5, 6, false, false);
+  void* r = rec->Handle();
+  rvs::LogJsonRec::AddDouble(r, "gflops", 12345.678);
+  rvs::LogJsonRec::AddUInt64(r, "bytes", 18446744073709551615ull);
+  rvs::LogJsonRec::AddBool(r, "pass", true);
+  void* n = rvs::LogJsonRec::CreateNode(r, "sub");
+  rvs::LogJsonRec::AddNode(r, n);
+  rvs::LogJsonRec::AddDouble(n, "nan", 0.0 / 0.0);
+  rvs::LogJsonRec::AddBool(n, "fail", false);
+  rvs::LogJsonRec::AddDouble(n, "small", 1.5e-9);
+  std::string s;
+  rec->ToJson(&s);
+  rvs::LogJsonRec::Release(rec);
+
+  EXPECT_EQ(s, expected);
+}
+
+TEST(LogJsonRecTest, minimal) {
+  rvs::MinNode* tree = new rvs::MinNode("act", 3);
+  tree->Add(new rvs::LogNodeString("a", "b", tree));
+  tree->Add(new rvs::LogNodeInt("x", 1, tree));
+  std::string expected = tree->ToJson("  ");
+  delete tree;
+
+  rvs::LogJsonRec* rec = rvs::LogJsonRec::Create(3, 0, 0, true, false);
+  rvs::LogJsonRec::AddString(rec->Handle(), "a", "b");
+  rvs::LogJsonRec::AddInt(rec->Handle(), "x", 1);
+  std::string s;
+  rec->ToJson(&s);
+  rvs::LogJsonRec::Release(rec);
+
+  EXPECT_EQ(s, expected);
+}
+
+TEST(LogJsonRecTest, compact) {
+  rvs::LogJsonRec* rec = rvs::LogJsonRec::Create(3, 12, 45, false, false,
+                                                 "gst", "act");
+  void* n = rvs::LogJsonRec::CreateNode(rec->Handle(), "props");
+  rvs::LogJsonRec::AddString(rec->Handle(), "gpu_id", "1234");
+  rvs::LogJsonRec::AddNode(rec->Handle(), n);
+  rvs::LogJsonRec::AddString(n, "msg", "a \"quoted\"\nline\t\\");
+  rvs::LogJsonRec::AddDouble(n, "gflops", 12.5);
+  rvs::LogJsonRec::AddBool(rec->Handle(), "pass", true);
+  std::string s;
+  rec->ToJson(&s);
+  rvs::LogJsonRec::Release(rec);
+
+  EXPECT_EQ(s, "{\"module\":\"gst\",\"action\":\"act\",\"loglevel\":3,"
+               "\"time\":12.000045,\"gpu_id\":\"1234\","
+               "\"props\":{\"msg\":\"a \\\"quoted\\\"\\nline\\t\\\\\","
+               "\"gflops\":12.5},\"pass\":true}");
+
+  // minimal records still carry their origin
+  rec = rvs::LogJsonRec::Create(3, 0, 0, true, false, "pebb", "act");
+  rvs::LogJsonRec::AddInt(rec->Handle(), "x", 1);
+  s.clear();
+  rec->ToJson(&s);
+  rvs::LogJsonRec::Release(rec);
+
+  EXPECT_EQ(s, "{\"module\":\"pebb\",\"action\":\"act\",\"loglevel\":3,"
+               "\"time\":0.000000,\"x\":1}");
+}
+
+TEST(LogJsonRecTest, reuse_and_discard) {
+  // large record spills into several arena chunks
+  rvs::LogJsonRec* rec = rvs::LogJsonRec::Create(3, 0, 0, false, false);
+  void* n = rvs::LogJsonRec::CreateNode(rec->Handle(), "big");
+  rvs::LogJsonRec::AddNode(rec->Handle(), n);
+  std::string val(RVS_LOGARENA_CHUNK / 2, 'x');
+  for (int i = 0; i < 8; i++) {
+    rvs::LogJsonRec::AddString(n, std::to_string(i).c_str(), val.c_str());
+  }
+  std::string s;
+  rec->ToJson(&s);
+  EXPECT_NE(s.find("\"7\" : \"" + val + "\""), std::string::npos);
+  rvs::LogJsonRec::Release(rec);
+
+  // released record is reused by the same thread
+  rvs::LogJsonRec* rec2 = rvs::LogJsonRec::Create(3, 0, 0, false, true);
+  EXPECT_EQ(rec2, rec);
+  void* d = rvs::LogJsonRec::CreateNode(rec2->Handle(), "ignored");
+  EXPECT_NE(d, nullptr);
+  rvs::LogJsonRec::AddString(d, "k", "v");
+  rvs::LogJsonRec::AddNode(rec2->Handle(), d);
+  rvs::LogJsonRec::AddInt(rec2->Handle(), "i", 1);
+  s.clear();
+  rec2->ToJson(&s);
+  EXPECT_EQ(s, "\n  }");
+  rvs::LogJsonRec::Release(rec2);
+}
+
+TEST(LogJsonRecTest, benchmark) {
+  size_t bytes = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_RECORDS; i++) {
+    bytes += tree_record(i).size();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  std::string out;
+  for (int i = 0; i < BENCH_RECORDS; i++) {
+    out.clear();
+    stream_record(i, &out);
+    bytes -= out.size();
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  EXPECT_EQ(bytes, 0u);
+
+  double tree_s = std::chrono::duration<double>(t1 - t0).count();
+  double stream_s = std::chrono::duration<double>(t2 - t1).count();
+  std::cout << "node tree:       " << static_cast<uint64_t>(BENCH_RECORDS / tree_s)
+            << " records/s" << std::endl;
+  std::cout << "streaming:       " << static_cast<uint64_t>(BENCH_RECORDS / stream_s)
+            << " records/s" << std::endl;
+}
@@ -0,0 +1,143 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvsloglp.h"
+
+#define BENCH_LOOPS 1000000
+#define LOGLP_FILE  "/tmp/rvs_test_loglp.log"
+
+static int evaluated = 0;
+
+static int count_eval() {
+  return ++evaluated;
+}
+
+class LogLpTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    T_MODULE_INIT d = {};
+    d.cbLog      = rvs::logger::Log;
+    d.cbLogExt   = rvs::logger::LogExt;
+    d.cbLogLevel = rvs::logger::log_level;
+    rvs::lp::Initialize(&d);
+    saved_level = rvs::logger::log_level();
+    rvs::logger::quiet();
+    rvs::logger::log_level(rvs::logresults);
+  }
+
+  void TearDown() override {
+    rvs::logger::log_level(saved_level);
+  }
+
+  //! logging level before the test
+  int saved_level;
+};
+
+TEST_F(LogLpTest, disabled_level_skips_arguments) {
+  evaluated = 0;
+  EXPECT_FALSE(RVSLOG_ENABLED(rvs::loginfo));
+  EXPECT_TRUE(RVSLOG_ENABLED(rvs::logresults));
+  RVSLOGF(rvs::loginfo, "value %d", count_eval());
+  RVSLOGF_EXT(rvs::logdebug, 1, 2, "value %d", count_eval());
+  EXPECT_EQ(evaluated, 0);
+  rvs::logger::log_level(rvs::loginfo);
+  RVSLOGF(rvs::loginfo, "value %d", count_eval());
+  EXPECT_EQ(evaluated, 1);
+}
+
+TEST_F(LogLpTest, debug_macro_is_one_statement) {
+  evaluated = 0;
+  // else must bind to the outer if
+  if (evaluated)
+    RVSDEBUG_("value", std::to_string(count_eval()));
+  else
+    count_eval();
+  EXPECT_EQ(evaluated, 1);
+  rvs::logger::log_level(rvs::logdebug);
+  if (evaluated)
+    RVSDEBUG_("value", std::to_string(count_eval()));
+  else
+    count_eval();
+  EXPECT_EQ(evaluated, 2);
+}
+
+TEST_F(LogLpTest, long_message) {
+  rvs::logger::log_level(rvs::loginfo);
+  rvs::logger::set_log_file(LOGLP_FILE);
+  rvs::logger::init_log_file();
+  std::string longval(3000, 'x');
+  RVSLOGF(rvs::loginfo, "[%s] %s %d %s", "act", "mod", 7, longval.c_str());
+  rvs::logger::flush();
+  rvs::logger::set_log_file("");
+
+  std::ifstream f(LOGLP_FILE);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  std::string expected = "[act] mod 7 " + longval;
+  size_t pos = ss.str().find(expected);
+  ASSERT_NE(pos, std::string::npos);
+  EXPECT_EQ(ss.str().find_first_not_of("\n", pos + expected.size()),
+            std::string::npos);
+  unlink(LOGLP_FILE);
+}
+
+TEST_F(LogLpTest, benchmark) {
+  std::string action_name("action_1");
+  int gpu_id = 12345;
+
+  // message at disabled level built eagerly, as modules used to do
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_LOOPS; i++) {
+    std::string msg = "[" + action_name + "] " + "mem" + " " +
+        std::to_string(gpu_id) + " progress: " + std::to_string(i) +
+        " out of " + std::to_string(BENCH_LOOPS) + " blocks finished";
+    rvs::lp::Log(msg, rvs::loginfo);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_LOOPS; i++) {
+    RVSLOGF(rvs::loginfo, "[%s] %s %d progress: %d out of %d blocks finished",
+            action_name.c_str(), "mem", gpu_id, i, BENCH_LOOPS);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double eager_ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  double lazy_ns = std::chrono::duration<double, std::nano>(t2 - t1).count();
+  std::cout << "eager:  " << eager_ns / BENCH_LOOPS << " ns/message"
+            << std::endl;
+  std::cout << "RVSLOGF: " << lazy_ns / BENCH_LOOPS << " ns/message"
+            << std::endl;
+  EXPECT_LT(lazy_ns, eager_ns);
+}
@@ -0,0 +1,212 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvslogring.h"
+
+namespace {
+
+struct out_rec {
+  uint64_t ts;
+  int level;
+  std::string msg;
+};
+
+std::mutex out_mutex;
+std::vector<out_rec> out;
+std::vector<size_t> out_batch;
+
+void test_output(const rvs::logring::entry_t* const* entries, size_t count) {
+  std::lock_guard<std::mutex> lk(out_mutex);
+  for (size_t i = 0; i < count; i++) {
+    out.push_back(out_rec{entries[i]->ts, entries[i]->level,
+                          entries[i]->msg});
+  }
+  out_batch.push_back(count);
+}
+
+}  // namespace
+
+class LogRingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    out.clear();
+    out_batch.clear();
+  }
+};
+
+TEST_F(LogRingTest, merge_by_timestamp) {
+  rvs::logring ring(test_output);
+
+  // posted out of order from different threads, then drained together
+  std::thread t1([&ring] {
+    ring.post(1, 10, 3, "a");
+    ring.post(1, 30, 3, "c");
+  });
+  t1.join();
+  std::thread t2([&ring] {
+    ring.post(1, 20, 3, "b");
+    ring.post(1, 40, 4, "d");
+  });
+  t2.join();
+  ring.flush();
+
+  std::lock_guard<std::mutex> lk(out_mutex);
+  ASSERT_EQ(out.size(), 4u);
+  // drain thread may have picked up t1 before t2 posted
+  if (out_batch.size() == 1) {
+    EXPECT_STREQ(out[0].msg.c_str(), "a");
+    EXPECT_STREQ(out[1].msg.c_str(), "b");
+    EXPECT_STREQ(out[2].msg.c_str(), "c");
+    EXPECT_STREQ(out[3].msg.c_str(), "d");
+  }
+  EXPECT_EQ(out[0].ts, 1000010u);
+  EXPECT_EQ(out[3].level, 4);
+}
+
+TEST_F(LogRingTest, many_producers) {
+  const int producers = 8;
+  const int msgs = 3 * RVS_LOGRING_SIZE;
+  rvs::logring::stats_t st;
+
+  {
+    rvs::logring ring(test_output);
+    std::vector<std::thread> t;
+    for (int p = 0; p < producers; p++) {
+      t.push_back(std::thread([&ring, p, msgs] {
+        for (int i = 0; i < msgs; i++) {
+          ring.post(p, i, 2, (std::to_string(p) + ":" +
+                              std::to_string(i)).c_str());
+        }
+      }));
+    }
+    for (auto& th : t) {
+      th.join();
+    }
+    ring.flush();
+    ring.get_stats(&st);
+  }
+
+  EXPECT_EQ(st.posted, static_cast<uint64_t>(producers * msgs));
+  EXPECT_EQ(st.rings, static_cast<uint64_t>(producers));
+
+  // nothing lost and per-producer order preserved
+  std::lock_guard<std::mutex> lk(out_mutex);
+  ASSERT_EQ(out.size(), static_cast<size_t>(producers * msgs));
+  std::vector<int> next(producers, 0);
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    size_t colon = it->msg.find(':');
+    int p = std::stoi(it->msg.substr(0, colon));
+    int i = std::stoi(it->msg.substr(colon + 1));
+    EXPECT_EQ(i, next[p]);
+    next[p] = i + 1;
+  }
+}
+
+namespace {
+
+// exposes the drain thread so that tests can stop it while the ring is
+// still in use
+class logring_probe : public rvs::logring {
+ public:
+  explicit logring_probe(output_t cb) : rvs::logring(cb) {}
+
+  void stop_drain() {
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      bquit = true;
+    }
+    cv_work.notify_one();
+    drainer.join();
+  }
+
+  void set_shutdown(bool val) { bshutdown = val; }
+};
+
+}  // namespace
+
+TEST_F(LogRingTest, full_ring_at_shutdown) {
+  logring_probe ring(test_output);
+  const int msgs = RVS_LOGRING_SIZE + 16;
+
+  // drain thread exits while a producer which has not seen it yet fills
+  // its ring: the producer must not wait for room forever
+  ring.stop_drain();
+  ring.set_shutdown(false);
+  std::thread t([&ring, msgs] {
+    for (int i = 0; i < msgs; i++) {
+      ring.post(1, i, 2, std::to_string(i).c_str());
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ring.set_shutdown(true);
+  t.join();
+
+  std::lock_guard<std::mutex> lk(out_mutex);
+  ASSERT_EQ(out.size(), static_cast<size_t>(msgs));
+  for (int i = 0; i < msgs; i++) {
+    EXPECT_EQ(std::to_string(i), out[i].msg);
+  }
+}
+
+TEST_F(LogRingTest, post_during_shutdown) {
+  const int producers = 4;
+  const int msgs = 4 * RVS_LOGRING_SIZE;
+  logring_probe ring(test_output);
+  std::vector<std::thread> t;
+
+  // drain thread exits while producers keep posting: nothing is lost and
+  // per-producer order is kept across the switch to direct output
+  for (int p = 0; p < producers; p++) {
+    t.push_back(std::thread([&ring, p, msgs] {
+      for (int i = 0; i < msgs; i++) {
+        ring.post(p, i, 2, (std::to_string(p) + ":" +
+                            std::to_string(i)).c_str());
+      }
+    }));
+  }
+  ring.stop_drain();
+  for (auto& th : t) {
+    th.join();
+  }
+
+  std::lock_guard<std::mutex> lk(out_mutex);
+  ASSERT_EQ(out.size(), static_cast<size_t>(producers * msgs));
+  std::vector<int> next(producers, 0);
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    size_t colon = it->msg.find(':');
+    int p = std::stoi(it->msg.substr(0, colon));
+    int i = std::stoi(it->msg.substr(colon + 1));
+    EXPECT_EQ(i, next[p]);
+    next[p] = i + 1;
+  }
+}
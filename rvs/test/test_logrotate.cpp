@@ -0,0 +1,278 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <unistd.h>
+
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "include/rvslogsink.h"
+#include "include/rvslogframe.h"
+
+namespace {
+
+// minimal JSON syntax checker for the subset written by the logger
+class json_check {
+ public:
+  explicit json_check(const std::string& s) : records(0), p(s.c_str()) {}
+
+  bool document() {
+    if (!value(0)) {
+      return false;
+    }
+    ws();
+    return *p == '\0';
+  }
+
+  //! number of objects at record depth ({module:{action:[{record}]}})
+  int records;
+
+ private:
+  void ws() {
+    while (*p && isspace(static_cast<unsigned char>(*p))) {
+      p++;
+    }
+  }
+
+  bool string() {
+    if (*p != '"') {
+      return false;
+    }
+    for (p++; *p && *p != '"'; p++) {
+      if (*p == '\\' && p[1]) {
+        p++;
+      }
+    }
+    if (*p != '"') {
+      return false;
+    }
+    p++;
+    return true;
+  }
+
+  bool value(int depth) {
+    ws();
+    if (*p == '{') {
+      if (depth == 3) {
+        records++;
+      }
+      p++;
+      ws();
+      if (*p == '}') {
+        p++;
+        return true;
+      }
+      for (;;) {
+        ws();
+        if (!string()) {
+          return false;
+        }
+        ws();
+        if (*p++ != ':') {
+          return false;
+        }
+        if (!value(depth + 1)) {
+          return false;
+        }
+        ws();
+        if (*p == '}') {
+          p++;
+          return true;
+        }
+        if (*p++ != ',') {
+          return false;
+        }
+      }
+    }
+    if (*p == '[') {
+      p++;
+      ws();
+      if (*p == ']') {
+        p++;
+        return true;
+      }
+      for (;;) {
+        if (!value(depth + 1)) {
+          return false;
+        }
+        ws();
+        if (*p == ']') {
+          p++;
+          return true;
+        }
+        if (*p++ != ',') {
+          return false;
+        }
+      }
+    }
+    if (*p == '"') {
+      return string();
+    }
+    const char* start = p;
+    while (*p && (isalnum(static_cast<unsigned char>(*p)) ||
+                  *p == '-' || *p == '.' || *p == '+')) {
+      p++;
+    }
+    return p != start;
+  }
+
+  const char* p;
+};
+
+}  // namespace
+
+class LogRotateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fname = "/tmp/rvs_logrotate_" + std::to_string(getpid()) + ".json";
+    cleanup();
+  }
+
+  void TearDown() override {
+    cleanup();
+  }
+
+  void cleanup() {
+    unlink(fname.c_str());
+    for (int i = 1; i <= 64; i++) {
+      unlink(generation(i).c_str());
+    }
+  }
+
+  std::string generation(int i) {
+    return fname + "." + std::to_string(i);
+  }
+
+  bool exists(const std::string& name) {
+    return access(name.c_str(), F_OK) == 0;
+  }
+
+  std::string read_file(const std::string& name) {
+    std::ifstream fs(name);
+    std::stringstream ss;
+    ss << fs.rdbuf();
+    return ss.str();
+  }
+
+  std::string fname;
+};
+
+TEST_F(LogRotateTest, json_segments_well_formed) {
+  rvs::logjsonframe frame;
+  rvs::logsink sink;
+  rvs::logsink::stats_t st;
+  const rvs::logsink::target_t t = rvs::logsink::target_json;
+
+  sink.set_framer(t, &frame);
+  sink.set_rotation(t, rvs::logsink::rotation_t{512, 0, 64});
+  sink.set_file(t, fname);
+
+  // same rows as produced by rvs::logger
+  sink.post(t, "{\"gst\":{\n", rvs::logjsonframe::tag_doc_start);
+  for (int a = 0; a < 3; a++) {
+    std::string row = a ? "," : "";
+    row += "  \"action_" + std::to_string(a) + "\":[\n";
+    sink.post(t, row, rvs::logjsonframe::tag_list_start);
+    for (int r = 0; r < 20; r++) {
+      row = r ? "," : "";
+      row += "\n  {\"gpu_id\":\"" + std::to_string(r) + "\", \"gflops\":12.5}";
+      sink.post(t, row, rvs::logjsonframe::tag_record);
+    }
+    sink.post(t, "  ]", rvs::logjsonframe::tag_list_end);
+  }
+  sink.post(t, "    }\n}", rvs::logjsonframe::tag_doc_end);
+  sink.close();
+
+  sink.get_stats(&st);
+  ASSERT_GT(st.rotations, 2u);
+  ASSERT_LT(st.rotations, 64u);
+
+  int records = 0;
+  for (int i = st.rotations; i >= 0; i--) {
+    std::string name = i ? generation(i) : fname;
+    ASSERT_TRUE(exists(name)) << name;
+    std::string text = read_file(name);
+    json_check chk(text);
+    EXPECT_TRUE(chk.document()) << name << ":\n" << text;
+    records += chk.records;
+  }
+  EXPECT_EQ(records, 60);
+  EXPECT_FALSE(exists(generation(st.rotations + 1)));
+}
+
+TEST_F(LogRotateTest, generations) {
+  rvs::logsink sink;
+  rvs::logsink::stats_t st;
+  const rvs::logsink::target_t t = rvs::logsink::target_text;
+
+  sink.set_rotation(t, rvs::logsink::rotation_t{100, 0, 2});
+  sink.set_file(t, fname);
+  for (int i = 0; i < 50; i++) {
+    char buff[32];
+    snprintf(buff, sizeof(buff), "row %04d ..........\n", i);
+    sink.post(t, buff);
+  }
+  sink.close();
+
+  // 20 byte rows, 5 per file
+  sink.get_stats(&st);
+  EXPECT_EQ(st.rotations, 9u);
+  EXPECT_TRUE(exists(fname));
+  EXPECT_TRUE(exists(generation(1)));
+  EXPECT_TRUE(exists(generation(2)));
+  EXPECT_FALSE(exists(generation(3)));
+
+  EXPECT_EQ(read_file(fname).substr(0, 8), "row 0045");
+  EXPECT_EQ(read_file(generation(1)).substr(0, 8), "row 0040");
+  EXPECT_EQ(read_file(generation(2)).substr(0, 8), "row 0035");
+  EXPECT_EQ(read_file(fname).size(), 100u);
+}
+
+TEST_F(LogRotateTest, max_age) {
+  rvs::logsink sink;
+  rvs::logsink::stats_t st;
+  const rvs::logsink::target_t t = rvs::logsink::target_text;
+
+  sink.set_flush_interval(10);
+  sink.set_rotation(t, rvs::logsink::rotation_t{0, 1, 1});
+  sink.set_file(t, fname);
+  sink.post(t, "first\n");
+  sink.flush();
+  sink.post(t, "second\n");
+  sink.flush();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  sink.post(t, "third\n");
+  sink.close();
+
+  sink.get_stats(&st);
+  EXPECT_EQ(st.rotations, 1u);
+  EXPECT_EQ(read_file(generation(1)), "first\nsecond\n");
+  EXPECT_EQ(read_file(fname), "third\n");
+}
@@ -0,0 +1,164 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvslogsink.h"
+
+class LogSinkTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fname_text = "/tmp/rvs_logsink_" + std::to_string(getpid()) + ".log";
+    fname_json = "/tmp/rvs_logsink_" + std::to_string(getpid()) + ".json";
+    unlink(fname_text.c_str());
+    unlink(fname_json.c_str());
+  }
+
+  void TearDown() override {
+    unlink(fname_text.c_str());
+    unlink(fname_json.c_str());
+  }
+
+  std::string read_file(const std::string& fname) {
+    std::ifstream fs(fname);
+    std::stringstream ss;
+    ss << fs.rdbuf();
+    return ss.str();
+  }
+
+  std::string fname_text;
+  std::string fname_json;
+};
+
+TEST_F(LogSinkTest, ordering_and_flush) {
+  rvs::logsink sink;
+  rvs::logsink::stats_t st;
+
+  sink.set_flush_interval(10000);
+  sink.set_file(rvs::logsink::target_text, fname_text);
+  sink.set_file(rvs::logsink::target_json, fname_json);
+
+  std::string exp_text;
+  std::string exp_json;
+  for (int i = 0; i < 1000; i++) {
+    std::string row = "row " + std::to_string(i) + "\n";
+    EXPECT_EQ(sink.post(rvs::logsink::target_text, row), 0);
+    exp_text += row;
+    row = "{" + std::to_string(i) + "}";
+    EXPECT_EQ(sink.post(rvs::logsink::target_json, row), 0);
+    exp_json += row;
+  }
+
+  // explicit flush writes everything out even with long flush interval
+  sink.flush();
+  EXPECT_STREQ(read_file(fname_text).c_str(), exp_text.c_str());
+  EXPECT_STREQ(read_file(fname_json).c_str(), exp_json.c_str());
+
+  sink.get_stats(&st);
+  EXPECT_EQ(st.records, 2000u);
+  EXPECT_EQ(st.bytes, exp_text.size() + exp_json.size());
+  EXPECT_EQ(st.dropped, 0u);
+
+  // rows posted before file change stay in the old file
+  std::string new_text = fname_text + ".1";
+  unlink(new_text.c_str());
+  sink.post(rvs::logsink::target_text, "old");
+  sink.set_file(rvs::logsink::target_text, new_text);
+  sink.post(rvs::logsink::target_text, "new");
+  sink.close();
+  EXPECT_STREQ(read_file(fname_text).c_str(), (exp_text + "old").c_str());
+  EXPECT_STREQ(read_file(new_text).c_str(), "new");
+  unlink(new_text.c_str());
+}
+
+TEST_F(LogSinkTest, overflow) {
+  const int producers = 4;
+  const int rows = 5000;
+
+  // blocking policy: nothing lost
+  {
+    rvs::logsink sink;
+    rvs::logsink::stats_t st;
+    sink.set_queue_depth(16);
+    sink.set_file(rvs::logsink::target_text, fname_text);
+
+    std::vector<std::thread> t;
+    for (int p = 0; p < producers; p++) {
+      t.push_back(std::thread([&sink, rows] {
+        for (int i = 0; i < rows; i++) {
+          sink.post(rvs::logsink::target_text, "x\n");
+        }
+      }));
+    }
+    for (auto& th : t) {
+      th.join();
+    }
+    sink.close();
+
+    sink.get_stats(&st);
+    EXPECT_EQ(st.records, static_cast<uint64_t>(producers * rows));
+    EXPECT_EQ(st.dropped, 0u);
+    EXPECT_EQ(read_file(fname_text).size(),
+              static_cast<size_t>(2 * producers * rows));
+  }
+
+  unlink(fname_text.c_str());
+
+  // dropping policy: every row is either written or counted as dropped
+  {
+    rvs::logsink sink;
+    rvs::logsink::stats_t st;
+    sink.set_queue_depth(2);
+    sink.set_overflow(rvs::logsink::overflow_drop);
+    sink.set_file(rvs::logsink::target_text, fname_text);
+
+    std::vector<std::thread> t;
+    for (int p = 0; p < producers; p++) {
+      t.push_back(std::thread([&sink, rows] {
+        for (int i = 0; i < rows; i++) {
+          sink.post(rvs::logsink::target_text, "x\n");
+        }
+      }));
+    }
+    for (auto& th : t) {
+      th.join();
+    }
+    sink.close();
+
+    sink.get_stats(&st);
+    EXPECT_EQ(st.stalled, 0u);
+    EXPECT_EQ(st.records + st.dropped,
+              static_cast<uint64_t>(producers * rows));
+    EXPECT_EQ(read_file(fname_text).size(), 2 * st.records);
+  }
+}
@@ -0,0 +1,201 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsmemtiler.h"
+
+#define MB    (1024ull * 1024)
+#define GB    (1024ull * MB)
+
+namespace {
+
+/**
+ * Simulated device memory: capacity bytes of which no single allocation
+ * may exceed max_alloc (largest free chunk after fragmentation or a
+ * per-allocation limit). Addresses are handed out from a 64-bit range
+ * and never reused, so tiles can be checked for overlap.
+ */
+class fakedevice : public rvs::memallocator {
+ public:
+  fakedevice(size_t capacity, size_t max_alloc)
+    : capacity(capacity), max_alloc(max_alloc) {}
+
+  void* alloc(size_t Size) override {
+    calls++;
+    if (Size == 0 || Size > max_alloc || Size > capacity - in_use) {
+      return nullptr;
+    }
+    void* ptr = reinterpret_cast<void*>(next);
+    next += Size;
+    in_use += Size;
+    live[ptr] = Size;
+    return ptr;
+  }
+
+  void free(void* Ptr) override {
+    auto it = live.find(Ptr);
+    ASSERT_NE(live.end(), it);
+    in_use -= it->second;
+    live.erase(it);
+  }
+
+  size_t available() override {
+    return report_free ? capacity - in_use : SIZE_MAX;
+  }
+
+  size_t capacity;
+  size_t max_alloc;
+  size_t in_use = 0;
+  bool report_free = true;
+  unsigned int calls = 0;
+  uintptr_t next = 0x7f0000000000ull;
+  std::map<void*, size_t> live;
+};
+
+// tiles must not overlap, must be live allocations and add up to covered()
+void check_tiles(const rvs::memtiler& tiler, const fakedevice& dev) {
+  std::vector<rvs::memtile_t> t = tiler.tiles();
+  size_t sum = 0;
+  std::sort(t.begin(), t.end(),
+            [](const rvs::memtile_t& a, const rvs::memtile_t& b) {
+              return a.ptr < b.ptr;
+            });
+  for (size_t i = 0; i < t.size(); i++) {
+    ASSERT_EQ(1u, dev.live.count(t[i].ptr));
+    EXPECT_EQ(dev.live.at(t[i].ptr), t[i].size);
+    EXPECT_EQ(0u, t[i].size % MB);
+    if (i > 0) {
+      EXPECT_LE(reinterpret_cast<uintptr_t>(t[i - 1].ptr) + t[i - 1].size,
+                reinterpret_cast<uintptr_t>(t[i].ptr));
+    }
+    sum += t[i].size;
+  }
+  EXPECT_EQ(sum, tiler.covered());
+  // nothing leaked by probing
+  EXPECT_EQ(sum, dev.in_use);
+}
+
+}  // namespace
+
+// 192 GB part: one allocation well above 4 GB in a single attempt
+TEST(memtiler, single) {
+  fakedevice dev(192 * GB, 192 * GB);
+  rvs::memtiler tiler(&dev, MB, 16 * MB, 64);
+
+  EXPECT_EQ(180 * GB, tiler.tile(180 * GB));
+  ASSERT_EQ(1u, tiler.tiles().size());
+  EXPECT_EQ(180 * GB, tiler.tiles()[0].size);
+  EXPECT_EQ(1u, tiler.attempts());
+  check_tiles(tiler, dev);
+}
+
+// largest allocation is found by bisection to the granule
+TEST(memtiler, probe) {
+  fakedevice dev(64 * GB, 24 * GB + 3 * MB);
+  rvs::memtiler tiler(&dev, MB, 0, 64);
+  void* ptr = nullptr;
+
+  EXPECT_EQ(24 * GB + 3 * MB, tiler.probe(48 * GB, &ptr));
+  EXPECT_NE(nullptr, ptr);
+  EXPECT_EQ(24 * GB + 3 * MB, dev.in_use);
+  // 1 + log2(48 GB / 1 MB) attempts, shrinking by 16 MB would take ~1500
+  EXPECT_LE(tiler.attempts(), 17u);
+  dev.free(ptr);
+
+  // nothing fits
+  fakedevice full(MB / 2, MB / 2);
+  rvs::memtiler none(&full, MB, 0, 64);
+  EXPECT_EQ(0u, none.probe(4 * GB, &ptr));
+  EXPECT_EQ(0u, full.in_use);
+  EXPECT_EQ(0u, none.probe(MB / 2, &ptr));
+}
+
+// probing is bound by capacity, not only by the largest allocation: sizes
+// which fit must not be held while larger ones are tried
+TEST(memtiler, probe_capacity) {
+  fakedevice dev(64 * GB, 40 * GB);
+  rvs::memtiler tiler(&dev, MB, 0, 1);
+
+  EXPECT_EQ(40 * GB, tiler.tile(64 * GB));
+  ASSERT_EQ(1u, tiler.tiles().size());
+  EXPECT_EQ(40 * GB, tiler.tiles()[0].size);
+  check_tiles(tiler, dev);
+}
+
+// fragmented memory: several tiles reach the target coverage
+TEST(memtiler, coverage) {
+  fakedevice dev(64 * GB, 10 * GB);
+  rvs::memtiler tiler(&dev, MB, 16 * MB, 64);
+  size_t target = (64 * GB * 90 / 100) / MB * MB;
+
+  EXPECT_EQ(target, tiler.tile(target));
+  EXPECT_EQ(6u, tiler.tiles().size());
+  for (const auto& t : tiler.tiles()) {
+    EXPECT_LE(t.size, 10 * GB);
+  }
+  check_tiles(tiler, dev);
+
+  // tiling again to a higher target adds to the covered tiles
+  EXPECT_EQ(target + 2 * GB, tiler.tile(target + 2 * GB));
+  check_tiles(tiler, dev);
+}
+
+// headroom is left free, also when free memory is not reported
+TEST(memtiler, headroom) {
+  fakedevice dev(8 * GB, 8 * GB);
+  rvs::memtiler tiler(&dev, MB, 16 * MB, 64);
+
+  EXPECT_EQ(8 * GB - 16 * MB, tiler.tile(1024 * GB));
+  EXPECT_EQ(1u, tiler.tiles().size());
+  check_tiles(tiler, dev);
+  tiler.release();
+  EXPECT_EQ(0u, dev.in_use);
+  EXPECT_EQ(0u, tiler.covered());
+
+  // without free memory reported all of it is probed
+  dev.report_free = false;
+  EXPECT_EQ(8 * GB, tiler.tile(1024 * GB));
+  check_tiles(tiler, dev);
+}
+
+// tile limit bounds the number of allocations
+TEST(memtiler, max_tiles) {
+  fakedevice dev(64 * GB, GB);
+  {
+    rvs::memtiler tiler(&dev, MB, 0, 4);
+    EXPECT_EQ(4 * GB, tiler.tile(32 * GB));
+    EXPECT_EQ(4u, tiler.tiles().size());
+    check_tiles(tiler, dev);
+  }
+  // destructor frees the tiles
+  EXPECT_EQ(0u, dev.in_use);
+  EXPECT_TRUE(dev.live.empty());
+}
@@ -0,0 +1,204 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsmetriclog.h"
+#include "include/rvslogjsonrec.h"
+
+#define METRIC_THREADS  4
+#define METRIC_SAMPLES  10000
+#define BENCH_SAMPLES   200000
+
+//! gives the test access to the write lock
+class metriclog_probe : public rvs::metriclog {
+ public:
+  static std::mutex& io() { return io_mtx; }
+};
+
+class MetricLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fname = "/tmp/rvs_metriclog_" + std::to_string(getpid()) + ".bin";
+  }
+
+  void TearDown() override {
+    rvs::metriclog::close();
+    unlink(fname.c_str());
+  }
+
+  std::string fname;
+};
+
+TEST_F(MetricLogTest, roundtrip) {
+  // nothing is recorded without file
+  rvs::metriclog::sample(rvs::metric_power, 1, 1.0);
+  EXPECT_FALSE(rvs::metriclog::active());
+
+  ASSERT_EQ(rvs::metriclog::open(fname), 0);
+  EXPECT_TRUE(rvs::metriclog::active());
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < METRIC_THREADS; t++) {
+    threads.emplace_back([t]() {
+      for (int i = 0; i < METRIC_SAMPLES; i++) {
+        rvs::metriclog::sample(rvs::metric_temperature + t, 100 + t, i);
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  rvs::metriclog::close();
+  EXPECT_FALSE(rvs::metriclog::active());
+
+  // incomplete trailing record is ignored
+  {
+    std::ofstream fs(fname, std::ios::app | std::ios::binary);
+    fs.write("abcde", 5);
+  }
+
+  rvs::metricreader reader;
+  ASSERT_EQ(reader.open(fname), 0);
+  ASSERT_EQ(reader.count(), static_cast<size_t>(METRIC_THREADS *
+                                                METRIC_SAMPLES));
+  EXPECT_NE(reader.start_ns(), 0u);
+
+  // samples of each thread are in order
+  int next[METRIC_THREADS] = {};
+  uint64_t last_time[METRIC_THREADS] = {};
+  const rvs::metric_record_t* r = reader.records();
+  for (size_t i = 0; i < reader.count(); i++, r++) {
+    int t = r->metric - rvs::metric_temperature;
+    ASSERT_GE(t, 0);
+    ASSERT_LT(t, METRIC_THREADS);
+    EXPECT_EQ(r->device, 100 + t);
+    EXPECT_EQ(r->value, next[t]++);
+    EXPECT_GE(r->time_ns, last_time[t]);
+    last_time[t] = r->time_ns;
+  }
+}
+
+TEST_F(MetricLogTest, no_stall_behind_write) {
+  ASSERT_EQ(rvs::metriclog::open(fname), 0);
+
+  // another sampler is writing: reaching the flush threshold must not wait
+  std::unique_lock<std::mutex> io(metriclog_probe::io());
+  auto done = std::async(std::launch::async, []() {
+    for (int i = 0; i < 3 * RVS_METRICLOG_BUFFER; i++) {
+      rvs::metriclog::sample(rvs::metric_power, 1, i);
+    }
+  });
+  bool stalled = done.wait_for(std::chrono::seconds(10)) !=
+                 std::future_status::ready;
+  io.unlock();
+  done.wait();
+  EXPECT_FALSE(stalled);
+
+  rvs::metriclog::close();
+  rvs::metricreader reader;
+  ASSERT_EQ(reader.open(fname), 0);
+  ASSERT_EQ(reader.count(), static_cast<size_t>(3 * RVS_METRICLOG_BUFFER));
+  const rvs::metric_record_t* r = reader.records();
+  for (size_t i = 0; i < reader.count(); i++, r++) {
+    EXPECT_EQ(r->value, i);
+  }
+}
+
+TEST_F(MetricLogTest, invalid_file) {
+  rvs::metricreader reader;
+  EXPECT_NE(reader.open("/nonexistent/metrics.bin"), 0);
+
+  {
+    std::ofstream fs(fname);
+    fs << "this is not a metrics file, but long enough for the header..";
+  }
+  EXPECT_NE(reader.open(fname), 0);
+  EXPECT_EQ(reader.count(), 0u);
+}
+
+TEST_F(MetricLogTest, metric_names) {
+  EXPECT_STREQ(rvs::metriclog::metric_name(rvs::metric_gflops), "gflops");
+  EXPECT_EQ(rvs::metriclog::metric_name(1000), nullptr);
+  EXPECT_EQ(rvs::metriclog::metric_id("bandwidth"), rvs::metric_bandwidth);
+  EXPECT_EQ(rvs::metriclog::metric_id("1000"), 1000);
+  EXPECT_EQ(rvs::metriclog::metric_id("70000"), -1);
+  EXPECT_EQ(rvs::metriclog::metric_id("bogus"), -1);
+}
+
+TEST_F(MetricLogTest, benchmark) {
+  // JSON path: one record per sample the way GST logs GFLOPS
+  size_t json_bytes = 0;
+  std::string out;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_SAMPLES; i++) {
+    rvs::LogJsonRec* rec = rvs::LogJsonRec::Create(3, 1234, i % 1000000,
+                                                   false, false);
+    void* h = rec->Handle();
+    rvs::LogJsonRec::AddString(h, "action", "action_1");
+    rvs::LogJsonRec::AddString(h, "module", "gst");
+    rvs::LogJsonRec::AddString(h, "loglevelname", "INFO  ");
+    rvs::LogJsonRec::AddString(h, "gpu_id", "12345");
+    rvs::LogJsonRec::AddDouble(h, "Gflops", 12345.678 + i);
+    out.assign(1, ',');
+    rec->ToJson(&out);
+    rvs::LogJsonRec::Release(rec);
+    json_bytes += out.size();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  ASSERT_EQ(rvs::metriclog::open(fname), 0);
+  auto t2 = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_SAMPLES; i++) {
+    rvs::metriclog::sample(rvs::metric_gflops, 12345, 12345.678 + i);
+  }
+  auto t3 = std::chrono::steady_clock::now();
+  rvs::metriclog::close();
+
+  rvs::metricreader reader;
+  ASSERT_EQ(reader.open(fname), 0);
+  ASSERT_EQ(reader.count(), static_cast<size_t>(BENCH_SAMPLES));
+  size_t bin_bytes = reader.count() * sizeof(rvs::metric_record_t);
+
+  double json_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+                   BENCH_SAMPLES;
+  double bin_ns = std::chrono::duration<double, std::nano>(t3 - t2).count() /
+                  BENCH_SAMPLES;
+  std::cout << "JSON record:     " << json_bytes / BENCH_SAMPLES
+            << " bytes, " << json_ns << " ns/sample" << std::endl;
+  std::cout << "binary sample:   " << sizeof(rvs::metric_record_t)
+            << " bytes, " << bin_ns << " ns/sample" << std::endl;
+
+  EXPECT_GE(json_bytes, 10 * bin_bytes);
+}
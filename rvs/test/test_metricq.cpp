@@ -0,0 +1,146 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsmetricq.h"
+#include "include/rvsactionbase.h"
+
+namespace {
+
+struct sink {
+  std::mutex mtx;
+  std::vector<rvs_metric_t> recs;
+  std::set<const rvs_metric_t*> slots;
+  unsigned int batches = 0;
+};
+
+void deliver(const rvs_metric_t* recs, unsigned int count, void* param) {
+  sink* s = static_cast<sink*>(param);
+  std::lock_guard<std::mutex> lk(s->mtx);
+  for (unsigned int i = 0; i < count; i++) {
+    s->recs.push_back(recs[i]);
+    s->slots.insert(&recs[i]);
+  }
+  s->batches++;
+}
+
+class test_action : public rvs::actionbase {
+ public:
+  int run(void) { return 0; }
+};
+
+void action_cb(const rvs::action_result_t* result, void* param) {
+  if (result->metric) {
+    *static_cast<rvs::action_metric_t*>(param) = *result->metric;
+  }
+}
+
+}  // namespace
+
+TEST(MetricQueue, producers_lossless_in_order) {
+  const unsigned int producers = 4;
+  const unsigned int per_producer = 20000;
+  const size_t size = 256;
+  sink s;
+  rvs::metricqueue::stats_t st;
+
+  {
+    rvs::metricqueue q(deliver, &s, size);
+    std::vector<std::thread> t;
+    for (unsigned int p = 0; p < producers; p++) {
+      t.push_back(std::thread([&q, p, per_producer] {
+        for (unsigned int i = 0; i < per_producer; i++) {
+          q.post("bandwidth", "GB/s", p, i, i);
+        }
+      }));
+    }
+    for (auto& th : t) {
+      th.join();
+    }
+    q.get_stats(&st);
+  }
+
+  ASSERT_EQ(s.recs.size(), producers * per_producer);
+  EXPECT_EQ(st.posted, producers * per_producer);
+
+  // records of each producer arrive in posting order
+  std::map<unsigned int, double> next;
+  for (const auto& r : s.recs) {
+    EXPECT_STREQ(r.name, "bandwidth");
+    EXPECT_STREQ(r.unit, "GB/s");
+    EXPECT_EQ(r.value, next[r.device]);
+    next[r.device] = r.value + 1;
+  }
+
+  // records are delivered in batches straight from the ring slots
+  EXPECT_LT(s.batches, producers * per_producer);
+  EXPECT_LE(s.slots.size(), size);
+}
+
+TEST(MetricQueue, delivered_on_destruction) {
+  sink s;
+  {
+    rvs::metricqueue q(deliver, &s);
+    q.post("gflops", "GFLOPS", 3, 1.5, 7);
+  }
+  ASSERT_EQ(s.recs.size(), 1u);
+  EXPECT_EQ(s.recs[0].device, 3u);
+  EXPECT_EQ(s.recs[0].value, 1.5);
+  EXPECT_EQ(s.recs[0].timestamp_ns, 7u);
+}
+
+TEST(MetricQueue, heap_allocation_aligned) {
+  sink s;
+  for (int i = 0; i < 4; i++) {
+    std::unique_ptr<rvs::metricqueue> q(new rvs::metricqueue(deliver, &s));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(q.get()) % RVS_METRICQ_CACHE_LINE,
+              0u);
+  }
+}
+
+TEST(MetricQueue, actionbase_metric) {
+  test_action a;
+  rvs::action_metric_t m = {nullptr, nullptr, 0, 0, 0};
+
+  // no callback registered
+  EXPECT_NE(a.metric("gflops", "GFLOPS", 1, 2.0), 0);
+
+  a.callback_set(action_cb, &m);
+  EXPECT_EQ(a.metric("gflops", "GFLOPS", 1, 2.0), 0);
+  EXPECT_STREQ(m.name, "gflops");
+  EXPECT_STREQ(m.unit, "GFLOPS");
+  EXPECT_EQ(m.device, 1u);
+  EXPECT_EQ(m.value, 2.0);
+  EXPECT_GT(m.ts_ns, 0u);
+}
@@ -0,0 +1,120 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+
+#define NDJSON_FILE     "/tmp/rvs_test_ndjson.json"
+#define NDJSON_THREADS  4
+#define NDJSON_RECORDS  100
+
+class NdjsonTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    unlink(NDJSON_FILE);
+    rvs::logger::quiet();
+    rvs::logger::log_level(rvs::loginfo);
+  }
+
+  void TearDown() override {
+    unlink(NDJSON_FILE);
+  }
+};
+
+TEST_F(NdjsonTest, invalid_file) {
+  EXPECT_NE(rvs::logger::set_ndjson_file("/nonexistent/dir/rvs.json"), 0);
+  EXPECT_FALSE(rvs::logger::ndjson());
+}
+
+TEST_F(NdjsonTest, append_lines) {
+  // previous run cut short in the middle of a record
+  {
+    std::ofstream fs(NDJSON_FILE);
+    fs << "{\"module\":\"gst\",\"action\":\"old\"}\n{\"module\":\"g";
+  }
+
+  ASSERT_EQ(rvs::logger::set_ndjson_file(NDJSON_FILE), 0);
+  EXPECT_TRUE(rvs::logger::ndjson());
+  EXPECT_TRUE(rvs::logger::to_json());
+
+  // document structure is not written in NDJSON mode
+  rvs::logger::JsonStartNodeCreate("gst", "act");
+  rvs::logger::JsonActionStartNodeCreate("gst", "act");
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < NDJSON_THREADS; t++) {
+    threads.emplace_back([t]() {
+      for (int i = 0; i < NDJSON_RECORDS; i++) {
+        void* r = rvs::logger::LogRecordCreate("gst", "act", rvs::loginfo,
+                                               0, 0);
+        rvs::logger::AddString(r, "gpu_id", std::to_string(t).c_str());
+        void* n = rvs::logger::CreateNode(r, "result");
+        rvs::logger::AddNode(r, n);
+        rvs::logger::AddDouble(n, "gflops", 1.5 * i);
+        rvs::logger::AddString(n, "msg", "two\nlines");
+        rvs::logger::LogRecordFlush(r);
+      }
+      // filtered out by logging level
+      void* r = rvs::logger::LogRecordCreate("gst", "act", rvs::logtrace,
+                                             0, 0);
+      rvs::logger::LogRecordFlush(r);
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  rvs::logger::JsonActionEndNodeCreate();
+  rvs::logger::JsonEndNodeCreate();
+  rvs::logger::flush();
+
+  std::ifstream fs(NDJSON_FILE);
+  std::string line;
+  ASSERT_TRUE(std::getline(fs, line));
+  EXPECT_EQ(line, "{\"module\":\"gst\",\"action\":\"old\"}");
+  ASSERT_TRUE(std::getline(fs, line));
+  EXPECT_EQ(line, "{\"module\":\"g");
+
+  const std::string head("{\"module\":\"gst\",\"action\":\"act\","
+                         "\"loglevel\":3,\"time\":");
+  int count = 0;
+  while (std::getline(fs, line)) {
+    EXPECT_EQ(line.compare(0, head.size(), head), 0) << line;
+    EXPECT_EQ(line.find("\"module\"", 2), std::string::npos) << line;
+    EXPECT_NE(line.find("\"gpu_id\":\""), std::string::npos) << line;
+    EXPECT_NE(line.find("\"msg\":\"two\\nlines\""), std::string::npos) << line;
+    EXPECT_EQ(line.back(), '}') << line;
+    count++;
+  }
+  EXPECT_EQ(count, NDJSON_THREADS * NDJSON_RECORDS);
+}
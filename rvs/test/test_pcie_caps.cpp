@@ -220,6 +220,9 @@ TEST_F(PcieCapsTest, pcie_caps) {
     case 4:
       EXPECT_STREQ(buff, "16 GT/s");
       break;
+    case 5:
+      EXPECT_STREQ(buff, "32 GT/s");
+      break;
     default:
       EXPECT_STREQ(buff, "Unknown speed");
       break;
@@ -314,6 +317,11 @@ TEST_F(PcieCapsTest, pcie_caps) {
     case 4:
       EXPECT_STREQ(buff, "16 GT/s");
       break;
+#endif
+#ifdef PCI_EXP_LNKSTA_CLS_32_0GB
+    case 5:
+      EXPECT_STREQ(buff, "32 GT/s");
+      break;
 #endif
     default:
       EXPECT_STREQ(buff, "Unknown speed");
@@ -0,0 +1,153 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsroundplan.h"
+
+using rvs::roundplan;
+
+namespace {
+
+//! all pairs of Ngpu GPUs
+std::vector<roundplan::resources_t> all_pairs(int Ngpu) {
+  std::vector<roundplan::resources_t> t;
+  for (int i = 0; i < Ngpu; i++) {
+    for (int j = i + 1; j < Ngpu; j++) {
+      t.push_back({roundplan::gpu_resource(i), roundplan::gpu_resource(j)});
+    }
+  }
+  return t;
+}
+
+//! largest number of transfers sharing one resource
+size_t max_degree(const std::vector<roundplan::resources_t>& Transfers) {
+  std::map<uint64_t, size_t> degree;
+  size_t maxdeg = 0;
+  for (const auto& t : Transfers) {
+    for (uint64_t r : t) {
+      maxdeg = std::max(maxdeg, ++degree[r]);
+    }
+  }
+  return maxdeg;
+}
+
+}  // namespace
+
+TEST(RoundPlan, empty) {
+  std::vector<std::vector<size_t>> rounds;
+  roundplan::plan({}, &rounds);
+  EXPECT_TRUE(rounds.empty());
+  EXPECT_TRUE(roundplan::valid({}, rounds));
+}
+
+TEST(RoundPlan, all_pairs_close_to_gpu_count) {
+  for (int n = 2; n <= 32; n++) {
+    auto t = all_pairs(n);
+    std::vector<std::vector<size_t>> rounds;
+    roundplan::plan(t, &rounds);
+
+    EXPECT_TRUE(roundplan::valid(t, rounds)) << n << " GPUs";
+    // chromatic index of complete graph is n - 1 (even n) or n (odd n)
+    EXPECT_GE(rounds.size(), static_cast<size_t>(n % 2 ? n : n - 1));
+    EXPECT_LE(rounds.size(), static_cast<size_t>(n)) << n << " GPUs";
+  }
+}
+
+TEST(RoundPlan, all_pairs_eight_gpus) {
+  auto t = all_pairs(8);
+  std::vector<std::vector<size_t>> rounds;
+  roundplan::plan(t, &rounds);
+
+  // 28 pairs, 4 at a time
+  ASSERT_EQ(7u, rounds.size());
+  for (const auto& r : rounds) {
+    EXPECT_EQ(4u, r.size());
+    EXPECT_TRUE(std::is_sorted(r.begin(), r.end()));
+  }
+}
+
+TEST(RoundPlan, random_peer_graphs) {
+  std::mt19937 rng(20231017);
+  for (int iter = 0; iter < 200; iter++) {
+    int n = 2 + rng() % 30;
+    std::vector<roundplan::resources_t> t;
+    for (const auto& p : all_pairs(n)) {
+      if (rng() % 3) {
+        t.push_back(p);
+      }
+    }
+    std::vector<std::vector<size_t>> rounds;
+    roundplan::plan(t, &rounds);
+
+    ASSERT_TRUE(roundplan::valid(t, rounds)) << "iteration " << iter;
+    // Vizing bound, guaranteed by Misra-Gries
+    EXPECT_LE(rounds.size(), max_degree(t) + 1) << "iteration " << iter;
+  }
+}
+
+TEST(RoundPlan, shared_host_link) {
+  // 8 PCIe GPUs on two NUMA nodes, pairs across nodes share one host link
+  std::vector<roundplan::resources_t> t;
+  size_t cross = 0;
+  for (int i = 0; i < 8; i++) {
+    for (int j = i + 1; j < 8; j++) {
+      roundplan::resources_t r = {roundplan::gpu_resource(i),
+                                  roundplan::gpu_resource(j)};
+      if (i / 4 != j / 4) {
+        r.push_back(roundplan::link_resource(i / 4, j / 4));
+        cross++;
+      }
+      t.push_back(r);
+    }
+  }
+  std::vector<std::vector<size_t>> rounds;
+  roundplan::plan(t, &rounds);
+
+  EXPECT_TRUE(roundplan::valid(t, rounds));
+  // one cross-node pair per round, pairs within a node fill the rest
+  EXPECT_EQ(cross, rounds.size());
+}
+
+TEST(RoundPlan, link_resource_is_symmetric) {
+  EXPECT_EQ(roundplan::link_resource(0, 1), roundplan::link_resource(1, 0));
+  EXPECT_NE(roundplan::link_resource(0, 1), roundplan::link_resource(0, 2));
+  EXPECT_NE(roundplan::link_resource(0, 0), roundplan::gpu_resource(0));
+}
+
+TEST(RoundPlan, invalid_plans_rejected) {
+  auto t = all_pairs(3);
+  // (0,1) and (0,2) share GPU 0
+  EXPECT_FALSE(roundplan::valid(t, {{0, 1}, {2}}));
+  // transfer 2 missing
+  EXPECT_FALSE(roundplan::valid(t, {{0}, {1}}));
+  // transfer 0 twice
+  EXPECT_FALSE(roundplan::valid(t, {{0}, {1}, {2}, {0}}));
+  EXPECT_TRUE(roundplan::valid(t, {{0}, {1}, {2}}));
+}
@@ -0,0 +1,146 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "include/rvs.h"
+#include "include/rvsliblogger.h"
+#include "include/rvsthreadbase.h"
+
+namespace {
+
+//! action referring to a module which does not exist fails quickly
+const char* bad_action =
+  "actions:\n"
+  "- name: bad\n"
+  "  module: nomodule\n";
+
+std::atomic<int> completed_callbacks(0);
+
+void session_cb(rvs_session_id_t, const rvs_results_t* results) {
+  if (results->state == RVS_SESSION_STATE_COMPLETED) {
+    completed_callbacks++;
+  }
+}
+
+class stop_thread : public rvs::ThreadBase {
+ public:
+  bool stopping = false;
+  void run() {
+    stopping = rvs::logger::Stopping();
+  }
+};
+
+}  // namespace
+
+TEST(Session, cancel_flag_inherited) {
+  std::atomic<bool> flag(false);
+  rvs::logger::set_cancel_flag(&flag);
+
+  stop_thread t1;
+  t1.start();
+  t1.join();
+  EXPECT_FALSE(t1.stopping);
+
+  // stop request reaches threads started by the session thread only
+  flag = true;
+  EXPECT_TRUE(rvs::logger::Stopping());
+  stop_thread t2;
+  t2.start();
+  t2.join();
+  EXPECT_TRUE(t2.stopping);
+
+  bool other = true;
+  std::thread t3([&other] { other = rvs::logger::Stopping(); });
+  t3.join();
+  EXPECT_FALSE(other);
+
+  rvs::logger::set_cancel_flag(nullptr);
+  EXPECT_FALSE(rvs::logger::Stopping());
+}
+
+TEST(Session, async_concurrent) {
+  ASSERT_EQ(rvs_initialize(), RVS_STATUS_SUCCESS);
+  completed_callbacks = 0;
+
+  rvs_session_property_t prop;
+  prop.type = RVS_SESSION_TYPE_CUSTOM_ACTION;
+  prop.custom_action.config = bad_action;
+
+  rvs_session_id_t id[2];
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ(rvs_session_create(&id[i], session_cb), RVS_STATUS_SUCCESS);
+    rvs_session_state_t state;
+    EXPECT_EQ(rvs_session_get_state(id[i], &state), RVS_STATUS_SUCCESS);
+    EXPECT_EQ(state, RVS_SESSION_STATE_CREATED);
+    // nothing to wait for yet
+    EXPECT_EQ(rvs_session_wait(id[i], 0), RVS_STATUS_INVALID_SESSION_STATE);
+    ASSERT_EQ(rvs_session_set_property(id[i], &prop), RVS_STATUS_SUCCESS);
+  }
+
+  // both sessions run at the same time
+  EXPECT_EQ(rvs_session_execute_async(id[0]), RVS_STATUS_SUCCESS);
+  EXPECT_EQ(rvs_session_execute_async(id[1]), RVS_STATUS_SUCCESS);
+
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(rvs_session_wait(id[i], -1), RVS_STATUS_FAILED);
+    rvs_session_state_t state;
+    EXPECT_EQ(rvs_session_get_state(id[i], &state), RVS_STATUS_SUCCESS);
+    EXPECT_EQ(state, RVS_SESSION_STATE_COMPLETED);
+    // result is kept until session is executed again
+    EXPECT_EQ(rvs_session_wait(id[i], 0), RVS_STATUS_FAILED);
+    EXPECT_EQ(rvs_session_cancel(id[i]), RVS_STATUS_INVALID_SESSION_STATE);
+  }
+
+  // synchronous execution on top of the same machinery
+  ASSERT_EQ(rvs_session_set_property(id[0], &prop), RVS_STATUS_SUCCESS);
+  EXPECT_EQ(rvs_session_execute(id[0]), RVS_STATUS_FAILED);
+
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(rvs_session_destroy(id[i]), RVS_STATUS_SUCCESS);
+  }
+  EXPECT_EQ(rvs_terminate(), RVS_STATUS_SUCCESS);
+}
+
+TEST(Session, max_sessions) {
+  ASSERT_EQ(rvs_initialize(), RVS_STATUS_SUCCESS);
+
+  std::vector<rvs_session_id_t> ids;
+  rvs_session_id_t id;
+  while (rvs_session_create(&id, session_cb) == RVS_STATUS_SUCCESS) {
+    ids.push_back(id);
+    ASSERT_LE(ids.size(), 64u);
+  }
+  EXPECT_GT(ids.size(), 1u);
+
+  for (auto i : ids) {
+    EXPECT_EQ(rvs_session_destroy(i), RVS_STATUS_SUCCESS);
+  }
+  EXPECT_EQ(rvs_terminate(), RVS_STATUS_SUCCESS);
+}
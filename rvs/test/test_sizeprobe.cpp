@@ -0,0 +1,190 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <math.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvssizeprobe.h"
+
+namespace {
+
+// 10 us latency, 25 GB/s link
+const double kAlpha = 10e-6;
+const double kBeta = 25e9;
+
+//! synthetic transfer time with relative gaussian noise
+class fakelink {
+ public:
+  fakelink(double Noise, unsigned int Seed) : rng(Seed), noise(0, Noise) {}
+
+  double time(size_t Size) {
+    samples++;
+    return (kAlpha + Size / kBeta) * (1 + noise(rng));
+  }
+
+  unsigned int samples = 0;
+
+ protected:
+  std::mt19937 rng;
+  std::normal_distribution<double> noise;
+};
+
+}  // namespace
+
+TEST(RunStats, mean_stddev_ci) {
+  rvs::runstats s;
+  EXPECT_EQ(0u, s.count());
+  EXPECT_TRUE(isinf(s.ci95()));
+
+  for (double v : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0}) {
+    s.add(v);
+  }
+  EXPECT_EQ(8u, s.count());
+  EXPECT_DOUBLE_EQ(5.0, s.mean());
+  EXPECT_NEAR(2.13809, s.stddev(), 1e-5);
+  // t(7) = 2.365
+  EXPECT_NEAR(2.365 * 2.13809 / sqrt(8), s.ci95(), 1e-4);
+  EXPECT_NEAR(s.ci95() / 5.0, s.rel_ci95(), 1e-12);
+}
+
+TEST(RunStats, large_sample_uses_normal_quantile) {
+  rvs::runstats s;
+  for (int i = 0; i < 100; i++) {
+    s.add(i % 2 ? 1.0 : -1.0);
+  }
+  EXPECT_NEAR(1.96 * s.stddev() / 10, s.ci95(), 1e-12);
+}
+
+TEST(AlphaBeta, exact_fit) {
+  std::vector<double> sizes;
+  std::vector<double> times;
+  for (double s = 1024; s <= 512.0 * 1024 * 1024; s *= 2) {
+    sizes.push_back(s);
+    times.push_back(kAlpha + s / kBeta);
+  }
+
+  rvs::alphabeta_t fit;
+  ASSERT_EQ(0, rvs::fit_alphabeta(sizes, times, &fit));
+  EXPECT_NEAR(kAlpha, fit.alpha, kAlpha * 1e-6);
+  EXPECT_NEAR(kBeta, fit.beta, kBeta * 1e-6);
+  EXPECT_NEAR(1.0, fit.r2, 1e-9);
+}
+
+TEST(AlphaBeta, degenerate_input) {
+  rvs::alphabeta_t fit;
+  EXPECT_NE(0, rvs::fit_alphabeta({}, {}, &fit));
+  EXPECT_NE(0, rvs::fit_alphabeta({1024}, {1e-6}, &fit));
+  // same size twice
+  EXPECT_NE(0, rvs::fit_alphabeta({1024, 1024}, {1e-6, 2e-6}, &fit));
+  // time decreasing with size
+  EXPECT_NE(0, rvs::fit_alphabeta({1024, 4096}, {2e-6, 1e-6}, &fit));
+  // zero time
+  EXPECT_NE(0, rvs::fit_alphabeta({1024, 4096}, {0, 1e-6}, &fit));
+}
+
+TEST(SizeProbe, initial_grid_is_log_scale) {
+  rvs::sizeprobe probe(1024, 512 * 1024 * 1024, 0.02);
+  const auto& pts = probe.points();
+
+  ASSERT_EQ(11u, pts.size());
+  EXPECT_EQ(1024u, pts.front().size);
+  EXPECT_EQ(512u * 1024 * 1024, pts.back().size);
+  for (size_t i = 1; i + 1 < pts.size(); i++) {
+    EXPECT_EQ(pts[i - 1].size * 4, pts[i].size);
+  }
+}
+
+TEST(SizeProbe, recovers_model_and_refines_knee) {
+  fakelink link(0.01, 1);
+  rvs::sizeprobe probe(1024, 512 * 1024 * 1024, 0.02);
+  size_t size;
+
+  while (probe.next(&size)) {
+    probe.add(size, link.time(size));
+    ASSERT_LT(link.samples, 10000u);
+  }
+
+  rvs::alphabeta_t fit;
+  ASSERT_EQ(0, probe.fit(&fit));
+  EXPECT_NEAR(kAlpha, fit.alpha, kAlpha * 0.05);
+  EXPECT_NEAR(kBeta, fit.beta, kBeta * 0.05);
+
+  // sizes added by refinement are near the half bandwidth size
+  // (alpha * beta = 250 KB), not at the flat ends
+  const double knee = kAlpha * kBeta;
+  unsigned int added = 0;
+  for (const auto& p : probe.points()) {
+    EXPECT_TRUE(p.time.count() >= 3);
+    EXPECT_TRUE(p.time.rel_ci95() <= 0.02 || p.time.count() >= 50);
+    bool on_grid = false;
+    for (size_t g = 1024; g <= 512u * 1024 * 1024; g *= 4) {
+      on_grid |= (p.size == g);
+    }
+    if (!on_grid && p.size != 512u * 1024 * 1024) {
+      added++;
+      EXPECT_GT(p.size, knee / 64) << p.size;
+      EXPECT_LT(p.size, knee * 64) << p.size;
+    }
+  }
+  EXPECT_GT(added, 0u);
+}
+
+TEST(SizeProbe, samples_follow_noise) {
+  fakelink quiet(0.001, 2);
+  fakelink noisy(0.05, 2);
+  size_t size;
+
+  rvs::sizeprobe a(1024, 64 * 1024 * 1024, 0.02);
+  while (a.next(&size)) {
+    a.add(size, quiet.time(size));
+  }
+  rvs::sizeprobe b(1024, 64 * 1024 * 1024, 0.02);
+  while (b.next(&size)) {
+    b.add(size, noisy.time(size));
+  }
+
+  // quiet link converges at the minimum sample count
+  for (const auto& p : a.points()) {
+    EXPECT_EQ(3u, p.time.count());
+  }
+  EXPECT_GT(noisy.samples, 2 * quiet.samples);
+}
+
+TEST(SizeProbe, stops_at_max_samples) {
+  fakelink link(0.5, 3);
+  rvs::sizeprobe probe(4096, 4096 * 16, 0.001, 3, 20, 4);
+  size_t size;
+
+  while (probe.next(&size)) {
+    probe.add(size, fabs(link.time(size)));
+  }
+  EXPECT_LE(probe.points().size(), 4u);
+  for (const auto& p : probe.points()) {
+    EXPECT_EQ(20u, p.time.count());
+  }
+}
@@ -0,0 +1,137 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvsthreadbase.h"
+
+using clk = std::chrono::steady_clock;
+
+namespace {
+
+//! elapsed time in milliseconds
+int64_t ms_since(clk::time_point t0) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+    clk::now() - t0).count();
+}
+
+//! worker sleeping far longer than any test runs
+class sleeper : public rvs::ThreadBase {
+ public:
+  std::atomic<bool> woken{false};
+
+ protected:
+  void run() override {
+    sleep(10000);
+    woken = true;
+  }
+};
+
+}  // namespace
+
+class StopTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    // clear stop request for the following tests
+    rvs::logger::reset();
+  }
+};
+
+TEST_F(StopTest, wait_times_out) {
+  clk::time_point t0 = clk::now();
+  EXPECT_FALSE(rvs::logger::WaitStop(50));
+  EXPECT_GE(ms_since(t0), 50);
+  EXPECT_FALSE(rvs::logger::Stopping());
+}
+
+TEST_F(StopTest, interrupt_wakes_waiters) {
+  std::atomic<int> woken(0);
+  std::thread t1([&]() { if (rvs::logger::WaitStop(10000)) woken++; });
+  std::thread t2([&]() { if (rvs::logger::WaitStop(10000)) woken++; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  clk::time_point t0 = clk::now();
+  rvs::logger::Interrupt();
+  t1.join();
+  t2.join();
+
+  EXPECT_EQ(2, woken.load());
+  EXPECT_LT(ms_since(t0), 1000);
+  EXPECT_TRUE(rvs::logger::Stopping());
+
+  // already stopped, no wait at all
+  EXPECT_TRUE(rvs::logger::WaitStop(10000));
+}
+
+TEST_F(StopTest, session_cancel_wakes_own_waiters) {
+  std::atomic<bool> cancel(false);
+  std::atomic<bool> woken(false);
+  std::atomic<bool> other_woken(false);
+
+  std::thread t1([&]() {
+    rvs::logger::set_cancel_flag(&cancel);
+    woken = rvs::logger::WaitStop(10000);
+  });
+  std::thread t2([&]() {
+    other_woken = rvs::logger::WaitStop(200);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  clk::time_point t0 = clk::now();
+  cancel = true;
+  rvs::logger::NotifyStop();
+  t1.join();
+  EXPECT_LT(ms_since(t0), 1000);
+  EXPECT_TRUE(woken);
+
+  // threads of other sessions keep sleeping
+  t2.join();
+  EXPECT_FALSE(other_woken);
+  EXPECT_FALSE(rvs::logger::Stopping());
+}
+
+TEST_F(StopTest, thread_sleep_wakes_on_stop) {
+  sleeper s;
+  s.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  clk::time_point t0 = clk::now();
+  rvs::logger::Interrupt();
+  s.join();
+
+  EXPECT_TRUE(s.woken);
+  EXPECT_LT(ms_since(t0), 1000);
+}
+
+TEST_F(StopTest, interrupt_before_log_file_kept) {
+  // signal arriving while the command line is still being processed
+  rvs::logger::Interrupt();
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  EXPECT_TRUE(rvs::logger::Stopping());
+}
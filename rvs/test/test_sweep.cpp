@@ -0,0 +1,124 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "yaml-cpp/yaml.h"
+
+#include "include/rvssweep.h"
+
+TEST(Sweep, product_first_entry_slowest) {
+  rvs::sweep sw;
+  std::string err;
+
+  YAML::Node node = YAML::Load("{ops_type: [sgemm, dgemm], "
+                               "matrix_size_a: [1, 2, 3]}");
+  ASSERT_EQ(0, sw.parse(node, &err)) << err;
+  ASSERT_EQ(6u, sw.size());
+  EXPECT_EQ(std::vector<std::string>({"ops_type", "matrix_size_a"}),
+            sw.properties());
+  EXPECT_EQ("sgemm", sw.point(0).at("ops_type"));
+  EXPECT_EQ("1", sw.point(0).at("matrix_size_a"));
+  EXPECT_EQ("sgemm", sw.point(2).at("ops_type"));
+  EXPECT_EQ("3", sw.point(2).at("matrix_size_a"));
+  EXPECT_EQ("dgemm", sw.point(3).at("ops_type"));
+  EXPECT_EQ("1", sw.point(3).at("matrix_size_a"));
+}
+
+TEST(Sweep, joined_keys_and_ranges) {
+  rvs::sweep sw;
+  std::string err;
+
+  YAML::Node node = YAML::Load(
+    "{'matrix_size_a, matrix_size_b': {start: 100, stop: 300, step: 100}, "
+    "block_size: {start: 4, stop: 100, factor: 4}}");
+  ASSERT_EQ(0, sw.parse(node, &err)) << err;
+  ASSERT_EQ(9u, sw.size());
+  EXPECT_EQ(3u, sw.properties().size());
+  for (size_t i = 0; i < sw.size(); i++) {
+    EXPECT_EQ(sw.point(i).at("matrix_size_a"),
+              sw.point(i).at("matrix_size_b"));
+  }
+  EXPECT_EQ("4", sw.point(0).at("block_size"));
+  EXPECT_EQ("16", sw.point(1).at("block_size"));
+  EXPECT_EQ("64", sw.point(2).at("block_size"));
+  EXPECT_EQ("300", sw.point(8).at("matrix_size_a"));
+
+  std::map<std::string, std::string> m = sw.max();
+  EXPECT_EQ("300", m["matrix_size_a"]);
+  EXPECT_EQ("300", m["matrix_size_b"]);
+  EXPECT_EQ("64", m["block_size"]);
+}
+
+TEST(Sweep, max_skips_non_numeric) {
+  rvs::sweep sw;
+  std::string err;
+
+  ASSERT_EQ(0, sw.parse(YAML::Load("{ops_type: [sgemm, dgemm], count: 7}"),
+                        &err)) << err;
+  std::map<std::string, std::string> m = sw.max();
+  EXPECT_EQ(1u, m.size());
+  EXPECT_EQ("7", m["count"]);
+}
+
+TEST(Sweep, errors) {
+  rvs::sweep sw;
+  std::string err;
+
+  EXPECT_NE(0, sw.parse(YAML::Load("[1, 2]"), &err));
+  EXPECT_NE(0, sw.parse(YAML::Load("{a: []}"), &err));
+  EXPECT_NE(0, sw.parse(YAML::Load("{a: [1], 'a,b': [2]}"), &err));
+  EXPECT_NE(0, sw.parse(YAML::Load("{a: {start: 5, stop: 1, step: 1}}"),
+                        &err));
+  EXPECT_NE(0, sw.parse(YAML::Load("{a: {start: 1, stop: 5}}"), &err));
+  EXPECT_NE(0, sw.parse(YAML::Load("{a: {start: 0, stop: 5, factor: 2}}"),
+                        &err));
+  EXPECT_NE(0, sw.parse(YAML::Load("{a: {start: 1, stop: 5, step: 1, "
+                                   "factor: 2}}"), &err));
+  EXPECT_NE(0, sw.parse(YAML::Load("{a: {start: 1, stop: 100000, step: 1}}"),
+                        &err));
+  EXPECT_NE(0, sw.parse(YAML::Load("{a: {start: 1, stop: 100, step: 1}, "
+                                   "b: {start: 1, stop: 100, step: 1}}"),
+                        &err));
+  EXPECT_FALSE(err.empty());
+}
+
+TEST(Sweep, table) {
+  rvs::sweep sw;
+  std::string err;
+
+  ASSERT_EQ(0, sw.parse(YAML::Load("{size: [8, 1024]}"), &err)) << err;
+  sw.add_result(0, 0, {{"gflops[GFlop/s]", 12.5}});
+  sw.add_result(1, 1, {});
+
+  std::vector<std::string> lines = sw.table();
+  ASSERT_EQ(3u, lines.size());
+  EXPECT_EQ("size  result  gflops[GFlop/s]", lines[0]);
+  EXPECT_EQ("8     pass    12.500", lines[1]);
+  EXPECT_EQ("1024  fail    -", lines[2]);
+}
@@ -0,0 +1,129 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvstimerservice.h"
+#include "include/rvsliblogger.h"
+
+using clk = std::chrono::steady_clock;
+
+TEST(TimerService, periodic_jitter) {
+  std::mutex mtx;
+  std::vector<clk::time_point> ticks;
+
+  rvs::timerservice& ts = rvs::timerservice::get();
+  clk::time_point t0 = clk::now();
+  uint64_t id = ts.add(10, false, [&]() {
+    std::lock_guard<std::mutex> lk(mtx);
+    ticks.push_back(clk::now());
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(205));
+  ts.cancel(id);
+
+  std::lock_guard<std::mutex> lk(mtx);
+  ASSERT_GE(ticks.size(), 19u);
+  ASSERT_LE(ticks.size(), 21u);
+  // ticks are scheduled from t0, not from the previous callback, so
+  // lateness does not accumulate
+  for (size_t i = 0; i < ticks.size(); i++) {
+    auto late = std::chrono::duration_cast<std::chrono::microseconds>(
+      ticks[i] - (t0 + std::chrono::milliseconds(10 * (i + 1)))).count();
+    EXPECT_GE(late, 0);
+    EXPECT_LT(late, 20000) << "tick " << i;
+  }
+}
+
+TEST(TimerService, once_and_cancel) {
+  std::atomic<int> fired(0);
+
+  uint64_t id1 = rvs::timerservice::get().add(20, true, [&]() { fired++; });
+  uint64_t id2 = rvs::timerservice::get().add(20, true, [&]() { fired += 10; });
+  EXPECT_TRUE(rvs::timerservice::get().active(id1));
+  rvs::timerservice::get().cancel(id2);
+  EXPECT_FALSE(rvs::timerservice::get().active(id2));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  EXPECT_EQ(1, fired.load());
+  EXPECT_FALSE(rvs::timerservice::get().active(id1));
+
+  // cancel of an expired timer is a no-op
+  rvs::timerservice::get().cancel(id1);
+}
+
+TEST(TimerService, cancel_waits_for_callback) {
+  std::atomic<bool> in_cb(false);
+  std::atomic<bool> done(false);
+
+  uint64_t id = rvs::timerservice::get().add(1, false, [&]() {
+    in_cb = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    done = true;
+  });
+  while (!in_cb) {
+    std::this_thread::yield();
+  }
+  rvs::timerservice::get().cancel(id);
+  EXPECT_TRUE(done.load());
+
+  // no further callbacks once cancel returned
+  done = false;
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(done.load());
+}
+
+TEST(TimerService, cancel_from_callback) {
+  std::atomic<int> fired(0);
+  std::atomic<uint64_t> id(0);
+
+  id = rvs::timerservice::get().add(5, false, [&]() {
+    fired++;
+    rvs::timerservice::get().cancel(id);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  EXPECT_EQ(1, fired.load());
+  EXPECT_FALSE(rvs::timerservice::get().active(id));
+}
+
+TEST(TimerService, session_stop_flag) {
+  std::atomic<bool> stop(true);
+  std::atomic<int> stopping(-1);
+
+  rvs::logger::set_cancel_flag(&stop);
+  rvs::timerservice::get().add(1, true, [&]() {
+    stopping = rvs::logger::Stopping() ? 1 : 0;
+  });
+  rvs::logger::set_cancel_flag(nullptr);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(1, stopping.load());
+}
@@ -0,0 +1,281 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvstopology.h"
+
+#define BENCH_GPUS       16
+#define BENCH_LOOPS      20
+
+// fake KFD topology of a 16 GPU system: CPU nodes 0 and 1, GPU nodes 2-17,
+// each GPU with a PCIe link to its CPU node and XGMI links to all other GPUs
+class TopologyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/rvs_sysfs_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(tmpl));
+    root = tmpl;
+    nodes = root + RVS_KFD_NODES_PATH;
+
+    for (int cpu = 0; cpu < 2; cpu++) {
+      put(cpu, "gpu_id", "0");
+      put(cpu, "properties", "cpu_cores_count 64\nsimd_count 0\n");
+    }
+    for (int i = 0; i < BENCH_GPUS; i++) {
+      int node = i + 2;
+      std::string props;
+      for (int p = 0; p < 40; p++) {
+        props += "prop_" + std::to_string(p) + " " + std::to_string(p) + "\n";
+      }
+      props += "device_id 29631\n";
+      props += "location_id " + std::to_string(location(i)) + "\n";
+      props += "domain " + std::to_string(i / 8) + "\n";
+      put(node, "gpu_id", std::to_string(gpu(i)));
+      put(node, "properties", props);
+
+      int link = 0;
+      put(node, "io_links/0/properties", "type 2\nnode_from " +
+          std::to_string(node) + "\nnode_to " + std::to_string(i / 8) + "\n");
+      for (int j = 0; j < BENCH_GPUS; j++) {
+        if (j == i) {
+          continue;
+        }
+        put(node, "io_links/" + std::to_string(++link) + "/properties",
+            "type 11\nnode_from " + std::to_string(node) + "\nnode_to " +
+            std::to_string(j + 2) + "\nweight 15\n");
+      }
+    }
+
+    rvs::topology::set_sysfs_root(root);
+  }
+
+  void TearDown() override {
+    rvs::topology::set_sysfs_root("");
+    std::string cmd = "rm -rf " + root;
+    EXPECT_EQ(0, system(cmd.c_str()));
+  }
+
+  static uint16_t gpu(int i) { return 1000 + i * 7; }
+  static uint16_t location(int i) { return (0x10 + i) << 8; }
+
+  void put(int node, const std::string& file, const std::string& content) {
+    std::string path = nodes + "/" + std::to_string(node) + "/" + file;
+    std::string cmd = "mkdir -p " + path.substr(0, path.rfind('/'));
+    ASSERT_EQ(0, system(cmd.c_str()));
+    std::ofstream f(path);
+    f << content;
+  }
+
+  std::string root;
+  std::string nodes;
+};
+
+// per property scan of every node, as gpulist::Initialize() used to do
+// (name nullptr - gpu_id, "node" - node ID)
+static void legacy_scan(const std::string& nodes, const char* name,
+                        std::vector<uint16_t>* pvals) {
+  int num_nodes = 0;
+  while (std::ifstream(nodes + "/" + std::to_string(num_nodes) + "/gpu_id")) {
+    num_nodes++;
+  }
+  for (int node = 0; node < num_nodes; node++) {
+    std::ifstream f_id(nodes + "/" + std::to_string(node) + "/gpu_id");
+    std::ifstream f_prop(nodes + "/" + std::to_string(node) + "/properties");
+    int gpu_id = 0;
+    f_id >> gpu_id;
+    if (gpu_id == 0) {
+      continue;
+    }
+    if (name == nullptr) {
+      pvals->push_back(gpu_id);
+      continue;
+    }
+    if (std::string(name) == "node") {
+      pvals->push_back(node);
+      continue;
+    }
+    std::string key;
+    uint32_t val;
+    while (f_prop >> key >> val) {
+      if (key == name) {
+        pvals->push_back(val);
+        break;
+      }
+    }
+  }
+}
+
+// gpup reading all properties and io_links of a node
+static size_t legacy_gpup(const std::string& nodes, uint16_t node) {
+  std::string path = nodes + "/" + std::to_string(node);
+  std::string name, val;
+  size_t n = 0;
+
+  std::ifstream f_prop(path + "/properties");
+  while (f_prop >> name >> val) {
+    n++;
+  }
+  for (int link = 0; ; link++) {
+    std::ifstream f_link(path + "/io_links/" + std::to_string(link) +
+                         "/properties");
+    if (!f_link.is_open()) {
+      break;
+    }
+    while (f_link >> name >> val) {
+      n++;
+    }
+  }
+  return n;
+}
+
+TEST_F(TopologyTest, single_pass) {
+  rvs::topology topo;
+  ASSERT_EQ(2 + BENCH_GPUS, topo.load(root));
+
+  std::vector<uint16_t> gpus;
+  topo.gpus(&gpus);
+  ASSERT_EQ(static_cast<size_t>(BENCH_GPUS), gpus.size());
+
+  for (int i = 0; i < BENCH_GPUS; i++) {
+    EXPECT_EQ(gpu(i), gpus[i]);
+
+    const rvs::toponode* node = topo.by_gpu(gpu(i));
+    ASSERT_NE(nullptr, node);
+    EXPECT_EQ(i + 2, node->node);
+    EXPECT_EQ(location(i), node->location_id);
+    EXPECT_EQ(29631, node->device_id);
+    EXPECT_EQ(i / 8, node->domain);
+    EXPECT_EQ(node, topo.by_node(i + 2));
+    EXPECT_EQ(node, topo.by_location(location(i)));
+    EXPECT_EQ(node, topo.by_bdf(i / 8, location(i)));
+
+    // properties kept in file order, io_links in numeric order
+    ASSERT_EQ(43u, node->properties.size());
+    EXPECT_EQ("prop_0", node->properties[0].first);
+    uint64_t val;
+    ASSERT_TRUE(node->get("prop_39", &val));
+    EXPECT_EQ(39u, val);
+    ASSERT_EQ(static_cast<size_t>(BENCH_GPUS), node->io_links.size());
+    EXPECT_EQ(i / 8, node->io_links[0].node_to);
+    for (size_t l = 0; l < node->io_links.size(); l++) {
+      EXPECT_EQ(l, node->io_links[l].id);
+    }
+    ASSERT_TRUE(node->io_links[1].get("type", &val));
+    EXPECT_EQ(11u, val);
+  }
+
+  // CPU nodes are not GPUs
+  ASSERT_NE(nullptr, topo.by_node(1));
+  EXPECT_EQ(0, topo.by_node(1)->gpu_id);
+  EXPECT_EQ(nullptr, topo.by_gpu(0));
+  EXPECT_EQ(nullptr, topo.by_gpu(1));
+  EXPECT_EQ(nullptr, topo.by_node(100));
+  EXPECT_EQ(nullptr, topo.by_bdf(1, location(0)));
+}
+
+TEST_F(TopologyTest, missing) {
+  rvs::topology topo;
+  EXPECT_EQ(-1, topo.load(root + "/nonexistent"));
+  EXPECT_TRUE(topo.nodes().empty());
+  EXPECT_EQ(nullptr, topo.by_gpu(gpu(0)));
+}
+
+TEST_F(TopologyTest, snapshot) {
+  auto topo = rvs::topology::snapshot();
+  ASSERT_NE(nullptr, topo->by_gpu(gpu(3)));
+  EXPECT_EQ(topo, rvs::topology::snapshot());
+
+  // refresh replaces the snapshot, snapshots already held stay valid
+  std::string cmd = "rm -rf " + nodes + "/5";
+  ASSERT_EQ(0, system(cmd.c_str()));
+  EXPECT_EQ(1 + BENCH_GPUS, rvs::topology::refresh());
+  EXPECT_EQ(nullptr, rvs::topology::snapshot()->by_gpu(gpu(3)));
+  ASSERT_NE(nullptr, topo->by_gpu(gpu(3)));
+  EXPECT_EQ(5, topo->by_gpu(gpu(3))->node);
+
+  // new root is read on next use
+  rvs::topology::set_sysfs_root(root + "/nonexistent");
+  EXPECT_TRUE(rvs::topology::snapshot()->nodes().empty());
+}
+
+TEST_F(TopologyTest, benchmark) {
+  size_t found = 0;
+  size_t props = 0;
+
+  // five scans, lookups by linear search over parallel vectors, gpup
+  // reading properties again
+  auto t0 = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < BENCH_LOOPS; loop++) {
+    std::vector<uint16_t> location_id, gpu_id, device_id, domain_id, node_id;
+    legacy_scan(nodes, "location_id", &location_id);
+    legacy_scan(nodes, nullptr, &gpu_id);
+    legacy_scan(nodes, "device_id", &device_id);
+    legacy_scan(nodes, "node", &node_id);
+    legacy_scan(nodes, "domain", &domain_id);
+    for (int i = 0; i < BENCH_GPUS; i++) {
+      auto it = std::find(location_id.begin(), location_id.end(),
+                          location(i));
+      found += gpu_id[it - location_id.begin()] == gpu(i);
+      props += legacy_gpup(nodes, node_id[it - location_id.begin()]);
+    }
+  }
+
+  // single pass, indexed lookups
+  auto t1 = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < BENCH_LOOPS; loop++) {
+    rvs::topology topo;
+    topo.load(root);
+    for (int i = 0; i < BENCH_GPUS; i++) {
+      const rvs::toponode* node = topo.by_location(location(i));
+      found += node->gpu_id == gpu(i);
+      props += node->properties.size();
+      for (const auto& link : node->io_links) {
+        props += link.properties.size();
+      }
+    }
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  EXPECT_EQ(2u * BENCH_LOOPS * BENCH_GPUS, found);
+  EXPECT_EQ(2u * BENCH_LOOPS * BENCH_GPUS * (43 + 3 + 4 * (BENCH_GPUS - 1)),
+            props);
+
+  double legacy_us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+  double snap_us = std::chrono::duration<double, std::micro>(t2 - t1).count();
+  std::cout << "5 scans + gpup: " << legacy_us / BENCH_LOOPS << " us"
+            << std::endl;
+  std::cout << "single pass:    " << snap_us / BENCH_LOOPS << " us"
+            << std::endl;
+  EXPECT_LT(snap_us, legacy_us);
+}
@@ -0,0 +1,257 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsxfercache.h"
+
+namespace {
+
+/**
+ * Allocator handing out distinct tokens in place of HSA buffers and
+ * signals; a transfer holds Size bytes per direction.
+ */
+class fakexfer : public rvs::xferallocator {
+ public:
+  int xfer_alloc(const rvs::xferkey_t& Key, size_t Size,
+                 void** ppData, size_t* pBytes) override {
+    std::lock_guard<std::mutex> lk(mtx);
+    allocs++;
+    if (fail) {
+      return -1;
+    }
+    void* p = reinterpret_cast<void*>(next++);
+    live[p] = Size;
+    *ppData = p;
+    *pBytes = Size * (std::get<2>(Key) ? 2 : 1);
+    return 0;
+  }
+
+  void xfer_free(void* pData) override {
+    std::lock_guard<std::mutex> lk(mtx);
+    ASSERT_EQ(1u, live.erase(pData));
+  }
+
+  std::mutex mtx;
+  std::map<void*, size_t> live;
+  uintptr_t next = 0x1000;
+  unsigned int allocs = 0;
+  bool fail = false;
+};
+
+rvs::xferkey_t key(uint32_t src, uint32_t dst, bool bidir = false) {
+  return std::make_tuple(src, dst, bidir);
+}
+
+}  // namespace
+
+TEST(XferCache, reuse_and_grow) {
+  fakexfer fx;
+  rvs::xfercache cache(&fx, SIZE_MAX);
+  rvs::xfercachestats_t st;
+  rvs::xferlease_t lease;
+
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 1024, &lease));
+  void* first = lease.data;
+  cache.release(&lease);
+
+  // smaller transfer reuses the buffers
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 512, &lease));
+  EXPECT_EQ(first, lease.data);
+  cache.release(&lease);
+
+  // larger one reallocates, old buffers are freed first
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 4096, &lease));
+  EXPECT_NE(first, lease.data);
+  EXPECT_EQ(1u, fx.live.size());
+  cache.release(&lease);
+
+  // direction is part of the key
+  ASSERT_EQ(0, cache.acquire(key(0, 1, true), 1024, &lease));
+  cache.release(&lease);
+
+  cache.get_stats(&st);
+  EXPECT_EQ(1u, st.hits);
+  EXPECT_EQ(3u, st.misses);
+  EXPECT_EQ(0u, st.evictions);
+  EXPECT_EQ(4096u + 2048u, st.bytes);
+
+  cache.clear();
+  cache.get_stats(&st);
+  EXPECT_EQ(0u, st.bytes);
+  EXPECT_TRUE(fx.live.empty());
+}
+
+TEST(XferCache, busy_lease_gets_temporary) {
+  fakexfer fx;
+  rvs::xfercache cache(&fx, SIZE_MAX);
+  rvs::xfercachestats_t st;
+  rvs::xferlease_t lease;
+  rvs::xferlease_t temp;
+
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 1024, &lease));
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 1024, &temp));
+  EXPECT_NE(lease.data, temp.data);
+  EXPECT_EQ(nullptr, temp.entry);
+  EXPECT_EQ(2u, fx.live.size());
+
+  // temporary buffers are not cached
+  cache.get_stats(&st);
+  EXPECT_EQ(1024u, st.bytes);
+  EXPECT_EQ(2u, st.misses);
+  cache.release(&temp);
+  EXPECT_EQ(1u, fx.live.size());
+
+  // leased transfer survives clear()
+  cache.clear();
+  EXPECT_EQ(1u, fx.live.size());
+  cache.release(&lease);
+
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 1024, &lease));
+  cache.release(&lease);
+  cache.get_stats(&st);
+  EXPECT_EQ(1u, st.hits);
+
+  cache.clear();
+  EXPECT_TRUE(fx.live.empty());
+}
+
+TEST(XferCache, lru_eviction) {
+  fakexfer fx;
+  rvs::xfercache cache(&fx, 3000);
+  rvs::xfercachestats_t st;
+  rvs::xferlease_t lease;
+  rvs::xferlease_t held;
+
+  for (uint32_t dst = 1; dst <= 3; dst++) {
+    ASSERT_EQ(0, cache.acquire(key(0, dst), 1000, &lease));
+    cache.release(&lease);
+  }
+  // 0->1 becomes most recently used
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 1000, &lease));
+  cache.release(&lease);
+
+  // fourth transfer exceeds the limit: least recently used 0->2 goes
+  ASSERT_EQ(0, cache.acquire(key(0, 4), 1000, &lease));
+  cache.release(&lease);
+  cache.get_stats(&st);
+  EXPECT_EQ(1u, st.evictions);
+  EXPECT_EQ(3000u, st.bytes);
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 1000, &lease));
+  cache.release(&lease);
+  ASSERT_EQ(0, cache.acquire(key(0, 3), 1000, &lease));
+  cache.release(&lease);
+  cache.get_stats(&st);
+  EXPECT_EQ(3u, st.hits);
+
+  // transfers in use are never evicted
+  ASSERT_EQ(0, cache.acquire(key(0, 4), 1000, &held));
+  cache.set_limit(0);
+  cache.get_stats(&st);
+  EXPECT_EQ(1000u, st.bytes);
+  EXPECT_EQ(1u, fx.live.size());
+  EXPECT_EQ(1u, fx.live.count(held.data));
+
+  // ... until released: the next allocation evicts it, not itself
+  cache.release(&held);
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 1000, &lease));
+  EXPECT_EQ(1u, fx.live.size());
+  EXPECT_EQ(1u, fx.live.count(lease.data));
+  cache.release(&lease);
+  cache.set_limit(0);
+  cache.get_stats(&st);
+  EXPECT_EQ(0u, st.bytes);
+  EXPECT_EQ(5u, st.evictions);
+  EXPECT_TRUE(fx.live.empty());
+}
+
+TEST(XferCache, alloc_failure) {
+  fakexfer fx;
+  rvs::xfercache cache(&fx, SIZE_MAX);
+  rvs::xfercachestats_t st;
+  rvs::xferlease_t lease;
+
+  fx.fail = true;
+  EXPECT_NE(0, cache.acquire(key(0, 1), 1024, &lease));
+
+  // failed transfer is not left leased, next call allocates again
+  fx.fail = false;
+  ASSERT_EQ(0, cache.acquire(key(0, 1), 1024, &lease));
+  EXPECT_NE(nullptr, lease.entry);
+  cache.release(&lease);
+  EXPECT_EQ(2u, fx.allocs);
+
+  cache.get_stats(&st);
+  EXPECT_EQ(1024u, st.bytes);
+  EXPECT_EQ(2u, st.misses);
+  cache.clear();
+}
+
+TEST(XferCache, concurrent) {
+  fakexfer fx;
+  rvs::xfercache cache(&fx, 8 * 4096);
+  std::atomic<int> errors(0);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 2000; i++) {
+        rvs::xferlease_t lease;
+        if (cache.acquire(key(t % 3, (i % 5) + 3, i & 1),
+                          1024 * (1 + i % 4), &lease)) {
+          errors++;
+          continue;
+        }
+        cache.release(&lease);
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  EXPECT_EQ(0, errors.load());
+
+  rvs::xfercachestats_t st;
+  cache.get_stats(&st);
+  EXPECT_EQ(16000u, st.hits + st.misses);
+  EXPECT_LE(st.bytes, 8u * 4096);
+
+  size_t live_bytes = 0;
+  for (auto& it : fx.live) {
+    live_bytes += it.second;
+  }
+  EXPECT_LE(live_bytes, st.bytes);
+
+  cache.clear();
+  EXPECT_TRUE(fx.live.empty());
+}
@@ -34,12 +34,8 @@
 
 #include "rocm_smi/rocm_smi.h"
 #include "include/gpu_util.h"
-std::vector<uint16_t> rvs::gpulist::location_id;
-std::vector<uint16_t> rvs::gpulist::gpu_id;
-std::vector<uint16_t> rvs::gpulist::device_id;
-std::vector<uint16_t> rvs::gpulist::node_id;
-std::vector<uint16_t> rvs::gpulist::domain_id;
-std::map<std::pair<uint16_t, uint16_t> , uint16_t> rvs::gpulist::domain_loc_map;
+#include "include/rvstopology.h"
+
 using std::vector;
 using std::string;
 using std::ifstream;
@@ -83,39 +79,10 @@ int gpu_num_subdirs(const char* dirpath, const char* prefix) {
  * @return
  */
 void gpu_get_all_location_id(std::vector<uint16_t>* pgpus_location_id) {
-  ifstream f_id, f_prop;
-  char path[KFD_PATH_MAX_LENGTH];
-
-  std::string prop_name;
-  int gpu_id;
-  uint32_t prop_val;
-
-
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
-
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-           node_id);
-    f_id.open(path);
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/properties",
-             KFD_SYS_PATH_NODES, node_id);
-    f_prop.open(path);
-
-    f_id >> gpu_id;
-    if (gpu_id != 0) {
-      while (f_prop >> prop_name) {
-        if (prop_name == "location_id") {
-          f_prop >> prop_val;
-          (*pgpus_location_id).push_back(prop_val);
-          break;
-        }
-      }
-    }
-    f_id.close();
-    f_prop.close();
+  auto topo = rvs::topology::snapshot();
+  for (const auto& node : topo->nodes()) {
+    if (node.gpu_id != 0)
+      (*pgpus_location_id).push_back(node.location_id);
   }
 }
 
@@ -125,28 +92,7 @@ void gpu_get_all_location_id(std::vector<uint16_t>* pgpus_location_id) {
  * @return
  */
 void gpu_get_all_gpu_id(std::vector<uint16_t>* pgpus_id) {
-  ifstream f_id, f_prop;
-  char path[KFD_PATH_MAX_LENGTH];
-
-  int gpu_id;
-
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
-
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-             node_id);
-    f_id.open(path);
-
-    f_id >> gpu_id;
-
-    if (gpu_id != 0)
-      (*pgpus_id).push_back(gpu_id);
-
-    f_id.close();
-  }
+  rvs::topology::snapshot()->gpus(pgpus_id);
 }
 
 /**
@@ -155,40 +101,10 @@ void gpu_get_all_gpu_id(std::vector<uint16_t>* pgpus_id) {
  * @return
  */
 void gpu_get_all_device_id(std::vector<uint16_t>* pgpus_device_id) {
-  ifstream f_id, f_prop;
-  char path[KFD_PATH_MAX_LENGTH];
-
-  std::string prop_name;
-  int gpu_id;
-  uint32_t prop_val;
-
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
-
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-             node_id);
-    f_id.open(path);
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/properties",
-             KFD_SYS_PATH_NODES, node_id);
-    f_prop.open(path);
-
-    f_id >> gpu_id;
-
-    if (gpu_id != 0) {
-      while (f_prop >> prop_name) {
-        if (prop_name == "device_id") {
-          f_prop >> prop_val;
-          (*pgpus_device_id).push_back(prop_val);
-          break;
-        }
-      }
-    }
-
-    f_id.close();
-    f_prop.close();
+  auto topo = rvs::topology::snapshot();
+  for (const auto& node : topo->nodes()) {
+    if (node.gpu_id != 0)
+      (*pgpus_device_id).push_back(node.device_id);
   }
 }
 
@@ -198,26 +114,10 @@ void gpu_get_all_device_id(std::vector<uint16_t>* pgpus_device_id) {
  * @return
  */
 void gpu_get_all_node_id(std::vector<uint16_t>* pgpus_node_id) {
-  ifstream f_id;
-  char path[KFD_PATH_MAX_LENGTH];
-  int gpu_id;
-
-
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
-
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-           node_id);
-    f_id.open(path);
-    f_id >> gpu_id;
-
-    if (gpu_id != 0) {
-      (*pgpus_node_id).push_back(node_id);
-    }
-    f_id.close();
+  auto topo = rvs::topology::snapshot();
+  for (const auto& node : topo->nodes()) {
+    if (node.gpu_id != 0)
+      (*pgpus_node_id).push_back(node.node);
   }
 }
 
@@ -226,48 +126,15 @@ void gpu_get_all_node_id(std::vector<uint16_t>* pgpus_node_id) {
  * @param pgpus_domain_id ptr to vector that will store all the GPU domain_id
  * @return
  */
-void gpu_get_all_domain_id(std::vector<uint16_t>* pgpus_domain_id, 
+void gpu_get_all_domain_id(std::vector<uint16_t>* pgpus_domain_id,
 		std::map<std::pair<uint16_t, uint16_t> , uint16_t>& pgpus_dom_loc_map) {
-  ifstream f_id, f_prop;
-  char path[KFD_PATH_MAX_LENGTH];
-
-  std::string prop_name;
-  int gpu_id;
-  uint32_t domain_val;
-  uint32_t loc_val;
-
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
-
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-             node_id);
-    f_id.open(path);
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/properties",
-             KFD_SYS_PATH_NODES, node_id);
-    f_prop.open(path);
-
-    f_id >> gpu_id;
-
-    if (gpu_id != 0) {
-      while (f_prop >> prop_name) {
-        if (prop_name == "domain") {
-          f_prop >> domain_val;
-          (*pgpus_domain_id).push_back(domain_val);
-          continue;
-        }
-	else if(prop_name == "location_id"){
-            f_prop >> loc_val;
-            continue;
-	}
-      }
-      pgpus_dom_loc_map[std::make_pair(domain_val, loc_val)] = gpu_id;
+  auto topo = rvs::topology::snapshot();
+  for (const auto& node : topo->nodes()) {
+    if (node.gpu_id != 0) {
+      (*pgpus_domain_id).push_back(node.domain);
+      pgpus_dom_loc_map[std::make_pair(node.domain, node.location_id)] =
+        node.gpu_id;
     }
-
-    f_id.close();
-    f_prop.close();
   }
 }
 
@@ -306,16 +173,16 @@ bool gpu_check_if_mcm_die (int idx) {
 
 /**
  * @brief Initialize gpulist helper class
- * @return 0 if successful, -1 otherwise
+ *
+ * KFD topology is read once per process, on first use; lookups below are
+ * served from the shared snapshot (see rvs::topology). Lookups keep a
+ * reference to the snapshot while they use its nodes, as a refresh may
+ * replace it meanwhile.
+ *
+ * @return 0 if successful, -1 if there is no KFD topology
  **/
 int rvs::gpulist::Initialize() {
-  gpu_get_all_location_id(&location_id);
-  gpu_get_all_gpu_id(&gpu_id);
-  gpu_get_all_device_id(&device_id);
-  gpu_get_all_node_id(&node_id);
-  gpu_get_all_domain_id(&domain_id, domain_loc_map);
-
-  return 0;
+  return rvs::topology::snapshot()->nodes().empty() ? -1 : 0;
 }
 
 
@@ -327,13 +194,12 @@ int rvs::gpulist::Initialize() {
  **/
 int rvs::gpulist::gpu2location(const uint16_t GpuID,
                                uint16_t* pLocationID) {
-  const auto it = std::find(gpu_id.cbegin(),
-                            gpu_id.cend(), GpuID);
-  if (it == gpu_id.cend()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_gpu(GpuID);
+  if (!node) {
     return -1;
   }
-  size_t pos = std::distance(gpu_id.cbegin(), it);
-  *pLocationID = location_id[pos];
+  *pLocationID = node->location_id;
   return 0;
 }
 
@@ -345,13 +211,12 @@ int rvs::gpulist::gpu2location(const uint16_t GpuID,
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::location2gpu(const uint16_t LocationID, uint16_t* pGpuID) {
-  const auto it = std::find(location_id.cbegin(),
-                            location_id.cend(), LocationID);
-  if (it == location_id.cend()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_location(LocationID);
+  if (!node) {
     return -1;
   }
-  size_t pos = std::distance(location_id.cbegin(), it);
-  *pGpuID = gpu_id[pos];
+  *pGpuID = node->gpu_id;
   return 0;
 }
 
@@ -363,13 +228,12 @@ int rvs::gpulist::location2gpu(const uint16_t LocationID, uint16_t* pGpuID) {
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::node2gpu(const uint16_t NodeID, uint16_t* pGpuID) {
-  const auto it = std::find(node_id.cbegin(),
-                            node_id.cend(), NodeID);
-  if (it == node_id.cend()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_node(NodeID);
+  if (!node || node->gpu_id == 0) {
     return -1;
   }
-  size_t pos = std::distance(node_id.cbegin(), it);
-  *pGpuID = gpu_id[pos];
+  *pGpuID = node->gpu_id;
   return 0;
 }
 
@@ -382,13 +246,12 @@ int rvs::gpulist::node2gpu(const uint16_t NodeID, uint16_t* pGpuID) {
  **/
 int rvs::gpulist::location2device(const uint16_t LocationID,
                                   uint16_t* pDeviceID) {
-  const auto it = std::find(location_id.cbegin(),
-                            location_id.cend(), LocationID);
-  if (it == location_id.cend()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_location(LocationID);
+  if (!node) {
     return -1;
   }
-  size_t pos = std::distance(location_id.cbegin(), it);
-  *pDeviceID = device_id[pos];
+  *pDeviceID = node->device_id;
   return 0;
 }
 
@@ -400,14 +263,12 @@ int rvs::gpulist::location2device(const uint16_t LocationID,
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::gpu2device(const uint16_t GpuID, uint16_t* pDeviceID) {
-  const auto it = std::find(gpu_id.cbegin(),
-                            gpu_id.cend(), GpuID);
-  if (it == gpu_id.cend()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_gpu(GpuID);
+  if (!node) {
     return -1;
   }
-
-  size_t pos = std::distance(gpu_id.cbegin(), it);
-  *pDeviceID = device_id[pos];
+  *pDeviceID = node->device_id;
   return 0;
 }
 
@@ -419,14 +280,12 @@ int rvs::gpulist::gpu2device(const uint16_t GpuID, uint16_t* pDeviceID) {
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::gpu2node(const uint16_t GpuID, uint16_t* pNodeID) {
-  const auto it = std::find(gpu_id.cbegin(),
-                            gpu_id.cend(), GpuID);
-  if (it == gpu_id.cend()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_gpu(GpuID);
+  if (!node) {
     return -1;
   }
-
-  size_t pos = std::distance(gpu_id.cbegin(), it);
-  *pNodeID = node_id[pos];
+  *pNodeID = node->node;
   return 0;
 }
 
@@ -439,14 +298,12 @@ int rvs::gpulist::gpu2node(const uint16_t GpuID, uint16_t* pNodeID) {
  **/
 int rvs::gpulist::location2node(const uint16_t LocationID,
                                     uint16_t* pNodeID) {
-  const auto it = std::find(location_id.cbegin(),
-                            location_id.cend(), LocationID);
-  if (it == location_id.cend()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_location(LocationID);
+  if (!node) {
     return -1;
   }
-
-  size_t pos = std::distance(location_id.cbegin(), it);
-  *pNodeID = node_id[pos];
+  *pNodeID = node->node;
   return 0;
 }
 
@@ -458,12 +315,13 @@ int rvs::gpulist::location2node(const uint16_t LocationID,
  **/
 int rvs::gpulist::domlocation2node(const uint16_t domainID, const uint16_t LocationID,
                                     uint16_t* pNodeID) {
-  auto it = domain_loc_map.find(std::make_pair(domainID, LocationID));
-  if (it == domain_loc_map.end()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_bdf(domainID, LocationID);
+  if (!node) {
     return -1;
   }
-
-  return gpu2node(it->second, pNodeID);
+  *pNodeID = node->node;
+  return 0;
 }
 
 /**
@@ -474,11 +332,12 @@ int rvs::gpulist::domlocation2node(const uint16_t domainID, const uint16_t Locat
  **/
 int rvs::gpulist::domlocation2gpu(const uint16_t domainID, const uint16_t LocationID,
                                     uint16_t* pGPUID) {
-  auto it = domain_loc_map.find(std::make_pair(domainID, LocationID));
-  if (it == domain_loc_map.end()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_bdf(domainID, LocationID);
+  if (!node) {
     return -1;
   }
-  *pGPUID = it->second;
+  *pGPUID = node->gpu_id;
   return 0;
 }
 
@@ -490,14 +349,12 @@ int rvs::gpulist::domlocation2gpu(const uint16_t domainID, const uint16_t Locati
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::gpu2domain(const uint16_t GpuID, uint16_t* pDomain) {
-  const auto it = std::find(gpu_id.cbegin(),
-                            gpu_id.cend(), GpuID);
-  if (it == gpu_id.cend()) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_gpu(GpuID);
+  if (!node) {
     return -1;
   }
-  size_t pos = std::distance(gpu_id.cbegin(), it);
-  std::cout << "For GPU " << GpuID << " domain is " << domain_id[pos] << std::endl;
-  *pDomain = domain_id[pos];
+  *pDomain = node->domain;
   return 0;
 }
 
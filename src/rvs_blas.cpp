@@ -62,6 +62,8 @@ rvs_blas::rvs_blas(int _gpu_device_index, int _m, int _n, int _k, int transA, in
                     , blas_handle(nullptr)
                     , is_handle_init(false)
                     , is_error(false)
+                    , req_transa(transA), req_transb(transB)
+                    , req_lda(lda), req_ldb(ldb), req_ldc(ldc)
 {
 
   if(transA == 0) {
@@ -76,37 +78,18 @@ rvs_blas::rvs_blas(int _gpu_device_index, int _m, int _n, int _k, int transA, in
     transb = rocblas_operation_transpose;
   }
 
-  if(ops_type == "hgemm") {
-    //auto    A_row = transA == rocblas_operation_none ? m : k;
-    auto    A_col = transA == rocblas_operation_none ? k : m;
-    //auto    B_row = transB == rocblas_operation_none ? k : n;
-    auto    B_col = transB == rocblas_operation_none ? n : k;
-
-    size_a = size_t(lda) * A_col;
-    size_b = size_t(ldb) * B_col;
-    size_c = size_t(ldc) * n;
-    size_d = size_t(ldc) * n;
-  }else{
-    size_a = size_t(k) * m;
-    size_b = size_t(k) * n;
-    size_c = size_t(n) * m;
-  }
+  matrix_sizes(m, n, k, &size_a, &size_b, &size_c, &size_d);
+  alloc_a = size_a;
+  alloc_b = size_b;
+  alloc_c = size_c;
+  alloc_d = size_d;
 
   //setting alpha and beta val
   blas_alpha_val = alpha;
   blas_beta_val = beta;
 
   //setting lda offsets 
-  //Leading data offsets
-  if(lda == 0 || ldb == 0 || ldc == 0) {
-    blas_lda_offset = m;
-    blas_ldb_offset = n;
-    blas_ldc_offset = k;
-  }else{
-    blas_lda_offset = lda;
-    blas_ldb_offset = ldb;
-    blas_ldc_offset = ldc;
-  }
+  set_ld_offsets();
 
   if (alocate_host_matrix_mem()) {
     if (!init_gpu_device())
@@ -116,6 +99,89 @@ rvs_blas::rvs_blas(int _gpu_device_index, int _m, int _n, int _k, int transA, in
   }
 }
 
+/**
+ * @brief computes number of elements of each matrix
+ * @param _m matrix A rows
+ * @param _n matrix B cols
+ * @param _k matrix A/B cols/rows respectively
+ * @param pa [out] matrix A elements
+ * @param pb [out] matrix B elements
+ * @param pc [out] matrix C elements
+ * @param pd [out] matrix D elements (hgemm only)
+ */
+void rvs_blas::matrix_sizes(rocblas_int _m, rocblas_int _n, rocblas_int _k,
+                            size_t* pa, size_t* pb, size_t* pc, size_t* pd) {
+  if(ops_type == "hgemm") {
+    //auto    A_row = req_transa == rocblas_operation_none ? _m : _k;
+    auto    A_col = req_transa == rocblas_operation_none ? _k : _m;
+    //auto    B_row = req_transb == rocblas_operation_none ? _k : _n;
+    auto    B_col = req_transb == rocblas_operation_none ? _n : _k;
+
+    *pa = size_t(req_lda) * A_col;
+    *pb = size_t(req_ldb) * B_col;
+    *pc = size_t(req_ldc) * _n;
+    *pd = size_t(req_ldc) * _n;
+  }else{
+    *pa = size_t(_k) * _m;
+    *pb = size_t(_k) * _n;
+    *pc = size_t(_n) * _m;
+    *pd = 0;
+  }
+}
+
+/**
+ * @brief sets leading data offsets for current m, n, k
+ */
+void rvs_blas::set_ld_offsets(void) {
+  if(req_lda == 0 || req_ldb == 0 || req_ldc == 0) {
+    blas_lda_offset = m;
+    blas_ldb_offset = n;
+    blas_ldc_offset = k;
+  }else{
+    blas_lda_offset = req_lda;
+    blas_ldb_offset = req_ldb;
+    blas_ldc_offset = req_ldc;
+  }
+}
+
+/**
+ * @brief changes GEMM dimensions keeping device buffers and rocBlas handle
+ *
+ * Lets a parameter sweep allocate for its largest point once and run the
+ * smaller points in the same buffers. Also selects the GPU device for the
+ * calling thread, which may not be the one the object was created on.
+ *
+ * @param _m matrix A rows
+ * @param _n matrix B cols
+ * @param _k matrix A/B cols/rows respectively
+ * @return true if new dimensions fit into allocated buffers and the device
+ * was selected, false otherwise
+ */
+bool rvs_blas::reshape(int _m, int _n, int _k) {
+  size_t a, b, c, d;
+
+  if (is_error)
+    return false;
+
+  if (hipSetDevice(gpu_device_index) != hipSuccess)
+    return false;
+
+  matrix_sizes(_m, _n, _k, &a, &b, &c, &d);
+  if (a > alloc_a || b > alloc_b || c > alloc_c || d > alloc_d)
+    return false;
+
+  m = _m;
+  n = _n;
+  k = _k;
+  size_a = a;
+  size_b = b;
+  size_c = c;
+  size_d = d;
+  set_ld_offsets();
+
+  return true;
+}
+
 /**
  * @brief class destructor
  */
@@ -25,6 +25,7 @@
 #include "include/rvsactionbase.h"
 
 #include <unistd.h>
+#include <time.h>
 #include <chrono>
 #include <utility>
 #include <regex>
@@ -51,6 +52,7 @@ rvs::actionbase::actionbase() {
   property_device_all = true;
   property_device_index_all = true;
   property_device_id = 0u;
+  property_cpu_affinity = affinitypolicy::NONE;
   callback = nullptr;
   user_param = 0u;
 }
@@ -111,15 +113,56 @@ int rvs::actionbase::action_callback(rvs::action_result_t *action_result) {
   return 0;
 }
 
+/**
+ * @brief Publish metric value through registered callback
+ *
+ * Sends a typed value to the application without formatting any text.
+ * May be called from worker threads. Name and unit are passed by pointer
+ * and have to be string literals.
+ *
+ * @param name metric name (e.g. "bandwidth")
+ * @param unit metric unit (e.g. "GB/s")
+ * @param device GPU id, 0 if not device specific
+ * @param value metric value
+ * @return 0 - success. non-zero if no callback is registered
+ *
+ * */
+int rvs::actionbase::metric(const char* name, const char* unit,
+                            uint16_t device, double value) {
+  if (nullptr == this->callback) {
+    return 1;
+  }
+
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  action_metric_t m;
+  m.name = name;
+  m.unit = unit;
+  m.device = device;
+  m.value = value;
+  m.ts_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+
+  action_result_t result;
+  result.state = rvs::actionstate::ACTION_RUNNING;
+  result.status = rvs::actionstatus::ACTION_SUCCESS;
+  result.metric = &m;
+
+  this->callback(&result, this->user_param);
+  return 0;
+}
+
 /**
  * @brief Pauses current thread for the given time period
  *
+ * Returns early if stop is requested (see rvs::logger::WaitStop()).
+ *
  * @param ms Sleep time in milliseconds.
  * @return (void)
  *
  * */
 void rvs::actionbase::sleep(const unsigned int ms) {
-  ::usleep(1000*ms);
+  rvs::lp::WaitStop(ms);
 }
 
 /**
@@ -182,6 +225,68 @@ int rvs::actionbase::property_get_device_index() {
     &property_device_index_all);
 }
 
+/**
+ * gets the CPU affinity policy of worker threads from the module's
+ * properties collection ('none' if the key is missing)
+ * @return 0 - OK
+ * @return 1 - syntax error in 'cpu_affinity' configuration key
+ */
+int rvs::actionbase::property_get_cpu_affinity() {
+  std::string val;
+
+  property_cpu_affinity = affinitypolicy::NONE;
+  property_cpu_affinity_cpus.clear();
+  if (!has_property(RVS_CONF_CPU_AFFINITY_KEY, &val)) {
+    return 0;
+  }
+
+  return affinity::parse(val, &property_cpu_affinity,
+                         &property_cpu_affinity_cpus) ? 1 : 0;
+}
+
+/**
+ * @brief Resolves CPUs worker threads serving a GPU should run on
+ *
+ * Applies the 'cpu_affinity' policy to the given GPU and logs the chosen
+ * CPU set. CPUs the process may not run on are left out.
+ *
+ * @param gpu_id GPU served by the thread
+ * @param pcpus [out] CPU list, empty if threads are not to be pinned
+ */
+void rvs::actionbase::get_cpu_affinity(uint16_t gpu_id,
+                                       std::vector<int>* pcpus) {
+  std::string msg;
+  int node = -1;
+
+  pcpus->clear();
+  switch (property_cpu_affinity) {
+  case affinitypolicy::NONE:
+    return;
+  case affinitypolicy::NUMA:
+    if (affinity::device_numa_node(gpu_id, &node) ||
+        affinity::node_cpus(node, pcpus)) {
+      msg = "[" + action_name + "] cpu_affinity " + std::to_string(gpu_id) +
+            " NUMA node unknown, threads not pinned";
+      rvs::lp::Log(msg, rvs::logerror);
+      pcpus->clear();
+      return;
+    }
+    break;
+  case affinitypolicy::CPUSET:
+    *pcpus = property_cpu_affinity_cpus;
+    break;
+  }
+
+  affinity::allowed(pcpus);
+  msg = "[" + action_name + "] cpu_affinity " + std::to_string(gpu_id);
+  if (node >= 0) {
+    msg += " numa_node:" + std::to_string(node);
+  }
+  msg += " cpus:" + (pcpus->empty() ? std::string("none allowed, not pinned") :
+                     affinity::cpulist(*pcpus));
+  rvs::lp::Log(msg, rvs::logresults);
+}
+
 /**
  * @brief Reads boolean property value from properties collection
  */
@@ -0,0 +1,221 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsaffinity.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "include/rvs_util.h"
+#include "include/rvstopology.h"
+
+#define NUMA_NODES_PATH                 "/devices/system/node"
+
+/**
+ * @brief Parses value of the cpu_affinity key
+ *
+ * @param val "none", "numa" or a CPU list (e.g. "0-7,16")
+ * @param ppolicy [out] affinity policy
+ * @param pcpus [out] CPU list for affinitypolicy::CPUSET
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::affinity::parse(const std::string& val, affinitypolicy* ppolicy,
+                         std::vector<int>* pcpus) {
+  pcpus->clear();
+
+  if (val == "none") {
+    *ppolicy = affinitypolicy::NONE;
+    return 0;
+  }
+
+  if (val == "numa") {
+    *ppolicy = affinitypolicy::NUMA;
+    return 0;
+  }
+
+  if (parse_cpulist(val, pcpus) || pcpus->empty()) {
+    return 1;
+  }
+
+  *ppolicy = affinitypolicy::CPUSET;
+  return 0;
+}
+
+/**
+ * @brief Parses CPU list in sysfs "cpulist" format
+ *
+ * @param list comma separated CPUs or CPU ranges, e.g. "0-3,8,10-11"
+ * @param pcpus [out] sorted list of CPUs
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::affinity::parse_cpulist(const std::string& list,
+                                 std::vector<int>* pcpus) {
+  std::string s(list);
+  s.erase(std::remove_if(s.begin(), s.end(), ::isspace), s.end());
+
+  pcpus->clear();
+  if (s.empty()) {
+    return 0;
+  }
+
+  std::vector<std::string> items = str_split(s, ",");
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    std::vector<std::string> range = str_split(*it, "-");
+    uint16_t first, last;
+    if (range.size() < 1 || range.size() > 2 ||
+        rvs_util_parse(range[0], &first) ||
+        rvs_util_parse(range.back(), &last) || last < first ||
+        last >= CPU_SETSIZE) {
+      pcpus->clear();
+      return 1;
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      pcpus->push_back(cpu);
+    }
+  }
+
+  std::sort(pcpus->begin(), pcpus->end());
+  pcpus->erase(std::unique(pcpus->begin(), pcpus->end()), pcpus->end());
+
+  return 0;
+}
+
+/**
+ * @brief Formats CPU list in sysfs "cpulist" format
+ *
+ * @param cpus sorted list of CPUs
+ * @return list with consecutive CPUs joined into ranges, e.g. "0-3,8"
+ *
+ */
+std::string rvs::affinity::cpulist(const std::vector<int>& cpus) {
+  std::string s;
+
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      j++;
+    }
+    if (!s.empty()) {
+      s += ",";
+    }
+    s += std::to_string(cpus[i]);
+    if (j > i) {
+      s += "-" + std::to_string(cpus[j]);
+    }
+    i = j + 1;
+  }
+
+  return s;
+}
+
+/**
+ * @brief Finds NUMA node a GPU is attached to
+ *
+ * @param gpu_id KFD gpu_id of the device
+ * @param pnode [out] NUMA node
+ * @return 0 if successful, non-zero if the GPU or its NUMA node is unknown
+ *
+ */
+int rvs::affinity::device_numa_node(uint16_t gpu_id, int* pnode) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = gpu_id ? topo->by_gpu(gpu_id) : nullptr;
+  if (!node) {
+    return -1;
+  }
+
+  // NUMA node of the PCI device
+  uint64_t location_id;
+  if (node->get("location_id", &location_id)) {
+    std::ifstream f(rvs::topology::sysfs_root() + RVS_PCI_DEVICES_PATH + "/" +
+                    node->bdf() + "/numa_node");
+    int numa;
+    if (f >> numa && numa >= 0) {
+      *pnode = numa;
+      return 0;
+    }
+  }
+
+  // KFD CPU node the GPU links to (KFD CPU nodes follow NUMA node order)
+  for (const auto& link : node->io_links) {
+    const rvs::toponode* to = topo->by_node(link.node_to);
+    if (to && to->gpu_id == 0) {
+      *pnode = link.node_to;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+/**
+ * @brief Returns CPUs of a NUMA node
+ *
+ * @param node NUMA node
+ * @param pcpus [out] sorted list of CPUs
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::affinity::node_cpus(int node, std::vector<int>* pcpus) {
+  std::ifstream f(rvs::topology::sysfs_root() + NUMA_NODES_PATH + "/node" +
+                  std::to_string(node) + "/cpulist");
+  std::string list;
+
+  pcpus->clear();
+  if (!std::getline(f, list)) {
+    return -1;
+  }
+
+  if (parse_cpulist(list, pcpus) || pcpus->empty()) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Removes CPUs the process may not run on
+ *
+ * @param pcpus [in,out] list of CPUs
+ *
+ */
+void rvs::affinity::allowed(std::vector<int>* pcpus) {
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set)) {
+    return;
+  }
+
+  pcpus->erase(std::remove_if(pcpus->begin(), pcpus->end(), [&set](int cpu) {
+    return !CPU_ISSET(cpu, &set);
+  }), pcpus->end());
+}
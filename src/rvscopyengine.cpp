@@ -0,0 +1,137 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvscopyengine.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param pBackend copy backend
+ * @param Depth number of copies in flight per direction (0 is taken as 1)
+ *
+ */
+rvs::copyengine::copyengine(copybackend* pBackend, unsigned int Depth)
+  : backend(pBackend), depth(Depth ? Depth : 1) {
+}
+
+/**
+ * @brief Perform a number of copies of the same size
+ *
+ * Keeps up to depth copies in flight in each direction until Copies copies
+ * per direction are done. On error, copies already in flight are waited
+ * for before returning.
+ *
+ * @param Size size of each copy
+ * @param Copies number of copies per direction
+ * @param Bidirectional 'true' to copy in both directions at the same time
+ * @param pStats [out] throughput and latency
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ */
+int rvs::copyengine::run(size_t Size, unsigned int Copies, bool Bidirectional,
+                         copystats_t* pStats) {
+  struct dirstate {
+    unsigned int issued;
+    unsigned int waited;
+    unsigned int done;
+    uint64_t first_start;
+    uint64_t first_end;
+    uint64_t last_end;
+    double latency;
+  } st[2] = {};
+  const int ndir = Bidirectional ? 2 : 1;
+  const unsigned int nslots = slots(depth);
+  int sts = 0;
+
+  if (Copies == 0) {
+    return -1;
+  }
+
+  // wait for the oldest copy in flight in direction Dir
+  auto complete = [&](int Dir) -> int {
+    dirstate& d = st[Dir];
+    uint64_t start;
+    uint64_t end;
+    if (backend->wait(Dir, d.waited++ % nslots, &start, &end)) {
+      return -1;
+    }
+    if (d.done++ == 0) {
+      d.first_start = start;
+      d.first_end = end;
+    }
+    d.last_end = end;
+    d.latency += end - start;
+    return 0;
+  };
+
+  for (unsigned int j = 0; j < Copies && !sts; j++) {
+    for (int dir = 0; dir < ndir && !sts; dir++) {
+      // slot is free once the copy depending on its last use is done
+      if (j >= depth) {
+        sts = complete(dir);
+      }
+      if (!sts) {
+        int dep = j ? static_cast<int>((j - 1) % nslots) : -1;
+        sts = backend->issue(dir, j % nslots, Size, dep) ? -1 : 0;
+      }
+      if (!sts) {
+        st[dir].issued++;
+      }
+    }
+  }
+
+  // drain copies still in flight
+  for (int dir = 0; dir < ndir; dir++) {
+    while (st[dir].waited < st[dir].issued) {
+      if (complete(dir)) {
+        sts = -1;
+      }
+    }
+  }
+
+  if (sts) {
+    return -1;
+  }
+
+  // average per-direction steady-state throughput in bytes per nanosecond
+  double bw = 0;
+  double latency = 0;
+  for (int dir = 0; dir < ndir; dir++) {
+    const dirstate& d = st[dir];
+    double span = d.done > 1 ? d.last_end - d.first_end :
+                               d.last_end - d.first_start;
+    if (span > 0) {
+      bw += (d.done > 1 ? d.done - 1 : 1) * static_cast<double>(Size) / span;
+    }
+    latency += d.latency;
+  }
+  bw /= ndir;
+
+  pStats->copies = Copies;
+  pStats->bytes = (Copies > 1 ? Copies - 1 : 1) * Size;
+  pStats->duration = bw > 0 ? pStats->bytes / bw / 1e9 : 0;
+  pStats->latency = latency / (Copies * ndir) / 1e9;
+
+  return 0;
+}
@@ -0,0 +1,207 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvserrring.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Size of a ring
+ *
+ * @param Capacity number of slots (power of two)
+ * @return size in bytes of header and slots
+ *
+ */
+size_t rvs::errharvester::size(uint64_t Capacity) {
+  return sizeof(errring_t) + Capacity * sizeof(errslot_t);
+}
+
+/**
+ * @brief Initializes an empty ring
+ *
+ * @param pRing ring memory, at least size(Capacity) bytes
+ * @param Capacity number of slots (power of two)
+ *
+ */
+void rvs::errharvester::init(errring_t* pRing, uint64_t Capacity) {
+  memset(pRing, 0, size(Capacity));
+  pRing->capacity = Capacity;
+}
+
+/**
+ * @brief Appends a record the way device producers do
+ *
+ * @param pRing ring
+ * @param Rec record
+ *
+ */
+void rvs::errharvester::append(errring_t* pRing, const errrecord_t& Rec) {
+  uint64_t idx = __atomic_fetch_add(&pRing->head, 1, __ATOMIC_RELAXED);
+  errslot_t* slot = RVS_ERRRING_SLOT(pRing, idx);
+
+  __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(&slot->rec.address, Rec.address, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->rec.expected, Rec.expected, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->rec.actual, Rec.actual, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->rec.reread, Rec.reread, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->seq, idx + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief class constructor
+ *
+ * @param pRing initialized ring
+ * @param Callback called for each harvested record
+ *
+ */
+rvs::errharvester::errharvester(errring_t* pRing, const callback_t& Callback)
+  : ring(pRing), callback(Callback), tail(0), harvested_cnt(0), lost_cnt(0),
+    brun(false) {
+}
+
+//! class destructor, stops the background thread
+rvs::errharvester::~errharvester() {
+  stop();
+}
+
+/**
+ * @brief Number of records appended so far
+ *
+ * @return ring head
+ *
+ */
+uint64_t rvs::errharvester::produced() const {
+  return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Harvests all published records
+ *
+ * Stops at the first record claimed but not yet published. A record is
+ * read between two reads of its sequence and taken only if the sequence
+ * did not change, so records being overwritten are counted as lost
+ * rather than returned torn.
+ *
+ * @return number of records passed to the callback
+ *
+ */
+size_t rvs::errharvester::harvest() {
+  std::lock_guard<std::mutex> lk(mtx);
+  uint64_t head = produced();
+  size_t cnt = 0;
+
+  // records already overwritten
+  if (head - tail > ring->capacity) {
+    lost_cnt += head - ring->capacity - tail;
+    tail = head - ring->capacity;
+  }
+
+  while (tail < head) {
+    errslot_t* slot = RVS_ERRRING_SLOT(ring, tail);
+    uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    if (seq != tail + 1) {
+      if (seq > tail + 1) {
+        // overwritten by a later record
+        lost_cnt++;
+        tail++;
+        continue;
+      }
+      // claimed but not yet published
+      break;
+    }
+
+    errrecord_t rec;
+    rec.address = __atomic_load_n(&slot->rec.address, __ATOMIC_RELAXED);
+    rec.expected = __atomic_load_n(&slot->rec.expected, __ATOMIC_RELAXED);
+    rec.actual = __atomic_load_n(&slot->rec.actual, __ATOMIC_RELAXED);
+    rec.reread = __atomic_load_n(&slot->rec.reread, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq) {
+      lost_cnt++;
+      tail++;
+      continue;
+    }
+
+    tail++;
+    harvested_cnt++;
+    cnt++;
+    callback(rec);
+  }
+
+  return cnt;
+}
+
+/**
+ * @brief Starts harvesting in a background thread
+ *
+ * @param IntervalMs time between harvests (ms)
+ *
+ */
+void rvs::errharvester::start(unsigned int IntervalMs) {
+  std::lock_guard<std::mutex> lk(mtx_run);
+  if (brun) {
+    return;
+  }
+  brun = true;
+  thrd = std::thread(&rvs::errharvester::worker, this, IntervalMs);
+}
+
+/**
+ * @brief Stops the background thread and harvests what is left
+ *
+ */
+void rvs::errharvester::stop() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_run);
+    brun = false;
+  }
+  cv.notify_all();
+  if (thrd.joinable()) {
+    thrd.join();
+  }
+  harvest();
+}
+
+/**
+ * @brief Background thread body
+ *
+ * @param IntervalMs time between harvests (ms)
+ *
+ */
+void rvs::errharvester::worker(unsigned int IntervalMs) {
+  std::unique_lock<std::mutex> lk(mtx_run);
+  while (brun) {
+    lk.unlock();
+    harvest();
+    lk.lock();
+    cv.wait_for(lk, std::chrono::milliseconds(IntervalMs),
+                [this] { return !brun; });
+  }
+}
@@ -77,11 +77,12 @@ rvs::hsa* rvs::hsa::Get() {
 }
 
 //! Default constructor
-rvs::hsa::hsa() {
+rvs::hsa::hsa() : transfers(this, CACHE_MAX_SIZE) {
 }
 
 //! Default destructor
 rvs::hsa::~hsa() {
+  ReleaseCache();
 }
 
 
@@ -271,6 +272,25 @@ bool rvs::hsa::check_link_type(
   return retval;
 }
 
+/**
+ * converts link types in @p arrLinkInfo to link model hop types
+ * @param arrLinkInfo array of links between two HSA nodes
+ * @param pTypes [out] hop types
+ */
+void rvs::hsa::get_link_types(
+  const std::vector<rvs::linkinfo_t>& arrLinkInfo,
+  std::vector<rvs::linktype>* pTypes) {
+  pTypes->clear();
+  for (auto it = arrLinkInfo.begin(); it != arrLinkInfo.end(); ++it) {
+    if (it->etype == HSA_AMD_LINK_INFO_TYPE_XGMI) {
+      pTypes->push_back(rvs::linktype::XGMI);
+    } else if (it->etype == HSA_AMD_LINK_INFO_TYPE_PCIE) {
+      pTypes->push_back(rvs::linktype::PCIE);
+    } else {
+      pTypes->push_back(rvs::linktype::UNKNOWN);
+    }
+  }
+}
 
 /**
  * @brief Fetch all HSA agents
@@ -728,121 +748,342 @@ int rvs::hsa::Allocate(int SrcAgent, int DstAgent, size_t Size,
 
 
 /**
- * @brief Allocate buffers in source and destination memory pools
+ * @brief Allocate buffers and signals for forward (and reverse) transfer
  *
- * @param SrcNode source NUMA node
- * @param DstNode destination NUMA node
- * @param Size size of data to transfer
- * @param bidirectional 'true' for bidirectional transfer
- * @param Duration [out] duration of transfer in seconds
+ * @param SrcAgent source agent index in agent_list vector
+ * @param DstAgent destination agent index in agent_list vector
+ * @param Size size of each buffer
+ * @param bidirectional 'true' to also allocate reverse transfer buffers
+ * @param pTransfer [out] allocated buffers and signals
  * @return 0 - if successfull, non-zero otherwise
  *
  * */
-int rvs::hsa::SendTraffic(uint32_t SrcNode, uint32_t DstNode,
-                              size_t Size, bool bidirectional,
-                              double* Duration) {
+int rvs::hsa::AllocTransfer(int SrcAgent, int DstAgent, size_t Size,
+                            bool bidirectional, transfer_t* pTransfer) {
   hsa_status_t status;
-  int sts;
-
-  int32_t src_ix_fwd;
-  int32_t dst_ix_fwd;
-  hsa_amd_memory_pool_t src_pool_fwd;
-  hsa_amd_memory_pool_t dst_pool_fwd;
-  void* src_ptr_fwd = nullptr;
-  void* dst_ptr_fwd = nullptr;
-  hsa_signal_t signal_fwd;
-
-  int32_t src_ix_rev;
-  int32_t dst_ix_rev;
-  hsa_amd_memory_pool_t src_pool_rev;
-  hsa_amd_memory_pool_t dst_pool_rev;
-  void* src_ptr_rev = nullptr;
-  void* dst_ptr_rev = nullptr;
-  hsa_signal_t signal_rev;
-
-  RVSHSATRACE_
-
-  // given NUMA nodes, find agent indexes
-  src_ix_fwd = FindAgent(SrcNode);
-  dst_ix_fwd = FindAgent(DstNode);
-  src_ix_rev = dst_ix_fwd;
-  dst_ix_rev = src_ix_fwd;
-
-    if (src_ix_fwd < 0 || dst_ix_fwd < 0) {
-    RVSHSATRACE_
-    return -1;
-  }
+  hsa_amd_memory_pool_t src_pool;
+  hsa_amd_memory_pool_t dst_pool;
 
   // allocate buffers and grant permissions for forward transfer
-  sts = Allocate(src_ix_fwd, dst_ix_fwd, Size,
-           &src_pool_fwd, &src_ptr_fwd,
-           &dst_pool_fwd, &dst_ptr_fwd);
-  if (sts) {
+  if (Allocate(SrcAgent, DstAgent, Size,
+               &src_pool, &pTransfer->src_fwd,
+               &dst_pool, &pTransfer->dst_fwd)) {
     RVSHSATRACE_
     return -1;
   }
 
   // Create a signal to wait on copy operation
   if (HSA_STATUS_SUCCESS !=
-     (status = hsa_signal_create(1, 0, NULL, &signal_fwd))) {
+     (status = hsa_signal_create(1, 0, NULL, &pTransfer->signal_fwd))) {
     print_hsa_status(__FILE__, __LINE__, __func__,
               "hsa_signal_create()",
               status);
-      hsa_amd_memory_pool_free(src_ptr_fwd);
-      hsa_amd_memory_pool_free(dst_ptr_fwd);
-      RVSHSATRACE_
-      return -1;
+    FreeTransfer(pTransfer);
+    return -1;
   }
 
   if (bidirectional) {
     RVSHSATRACE_
-
     // allocate buffers and grant permissions for reverse transfer
-    sts = Allocate(src_ix_rev, dst_ix_rev, Size,
-            &src_pool_rev, &src_ptr_rev,
-            &dst_pool_rev, &dst_ptr_rev);
-
-    if (sts) {
+    if (Allocate(DstAgent, SrcAgent, Size,
+                 &src_pool, &pTransfer->src_rev,
+                 &dst_pool, &pTransfer->dst_rev)) {
       RVSHSATRACE_
-      hsa_amd_memory_pool_free(src_ptr_fwd);
-      hsa_amd_memory_pool_free(dst_ptr_fwd);
+      FreeTransfer(pTransfer);
       return -1;
     }
 
     // Create a signal to wait on for reverse copy operation
     if (HSA_STATUS_SUCCESS !=
-       (status = hsa_signal_create(1, 0, NULL, &signal_rev))) {
+       (status = hsa_signal_create(1, 0, NULL, &pTransfer->signal_rev))) {
       print_hsa_status(__FILE__, __LINE__, __func__,
               "hsa_signal_create()",
               status);
-      hsa_amd_memory_pool_free(src_ptr_fwd);
-      hsa_amd_memory_pool_free(dst_ptr_fwd);
-      hsa_amd_memory_pool_free(src_ptr_rev);
-      hsa_amd_memory_pool_free(dst_ptr_rev);
-      hsa_signal_destroy(signal_fwd);
+      FreeTransfer(pTransfer);
       return -1;
     }
   }
 
+  pTransfer->size = Size;
+  return 0;
+}
+
+/**
+ * @brief Free buffers and signals of a transfer
+ *
+ * @param pTransfer transfer to free
+ *
+ * */
+void rvs::hsa::FreeTransfer(transfer_t* pTransfer) {
+  void** buffs[] = {&pTransfer->src_fwd, &pTransfer->dst_fwd,
+                    &pTransfer->src_rev, &pTransfer->dst_rev};
+  for (void** pbuff : buffs) {
+    if (*pbuff) {
+      hsa_amd_memory_pool_free(*pbuff);
+      *pbuff = nullptr;
+    }
+  }
+
+  if (pTransfer->signal_fwd.handle) {
+    hsa_signal_destroy(pTransfer->signal_fwd);
+    pTransfer->signal_fwd.handle = 0;
+  }
+  if (pTransfer->signal_rev.handle) {
+    hsa_signal_destroy(pTransfer->signal_rev);
+    pTransfer->signal_rev.handle = 0;
+  }
+  for (hsa_signal_t signal : pTransfer->queue_fwd) {
+    hsa_signal_destroy(signal);
+  }
+  pTransfer->queue_fwd.clear();
+  for (hsa_signal_t signal : pTransfer->queue_rev) {
+    hsa_signal_destroy(signal);
+  }
+  pTransfer->queue_rev.clear();
+
+  pTransfer->size = 0;
+}
+
+/**
+ * @brief Create completion signals for SendTrafficQueued() slots
+ *
+ * Signals already present are kept, so a cached transfer only creates
+ * them once for the largest depth used.
+ *
+ * @param bidirectional 'true' to also create reverse transfer signals
+ * @param Slots number of slots per direction
+ * @param pTransfer transfer owned by the caller
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ * */
+int rvs::hsa::AllocQueueSignals(bool bidirectional, unsigned int Slots,
+                                transfer_t* pTransfer) {
+  hsa_status_t status;
+  vector<hsa_signal_t>* queues[] = {&pTransfer->queue_fwd,
+                                    &pTransfer->queue_rev};
+
+  for (int dir = 0; dir < (bidirectional ? 2 : 1); dir++) {
+    while (queues[dir]->size() < Slots) {
+      hsa_signal_t signal;
+      if (HSA_STATUS_SUCCESS !=
+         (status = hsa_signal_create(1, 0, NULL, &signal))) {
+        print_hsa_status(__FILE__, __LINE__, __func__,
+                "hsa_signal_create()",
+                status);
+        return -1;
+      }
+      queues[dir]->push_back(signal);
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Allocate transfer for the transfer cache
+ *
+ * @param Key source node, destination node and direction
+ * @param Size size of each buffer
+ * @param ppData [out] allocated transfer_t
+ * @param pBytes [out] bytes held by transfer buffers
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ * */
+int rvs::hsa::xfer_alloc(const xferkey_t& Key, size_t Size,
+                         void** ppData, size_t* pBytes) {
+  int src_ix = FindAgent(std::get<0>(Key));
+  int dst_ix = FindAgent(std::get<1>(Key));
+  bool bidirectional = std::get<2>(Key);
+
+  if (src_ix < 0 || dst_ix < 0) {
+    RVSHSATRACE_
+    return -1;
+  }
+
+  transfer_t* ptransfer = new transfer_t;
+  if (AllocTransfer(src_ix, dst_ix, Size, bidirectional, ptransfer)) {
+    RVSHSATRACE_
+    delete ptransfer;
+    return -1;
+  }
+
+  *ppData = ptransfer;
+  *pBytes = Size * (bidirectional ? 4 : 2);
+  return 0;
+}
+
+/**
+ * @brief Free transfer allocated for the transfer cache
+ *
+ * @param pData transfer_t returned by xfer_alloc()
+ *
+ * */
+void rvs::hsa::xfer_free(void* pData) {
+  transfer_t* ptransfer = static_cast<transfer_t*>(pData);
+  FreeTransfer(ptransfer);
+  delete ptransfer;
+}
+
+/**
+ * @brief Get buffers and signals for a transfer
+ *
+ * Cached buffers of the same (SrcNode, DstNode, bidirectional) transfer are
+ * reused if large enough. Otherwise they are reallocated to Size. If the
+ * cached buffers are in use by another caller, temporary buffers are
+ * allocated instead (see rvs::xfercache).
+ *
+ * @param SrcNode source NUMA node
+ * @param DstNode destination NUMA node
+ * @param Size size of data to transfer
+ * @param bidirectional 'true' for bidirectional transfer
+ * @param pLease [out] cache lease, to be returned by ReleaseTransfer()
+ * @param ppTransfer [out] buffers to use
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ * */
+int rvs::hsa::AcquireTransfer(uint32_t SrcNode, uint32_t DstNode,
+                              size_t Size, bool bidirectional,
+                              xferlease_t* pLease, transfer_t** ppTransfer) {
+  if (transfers.acquire(std::make_tuple(SrcNode, DstNode, bidirectional),
+                        Size, pLease)) {
+    RVSHSATRACE_
+    return -1;
+  }
+
+  *ppTransfer = static_cast<transfer_t*>(pLease->data);
+  return 0;
+}
+
+/**
+ * @brief Return buffers obtained from AcquireTransfer()
+ *
+ * @param pLease cache lease returned by AcquireTransfer()
+ *
+ * */
+void rvs::hsa::ReleaseTransfer(xferlease_t* pLease) {
+  transfers.release(pLease);
+}
+
+/**
+ * @brief Free all cached transfer buffers not currently in use
+ *
+ * */
+void rvs::hsa::ReleaseCache() {
+  hsacachestats_t stats;
+
+  transfers.clear();
+
+  transfers.get_stats(&stats);
+  rvs::lp::Log("hsa transfer cache hits: " + std::to_string(stats.hits)
+               + " misses: " + std::to_string(stats.misses)
+               + " evictions: " + std::to_string(stats.evictions),
+               rvs::logdebug);
+}
+
+/**
+ * @brief Set limit of bytes kept in cached transfer buffers
+ *
+ * Idle cached transfers are released, least recently used first, when
+ * the limit is exceeded.
+ *
+ * @param Bytes new limit
+ *
+ * */
+void rvs::hsa::SetCacheLimit(size_t Bytes) {
+  transfers.set_limit(Bytes);
+}
+
+/**
+ * @brief Get transfer cache statistics
+ *
+ * @param pStats [out] statistics
+ *
+ * */
+void rvs::hsa::GetCacheStats(hsacachestats_t* pStats) {
+  transfers.get_stats(pStats);
+}
+
+/**
+ * @brief Allocate cached buffers for transfers up to Size in advance
+ *
+ * Intended to be called with the largest block size before a sequence of
+ * SendTraffic() calls so that none of them allocates.
+ *
+ * @param SrcNode source NUMA node
+ * @param DstNode destination NUMA node
+ * @param Size largest size of data to transfer
+ * @param bidirectional 'true' for bidirectional transfer
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ * */
+int rvs::hsa::Reserve(uint32_t SrcNode, uint32_t DstNode,
+                      size_t Size, bool bidirectional) {
+  xferlease_t lease;
+  transfer_t* ptransfer;
+
+  if (AcquireTransfer(SrcNode, DstNode, Size, bidirectional,
+                      &lease, &ptransfer)) {
+    return -1;
+  }
+  ReleaseTransfer(&lease);
+
+  return 0;
+}
+
+/**
+ * @brief Send data between source and destination NUMA nodes
+ *
+ * Buffers and signals come from the transfer cache (see Reserve()), so
+ * repeated calls only time the copies.
+ *
+ * @param SrcNode source NUMA node
+ * @param DstNode destination NUMA node
+ * @param Size size of data to transfer
+ * @param bidirectional 'true' for bidirectional transfer
+ * @param Duration [out] duration of transfer in seconds
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ * */
+int rvs::hsa::SendTraffic(uint32_t SrcNode, uint32_t DstNode,
+                              size_t Size, bool bidirectional,
+                              double* Duration) {
+  hsa_status_t status;
+  xferlease_t lease;
+  transfer_t* px;
+
+  RVSHSATRACE_
+
+  // given NUMA nodes, find agent indexes
+  int32_t src_ix_fwd = FindAgent(SrcNode);
+  int32_t dst_ix_fwd = FindAgent(DstNode);
+  int32_t src_ix_rev = dst_ix_fwd;
+  int32_t dst_ix_rev = src_ix_fwd;
+
+  // get buffers and signals for forward (and reverse) transfer
+  if (AcquireTransfer(SrcNode, DstNode, Size, bidirectional, &lease, &px)) {
+    RVSHSATRACE_
+    return -1;
+  }
+
   // initiate forward transfer
-  hsa_signal_store_relaxed(signal_fwd, 1);
+  hsa_signal_store_relaxed(px->signal_fwd, 1);
   if (HSA_STATUS_SUCCESS !=
      (status = hsa_amd_memory_async_copy(
-                dst_ptr_fwd, agent_list[dst_ix_fwd].agent,
-                src_ptr_fwd, agent_list[src_ix_fwd].agent,
+                px->dst_fwd, agent_list[dst_ix_fwd].agent,
+                px->src_fwd, agent_list[src_ix_fwd].agent,
                 Size,
-                0, NULL, signal_fwd)))
+                0, NULL, px->signal_fwd)))
     print_hsa_status(__FILE__, __LINE__, __func__,
               "hsa_amd_memory_async_copy()",
               status);
   if (bidirectional) {
     RVSHSATRACE_
     // initiate reverse transfer
-    hsa_signal_store_relaxed(signal_rev, 1);
+    hsa_signal_store_relaxed(px->signal_rev, 1);
     if (HSA_STATUS_SUCCESS != (status = hsa_amd_memory_async_copy(
-        dst_ptr_rev, agent_list[dst_ix_rev].agent,
-        src_ptr_rev, agent_list[src_ix_rev].agent, Size,
-        0, NULL, signal_rev)))
+        px->dst_rev, agent_list[dst_ix_rev].agent,
+        px->src_rev, agent_list[src_ix_rev].agent, Size,
+        0, NULL, px->signal_rev)))
       print_hsa_status(__FILE__, __LINE__, __func__,
               "hsa_amd_memory_async_copy()",
               status);
@@ -850,34 +1091,146 @@ int rvs::hsa::SendTraffic(uint32_t SrcNode, uint32_t DstNode,
 
   // wait for transfer to complete
   RVSHSATRACE_
-  hsa_signal_wait_acquire(signal_fwd, HSA_SIGNAL_CONDITION_LT, 1, uint64_t(-1), HSA_WAIT_STATE_ACTIVE);
+  hsa_signal_wait_acquire(px->signal_fwd, HSA_SIGNAL_CONDITION_LT, 1, uint64_t(-1), HSA_WAIT_STATE_ACTIVE);
 
   // if bidirectional, also wait for reverse transfer to complete
   if (bidirectional == true) {
     RVSHSATRACE_
-    hsa_signal_wait_acquire(signal_rev, HSA_SIGNAL_CONDITION_LT, 1, uint64_t(-1), HSA_WAIT_STATE_ACTIVE);
+    hsa_signal_wait_acquire(px->signal_rev, HSA_SIGNAL_CONDITION_LT, 1, uint64_t(-1), HSA_WAIT_STATE_ACTIVE);
   }
 
   RVSHSATRACE_
   // get transfer duration
-  *Duration = GetCopyTime(bidirectional, signal_fwd, signal_rev)/1000000000;
+  *Duration = GetCopyTime(bidirectional, px->signal_fwd, px->signal_rev)
+              / 1000000000;
 
-  hsa_amd_memory_pool_free(src_ptr_fwd);
-  hsa_amd_memory_pool_free(dst_ptr_fwd);
-  hsa_signal_destroy(signal_fwd);
+  ReleaseTransfer(&lease);
+  RVSHSATRACE_
 
-  if (bidirectional) {
+  return 0;
+}
+
+namespace {
+
+/**
+ * @brief rvs::copybackend issuing HSA async copies between the buffers
+ * of a transfer
+ *
+ */
+class hsacopy : public rvs::copybackend {
+ public:
+  hsacopy(const rvs::hsa::transfer_t& Transfer,
+          hsa_agent_t SrcAgent, hsa_agent_t DstAgent)
+    : transfer(Transfer), src_agent(SrcAgent), dst_agent(DstAgent) {}
+
+  int issue(int Dir, int Slot, size_t Size, int DepSlot) override {
+    const vector<hsa_signal_t>& signals = queue(Dir);
+    hsa_status_t status;
+
+    hsa_signal_store_relaxed(signals[Slot], 1);
+    if (HSA_STATUS_SUCCESS != (status = hsa_amd_memory_async_copy(
+        Dir ? transfer.dst_rev : transfer.dst_fwd,
+        Dir ? src_agent : dst_agent,
+        Dir ? transfer.src_rev : transfer.src_fwd,
+        Dir ? dst_agent : src_agent,
+        Size,
+        DepSlot < 0 ? 0 : 1, DepSlot < 0 ? NULL : &signals[DepSlot],
+        signals[Slot]))) {
+      rvs::hsa::print_hsa_status(__FILE__, __LINE__, __func__,
+                "hsa_amd_memory_async_copy()",
+                status);
+      return -1;
+    }
+    return 0;
+  }
+
+  int wait(int Dir, int Slot, uint64_t* pStart, uint64_t* pEnd) override {
+    hsa_signal_t signal = queue(Dir)[Slot];
+    hsa_status_t status;
+
+    hsa_signal_wait_acquire(signal, HSA_SIGNAL_CONDITION_LT, 1,
+                            uint64_t(-1), HSA_WAIT_STATE_ACTIVE);
+
+    hsa_amd_profiling_async_copy_time_t async_time {0};
+    if (HSA_STATUS_SUCCESS !=
+       (status = hsa_amd_profiling_get_async_copy_time(signal, &async_time))) {
+      rvs::hsa::print_hsa_status(__FILE__, __LINE__, __func__,
+                "hsa_amd_profiling_get_async_copy_time()",
+                status);
+      return -1;
+    }
+    *pStart = async_time.start;
+    *pEnd = async_time.end;
+    return 0;
+  }
+
+ protected:
+  const vector<hsa_signal_t>& queue(int Dir) {
+    return Dir ? transfer.queue_rev : transfer.queue_fwd;
+  }
+
+  //! buffers and slot signals
+  const rvs::hsa::transfer_t& transfer;
+  //! forward transfer source agent
+  hsa_agent_t src_agent;
+  //! forward transfer destination agent
+  hsa_agent_t dst_agent;
+};
+
+}  // namespace
+
+/**
+ * @brief Send a number of copies between source and destination NUMA
+ * nodes keeping several of them in flight
+ *
+ * Unlike SendTraffic(), which waits for every copy before issuing the next
+ * one, up to Depth chained copies per direction are outstanding so
+ * that the link does not idle while the host waits and relaunches. See
+ * rvs::copyengine.
+ *
+ * @param SrcNode source NUMA node
+ * @param DstNode destination NUMA node
+ * @param Size size of each copy
+ * @param bidirectional 'true' for bidirectional transfer
+ * @param Depth number of copies in flight per direction
+ * @param Copies number of copies per direction
+ * @param pStats [out] throughput and latency of the copies
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ * */
+int rvs::hsa::SendTrafficQueued(uint32_t SrcNode, uint32_t DstNode,
+                                size_t Size, bool bidirectional,
+                                unsigned int Depth, unsigned int Copies,
+                                copystats_t* pStats) {
+  xferlease_t lease;
+  transfer_t* px;
+  int sts;
+
+  RVSHSATRACE_
+
+  // given NUMA nodes, find agent indexes
+  int32_t src_ix = FindAgent(SrcNode);
+  int32_t dst_ix = FindAgent(DstNode);
+
+  // get buffers and signals for forward (and reverse) transfer
+  if (AcquireTransfer(SrcNode, DstNode, Size, bidirectional, &lease, &px)) {
     RVSHSATRACE_
-    hsa_amd_memory_pool_free(src_ptr_rev);
-    hsa_amd_memory_pool_free(dst_ptr_rev);
-    hsa_signal_destroy(signal_rev);
+    return -1;
+  }
+
+  sts = AllocQueueSignals(bidirectional, copyengine::slots(Depth), px);
+  if (!sts) {
+    hsacopy backend(*px, agent_list[src_ix].agent, agent_list[dst_ix].agent);
+    copyengine engine(&backend, Depth);
+    sts = engine.run(Size, Copies, bidirectional, pStats);
   }
+
+  ReleaseTransfer(&lease);
   RVSHSATRACE_
 
-  return 0;
+  return sts;
 }
 
-
 /**
  * @brief Get peer status between Src and Dst nodes
  *
@@ -24,6 +24,7 @@
  *******************************************************************************/
 #include "include/rvsliblogger.h"
 
+#include <fcntl.h>
 #include <unistd.h>
 #include <time.h>
 #include <stdio.h>
@@ -37,27 +38,31 @@
 #include <mutex>
 
 #include "include/rvstrace.h"
-#include "include/rvslognode.h"
-#include "include/rvslognodestring.h"
-#include "include/rvslognodeint.h"
-#include "include/rvslognoderec.h"
-#include "include/rvsminnode.h"
+#include "include/rvslogjsonrec.h"
+#include "include/rvslogframe.h"
 
 using std::cerr;
 using std::cout;
 
-int   rvs::logger::loglevel_m(2);
-bool  rvs::logger::tojson_m(false);
-bool  rvs::logger::append_m(false);
-bool  rvs::logger::isfirstrecord_m(true);
+std::atomic<int>   rvs::logger::loglevel_m(2);
+std::atomic<bool>  rvs::logger::tojson_m(false);
+std::atomic<bool>  rvs::logger::ndjson_m(false);
+std::atomic<bool>  rvs::logger::append_m(false);
+std::atomic<bool>  rvs::logger::isfirstrecord_m(true);
 std::mutex  rvs::logger::cout_mutex;
-std::mutex  rvs::logger::log_mutex;
-bool  rvs::logger::bStop(false);
-uint16_t rvs::logger::stop_flags(0u);
-bool rvs::logger::b_quiet(false);
+std::atomic<bool>  rvs::logger::bStop(false);
+thread_local std::atomic<bool>* rvs::logger::pcancel(nullptr);
+std::atomic<uint16_t> rvs::logger::stop_flags(0u);
+std::mutex rvs::logger::stop_mutex;
+std::condition_variable rvs::logger::stop_cv;
+std::atomic<bool> rvs::logger::b_quiet(false);
 char rvs::logger::log_file[1024];
 std::string rvs::logger::json_log_file;
 std::mutex  rvs::logger::json_log_mutex;
+bool  rvs::logger::isfirstaction_m(true);
+// framer must outlive the sink which may still use it while shutting down
+static rvs::logjsonframe json_frame;
+rvs::logsink rvs::logger::sink;
 const char*  rvs::logger::loglevelname[] = {
   "NONE  ", "RESULT", "ERROR ", "INFO  ", "DEBUG ", "TRACE " };
 
@@ -91,6 +96,7 @@ bool rvs::logger::append() {
 
 void rvs::logger::set_log_file(const std::string& fname) {
     strncpy(log_file, fname.c_str(), sizeof(log_file));
+    sink.set_file(logsink::target_text, log_file);
 }
 
 /**
@@ -103,6 +109,16 @@ void rvs::logger::log_level(const int rLevel) {
   loglevel_m = rLevel;
 }
 
+/**
+ * @brief Get logging level
+ *
+ * @return Current logging level
+ *
+ */
+int rvs::logger::log_level() {
+  return loglevel_m;
+}
+
 /**
  * @brief Fetches times since system start
  *
@@ -141,6 +157,55 @@ bool rvs::logger::to_json() {
   return tojson_m;
 }
 
+/**
+ * @brief Request newline-delimited JSON output to the given file
+ *
+ * Each JSON record is written as a single self-contained line carrying
+ * module, action, level and time. Lines are appended to the file, so it
+ * may be followed while RVS runs and shared by multiple runs. If the file
+ * ends with a partial line (e.g. after a crash), the line is terminated
+ * first so that it does not corrupt the next record.
+ *
+ * @param fname output file name
+ * @return 0 - success, non-zero if file can not be opened for writing
+ *
+ */
+int rvs::logger::set_ndjson_file(const std::string& fname) {
+  int fd = ::open(fname.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC,
+                  0644);
+  if (fd < 0) {
+    return -1;
+  }
+  bool bpartial = false;
+  off_t size = ::lseek(fd, 0, SEEK_END);
+  char last = '\n';
+  if (size > 0 && ::pread(fd, &last, 1, size - 1) == 1 && last != '\n') {
+    bpartial = true;
+  }
+  ::close(fd);
+
+  tojson_m = true;
+  ndjson_m = true;
+  json_log_file = fname;
+  sink.set_framer(logsink::target_json, nullptr);
+  sink.set_file(logsink::target_json, json_log_file);
+  if (bpartial) {
+    sink.post(logsink::target_json, RVSENDL);
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Get 'ndjson' flag
+ *
+ * @return 'true' if newline-delimited JSON output is requested
+ *
+ */
+bool rvs::logger::ndjson() {
+  return ndjson_m;
+}
+
 /**
  * @brief Output log message
  *
@@ -215,49 +280,91 @@ int rvs::logger::LogExt(const char* Message, const int LogLevel,
   }
 
   DTRACE_
+  // hand over to drain thread which outputs to cout and log file
+  ring().post(secs, usecs, LogLevel, Message);
+
+  DTRACE_
+  return 0;
+}
+
+/**
+ * @brief Get message ring
+ *
+ * Ring (and its drain thread) is created on first use.
+ *
+ * @return Reference to logger message ring
+ *
+ */
+rvs::logring& rvs::logger::ring() {
+  static logring r(ring_output);
+  return r;
+}
+
+/**
+ * @brief Output batch of log messages
+ *
+ * Called from the ring drain thread with messages ordered by timestamp.
+ * Formats messages and sends them to cout and to log file.
+ *
+ * @param entries messages to output
+ * @param count number of messages
+ *
+ */
+void rvs::logger::ring_output(const logring::entry_t* const* entries,
+                              size_t count) {
+  std::string con;
+  std::string file;
   char  buff[64];
-  snprintf(buff, sizeof(buff), "%6d.%-6d", secs, usecs);
 
-  std::string row("[");
-  row += loglevelname[LogLevel];
-  row +="] [";
-  row += buff;
-  row +="] ";
-  row += Message;
+  for (size_t i = 0; i < count; i++) {
+    const logring::entry_t* e = entries[i];
+    snprintf(buff, sizeof(buff), "%6d.%-6d", e->sec, e->usec);
+
+    std::string row("[");
+    row += loglevelname[e->level];
+    row +="] [";
+    row += buff;
+    row +="] ";
+    row += e->msg;
+
+    // if no quiet option given, output to cout
+    if (!b_quiet) {
+      con += row;
+      con += '\n';
+    }
 
-  // if no quiet option given, output to cout
-  if (!b_quiet) {
-    DTRACE_
-    // lock cout_mutex for the duration of this block
-    std::lock_guard<std::mutex> lk(cout_mutex);
-    cout << row << '\n';
-  }
+    // this stream does not output JSON
+    if (to_json() && !ndjson_m) {
+      continue;
+    }
 
-  // this stream does not output JSON
-  if (to_json()) {
-    DTRACE_
-    return 0;
+    // send to file if requested
+    if (isfirstrecord_m) {
+      isfirstrecord_m = false;
+    } else {
+      file += RVSENDL;
+    }
+    file += row;
   }
 
-  DTRACE_
-  // send to file if requested
-  if (isfirstrecord_m) {
-    DTRACE_
-    isfirstrecord_m = false;
-  } else {
-    DTRACE_
-    row = RVSENDL + row;
+  if (!con.empty()) {
+    // lock cout_mutex for the duration of this block
+    std::lock_guard<std::mutex> lk(cout_mutex);
+    cout << con;
   }
-  DTRACE_
 
-  if (true) {
-    // lock log_mutex for the duration of this block
-    std::lock_guard<std::mutex> lk(log_mutex);
-    ToFile(row);
+  if (!file.empty()) {
+    ToFile(file);
   }
+}
 
-  DTRACE_
-  return 0;
+/**
+ * @brief Wait for all log messages posted so far to be output
+ *
+ */
+void rvs::logger::flush() {
+  ring().flush();
+  sink.flush();
 }
 
 /**
@@ -294,27 +401,40 @@ void* rvs::logger::LogRecordCreate(const char* Module, const char* Action,
   uint32_t   usec;
   if( json_log_file.empty()){
        json_log_file = json_filename(Module);
+       sink.set_framer(logsink::target_json, &json_frame);
+       sink.set_file(logsink::target_json, json_log_file);
        std::lock_guard<std::mutex> lk(cout_mutex);
        std::cout << "json log file is " << json_log_file<< std::endl;
   }
-  if( minimal){
-    rvs::MinNode* minrec = new rvs::MinNode(Action, LogLevel);
-    return static_cast<void*>(minrec);
-  }
-  if ((Sec|uSec)) {
+  if ((Sec|uSec) || minimal) {
     sec = Sec;
     usec = uSec;
   } else  {
     get_ticks(&sec, &usec);
   }
 
-  rvs::LogNodeRec* rec = new LogNodeRec(Action, LogLevel, sec, usec);
-  AddString(rec, "action", Action);
-  AddString(rec, "module", Module);
-  AddString(rec, "loglevelname", (LogLevel >= lognone && LogLevel < logtrace) ?
+  // fields of records which are not going to be written are ignored
+  bool discard = !to_json() || LogLevel > loglevel_m;
+  rvs::LogJsonRec* rec;
+  if (ndjson_m) {
+    rec = rvs::LogJsonRec::Create(LogLevel, sec, usec, minimal, discard,
+                                  Module ? Module : "", Action);
+  } else {
+    rec = rvs::LogJsonRec::Create(LogLevel, sec, usec, minimal, discard);
+  }
+  if (minimal) {
+    return rec->Handle();
+  }
+  // NDJSON records already start with module and action
+  if (!ndjson_m) {
+    AddString(rec->Handle(), "action", Action);
+    AddString(rec->Handle(), "module", Module);
+  }
+  AddString(rec->Handle(), "loglevelname",
+    (LogLevel >= lognone && LogLevel < logtrace) ?
     loglevelname[LogLevel] : "UNKNOWN");
 
-  return static_cast<void*>(rec);
+  return rec->Handle();
 }
 
 /**
@@ -329,8 +449,14 @@ void* rvs::logger::LogRecordCreate(const char* Module, const char* Action,
  */
 #if 1
 int rvs::logger::JsonStartNodeCreate(const char* Module, const char* Action) {
+  // NDJSON records stand on their own
+  if (ndjson_m) {
+    return 0;
+  }
     if ( json_log_file.empty()){
         json_log_file = json_filename(Module);
+        sink.set_framer(logsink::target_json, &json_frame);
+        sink.set_file(logsink::target_json, json_log_file);
         std::lock_guard<std::mutex> lk(cout_mutex);
         std::cout << "json log file is " << json_log_file<< std::endl;
   }
@@ -339,25 +465,37 @@ int rvs::logger::JsonStartNodeCreate(const char* Module, const char* Action) {
   //row += RVSINDENT;
   //row += std::string("\"") + Action + std::string("\"") + kv_delimit + list_start + newline;
   std::lock_guard<std::mutex> lk(json_log_mutex);
-  return ToFile(row, true);
+  isfirstaction_m = true;
+  return ToFile(row, true, logjsonframe::tag_doc_start);
 }
 
 int rvs::logger::JsonActionStartNodeCreate(const char* Module, const char* Action) {
+  if (ndjson_m) {
+    return 0;
+  }
   if(json_log_file.empty()){
     rvs::logger::JsonStartNodeCreate(Module, Action);
   }
-  isfirstrecord_m = true;
   std::string row{RVSINDENT};
   row += std::string("\"") + Action + std::string("\"") + kv_delimit + list_start + newline;
   std::lock_guard<std::mutex> lk(json_log_mutex);
-  return ToFile(row, true);
+  isfirstrecord_m = true;
+  // separate from the previous action list, if any
+  if (!isfirstaction_m) {
+    row.insert(0, ",");
+  }
+  isfirstaction_m = false;
+  return ToFile(row, true, logjsonframe::tag_list_start);
 }
 
 int rvs::logger::JsonActionEndNodeCreate() {
+  if (ndjson_m) {
+    return 0;
+  }
   std::string row{RVSINDENT};
-  row += list_end + std::string(",");
+  row += list_end;
   std::lock_guard<std::mutex> lk(json_log_mutex);
-  return ToFile(row, true);
+  return ToFile(row, true, logjsonframe::tag_list_end);
 }
 
 /**
@@ -372,11 +510,14 @@ int rvs::logger::JsonActionEndNodeCreate() {
 int rvs::logger::JsonEndNodeCreate(void) {
   if(json_log_file.empty())
     return -1;
+  if (ndjson_m) {
+    return 0;
+  }
   std::string row{RVSINDENT};
   row += RVSINDENT + node_end + newline;
   row += node_end;
   std::lock_guard<std::mutex> lk(json_log_mutex);
-  return ToFile(row, true); 
+  return ToFile(row, true, logjsonframe::tag_doc_end);
 }
 
 #endif
@@ -390,20 +531,13 @@ int rvs::logger::JsonEndNodeCreate(void) {
  *
  */
 int   rvs::logger::LogRecordFlush(void* pLogRecord, bool minimal) {
-  // lock log_mutex for the duration of this block
-  std::lock_guard<std::mutex> lk(json_log_mutex);
-  std::string val;
-  LogNode *r = nullptr;
   DTRACE_
-  if(minimal){
-    r = static_cast<MinNode*>(pLogRecord);	
-  }else{
-    r = static_cast<LogNodeRec*>(pLogRecord);
-  }
+  (void)minimal;
+  rvs::LogJsonRec* r = rvs::LogJsonRec::FromHandle(pLogRecord);
   // no JSON loggin requested
   if (!to_json()) {
     DTRACE_
-    delete r;
+    rvs::LogJsonRec::Release(r);
     return 0;
   }
 
@@ -413,37 +547,43 @@ int   rvs::logger::LogRecordFlush(void* pLogRecord, bool minimal) {
     char buff[128];
     snprintf(buff, sizeof(buff), "unknown logging level: %d", r->LogLevel());
     Err(buff, "CLI");
-    delete r;
+    rvs::LogJsonRec::Release(r);
     return -1;
   }
   // if too high, ignore record
   if (level > loglevel_m) {
     DTRACE_
-    delete r;
+    rvs::LogJsonRec::Release(r);
     return 0;
   }
 
+  static thread_local std::string row;
+
+  // NDJSON: one line per record, no separator state to keep
+  if (ndjson_m) {
+    row.clear();
+    r->ToJson(&row);
+    rvs::LogJsonRec::Release(r);
+    row += RVSENDL;
+    return ToFile(row, true);
+  }
+
+  // get JSON formatted log record, leaving room for "," separator
+  row.assign(1, ',');
+  r->ToJson(&row);
+  rvs::LogJsonRec::Release(r);
+
+  // lock log_mutex for the duration of this block
+  std::lock_guard<std::mutex> lk(json_log_mutex);
+
   // do not pre-pend "," separator for the first row
-  std::string row;
-  if (append_m) {
+  if (append_m || !isfirstrecord_m) {
     DTRACE_
-    row = ",";
+    ToFile(row, true, logjsonframe::tag_record);
   } else {
     DTRACE_
-    if (!isfirstrecord_m) {
-      DTRACE_
-      row = ",";
-    }
+    ToFile(row.substr(1), true, logjsonframe::tag_record);
   }
-  DTRACE_
-  // get JSON formatted log record
-  row += r->ToJson("  ");
-
-  // send it to file
-  ToFile(row, true);
-  
-  // dealloc memory
-  delete r;
 
   if (isfirstrecord_m) {
     DTRACE_
@@ -457,34 +597,31 @@ int   rvs::logger::LogRecordFlush(void* pLogRecord, bool minimal) {
 /**
  * @brief Output log record to file
  *
- * Sends out string representing record to a log file
+ * Queues string representing record to the log sink which writes it to
+ * the log file from its own thread.
  *
  * @param Row string representing log record
+ * @param json_rec 'true' if row goes to JSON file
+ * @param tag row kind (see logjsonframe::tag_t)
  * @return 0 - success, non-zero otherwise
  *
  */
-int rvs::logger::ToFile(const std::string& Row, bool json_rec) {
+int rvs::logger::ToFile(const std::string& Row, bool json_rec,
+                        unsigned int tag) {
   if (bStop) {
     if (stop_flags)
       return 0;
   }
 
-  std::string logfile;
-  if (json_rec)
-	logfile.assign(json_log_file);
-  else
-	logfile.assign(log_file);
-  if (logfile == "")
-    return -1;
-
-  std::fstream fs;
-  fs.open(logfile, std::fstream::out | std::fstream::app);
-
-  fs << Row;
-
-  fs.close();
+  if (json_rec) {
+    if (json_log_file.empty())
+      return -1;
+    return sink.post(logsink::target_json, Row, tag);
+  }
 
-  return 0;
+  if (log_file[0] == '\0')
+    return -1;
+  return sink.post(logsink::target_text, Row);
 }
 
 /**
@@ -501,6 +638,9 @@ int rvs::logger::ToFile(const std::string& Row, bool json_rec) {
 int rvs::logger::JsonPatchAppend(int* pSts) {
   std::string logfile(json_log_file);
 
+  // make sure everything queued so far is in the file
+  sink.flush();
+
   FILE * pFile;
   pFile = fopen(logfile.c_str() , "r+");
   if (pFile == nullptr) {
@@ -524,8 +664,7 @@ int rvs::logger::JsonPatchAppend(int* pSts) {
  *
  */
 void* rvs::logger::CreateNode(void* Parent, const char* Name) {
-  rvs::LogNode* p = new LogNode(Name, static_cast<rvs::LogNodeBase*>(Parent));
-  return p;
+  return rvs::LogJsonRec::CreateNode(Parent, Name);
 }
 
 /**
@@ -539,9 +678,7 @@ void* rvs::logger::CreateNode(void* Parent, const char* Name) {
  *
  */
 void  rvs::logger::AddString(void* Parent, const char* Key, const char* Val) {
-  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
-  rvs::LogNodeString* p = new LogNodeString(Key, Val, pp);
-  pp->Add(p);
+  rvs::LogJsonRec::AddString(Parent, Key, Val);
 }
 
 /**
@@ -555,9 +692,49 @@ void  rvs::logger::AddString(void* Parent, const char* Key, const char* Val) {
  *
  */
 void  rvs::logger::AddInt(void* Parent, const char* Key, const int Val) {
-  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
-  rvs::LogNodeInt* p = new LogNodeInt(Key, Val, pp);
-  pp->Add(p);
+  rvs::LogJsonRec::AddInt(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type floating point to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as double
+ *
+ */
+void  rvs::logger::AddDouble(void* Parent, const char* Key, const double Val) {
+  rvs::LogJsonRec::AddDouble(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type unsigned 64-bit integer to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as uint64_t
+ *
+ */
+void  rvs::logger::AddUInt64(void* Parent, const char* Key, const uint64_t Val) {
+  rvs::LogJsonRec::AddUInt64(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type boolean to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as bool
+ *
+ */
+void  rvs::logger::AddBool(void* Parent, const char* Key, const bool Val) {
+  rvs::LogJsonRec::AddBool(Parent, Key, Val);
 }
 
 /**
@@ -573,8 +750,7 @@ void  rvs::logger::AddInt(void* Parent, const char* Key, const int Val) {
  *
  */
 void  rvs::logger::AddNode(void* Parent, void* Child) {
-  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
-  pp->Add(static_cast<rvs::LogNodeBase*>(Child));
+  rvs::LogJsonRec::AddNode(Parent, Child);
 }
 
 
@@ -585,9 +761,10 @@ void  rvs::logger::AddNode(void* Parent, void* Child) {
  *
  */
 int rvs::logger::init_log_file() {
+  // output messages pending from previous run first
+  ring().flush();
+
   isfirstrecord_m = true;
-  bStop = false;
-  stop_flags = 0;
 
   std::string row;
   std::string logfile(log_file);
@@ -601,7 +778,7 @@ int rvs::logger::init_log_file() {
     // have well formed JSON after appending
     int patch_status = -1;
 
-    if (to_json()) {
+    if (to_json() && !ndjson_m) {
       int sts = JsonPatchAppend(&patch_status);
       if (sts) {
         return -1;
@@ -616,7 +793,7 @@ int rvs::logger::init_log_file() {
     if (berror) {
       return -1;
     }
-    if (to_json()) {
+    if (to_json() && !ndjson_m) {
       row = "[";
     }
   }
@@ -639,15 +816,40 @@ int rvs::logger::terminate() {
   if (logfile == "")
     return 0;
 
+  // output pending messages before closing the file
+  ring().flush();
+
   std::string row(RVSENDL);
 
-  if (to_json()) {
+  // report log sink overflows, if any
+  logsink::stats_t st;
+  sink.get_stats(&st);
+  if ((st.dropped || st.stalled) && (!to_json() || ndjson_m) &&
+      loglevel_m >= loginfo) {
+    uint32_t secs = 0;
+    uint32_t usecs = 0;
+    get_ticks(&secs, &usecs);
+
+    char buff[256];
+    snprintf(buff, sizeof(buff),
+             "[%s] [%6d.%-6d] log sink: %lu records dropped, %lu stalled",
+             loglevelname[loginfo], secs, usecs,
+             static_cast<unsigned long>(st.dropped),
+             static_cast<unsigned long>(st.stalled));
+    row += buff;
+    row += RVSENDL;
+  }
+
+  if (to_json() && !ndjson_m) {
     row += "]";
   }
 
   // print to log file if requested
   ToFile(row);
 
+  // make sure everything reaches the disk before returning
+  sink.flush();
+
   return 0;
 }
 
@@ -660,12 +862,12 @@ int rvs::logger::terminate() {
  *
  */
 void rvs::logger::Stop(uint16_t flags) {
-  // lock cout_mutex for the duration of this block
-  std::lock_guard<std::mutex> lk(cout_mutex);
-
   // signal no further logging to either screen or file
-  bStop = true;
   stop_flags = flags;
+  bStop = true;
+
+  // wake up threads waiting in WaitStop()
+  NotifyStop();
 
   // properly terminate log file if needed
   terminate();
@@ -674,17 +876,146 @@ void rvs::logger::Stop(uint16_t flags) {
 /**
  * @brief Returns stop flag
  *
- * Checks if a module requested RVS processing to stop
+ * Checks if a module requested RVS processing to stop or if the session
+ * the calling thread works for was asked to stop
  *
  */
 bool rvs::logger::Stopping(void) {
-  // lock cout_mutex for the duration of this block
-  std::lock_guard<std::mutex> lk(cout_mutex);
+  if (pcancel && pcancel->load(std::memory_order_acquire)) {
+    return true;
+  }
 
-  // return stop flag
-  return bStop;
+  return bStop.load(std::memory_order_acquire);
 }
 
+/**
+ * @brief Sleeps until timeout or stop request
+ *
+ * Replaces plain sleeps in module workers so that a stop request (module
+ * Stop(), Ctrl-C or cancellation of the session the calling thread works
+ * for) is acted upon at once rather than when the sleep runs out.
+ *
+ * @param ms maximum sleep time in milliseconds
+ * @return true if stop was requested, false on timeout
+ *
+ */
+bool rvs::logger::WaitStop(unsigned int ms) {
+  std::atomic<bool>* pflag = pcancel;
+  std::unique_lock<std::mutex> lk(stop_mutex);
+
+  return stop_cv.wait_for(lk, std::chrono::milliseconds(ms), [pflag]() {
+    return bStop.load() || (pflag && pflag->load());
+  });
+}
+
+/**
+ * @brief Wakes up all threads sleeping in WaitStop()
+ *
+ * To be called after setting a stop request flag.
+ *
+ */
+void rvs::logger::NotifyStop() {
+  {
+    // serialize with waiters checking flags so the wake up is not missed
+    std::lock_guard<std::mutex> lk(stop_mutex);
+  }
+  stop_cv.notify_all();
+}
+
+/**
+ * @brief Requests RVS processing to stop without terminating logs
+ *
+ * Used on SIGINT/SIGTERM: running actions observe Stopping() and wind down,
+ * logging stays enabled so that results produced so far are recorded and the
+ * log file is properly terminated once actions return.
+ *
+ */
+void rvs::logger::Interrupt() {
+  bStop.store(true, std::memory_order_release);
+  NotifyStop();
+}
+
+/**
+ * @brief Sets session stop request flag for the calling thread
+ *
+ * Once the flag is set, Stopping() returns 'true' in this thread (and in
+ * threads it starts through ThreadBase) while logging is not affected.
+ *
+ * @param pflag pointer to stop request flag, nullptr to clear
+ *
+ */
+void rvs::logger::set_cancel_flag(std::atomic<bool>* pflag) {
+  pcancel = pflag;
+}
+
+/**
+ * @brief Returns session stop request flag of the calling thread
+ *
+ * @return pointer to stop request flag, nullptr if none
+ *
+ */
+std::atomic<bool>* rvs::logger::cancel_flag() {
+  return pcancel;
+}
+
+/**
+ * @brief Set log file rotation policy
+ *
+ * Applies to both text and JSON log files. Each rotated JSON file is closed
+ * and the next one reopened so that every file is a well-formed document.
+ *
+ * @param max_bytes maximum file size in bytes (0 - no limit)
+ * @param max_age maximum file age in seconds (0 - no limit)
+ * @param generations number of rotated files to keep
+ *
+ */
+void rvs::logger::rotation(uint64_t max_bytes, unsigned int max_age,
+                           unsigned int generations) {
+  logsink::rotation_t policy{max_bytes, max_age, generations};
+  sink.set_rotation(logsink::target_text, policy);
+  sink.set_rotation(logsink::target_json, policy);
+}
+
+/**
+ * @brief Restore default logging settings
+ *
+ * Used by a long running process (rvsd) between jobs, each of which sets
+ * up logging from its own command line. Files of the previous job are
+ * closed and a stop request of the previous job is cleared.
+ *
+ */
+void rvs::logger::reset() {
+  ring().flush();
+
+  loglevel_m = logerror;
+  tojson_m = false;
+  ndjson_m = false;
+  append_m = false;
+  b_quiet = false;
+  isfirstaction_m = true;
+
+  // stop request of the previous job does not carry over
+  stop_flags = 0;
+  bStop = false;
+
+  set_log_file("");
+  json_log_file.clear();
+  sink.set_framer(logsink::target_json, nullptr);
+  sink.set_file(logsink::target_json, json_log_file);
+  rotation(0, 0, 0);
+
+  sink.flush();
+}
+
+/**
+ * @brief Fetch log sink statistics
+ *
+ * @param pstats [out] number of records written, dropped and stalled on
+ *
+ */
+void rvs::logger::sink_stats(logsink::stats_t* pstats) {
+  sink.get_stats(pstats);
+}
 
 /**
  * @brief Output Error message
@@ -0,0 +1,346 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslinkmodel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "include/rvstopology.h"
+
+//! KFD io_link type of XGMI links
+#define KFD_IOLINK_TYPE_XGMI            11
+
+/**
+ * @brief Encoding efficiency of a PCIe link
+ *
+ * @param Speed transfer rate per lane (GT/s)
+ * @return share of the raw rate carrying data
+ *
+ */
+double rvs::linkmodel::encoding(double Speed) {
+  if (Speed <= 5) {
+    return 8.0 / 10;      // Gen1, Gen2
+  }
+  if (Speed <= 32) {
+    return 128.0 / 130;   // Gen3 - Gen5
+  }
+  return 242.0 / 256;     // Gen6 FLIT mode
+}
+
+/**
+ * @brief Theoretical bandwidth of one hop
+ *
+ * @param Hop link hop
+ * @return bandwidth per direction (bytes/s), 0 if not known
+ *
+ */
+double rvs::linkmodel::hop_bandwidth(const linkhop_t& Hop) {
+  if (Hop.bandwidth > 0) {
+    return Hop.bandwidth;
+  }
+  if (Hop.type == linktype::PCIE) {
+    return Hop.speed * 1e9 * Hop.width * encoding(Hop.speed) / 8;
+  }
+  return 0;
+}
+
+//! Bandwidth of the slowest known hop, 0 if none is known
+static double path_bandwidth(const std::vector<rvs::linkhop_t>& Path) {
+  double bw = 0;
+  for (const auto& hop : Path) {
+    double hbw = rvs::linkmodel::hop_bandwidth(hop);
+    if (hbw > 0 && (bw == 0 || hbw < bw)) {
+      bw = hbw;
+    }
+  }
+  return bw;
+}
+
+/**
+ * @brief Estimates theoretical bandwidth of a transfer path
+ *
+ * @param Path hops of the path as trained (negotiated speed and width)
+ * @param Capable the same hops at their maximum speed and width, or the
+ * direct link the path should have been
+ * @param pEstimate [out] expected and capable bandwidth and the reasons
+ * they differ
+ *
+ */
+void rvs::linkmodel::estimate(const std::vector<linkhop_t>& Path,
+                              const std::vector<linkhop_t>& Capable,
+                              linkestimate_t* pEstimate) {
+  char buff[64];
+  std::vector<std::string> limits;
+
+  for (size_t i = 0; i < std::min(Path.size(), Capable.size()); i++) {
+    const linkhop_t& cur = Path[i];
+    const linkhop_t& cap = Capable[i];
+    if (cur.type != linktype::PCIE || cap.type != linktype::PCIE) {
+      continue;
+    }
+    if (cur.width && cur.width < cap.width) {
+      snprintf(buff, sizeof(buff), "x%u of x%u", cur.width, cap.width);
+      limits.push_back(buff);
+    }
+    if (cur.speed > 0 && cur.speed < cap.speed) {
+      snprintf(buff, sizeof(buff), "%g GT/s of %g GT/s", cur.speed, cap.speed);
+      limits.push_back(buff);
+    }
+  }
+  if (Path.size() > Capable.size()) {
+    limits.push_back(std::to_string(Path.size()) + " hops");
+  }
+
+  pEstimate->expected = path_bandwidth(Path);
+  pEstimate->capable = path_bandwidth(Capable);
+  pEstimate->hops = Path.size();
+  pEstimate->limit.clear();
+  for (const auto& l : limits) {
+    pEstimate->limit += (pEstimate->limit.empty() ? "" : ", ") + l;
+  }
+}
+
+/**
+ * @brief Efficiency of a measured transfer against full link capability
+ *
+ * @param Estimate theoretical bandwidth of the transfer path
+ * @param Bandwidth measured bandwidth (GB/s), both directions summed if
+ * bidirectional, 0 if not measured
+ * @param Bidir 'true' for bidirectional transfer
+ * @param pText [out] " efficiency: ..." appended if efficiency is known
+ * @return efficiency (fraction of 1), -1 if unknown
+ *
+ */
+double rvs::linkmodel::efficiency(const linkestimate_t& Estimate,
+                                  double Bandwidth, bool Bidir,
+                                  std::string* pText) {
+  char buff[64];
+
+  if (Bandwidth <= 0 || Estimate.capable <= 0) {
+    return -1;
+  }
+
+  double eff = Bandwidth * 1e9 / (Bidir ? 2 : 1) / Estimate.capable;
+  snprintf(buff, sizeof(buff), "  efficiency: %.1f%% of %.3f GBps",
+           eff * 100, Estimate.capable / 1e9);
+  *pText += buff;
+  return eff;
+}
+
+/**
+ * @brief Converts PCIe link speed code (LNKCAP/LNKSTA) to transfer rate
+ *
+ * @param Code speed code (1 - 2.5 GT/s ... 6 - 64 GT/s)
+ * @return transfer rate per lane (GT/s), 0 if unknown
+ *
+ */
+double rvs::linkmodel::speed_from_code(unsigned int Code) {
+  static const double speeds[] = {0, 2.5, 5, 8, 16, 32, 64};
+  return Code < sizeof(speeds) / sizeof(speeds[0]) ? speeds[Code] : 0;
+}
+
+/**
+ * @brief Parses PCIe link speed
+ *
+ * @param Val speed as printed by pci_caps ("16 GT/s") or sysfs
+ * ("16.0 GT/s PCIe")
+ * @param pSpeed [out] transfer rate per lane (GT/s)
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::linkmodel::parse_speed(const std::string& Val, double* pSpeed) {
+  char* end;
+  double speed = strtod(Val.c_str(), &end);
+
+  if (end == Val.c_str() || speed <= 0 ||
+      std::string(end).find("GT/s") == std::string::npos) {
+    return -1;
+  }
+  *pSpeed = speed;
+  return 0;
+}
+
+/**
+ * @brief Parses PCIe link width
+ *
+ * @param Val width as printed by pci_caps ("x16") or sysfs ("16")
+ * @param pWidth [out] number of lanes
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::linkmodel::parse_width(const std::string& Val, unsigned int* pWidth) {
+  const char* p = Val.c_str();
+  char* end;
+
+  if (*p == 'x') {
+    p++;
+  }
+  unsigned long width = strtoul(p, &end, 10);
+  if (end == p || width == 0) {
+    return -1;
+  }
+  *pWidth = width;
+  return 0;
+}
+
+//! Reads first line of a sysfs file
+static int read_line(const std::string& path, std::string* pline) {
+  std::ifstream f(path);
+  return std::getline(f, *pline) ? 0 : -1;
+}
+
+/**
+ * @brief Reads PCIe link of a GPU from sysfs
+ *
+ * @param GpuId KFD gpu_id
+ * @param pCur [out] negotiated speed and width
+ * @param pCap [out] maximum speed and width
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::linkmodel::pcie_hop(uint16_t GpuId, linkhop_t* pCur,
+                             linkhop_t* pCap) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_gpu(GpuId);
+  if (!node) {
+    return -1;
+  }
+
+  std::string dev = rvs::topology::sysfs_root() + RVS_PCI_DEVICES_PATH + "/"
+                  + node->bdf() + "/";
+  std::string cur_speed, cur_width, max_speed, max_width;
+  if (read_line(dev + "current_link_speed", &cur_speed) ||
+      read_line(dev + "current_link_width", &cur_width) ||
+      read_line(dev + "max_link_speed", &max_speed) ||
+      read_line(dev + "max_link_width", &max_width)) {
+    return -1;
+  }
+
+  *pCur = linkhop_t{linktype::PCIE, 0, 0, 0};
+  *pCap = linkhop_t{linktype::PCIE, 0, 0, 0};
+  if (parse_speed(cur_speed, &pCur->speed) ||
+      parse_width(cur_width, &pCur->width) ||
+      parse_speed(max_speed, &pCap->speed) ||
+      parse_width(max_width, &pCap->width)) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Gets XGMI link between two KFD nodes
+ *
+ * Bandwidth is the io_link max_bandwidth (MB/s) reported by KFD. If the
+ * nodes are not linked directly, the XGMI link of the source node they
+ * are reached through is returned instead.
+ *
+ * @param SrcNode source KFD node
+ * @param DstNode destination KFD node
+ * @param pHop [out] link
+ * @return 0 - direct link, 1 - no direct link, -1 - no XGMI link
+ *
+ */
+int rvs::linkmodel::xgmi_hop(uint16_t SrcNode, uint16_t DstNode,
+                             linkhop_t* pHop) {
+  auto topo = rvs::topology::snapshot();
+  const rvs::toponode* node = topo->by_node(SrcNode);
+  int sts = -1;
+  if (!node) {
+    return -1;
+  }
+
+  for (const auto& link : node->io_links) {
+    uint64_t type;
+    uint64_t bw;
+    if (!link.get("type", &type) || type != KFD_IOLINK_TYPE_XGMI ||
+        !link.get("max_bandwidth", &bw) || bw == 0) {
+      continue;
+    }
+    if (link.node_to == DstNode) {
+      *pHop = linkhop_t{linktype::XGMI, 0, 0, bw * 1e6};
+      return 0;
+    }
+    if (sts < 0) {
+      *pHop = linkhop_t{linktype::XGMI, 0, 0, bw * 1e6};
+      sts = 1;
+    }
+  }
+
+  return sts;
+}
+
+/**
+ * @brief Estimates theoretical bandwidth between two KFD nodes
+ *
+ * A path of XGMI hops only is modelled as that many XGMI links against
+ * a single direct one. Any other path is modelled as the PCIe links of
+ * its GPU endpoints, as trained against their maximum.
+ *
+ * @param SrcNode source KFD node (CPU or GPU)
+ * @param DstNode destination KFD node (CPU or GPU)
+ * @param Hops link types of the path hops as reported by HSA
+ * @param pEstimate [out] estimate
+ * @return 0 if successful, non-zero if no link could be modelled
+ *
+ */
+int rvs::linkmodel::path_estimate(uint16_t SrcNode, uint16_t DstNode,
+                                  const std::vector<linktype>& Hops,
+                                  linkestimate_t* pEstimate) {
+  std::vector<linkhop_t> path;
+  std::vector<linkhop_t> capable;
+  bool bxgmi = !Hops.empty() &&
+      std::all_of(Hops.begin(), Hops.end(),
+                  [](linktype t) { return t == linktype::XGMI; });
+
+  if (bxgmi) {
+    linkhop_t hop;
+    if (xgmi_hop(SrcNode, DstNode, &hop) < 0) {
+      return -1;
+    }
+    path.assign(Hops.size(), hop);
+    capable.push_back(hop);
+  } else {
+    auto topo = rvs::topology::snapshot();
+    for (uint16_t node : {SrcNode, DstNode}) {
+      const rvs::toponode* pnode = topo->by_node(node);
+      linkhop_t cur, cap;
+      if (pnode && pnode->gpu_id && !pcie_hop(pnode->gpu_id, &cur, &cap)) {
+        path.push_back(cur);
+        capable.push_back(cap);
+      }
+    }
+    if (path.empty()) {
+      return -1;
+    }
+  }
+
+  estimate(path, capable, pEstimate);
+  return 0;
+}
@@ -0,0 +1,132 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogframe.h"
+
+#include <string>
+
+//! Default constructor
+rvs::logjsonframe::logjsonframe()
+:
+in_doc(false),
+in_list(false),
+seg_list(false),
+seg_rec(false) {
+}
+
+/**
+ * @brief Remove leading "," separator from the row
+ *
+ * @param prow [in,out] row text
+ *
+ */
+static void strip_separator(std::string* prow) {
+  if (!prow->empty() && (*prow)[0] == ',') {
+    prow->erase(0, 1);
+  }
+}
+
+/**
+ * @brief Account for JSON row about to be written
+ *
+ * @param tag row kind (tag_t)
+ * @param prow [in,out] row text
+ *
+ */
+void rvs::logjsonframe::row(unsigned int tag, std::string* prow) {
+  switch (tag) {
+  case tag_doc_start:
+    doc_head = *prow;
+    in_doc = true;
+    in_list = false;
+    seg_list = false;
+    break;
+
+  case tag_list_start:
+    list_head = *prow;
+    strip_separator(&list_head);
+    if (!seg_list) {
+      strip_separator(prow);
+    }
+    in_list = true;
+    seg_list = true;
+    seg_rec = false;
+    break;
+
+  case tag_record:
+    if (!seg_rec) {
+      strip_separator(prow);
+    }
+    seg_rec = true;
+    break;
+
+  case tag_list_end:
+    in_list = false;
+    break;
+
+  case tag_doc_end:
+    in_doc = false;
+    in_list = false;
+    break;
+
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief Closing text for the current JSON file
+ *
+ * @return "]" and "}" needed to close open list and document
+ *
+ */
+std::string rvs::logjsonframe::trailer() {
+  std::string s;
+  if (in_list) {
+    s += "  ]";
+  }
+  if (in_doc) {
+    s += "    }\n}";
+  }
+  return s;
+}
+
+/**
+ * @brief Start new JSON file
+ *
+ * @return document and list heads to reopen in the new file
+ *
+ */
+std::string rvs::logjsonframe::segment() {
+  std::string s;
+  if (in_doc) {
+    s = doc_head;
+    if (in_list) {
+      s += list_head;
+    }
+  }
+  seg_list = in_doc && in_list;
+  seg_rec = false;
+  return s;
+}
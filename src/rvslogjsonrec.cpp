@@ -0,0 +1,632 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogjsonrec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "include/rvslognodedouble.h"
+
+#define RVSLOGJSON_FIELD_LEAD   4
+#define RVSLOGJSON_ALIGN        8
+
+/**
+ * @brief Constructor
+ *
+ */
+rvs::LogArena::LogArena() : head(nullptr), cur(nullptr) {
+}
+
+//! Destructor
+rvs::LogArena::~LogArena() {
+  chunk_t* p = head;
+  while (p) {
+    chunk_t* n = p->next;
+    free(p);
+    p = n;
+  }
+}
+
+/**
+ * @brief Allocate memory from arena
+ *
+ * Memory is aligned to 8 bytes and stays valid until reset().
+ *
+ * @param size Number of bytes
+ * @return Pointer to allocated memory, nullptr if out of memory
+ *
+ */
+void* rvs::LogArena::alloc(size_t size) {
+  size = (size + RVSLOGJSON_ALIGN - 1) & ~(size_t)(RVSLOGJSON_ALIGN - 1);
+
+  // find chunk with enough space, reusing chunks left from previous records
+  while (cur && cur->used + size > cur->size) {
+    if (!cur->next)
+      break;
+    cur = cur->next;
+    cur->used = 0;
+  }
+
+  if (!cur || cur->used + size > cur->size) {
+    size_t csize = size > RVS_LOGARENA_CHUNK ? size : RVS_LOGARENA_CHUNK;
+    chunk_t* c = static_cast<chunk_t*>(malloc(sizeof(chunk_t) + csize));
+    if (!c)
+      return nullptr;
+    c->next = nullptr;
+    c->size = csize;
+    c->used = 0;
+    if (cur) {
+      cur->next = c;
+    } else {
+      head = c;
+    }
+    cur = c;
+  }
+
+  char* p = reinterpret_cast<char*>(cur + 1) + cur->used;
+  cur->used += size;
+  return p;
+}
+
+/**
+ * @brief Copy C string into arena
+ *
+ * @param str Source string (nullptr is treated as empty string)
+ * @return Pointer to copy
+ *
+ */
+const char* rvs::LogArena::copy(const char* str) {
+  size_t len = str ? strlen(str) : 0;
+  char* p = static_cast<char*>(alloc(len + 1));
+  if (!p)
+    return "";
+  if (len)
+    memcpy(p, str, len);
+  p[len] = '\0';
+  return p;
+}
+
+/**
+ * @brief Release all allocations in one step
+ *
+ * Chunks are kept for reuse; only the first one is filled before
+ * the next one is reused.
+ *
+ */
+void rvs::LogArena::reset() {
+  cur = head;
+  if (cur)
+    cur->used = 0;
+}
+
+//! Destructor
+rvs::LogJsonRec::pool_t::~pool_t() {
+  for (auto it = free.begin(); it != free.end(); ++it) {
+    delete (*it);
+  }
+}
+
+/**
+ * @brief Per-thread pool of released records
+ *
+ * @return Reference to pool of calling thread
+ *
+ */
+rvs::LogJsonRec::pool_t& rvs::LogJsonRec::pool() {
+  static thread_local pool_t p;
+  return p;
+}
+
+/**
+ * @brief Constructor
+ *
+ */
+rvs::LogJsonRec::LogJsonRec()
+:
+Level(0),
+bMinimal(false),
+bDiscard(false),
+bCompact(false),
+nFields(0) {
+  memset(&root, 0, sizeof(root));
+  root.type = eLN::Record;
+  root.rec = this;
+}
+
+//! Destructor
+rvs::LogJsonRec::~LogJsonRec() {
+}
+
+/**
+ * @brief Create log record
+ *
+ * Takes record from the pool of the calling thread if one is available.
+ *
+ * @param LogLevel Logging level
+ * @param Sec seconds since system start
+ * @param uSec microseconds in current second
+ * @param Minimal 'true' for minimal record (no level and time fields)
+ * @param Discard 'true' if record will not be written
+ * @param Module module name for compact record, nullptr for regular one
+ * @param Action action name for compact record
+ * @return Pointer to record
+ *
+ */
+rvs::LogJsonRec* rvs::LogJsonRec::Create(int LogLevel, unsigned Sec,
+                                         unsigned uSec, bool Minimal,
+                                         bool Discard, const char* Module,
+                                         const char* Action) {
+  LogJsonRec* r;
+  pool_t& p = pool();
+  if (p.free.empty()) {
+    r = new LogJsonRec();
+  } else {
+    r = p.free.back();
+    p.free.pop_back();
+  }
+  r->Init(LogLevel, Sec, uSec, Minimal, Discard, Module, Action);
+  return r;
+}
+
+/**
+ * @brief Release log record
+ *
+ * Arena is reset in one step and the record is returned to the pool of
+ * the calling thread.
+ *
+ * @param pRec Pointer to record
+ *
+ */
+void rvs::LogJsonRec::Release(LogJsonRec* pRec) {
+  if (!pRec)
+    return;
+  pRec->arena.reset();
+  pRec->splice.clear();
+
+  pool_t& p = pool();
+  if (p.free.size() < RVS_LOGJSON_POOL_SIZE) {
+    p.free.push_back(pRec);
+  } else {
+    delete pRec;
+  }
+}
+
+/**
+ * @brief Get record from handle returned by Handle()
+ *
+ * @param Handle Record handle
+ * @return Pointer to record
+ *
+ */
+rvs::LogJsonRec* rvs::LogJsonRec::FromHandle(void* Handle) {
+  return static_cast<LogJsonNode*>(Handle)->rec;
+}
+
+/**
+ * @brief Initialize record and write its opening part into buffer
+ *
+ */
+void rvs::LogJsonRec::Init(int LogLevel, unsigned Sec, unsigned uSec,
+                           bool Minimal, bool Discard,
+                           const char* Module, const char* Action) {
+  Level = LogLevel;
+  bMinimal = Minimal;
+  bDiscard = Discard;
+  bCompact = Module != nullptr;
+  nFields = 0;
+  buff.clear();
+
+  if (bDiscard)
+    return;
+
+  char  tmp[64];
+  if (bCompact) {
+    // every line carries its origin, minimal records included
+    buff += "{\"module\":";
+    StringToJson(&buff, Module, true);
+    buff += ",\"action\":";
+    StringToJson(&buff, Action ? Action : "", true);
+    buff += ",\"loglevel\":";
+    buff += std::to_string(Level);
+    snprintf(tmp, sizeof(tmp), ",\"time\":%u.%06u", Sec, uSec);
+    buff += tmp;
+    nFields = 1;
+    return;
+  }
+
+  if (bMinimal) {
+    buff += RVSENDL "{";
+    return;
+  }
+
+  buff += RVSENDL RVSINDENT "{" RVSENDL RVSINDENT RVSINDENT "\"loglevel\" : ";
+  buff += std::to_string(Level);
+  snprintf(tmp, sizeof(tmp), "%6d.%-6d", Sec, uSec);
+  buff += "," RVSENDL RVSINDENT RVSINDENT "\"time\" : \"";
+  buff += tmp;
+  buff += "\",";
+}
+
+/**
+ * @brief Write separator, indentation and key of next top level field
+ *
+ * @param Key Field name
+ *
+ */
+void rvs::LogJsonRec::OpenField(const char* Key) {
+  if (nFields++)
+    buff += ',';
+  if (bCompact) {
+    StringToJson(&buff, Key, true);
+    buff += ':';
+    return;
+  }
+  buff += RVSENDL;
+  buff.append(RVSLOGJSON_FIELD_LEAD, ' ');
+  buff += '"';
+  buff += Key;
+  buff += "\" : ";
+}
+
+/**
+ * @brief Write quoted string
+ *
+ * @param pOut Output string
+ * @param Str String value
+ * @param Escape 'true' to escape quotes, backslashes and control characters
+ *
+ */
+void rvs::LogJsonRec::StringToJson(std::string* pOut, const char* Str,
+                                   bool Escape) {
+  *pOut += '"';
+  if (!Escape) {
+    *pOut += Str;
+    *pOut += '"';
+    return;
+  }
+  char  tmp[8];
+  for (const char* p = Str; *p; p++) {
+    unsigned char c = static_cast<unsigned char>(*p);
+    switch (c) {
+    case '"':
+      *pOut += "\\\"";
+      break;
+    case '\\':
+      *pOut += "\\\\";
+      break;
+    case '\n':
+      *pOut += "\\n";
+      break;
+    case '\r':
+      *pOut += "\\r";
+      break;
+    case '\t':
+      *pOut += "\\t";
+      break;
+    default:
+      if (c < 0x20) {
+        snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+        *pOut += tmp;
+      } else {
+        *pOut += *p;
+      }
+      break;
+    }
+  }
+  *pOut += '"';
+}
+
+/**
+ * @brief Allocate node in record arena
+ *
+ */
+rvs::LogJsonNode* rvs::LogJsonRec::NewNode(LogJsonRec* pRec, T_LNTYPE Type,
+                                           const char* Name) {
+  LogJsonNode* n = static_cast<LogJsonNode*>(
+    pRec->arena.alloc(sizeof(LogJsonNode)));
+  if (!n)
+    return nullptr;
+  memset(n, 0, sizeof(*n));
+  n->type = Type;
+  n->rec = pRec;
+  n->name = pRec->arena.copy(Name);
+  return n;
+}
+
+/**
+ * @brief Append child to the list of children of nested node
+ *
+ */
+void rvs::LogJsonRec::Link(LogJsonNode* pParent, LogJsonNode* pChild) {
+  pChild->next = nullptr;
+  if (pParent->last) {
+    pParent->last->next = pChild;
+  } else {
+    pParent->first = pChild;
+  }
+  pParent->last = pChild;
+}
+
+/**
+ * @brief Create nested node
+ *
+ * Node is allocated in the arena of the record owning the parent node.
+ *
+ * @param Parent Parent node (record or nested node)
+ * @param Name Node name
+ * @return Node handle, nullptr on error
+ *
+ */
+void* rvs::LogJsonRec::CreateNode(void* Parent, const char* Name) {
+  if (!Parent)
+    return nullptr;
+  LogJsonNode* pp = static_cast<LogJsonNode*>(Parent);
+  // nothing will be written so hand out the record itself
+  if (pp->rec->bDiscard)
+    return pp->rec->Handle();
+  return NewNode(pp->rec, eLN::List, Name);
+}
+
+/**
+ * @brief Add string field
+ *
+ * Top level fields are written straight into the record buffer.
+ *
+ * @param Parent Parent node (record or nested node)
+ * @param Key Key as C string
+ * @param Val Value as C string
+ *
+ */
+void rvs::LogJsonRec::AddString(void* Parent, const char* Key,
+                                const char* Val) {
+  LogJsonNode* pp = static_cast<LogJsonNode*>(Parent);
+  LogJsonRec* r = pp->rec;
+  if (r->bDiscard)
+    return;
+
+  if (pp->type == eLN::Record) {
+    r->OpenField(Key);
+    StringToJson(&r->buff, Val, r->bCompact);
+    return;
+  }
+
+  LogJsonNode* n = NewNode(r, eLN::String, Key);
+  if (!n)
+    return;
+  n->sval = r->arena.copy(Val);
+  Link(pp, n);
+}
+
+/**
+ * @brief Add scalar field
+ *
+ * Top level fields are written straight into the record buffer, nested
+ * ones are kept in the arena until the record is serialized.
+ *
+ * @param Parent Parent node (record or nested node)
+ * @param Key Key as C string
+ * @param Type Value type
+ * @param IVal Value of Integer, UInt64 and Bool types
+ * @param DVal Value of Double type
+ *
+ */
+void rvs::LogJsonRec::AddValue(void* Parent, const char* Key, T_LNTYPE Type,
+                               uint64_t IVal, double DVal) {
+  LogJsonNode* pp = static_cast<LogJsonNode*>(Parent);
+  LogJsonRec* r = pp->rec;
+  if (r->bDiscard)
+    return;
+
+  if (pp->type == eLN::Record) {
+    r->OpenField(Key);
+    ValueToJson(&r->buff, Type, IVal, DVal);
+    return;
+  }
+
+  LogJsonNode* n = NewNode(r, Type, Key);
+  if (!n)
+    return;
+  n->ival = IVal;
+  n->dval = DVal;
+  Link(pp, n);
+}
+
+/**
+ * @brief Write scalar value
+ *
+ * @param pOut Output string
+ * @param Type Value type
+ * @param IVal Value of Integer, UInt64 and Bool types
+ * @param DVal Value of Double type
+ *
+ */
+void rvs::LogJsonRec::ValueToJson(std::string* pOut, T_LNTYPE Type,
+                                  uint64_t IVal, double DVal) {
+  char  tmp[32];
+  switch (Type) {
+  case eLN::Integer:
+    *pOut += std::to_string(static_cast<int>(IVal));
+    break;
+  case eLN::UInt64:
+    *pOut += std::to_string(IVal);
+    break;
+  case eLN::Bool:
+    *pOut += IVal ? "true" : "false";
+    break;
+  case eLN::Double:
+    LogNodeDouble::Format(DVal, tmp, sizeof(tmp));
+    *pOut += tmp;
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief Add integer field
+ *
+ * @param Parent Parent node (record or nested node)
+ * @param Key Key as C string
+ * @param Val Value as integer
+ *
+ */
+void rvs::LogJsonRec::AddInt(void* Parent, const char* Key, const int Val) {
+  AddValue(Parent, Key, eLN::Integer,
+           static_cast<uint64_t>(static_cast<int64_t>(Val)), 0);
+}
+
+/**
+ * @brief Add floating point field
+ *
+ * @param Parent Parent node (record or nested node)
+ * @param Key Key as C string
+ * @param Val Value as double
+ *
+ */
+void rvs::LogJsonRec::AddDouble(void* Parent, const char* Key,
+                                const double Val) {
+  AddValue(Parent, Key, eLN::Double, 0, Val);
+}
+
+/**
+ * @brief Add unsigned 64-bit integer field
+ *
+ * @param Parent Parent node (record or nested node)
+ * @param Key Key as C string
+ * @param Val Value as uint64_t
+ *
+ */
+void rvs::LogJsonRec::AddUInt64(void* Parent, const char* Key,
+                                const uint64_t Val) {
+  AddValue(Parent, Key, eLN::UInt64, Val, 0);
+}
+
+/**
+ * @brief Add boolean field
+ *
+ * @param Parent Parent node (record or nested node)
+ * @param Key Key as C string
+ * @param Val Value as bool
+ *
+ */
+void rvs::LogJsonRec::AddBool(void* Parent, const char* Key, const bool Val) {
+  AddValue(Parent, Key, eLN::Bool, Val ? 1 : 0, 0);
+}
+
+/**
+ * @brief Add nested node to parent
+ *
+ * When added to the record itself, the node position in the buffer is
+ * remembered and the node is serialized when the record is flushed, so
+ * fields may still be added to it.
+ *
+ * @param Parent Parent node (record or nested node)
+ * @param Child Node previously created using CreateNode()
+ *
+ */
+void rvs::LogJsonRec::AddNode(void* Parent, void* Child) {
+  LogJsonNode* pp = static_cast<LogJsonNode*>(Parent);
+  LogJsonNode* pc = static_cast<LogJsonNode*>(Child);
+  LogJsonRec* r = pp->rec;
+  if (r->bDiscard || !pc || pc == pp)
+    return;
+
+  if (pp->type == eLN::Record) {
+    if (r->nFields++)
+      r->buff += ',';
+    r->splice.push_back(std::make_pair(r->buff.size(), pc));
+    return;
+  }
+
+  Link(pp, pc);
+}
+
+/**
+ * @brief Serialize nested node
+ *
+ * @param pOut Output string
+ * @param pNode Node
+ * @param Lead Indentation (number of blanks)
+ * @param Compact 'true' for single line output
+ *
+ */
+void rvs::LogJsonRec::NodeToJson(std::string* pOut, const LogJsonNode* pNode,
+                                 size_t Lead, bool Compact) {
+  if (Compact) {
+    StringToJson(pOut, pNode->name, true);
+    *pOut += ':';
+  } else {
+    *pOut += RVSENDL;
+    pOut->append(Lead, ' ');
+    *pOut += '"';
+    *pOut += pNode->name;
+    *pOut += "\" : ";
+  }
+
+  switch (pNode->type) {
+  case eLN::String:
+    StringToJson(pOut, pNode->sval, Compact);
+    break;
+  case eLN::List:
+    *pOut += '{';
+    for (const LogJsonNode* c = pNode->first; c; c = c->next) {
+      NodeToJson(pOut, c, Lead + 2, Compact);
+      if (c->next)
+        *pOut += ',';
+    }
+    if (!Compact) {
+      *pOut += RVSENDL;
+      pOut->append(Lead, ' ');
+    }
+    *pOut += '}';
+    break;
+  default:
+    ValueToJson(pOut, pNode->type, pNode->ival, pNode->dval);
+    break;
+  }
+}
+
+/**
+ * @brief Append JSON representation of the record
+ *
+ * Output is identical to the one produced by LogNodeRec::ToJson("  ").
+ * Compact records are closed without line break.
+ *
+ * @param pOut Output string
+ *
+ */
+void rvs::LogJsonRec::ToJson(std::string* pOut) const {
+  size_t pos = 0;
+  for (auto it = splice.begin(); it != splice.end(); ++it) {
+    pOut->append(buff, pos, it->first - pos);
+    NodeToJson(pOut, it->second, RVSLOGJSON_FIELD_LEAD, bCompact);
+    pos = it->first;
+  }
+  pOut->append(buff, pos, std::string::npos);
+  *pOut += bCompact ? "}" : RVSENDL RVSINDENT "}";
+}
@@ -24,6 +24,9 @@
  *******************************************************************************/
 #include "include/rvsloglp.h"
 
+#include <stdarg.h>
+#include <stdio.h>
+
 #include <chrono>
 #include <string>
 
@@ -55,6 +58,12 @@ int   rvs::lp::Initialize(const T_MODULE_INIT* pMi) {
   mi.cbStop                       = pMi->cbStop;
   mi.cbStopping                   = pMi->cbStopping;
   mi.cbErr                        = pMi->cbErr;
+  mi.cbAddDouble                  = pMi->cbAddDouble;
+  mi.cbAddUInt64                  = pMi->cbAddUInt64;
+  mi.cbAddBool                    = pMi->cbAddBool;
+  mi.cbLogLevel                   = pMi->cbLogLevel;
+  mi.cbMetric                     = pMi->cbMetric;
+  mi.cbWaitStop                   = pMi->cbWaitStop;
 
   return 0;
 }
@@ -98,6 +107,94 @@ int rvs::lp::Log(const std::string& Msg, const int LogLevel,
   return (*mi.cbLogExt)(Msg.c_str(), LogLevel, Sec, uSec);
 }
 
+/**
+ * @brief Format message and output it
+ *
+ * Short messages are formatted on stack, longer ones on heap.
+ *
+ * @param level Logging level
+ * @param bExt 'true' if Sec and uSec are to be used as timestamp
+ * @param Sec seconds from system start
+ * @param uSec microseconds within current second
+ * @param pFormat printf() format string
+ * @param args arguments
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::lp::Logv(const int level, const bool bExt, const unsigned int Sec,
+                  const unsigned int uSec, const char* pFormat, va_list args) {
+  char buff[1024];
+  std::string tmp;
+  const char* pMsg = buff;
+  va_list args2;
+
+  va_copy(args2, args);
+  int n = vsnprintf(buff, sizeof(buff), pFormat, args);
+  if (n >= 0 && static_cast<size_t>(n) >= sizeof(buff)) {
+    tmp.resize(n + 1);
+    vsnprintf(&tmp[0], tmp.size(), pFormat, args2);
+    pMsg = tmp.c_str();
+  }
+  va_end(args2);
+  if (n < 0)
+    return -1;
+
+  return bExt ? (*mi.cbLogExt)(pMsg, level, Sec, uSec) : (*mi.cbLog)(pMsg, level);
+}
+
+/**
+ * @brief Output printf-style formatted log message
+ *
+ * Use RVSLOGF() macro in order to skip formatting when level is not
+ * enabled.
+ *
+ * @param level Logging level
+ * @param pFormat printf() format string
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::lp::Logf(const int level, const char* pFormat, ...) {
+  va_list args;
+  va_start(args, pFormat);
+  int sts = Logv(level, false, 0, 0, pFormat, args);
+  va_end(args);
+  return sts;
+}
+
+/**
+ * @brief Output printf-style formatted log message with given timestamp
+ *
+ * Use RVSLOGF_EXT() macro in order to skip formatting when level is not
+ * enabled.
+ *
+ * @param level Logging level
+ * @param Sec seconds from system start
+ * @param uSec microseconds within current second
+ * @param pFormat printf() format string
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::lp::LogfExt(const int level, const unsigned int Sec,
+                     const unsigned int uSec, const char* pFormat, ...) {
+  va_list args;
+  va_start(args, pFormat);
+  int sts = Logv(level, true, Sec, uSec, pFormat, args);
+  va_end(args);
+  return sts;
+}
+
+/**
+ * @brief Get current logging level
+ *
+ * @return Logging level; messages with higher level are not output
+ *
+ */
+int rvs::lp::LogLevel() {
+  if (!mi.cbLogLevel)
+    return rvs::logtrace;
+  return (*mi.cbLogLevel)();
+}
+
 /**
  * @brief Create log record
  *
@@ -245,6 +342,68 @@ void  rvs::lp::AddInt(void* Parent, const char* Key, const int Val) {
   (*mi.cbAddInt)(Parent, Key, Val);
 }
 
+/**
+ * @brief Create and add child node of type floating point to the given parent node
+ *
+ * Note: this API is used to construct JSON output. Value is written as
+ * JSON number.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as double
+ *
+ */
+void  rvs::lp::AddDouble(void* Parent, const char* Key, const double Val) {
+  (*mi.cbAddDouble)(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type unsigned 64-bit integer to the given parent node
+ *
+ * Note: this API is used to construct JSON output. Value is written as
+ * JSON number.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as uint64_t
+ *
+ */
+void  rvs::lp::AddUInt64(void* Parent, const char* Key, const uint64_t Val) {
+  (*mi.cbAddUInt64)(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type boolean to the given parent node
+ *
+ * Note: this API is used to construct JSON output. Value is written as
+ * JSON boolean.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as bool
+ *
+ */
+void  rvs::lp::AddBool(void* Parent, const char* Key, const bool Val) {
+  (*mi.cbAddBool)(Parent, Key, Val);
+}
+
+/**
+ * @brief Record numeric sample in binary metrics file
+ *
+ * Cheap alternative to logging periodic samples as text and JSON; does
+ * nothing if no metrics file was requested.
+ *
+ * @param Metric metric id (rvs::metric_t)
+ * @param Device device id (GPU ID)
+ * @param Val sample value
+ *
+ */
+void  rvs::lp::Metric(uint16_t Metric, uint16_t Device, double Val) {
+  if (!mi.cbMetric)
+    return;
+  (*mi.cbMetric)(Metric, Device, Val);
+}
+
 /**
  * @brief Add child node to parent
  *
@@ -301,6 +460,17 @@ bool  rvs::lp::Stopping() {
   return (*mi.cbStopping)();
 }
 
+/**
+ * @brief Sleeps until timeout or stop request
+ *
+ * @param ms maximum sleep time in milliseconds
+ * @return true if stop was requested, false on timeout
+ *
+ */
+bool  rvs::lp::WaitStop(unsigned int ms) {
+  return (*mi.cbWaitStop)(ms);
+}
+
 /**
  * @brief Log Error output
  *
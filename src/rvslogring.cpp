@@ -0,0 +1,346 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogring.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <queue>
+#include <utility>
+#include <vector>
+
+thread_local rvs::logring::holder_t rvs::logring::tl_ring;
+
+//! Ring constructor
+rvs::logring::ring_t::ring_t()
+:
+head(0),
+tail(0),
+closed(false) {
+}
+
+/**
+ * @brief Per-thread holder destructor
+ *
+ * Marks thread's ring as closed so that drain thread can release it once
+ * it becomes empty.
+ *
+ */
+rvs::logring::holder_t::~holder_t() {
+  if (ring) {
+    ring->closed.store(true, std::memory_order_release);
+  }
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param cb output callback, called from drain thread
+ *
+ */
+rvs::logring::logring(output_t cb)
+:
+output(cb),
+idle(false),
+bquit(false),
+bshutdown(false),
+inflight(0),
+flush_req(0),
+flush_done(0),
+st_posted(0),
+st_stalled(0),
+st_rings(0) {
+  drainer = std::thread(&rvs::logring::run, this);
+}
+
+/**
+ * @brief Destructor
+ *
+ * Drains all rings and stops drain thread. Entries posted afterwards are
+ * output synchronously.
+ *
+ */
+rvs::logring::~logring() {
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    bquit = true;
+  }
+  cv_work.notify_one();
+  if (drainer.joinable()) {
+    drainer.join();
+  }
+}
+
+/**
+ * @brief Post log message
+ *
+ * Copies message into calling thread's ring. Does not take any lock unless
+ * the ring is full. Once the drain thread has exited the message is output
+ * directly, after anything still left in the rings.
+ *
+ * @param sec seconds part of timestamp
+ * @param usec microseconds part of timestamp
+ * @param level logging level
+ * @param msg message text
+ *
+ */
+void rvs::logring::post(uint32_t sec, uint32_t usec, int level,
+                        const char* msg) {
+  // raised before bshutdown is checked and lowered once the entry is
+  // published, so that the drain thread does its final pass after it
+  inflight.fetch_add(1);
+  if (bshutdown.load()) {
+    inflight.fetch_sub(1);
+    // drain thread is gone: output directly, after what is still queued
+    drain_once();
+    entry_t e;
+    e.ts = static_cast<uint64_t>(sec) * 1000000 + usec;
+    e.sec = sec;
+    e.usec = usec;
+    e.level = level;
+    e.msg = msg;
+    const entry_t* pe = &e;
+    std::lock_guard<std::mutex> lk(reg_mutex);
+    (*output)(&pe, 1);
+    return;
+  }
+
+  ring_t* r = get_ring();
+  uint64_t t = r->tail.load(std::memory_order_relaxed);
+  if (t - r->head.load(std::memory_order_acquire) >= RVS_LOGRING_SIZE) {
+    wait_space(r, t);
+  }
+
+  // slot strings are reused so their capacity is retained between messages
+  entry_t& e = r->slot[t & (RVS_LOGRING_SIZE - 1)];
+  e.ts = static_cast<uint64_t>(sec) * 1000000 + usec;
+  e.sec = sec;
+  e.usec = usec;
+  e.level = level;
+  e.msg.assign(msg);
+  r->tail.store(t + 1, std::memory_order_release);
+  inflight.fetch_sub(1);
+  st_posted++;
+
+  if (idle.load(std::memory_order_relaxed)) {
+    cv_work.notify_one();
+  }
+}
+
+/**
+ * @brief Wait until all messages posted so far are output
+ *
+ */
+void rvs::logring::flush() {
+  if (bshutdown.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lk(mtx);
+  uint64_t req = ++flush_req;
+  cv_work.notify_one();
+  cv_done.wait(lk, [this, req]{ return flush_done >= req || bshutdown; });
+}
+
+/**
+ * @brief Fetch ring statistics
+ *
+ * @param pstats [out] statistics
+ *
+ */
+void rvs::logring::get_stats(stats_t* pstats) {
+  pstats->posted  = st_posted;
+  pstats->stalled = st_stalled;
+  pstats->rings   = st_rings;
+}
+
+/**
+ * @brief Get ring of the calling thread, create it if needed
+ *
+ * @return Pointer to the ring
+ *
+ */
+rvs::logring::ring_t* rvs::logring::get_ring() {
+  if (tl_ring.owner == this && tl_ring.ring) {
+    return tl_ring.ring.get();
+  }
+
+  // ring holds cache line aligned members: allocate accordingly
+  void* p = nullptr;
+  if (posix_memalign(&p, RVS_CACHE_LINE, sizeof(ring_t))) {
+    throw std::bad_alloc();
+  }
+  std::shared_ptr<ring_t> sp(new (p) ring_t(), [](ring_t* r) {
+    r->~ring_t();
+    free(r);
+  });
+
+  if (tl_ring.ring) {
+    tl_ring.ring->closed.store(true, std::memory_order_release);
+  }
+  tl_ring.owner = this;
+  tl_ring.ring = sp;
+
+  {
+    std::lock_guard<std::mutex> lk(reg_mutex);
+    rings.push_back(sp);
+  }
+  st_rings++;
+
+  return sp.get();
+}
+
+/**
+ * @brief Wait for room in a full ring
+ *
+ * If the drain thread exits meanwhile, the rings are drained by the
+ * calling thread.
+ *
+ * @param r ring
+ * @param t current producer index
+ *
+ */
+void rvs::logring::wait_space(ring_t* r, uint64_t t) {
+  st_stalled++;
+  std::unique_lock<std::mutex> lk(mtx);
+  while (t - r->head.load(std::memory_order_acquire) >= RVS_LOGRING_SIZE) {
+    if (bshutdown.load()) {
+      lk.unlock();
+      drain_once();
+      lk.lock();
+      continue;
+    }
+    cv_work.notify_one();
+    cv_done.wait_for(lk, std::chrono::milliseconds(1));
+  }
+}
+
+/**
+ * @brief Drain thread function
+ *
+ */
+void rvs::logring::run() {
+  std::unique_lock<std::mutex> lk(mtx);
+  for (;;) {
+    uint64_t req = flush_req;
+    bool quit = bquit;
+    lk.unlock();
+
+    // take everything there is, including what arrives meanwhile
+    while (drain_once()) {
+    }
+
+    lk.lock();
+    flush_done = req;
+    cv_done.notify_all();
+
+    if (quit) {
+      break;
+    }
+
+    if (flush_req == flush_done && !bquit) {
+      idle.store(true);
+      cv_work.wait_for(lk, std::chrono::milliseconds(RVS_LOGRING_IDLE_WAIT));
+      idle.store(false);
+    }
+  }
+
+  // producers stalled on a full ring drain it themselves from now on
+  bshutdown.store(true);
+
+  // entries posted after the last pass are still in the rings; wait for
+  // producers which passed the bshutdown check before it was set to
+  // publish theirs, then take them all
+  lk.unlock();
+  while (inflight.load()) {
+    std::this_thread::yield();
+  }
+  while (drain_once()) {
+  }
+  lk.lock();
+
+  cv_done.notify_all();
+}
+
+/**
+ * @brief Take available entries from all rings and output them
+ *
+ * Entries of each ring are already ordered, so they are merged by
+ * timestamp using a heap holding the head of every ring.
+ *
+ * @return Number of entries output
+ *
+ */
+size_t rvs::logring::drain_once() {
+  typedef std::pair<uint64_t, size_t> heap_item_t;  // (timestamp, ring index)
+  std::priority_queue<heap_item_t, std::vector<heap_item_t>,
+                      std::greater<heap_item_t>> heap;
+
+  std::lock_guard<std::mutex> lk(reg_mutex);
+
+  size_t n = rings.size();
+  std::vector<uint64_t> pos(n);
+  std::vector<uint64_t> end(n);
+
+  for (size_t i = 0; i < n; i++) {
+    ring_t* r = rings[i].get();
+    pos[i] = r->head.load(std::memory_order_relaxed);
+    end[i] = r->tail.load(std::memory_order_acquire);
+    if (pos[i] != end[i]) {
+      heap.push(heap_item_t(
+        r->slot[pos[i] & (RVS_LOGRING_SIZE - 1)].ts, i));
+    }
+  }
+
+  merged.clear();
+  while (!heap.empty()) {
+    size_t i = heap.top().second;
+    heap.pop();
+    ring_t* r = rings[i].get();
+    merged.push_back(&r->slot[pos[i] & (RVS_LOGRING_SIZE - 1)]);
+    if (++pos[i] != end[i]) {
+      heap.push(heap_item_t(
+        r->slot[pos[i] & (RVS_LOGRING_SIZE - 1)].ts, i));
+    }
+  }
+
+  if (!merged.empty()) {
+    (*output)(merged.data(), merged.size());
+  }
+
+  // release slots and drop rings of threads which have exited
+  for (size_t i = n; i-- > 0;) {
+    ring_t* r = rings[i].get();
+    r->head.store(end[i], std::memory_order_release);
+    if (r->closed.load(std::memory_order_acquire) &&
+        r->tail.load(std::memory_order_acquire) == end[i]) {
+      rings.erase(rings.begin() + i);
+    }
+  }
+
+  return merged.size();
+}
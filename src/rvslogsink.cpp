@@ -0,0 +1,543 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogsink.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include "include/rvslogframe.h"
+
+//! Default constructor
+rvs::logsink::logsink()
+:
+queue_depth(RVS_LOGSINK_QUEUE_DEPTH),
+flush_interval(RVS_LOGSINK_FLUSH_INTERVAL),
+overflow(overflow_block),
+brunning(false),
+bquit(false),
+bshutdown(false),
+flush_req(0),
+flush_done(0),
+st_records(0),
+st_bytes(0),
+st_batches(0),
+st_dropped(0),
+st_stalled(0),
+st_rotations(0) {
+  for (int i = 0; i < target_max; i++) {
+    fd[i] = -1;
+    rotation[i] = rotation_t{0, 0, 0};
+    seg_policy[i] = rotation[i];
+    framer[i] = nullptr;
+    seg_framer[i] = nullptr;
+    seg_known[i] = false;
+    seg_bytes[i] = 0;
+    seg_rows[i] = 0;
+  }
+}
+
+/**
+ * @brief Destructor
+ *
+ * Drains the queue, stops the writer thread and closes files. Rows posted
+ * after this point (e.g. from threads still running at process exit) are
+ * written synchronously.
+ *
+ */
+rvs::logsink::~logsink() {
+  close();
+  std::lock_guard<std::mutex> lk(mtx);
+  bshutdown = true;
+}
+
+/**
+ * @brief Set output file for the given target
+ *
+ * The change is queued so that rows posted before this call still end up
+ * in the previous file.
+ *
+ * @param target output target
+ * @param name file name
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::logsink::set_file(target_t target, const std::string& name) {
+  if (target < 0 || target >= target_max) {
+    return -1;
+  }
+
+  std::lock_guard<std::mutex> lk(mtx);
+  if (bshutdown) {
+    write_out(target);
+    if (fd[target] >= 0) {
+      ::close(fd[target]);
+      fd[target] = -1;
+    }
+    fd_name[target] = name;
+    seg_known[target] = false;
+    return 0;
+  }
+
+  if (!brunning) {
+    start();
+  }
+  queue.push_back(record_t{target, true, 0, name});
+  cv_work.notify_one();
+
+  return 0;
+}
+
+/**
+ * @brief Queue row for writing
+ *
+ * If the queue is full, either waits for the writer to make room or drops
+ * the row, depending on overflow policy.
+ *
+ * @param target output target
+ * @param row text to append to the file
+ * @param tag row kind, passed on to the framer of the target (if any)
+ * @return 0 - success, non-zero if row was dropped
+ *
+ */
+int rvs::logsink::post(target_t target, const std::string& row,
+                       unsigned int tag) {
+  if (target < 0 || target >= target_max) {
+    return -1;
+  }
+  if (row.empty()) {
+    return 0;
+  }
+
+  std::unique_lock<std::mutex> lk(mtx);
+
+  if (bshutdown) {
+    record_t rec{target, false, tag, row};
+    if (framer[target]) {
+      framer[target]->row(tag, &rec.row);
+    }
+    buffer[target] += rec.row;
+    write_out(target);
+    return 0;
+  }
+
+  if (!brunning) {
+    start();
+  }
+
+  if (queue.size() >= queue_depth) {
+    if (overflow == overflow_drop) {
+      st_dropped++;
+      return -1;
+    }
+    st_stalled++;
+    cv_work.notify_one();
+    cv_done.wait(lk, [this]{ return queue.size() < queue_depth || bquit; });
+  }
+
+  queue.push_back(record_t{target, false, tag, row});
+  st_records++;
+
+  // let rows pile up for batching, but wake writer well before it is full
+  if (queue.size() >= queue_depth / 2) {
+    cv_work.notify_one();
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Write out all rows queued so far
+ *
+ * Blocks until all rows posted before this call have been written to their
+ * files.
+ *
+ */
+void rvs::logsink::flush() {
+  std::unique_lock<std::mutex> lk(mtx);
+  if (!brunning) {
+    return;
+  }
+
+  uint64_t req = ++flush_req;
+  cv_work.notify_one();
+  cv_done.wait(lk, [this, req]{ return flush_done >= req; });
+}
+
+/**
+ * @brief Flush, stop writer thread and close files
+ *
+ * Sink can be reused afterwards; writer thread is restarted on the next
+ * post().
+ *
+ */
+void rvs::logsink::close() {
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (!brunning) {
+      return;
+    }
+    bquit = true;
+    flush_req++;
+  }
+  cv_work.notify_one();
+
+  if (writer.joinable()) {
+    writer.join();
+  }
+
+  std::lock_guard<std::mutex> lk(mtx);
+  brunning = false;
+  bquit = false;
+  cv_done.notify_all();
+}
+
+/**
+ * @brief Fetch sink statistics
+ *
+ * @param pstats [out] statistics
+ *
+ */
+void rvs::logsink::get_stats(stats_t* pstats) {
+  pstats->records = st_records;
+  pstats->bytes   = st_bytes;
+  pstats->batches = st_batches;
+  pstats->dropped = st_dropped;
+  pstats->stalled = st_stalled;
+  pstats->rotations = st_rotations;
+}
+
+/**
+ * @brief Set maximum number of rows pending in the queue
+ *
+ * @param depth queue depth (at least 1)
+ *
+ */
+void rvs::logsink::set_queue_depth(size_t depth) {
+  std::lock_guard<std::mutex> lk(mtx);
+  queue_depth = depth ? depth : 1;
+}
+
+/**
+ * @brief Set periodic flush interval
+ *
+ * @param ms interval in milliseconds (at least 1)
+ *
+ */
+void rvs::logsink::set_flush_interval(unsigned int ms) {
+  std::lock_guard<std::mutex> lk(mtx);
+  flush_interval = ms ? ms : 1;
+}
+
+/**
+ * @brief Set queue overflow policy
+ *
+ * @param policy overflow_block or overflow_drop
+ *
+ */
+void rvs::logsink::set_overflow(overflow_t policy) {
+  std::lock_guard<std::mutex> lk(mtx);
+  overflow = policy;
+}
+
+/**
+ * @brief Set rotation policy for the given target
+ *
+ * Once the file would grow over policy.max_bytes or gets older than
+ * policy.max_age seconds, it is renamed to <name>.1 (older generations
+ * shifted to <name>.2 .. <name>.N) and a new file is started. Zero limit
+ * disables the respective check.
+ *
+ * @param target output target
+ * @param policy rotation policy
+ *
+ */
+void rvs::logsink::set_rotation(target_t target, const rotation_t& policy) {
+  if (target < 0 || target >= target_max) {
+    return;
+  }
+  std::lock_guard<std::mutex> lk(mtx);
+  rotation[target] = policy;
+}
+
+/**
+ * @brief Set framer for the given target
+ *
+ * Framer sees all rows written to the target and supplies the text needed
+ * to close and reopen the document when the file is rotated. Framer is
+ * invoked on the writer thread only and must outlive the sink.
+ *
+ * @param target output target
+ * @param pframer framer, or nullptr to write rows as they are
+ *
+ */
+void rvs::logsink::set_framer(target_t target, logframe* pframer) {
+  if (target < 0 || target >= target_max) {
+    return;
+  }
+  std::lock_guard<std::mutex> lk(mtx);
+  framer[target] = pframer;
+}
+
+/**
+ * @brief Start writer thread
+ *
+ * Note: called with mtx locked
+ *
+ */
+void rvs::logsink::start() {
+  if (writer.joinable()) {
+    writer.join();
+  }
+  brunning = true;
+  bquit = false;
+  writer = std::thread(&rvs::logsink::run, this);
+}
+
+/**
+ * @brief Writer thread function
+ *
+ * Takes all queued rows at once, appends them to per-target buffers and
+ * writes buffers out when they grow large, when flush interval elapses or
+ * when a flush is requested.
+ *
+ */
+void rvs::logsink::run() {
+  std::deque<record_t> batch;
+  auto last_write = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> lk(mtx);
+  for (;;) {
+    if (queue.empty() && !bquit && flush_req == flush_done) {
+      cv_work.wait_for(lk, std::chrono::milliseconds(flush_interval));
+    }
+
+    batch.swap(queue);
+    uint64_t req = flush_req;
+    bool quit = bquit;
+    for (int t = 0; t < target_max; t++) {
+      seg_policy[t] = rotation[t];
+      seg_framer[t] = framer[t];
+    }
+    lk.unlock();
+
+    // room was made in the queue
+    cv_done.notify_all();
+
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+      int t = it->target;
+      if (it->bctl) {
+        // file change: write out what belongs to the old file first
+        write_out(t);
+        if (fd[t] >= 0) {
+          ::close(fd[t]);
+          fd[t] = -1;
+        }
+        fd_name[t] = it->row;
+        seg_known[t] = false;
+        continue;
+      }
+      append(t, &(*it));
+    }
+    batch.clear();
+
+    auto now = std::chrono::steady_clock::now();
+    if (quit || req != flush_done ||
+        now - last_write >= std::chrono::milliseconds(flush_interval)) {
+      for (int t = 0; t < target_max; t++) {
+        write_out(t);
+      }
+      last_write = now;
+    }
+
+    lk.lock();
+    flush_done = req;
+    cv_done.notify_all();
+
+    if (quit && queue.empty()) {
+      break;
+    }
+  }
+  lk.unlock();
+
+  close_files();
+}
+
+/**
+ * @brief Write buffered rows for the given target to its file
+ *
+ * File is opened on first use and kept open until file name changes or the
+ * sink is closed.
+ *
+ * @param target output target
+ *
+ */
+void rvs::logsink::write_out(int target) {
+  std::string& buf = buffer[target];
+  if (buf.empty()) {
+    return;
+  }
+
+  if (fd[target] < 0) {
+    if (fd_name[target].empty()) {
+      buf.clear();
+      return;
+    }
+    fd[target] = ::open(fd_name[target].c_str(),
+                        O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd[target] < 0) {
+      buf.clear();
+      return;
+    }
+  }
+
+  const char* p = buf.data();
+  size_t left = buf.size();
+  while (left) {
+    ssize_t n = ::write(fd[target], p, left);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    p += n;
+    left -= n;
+  }
+
+  st_bytes += buf.size() - left;
+  st_batches++;
+  buf.clear();
+}
+
+/**
+ * @brief Append row to the target buffer, rotating the file if needed
+ *
+ * Note: called on the writer thread
+ *
+ * @param target output target
+ * @param prec record to append
+ *
+ */
+void rvs::logsink::append(int target, record_t* prec) {
+  const rotation_t& policy = seg_policy[target];
+  auto now = std::chrono::steady_clock::now();
+
+  if (!seg_known[target]) {
+    // existing file (e.g. when appending) counts towards the size limit
+    struct stat st;
+    seg_bytes[target] = 0;
+    if (!fd_name[target].empty() && ::stat(fd_name[target].c_str(), &st) == 0) {
+      seg_bytes[target] = st.st_size;
+    }
+    seg_rows[target] = seg_bytes[target] ? 1 : 0;
+    seg_start[target] = now;
+    seg_known[target] = true;
+  }
+
+  if (seg_rows[target] && !fd_name[target].empty()) {
+    bool over_size = policy.max_bytes &&
+      seg_bytes[target] + prec->row.size() > policy.max_bytes;
+    bool over_age = policy.max_age &&
+      now - seg_start[target] >= std::chrono::seconds(policy.max_age);
+    if (over_size || over_age) {
+      rotate(target);
+    }
+  }
+
+  if (seg_framer[target]) {
+    seg_framer[target]->row(prec->tag, &prec->row);
+  }
+
+  buffer[target] += prec->row;
+  seg_bytes[target] += prec->row.size();
+  seg_rows[target]++;
+  if (buffer[target].size() >= RVS_LOGSINK_WRITE_THRESHOLD) {
+    write_out(target);
+  }
+}
+
+/**
+ * @brief Close current file, shift older generations and start a new one
+ *
+ * Note: called on the writer thread
+ *
+ * @param target output target
+ *
+ */
+void rvs::logsink::rotate(int target) {
+  if (seg_framer[target]) {
+    buffer[target] += seg_framer[target]->trailer();
+  }
+  write_out(target);
+  if (fd[target] >= 0) {
+    ::close(fd[target]);
+    fd[target] = -1;
+  }
+
+  const std::string& name = fd_name[target];
+  unsigned int gens = seg_policy[target].generations;
+  if (gens == 0) {
+    ::unlink(name.c_str());
+  } else {
+    for (unsigned int i = gens - 1; i >= 1; i--) {
+      std::string from = name + "." + std::to_string(i);
+      std::string to = name + "." + std::to_string(i + 1);
+      ::rename(from.c_str(), to.c_str());
+    }
+    ::rename(name.c_str(), (name + ".1").c_str());
+  }
+
+  seg_bytes[target] = 0;
+  seg_rows[target] = 0;
+  seg_start[target] = std::chrono::steady_clock::now();
+  st_rotations++;
+
+  if (seg_framer[target]) {
+    std::string head = seg_framer[target]->segment();
+    buffer[target] += head;
+    seg_bytes[target] += head.size();
+  }
+}
+
+/**
+ * @brief Write out remaining data and close all files
+ *
+ */
+void rvs::logsink::close_files() {
+  for (int t = 0; t < target_max; t++) {
+    write_out(t);
+    if (fd[t] >= 0) {
+      ::close(fd[t]);
+      fd[t] = -1;
+    }
+  }
+}
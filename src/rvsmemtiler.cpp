@@ -0,0 +1,146 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsmemtiler.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief class constructor
+ *
+ * @param pAllocator memory allocator
+ * @param Granularity allocation granularity (bytes)
+ * @param Headroom free memory to be left unallocated (bytes)
+ * @param MaxTiles maximum number of allocations
+ *
+ */
+rvs::memtiler::memtiler(memallocator* pAllocator, size_t Granularity,
+                        size_t Headroom, unsigned int MaxTiles)
+  : allocator(pAllocator), granularity(Granularity), headroom(Headroom),
+    max_tiles(MaxTiles), covered_size(0), alloc_attempts(0) {
+}
+
+//! class destructor, frees all tiles
+rvs::memtiler::~memtiler() {
+  release();
+}
+
+/**
+ * @brief Finds and allocates the largest allocatable size up to High
+ *
+ * High is tried first, as it usually fits; otherwise the size is
+ * bisected between the largest size known to fit and the smallest size
+ * known not to. The last successful allocation is freed before a larger
+ * size is tried, so that it does not count against device capacity, and
+ * the size found is allocated again if the last attempt failed.
+ *
+ * @param High upper limit (bytes)
+ * @param pPtr [out] address of the allocation
+ * @return size of the allocation (bytes), 0 if no granule could be
+ * allocated
+ *
+ */
+size_t rvs::memtiler::probe(size_t High, void** pPtr) {
+  // sizes in granules: lo fits (0 trivially), hi does not
+  uint64_t lo = 0;
+  uint64_t hi = High / granularity;
+  void* best = nullptr;
+
+  if (hi == 0) {
+    return 0;
+  }
+
+  alloc_attempts++;
+  best = allocator->alloc(hi * granularity);
+  if (best) {
+    *pPtr = best;
+    return hi * granularity;
+  }
+
+  while (hi - lo > 1) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (best) {
+      allocator->free(best);
+      best = nullptr;
+    }
+    alloc_attempts++;
+    void* ptr = allocator->alloc(mid * granularity);
+    if (ptr) {
+      best = ptr;
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (!best) {
+    // lo fitted when probed; if memory was taken meanwhile probe below it
+    return lo ? probe(lo * granularity, pPtr) : 0;
+  }
+  *pPtr = best;
+  return lo * granularity;
+}
+
+/**
+ * @brief Allocates tiles until Target bytes are covered
+ *
+ * @param Target number of bytes to cover, counting tiles already allocated
+ * @return number of bytes covered
+ *
+ */
+size_t rvs::memtiler::tile(size_t Target) {
+  while (covered_size + granularity <= Target &&
+         tile_list.size() < max_tiles) {
+    size_t high = Target - covered_size;
+    size_t avail = allocator->available();
+    if (avail != SIZE_MAX) {
+      high = std::min(high, avail > headroom ? avail - headroom : 0);
+    }
+
+    memtile_t t;
+    t.size = probe(high, &t.ptr);
+    if (t.size == 0) {
+      break;
+    }
+    tile_list.push_back(t);
+    covered_size += t.size;
+  }
+
+  return covered_size;
+}
+
+/**
+ * @brief Frees all tiles
+ *
+ */
+void rvs::memtiler::release() {
+  for (auto it = tile_list.begin(); it != tile_list.end(); ++it) {
+    allocator->free(it->ptr);
+  }
+  tile_list.clear();
+  covered_size = 0;
+}
@@ -0,0 +1,347 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsmetriclog.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+std::atomic<bool> rvs::metriclog::bactive(false);
+std::mutex rvs::metriclog::mtx;
+std::mutex rvs::metriclog::io_mtx;
+int rvs::metriclog::fd(-1);
+std::vector<rvs::metric_record_t> rvs::metriclog::buffer;
+std::vector<rvs::metric_record_t> rvs::metriclog::spare;
+std::chrono::steady_clock::time_point rvs::metriclog::start;
+std::chrono::steady_clock::time_point rvs::metriclog::last_write;
+
+//! names of predefined metrics, indexed by metric_t
+static const char* metric_names[rvs::metric_max] = {
+  "none",
+  "temperature",
+  "power",
+  "sclk",
+  "mclk",
+  "fan",
+  "gflops",
+  "bandwidth"
+};
+
+/**
+ * @brief Write all of the given data to file
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+static int write_all(int fd, const void* data, size_t size) {
+  const char* p = static_cast<const char*>(data);
+  while (size) {
+    ssize_t n = ::write(fd, p, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    p += n;
+    size -= n;
+  }
+  return 0;
+}
+
+/**
+ * @brief Create metrics file and start recording samples
+ *
+ * Existing file is truncated.
+ *
+ * @param fname file name
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::metriclog::open(const std::string& fname) {
+  close();
+
+  int f = ::open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                 0644);
+  if (f < 0) {
+    return -1;
+  }
+
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  metric_header_t hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, RVS_METRICLOG_MAGIC, sizeof(hdr.magic));
+  hdr.version = RVS_METRICLOG_VERSION;
+  hdr.record_size = sizeof(metric_record_t);
+  hdr.start_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull +
+                 ts.tv_nsec;
+  if (write_all(f, &hdr, sizeof(hdr))) {
+    ::close(f);
+    return -1;
+  }
+
+  std::lock_guard<std::mutex> lk(mtx);
+  fd = f;
+  buffer.reserve(RVS_METRICLOG_BUFFER);
+  start = std::chrono::steady_clock::now();
+  last_write = start;
+  bactive = true;
+
+  return 0;
+}
+
+/**
+ * @brief Record sample
+ *
+ * Does nothing unless metrics file is open.
+ *
+ * @param metric metric id (metric_t or module specific)
+ * @param device device id (GPU ID)
+ * @param value sample value
+ *
+ */
+void rvs::metriclog::sample(uint16_t metric, uint16_t device, double value) {
+  if (!active()) {
+    return;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> lk(mtx);
+  if (fd < 0) {
+    return;
+  }
+  metric_record_t r;
+  r.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    now - start).count();
+  r.metric = metric;
+  r.device = device;
+  r.value = static_cast<float>(value);
+  buffer.push_back(r);
+
+  if (buffer.size() >= RVS_METRICLOG_BUFFER ||
+      now - last_write >=
+        std::chrono::milliseconds(RVS_METRICLOG_FLUSH_INTERVAL)) {
+    // while another sampler is writing keep collecting, the next sample
+    // after that write tries again
+    if (write_out(&lk, true) == 0) {
+      last_write = now;
+    }
+  }
+}
+
+/**
+ * @brief Write collected samples to file
+ *
+ * Note: called with mtx locked, returns with mtx unlocked if samples were
+ * written. Samples are written while new ones are collected into the
+ * other buffer.
+ *
+ * @param plk lock holding mtx
+ * @param nowait do not wait for a write in progress
+ * @return 0 - samples written, -1 - write in progress (nowait only)
+ *
+ */
+int rvs::metriclog::write_out(std::unique_lock<std::mutex>* plk,
+                              bool nowait) {
+  // taken before mtx is released so buffers are written in order
+  std::unique_lock<std::mutex> io(io_mtx, std::defer_lock);
+  if (nowait) {
+    if (!io.try_lock()) {
+      return -1;
+    }
+  } else {
+    io.lock();
+  }
+  int f = fd;
+  spare.swap(buffer);
+  buffer.reserve(RVS_METRICLOG_BUFFER);
+  plk->unlock();
+
+  if (!spare.empty()) {
+    write_all(f, spare.data(), spare.size() * sizeof(metric_record_t));
+  }
+  spare.clear();
+
+  return 0;
+}
+
+/**
+ * @brief Write out all samples recorded so far
+ *
+ */
+void rvs::metriclog::flush() {
+  std::unique_lock<std::mutex> lk(mtx);
+  if (fd < 0) {
+    return;
+  }
+  last_write = std::chrono::steady_clock::now();
+  write_out(&lk);
+}
+
+/**
+ * @brief Write out remaining samples, stop recording and close file
+ *
+ */
+void rvs::metriclog::close() {
+  std::unique_lock<std::mutex> lk(mtx);
+  bactive = false;
+  if (fd < 0) {
+    return;
+  }
+  write_out(&lk);
+
+  // samples which got in while the last buffer was written
+  lk.lock();
+  std::lock_guard<std::mutex> io(io_mtx);
+  if (!buffer.empty()) {
+    write_all(fd, buffer.data(), buffer.size() * sizeof(metric_record_t));
+    buffer.clear();
+  }
+  ::close(fd);
+  fd = -1;
+}
+
+/**
+ * @brief Get metric name
+ *
+ * @param metric metric id
+ * @return name of predefined metric, nullptr for other ids
+ *
+ */
+const char* rvs::metriclog::metric_name(uint16_t metric) {
+  if (metric >= metric_max) {
+    return nullptr;
+  }
+  return metric_names[metric];
+}
+
+/**
+ * @brief Get metric id from its name
+ *
+ * @param name name of predefined metric or decimal id
+ * @return metric id, -1 if name is neither known metric nor valid id
+ *
+ */
+int rvs::metriclog::metric_id(const std::string& name) {
+  for (int i = metric_none + 1; i < metric_max; i++) {
+    if (name == metric_names[i]) {
+      return i;
+    }
+  }
+  try {
+    size_t pos = 0;
+    unsigned long id = std::stoul(name, &pos);
+    if (pos == name.size() && id <= UINT16_MAX) {
+      return static_cast<int>(id);
+    }
+  } catch (...) {
+  }
+  return -1;
+}
+
+//! Default constructor
+rvs::metricreader::metricreader()
+:
+map(nullptr),
+map_size(0),
+header(nullptr),
+data(nullptr),
+nrecords(0) {
+}
+
+//! Destructor
+rvs::metricreader::~metricreader() {
+  close();
+}
+
+/**
+ * @brief Map metrics file
+ *
+ * Incomplete record at the end of file (e.g. after a crash) is ignored.
+ *
+ * @param fname file name
+ * @return 0 - success, non-zero if file can not be mapped or is not
+ * a metrics file
+ *
+ */
+int rvs::metricreader::open(const std::string& fname) {
+  close();
+
+  int f = ::open(fname.c_str(), O_RDONLY | O_CLOEXEC);
+  if (f < 0) {
+    return -1;
+  }
+  struct stat st;
+  if (fstat(f, &st) || static_cast<size_t>(st.st_size) <
+      sizeof(metric_header_t)) {
+    ::close(f);
+    return -1;
+  }
+  void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, f, 0);
+  ::close(f);
+  if (p == MAP_FAILED) {
+    return -1;
+  }
+  map = p;
+  map_size = st.st_size;
+
+  header = static_cast<const metric_header_t*>(map);
+  if (memcmp(header->magic, RVS_METRICLOG_MAGIC, sizeof(header->magic)) ||
+      header->version != RVS_METRICLOG_VERSION ||
+      header->record_size != sizeof(metric_record_t)) {
+    close();
+    return -1;
+  }
+
+  data = reinterpret_cast<const metric_record_t*>(header + 1);
+  nrecords = (map_size - sizeof(metric_header_t)) / sizeof(metric_record_t);
+  return 0;
+}
+
+/**
+ * @brief Unmap metrics file
+ *
+ */
+void rvs::metricreader::close() {
+  if (map) {
+    munmap(map, map_size);
+  }
+  map = nullptr;
+  map_size = 0;
+  header = nullptr;
+  data = nullptr;
+  nrecords = 0;
+}
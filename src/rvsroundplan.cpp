@@ -0,0 +1,348 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsroundplan.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Colours transfers with the DSATUR heuristic
+ *
+ * Two transfers conflict if they share a resource. The next transfer
+ * placed is the one whose conflicting transfers already occupy the most
+ * distinct rounds, ties broken by the number of conflicts. It goes to
+ * the first round it does not conflict with.
+ *
+ * @param Transfers resources used by each transfer
+ * @param pRounds [out] indexes into Transfers, one vector per round
+ *
+ */
+static void plan_dsatur(
+    const std::vector<rvs::roundplan::resources_t>& Transfers,
+    std::vector<std::vector<size_t>>* pRounds) {
+  const size_t n = Transfers.size();
+  std::unordered_map<uint64_t, std::vector<size_t>> users;
+  std::vector<std::vector<size_t>> conflicts(n);
+
+  pRounds->clear();
+
+  for (size_t i = 0; i < n; i++) {
+    for (uint64_t res : Transfers[i]) {
+      users[res].push_back(i);
+    }
+  }
+  for (const auto& res : users) {
+    for (size_t i : res.second) {
+      for (size_t j : res.second) {
+        if (i != j) {
+          conflicts[i].push_back(j);
+        }
+      }
+    }
+  }
+  for (auto& c : conflicts) {
+    std::sort(c.begin(), c.end());
+    c.erase(std::unique(c.begin(), c.end()), c.end());
+  }
+
+  // round of each transfer, rounds taken by conflicting transfers
+  std::vector<int> round(n, -1);
+  std::vector<std::vector<bool>> taken(n);
+  std::vector<size_t> saturation(n, 0);
+
+  for (size_t placed = 0; placed < n; placed++) {
+    size_t next = n;
+    for (size_t i = 0; i < n; i++) {
+      if (round[i] >= 0) {
+        continue;
+      }
+      if (next == n || saturation[i] > saturation[next] ||
+          (saturation[i] == saturation[next] &&
+           conflicts[i].size() > conflicts[next].size())) {
+        next = i;
+      }
+    }
+
+    size_t r = 0;
+    while (r < taken[next].size() && taken[next][r]) {
+      r++;
+    }
+    round[next] = static_cast<int>(r);
+    if (r >= pRounds->size()) {
+      pRounds->resize(r + 1);
+    }
+    (*pRounds)[r].push_back(next);
+
+    for (size_t j : conflicts[next]) {
+      if (taken[j].size() <= r) {
+        taken[j].resize(r + 1, false);
+      }
+      if (!taken[j][r]) {
+        taken[j][r] = true;
+        saturation[j]++;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Edge colouring of a simple graph with the Misra-Gries algorithm
+ *
+ * Every transfer is an edge between its two resources. Uses at most
+ * max degree + 1 rounds, which is at most one more than optimal.
+ *
+ * @param Transfers resources used by each transfer, two per transfer,
+ * no two transfers with the same pair
+ * @param pRounds [out] indexes into Transfers, one vector per round
+ *
+ */
+static void plan_misra_gries(
+    const std::vector<rvs::roundplan::resources_t>& Transfers,
+    std::vector<std::vector<size_t>>* pRounds) {
+  std::unordered_map<uint64_t, int> index;
+  std::vector<std::pair<int, int>> edges;
+  int nv = 0;
+
+  for (const auto& t : Transfers) {
+    int v[2];
+    for (int k = 0; k < 2; k++) {
+      auto it = index.find(t[k]);
+      if (it == index.end()) {
+        it = index.emplace(t[k], nv++).first;
+      }
+      v[k] = it->second;
+    }
+    edges.push_back(std::make_pair(v[0], v[1]));
+  }
+
+  std::vector<int> degree(nv, 0);
+  for (const auto& e : edges) {
+    degree[e.first]++;
+    degree[e.second]++;
+  }
+  const int ncol = (nv ? *std::max_element(degree.begin(), degree.end()) : 0)
+                   + 1;
+
+  // colour of edge (x, y), -1 if none; neighbour at x over colour c
+  std::vector<std::vector<int>> col(nv, std::vector<int>(nv, -1));
+  std::vector<std::vector<int>> at(nv, std::vector<int>(ncol, -1));
+  std::vector<std::vector<int>> adj(nv);
+  for (const auto& e : edges) {
+    adj[e.first].push_back(e.second);
+    adj[e.second].push_back(e.first);
+  }
+
+  auto setcol = [&](int x, int y, int c) {
+    int old = col[x][y];
+    if (old >= 0) {
+      at[x][old] = -1;
+      at[y][old] = -1;
+    }
+    col[x][y] = col[y][x] = c;
+    if (c >= 0) {
+      at[x][c] = y;
+      at[y][c] = x;
+    }
+  };
+  auto free_at = [&](int x, int c) { return at[x][c] < 0; };
+  auto first_free = [&](int x) {
+    int c = 0;
+    while (!free_at(x, c)) {
+      c++;
+    }
+    return c;
+  };
+
+  for (const auto& e : edges) {
+    const int u = e.first;
+
+    // maximal fan of u starting at the uncoloured edge
+    std::vector<int> fan(1, e.second);
+    std::vector<bool> infan(nv, false);
+    infan[e.second] = true;
+    for (bool grown = true; grown;) {
+      grown = false;
+      for (int z : adj[u]) {
+        if (!infan[z] && col[u][z] >= 0 && free_at(fan.back(), col[u][z])) {
+          fan.push_back(z);
+          infan[z] = true;
+          grown = true;
+          break;
+        }
+      }
+    }
+
+    // invert the cd path starting at u, making d free on u
+    const int c = first_free(u);
+    const int d = first_free(fan.back());
+    if (c != d) {
+      std::vector<std::pair<int, int>> path;
+      int x = u;
+      for (int cur = d; at[x][cur] >= 0; cur = (cur == d) ? c : d) {
+        path.push_back(std::make_pair(x, at[x][cur]));
+        x = at[x][cur];
+      }
+      std::vector<int> old;
+      for (const auto& p : path) {
+        old.push_back(col[p.first][p.second]);
+        setcol(p.first, p.second, -1);
+      }
+      for (size_t k = 0; k < path.size(); k++) {
+        setcol(path[k].first, path[k].second, old[k] == d ? c : d);
+      }
+    }
+
+    // shortest prefix of the fan ending where d is free, still a fan
+    size_t w = 0;
+    for (; w < fan.size(); w++) {
+      if (free_at(fan[w], d)) {
+        break;
+      }
+      if (w + 1 < fan.size() && !free_at(fan[w], col[u][fan[w + 1]])) {
+        w = fan.size();
+        break;
+      }
+    }
+
+    // rotate the fan prefix and colour its last edge with d
+    for (size_t k = 0; k < w; k++) {
+      int next = col[u][fan[k + 1]];
+      setcol(u, fan[k + 1], -1);
+      setcol(u, fan[k], next);
+    }
+    setcol(u, fan[w], d);
+  }
+
+  pRounds->assign(ncol, std::vector<size_t>());
+  for (size_t i = 0; i < edges.size(); i++) {
+    (*pRounds)[col[edges[i].first][edges[i].second]].push_back(i);
+  }
+  pRounds->erase(std::remove_if(pRounds->begin(), pRounds->end(),
+                   [](const std::vector<size_t>& r) { return r.empty(); }),
+                 pRounds->end());
+}
+
+/**
+ * @brief Assigns transfers to rounds
+ *
+ * Transfers using two GPUs and nothing else form a simple graph, where
+ * the better of Misra-Gries edge colouring (at most one round over the
+ * optimum) and DSATUR is taken. With shared links as extra resources
+ * DSATUR is used.
+ *
+ * @param Transfers resources used by each transfer
+ * @param pRounds [out] indexes into Transfers, one vector per round,
+ * ascending within a round
+ *
+ */
+void rvs::roundplan::plan(const std::vector<resources_t>& Transfers,
+                          std::vector<std::vector<size_t>>* pRounds) {
+  plan_dsatur(Transfers, pRounds);
+
+  bool graph = true;
+  std::vector<std::pair<uint64_t, uint64_t>> pairs;
+  for (const auto& t : Transfers) {
+    if (t.size() != 2 || t[0] == t[1]) {
+      graph = false;
+      break;
+    }
+    pairs.push_back(std::make_pair(std::min(t[0], t[1]),
+                                   std::max(t[0], t[1])));
+  }
+  std::sort(pairs.begin(), pairs.end());
+  if (std::adjacent_find(pairs.begin(), pairs.end()) != pairs.end()) {
+    graph = false;
+  }
+
+  if (graph) {
+    std::vector<std::vector<size_t>> rounds;
+    plan_misra_gries(Transfers, &rounds);
+    if (rounds.size() < pRounds->size()) {
+      pRounds->swap(rounds);
+    }
+  }
+
+  for (auto& r : *pRounds) {
+    std::sort(r.begin(), r.end());
+  }
+}
+
+/**
+ * @brief Checks that every transfer is in exactly one round and no two
+ * transfers of a round share a resource
+ *
+ * @param Transfers resources used by each transfer
+ * @param Rounds rounds as returned by plan()
+ * @return true if the plan is valid
+ *
+ */
+bool rvs::roundplan::valid(const std::vector<resources_t>& Transfers,
+                           const std::vector<std::vector<size_t>>& Rounds) {
+  std::vector<int> seen(Transfers.size(), 0);
+
+  for (const auto& r : Rounds) {
+    std::vector<uint64_t> used;
+    for (size_t i : r) {
+      if (i >= Transfers.size() || seen[i]++) {
+        return false;
+      }
+      used.insert(used.end(), Transfers[i].begin(), Transfers[i].end());
+    }
+    std::sort(used.begin(), used.end());
+    if (std::adjacent_find(used.begin(), used.end()) != used.end()) {
+      return false;
+    }
+  }
+
+  return std::find(seen.begin(), seen.end(), 0) == seen.end();
+}
+
+/**
+ * @brief Resource key of a GPU
+ *
+ * @param GpuId GPU ID
+ * @return resource key
+ *
+ */
+uint64_t rvs::roundplan::gpu_resource(uint16_t GpuId) {
+  return GpuId;
+}
+
+/**
+ * @brief Resource key of the host path between two NUMA nodes
+ *
+ * The key does not depend on the direction.
+ *
+ * @param NodeA first NUMA node
+ * @param NodeB second NUMA node
+ * @return resource key
+ *
+ */
+uint64_t rvs::roundplan::link_resource(int NodeA, int NodeB) {
+  uint64_t a = static_cast<uint32_t>(std::min(NodeA, NodeB));
+  uint64_t b = static_cast<uint32_t>(std::max(NodeA, NodeB));
+  return (1ull << 63) | (a << 24) | b;
+}
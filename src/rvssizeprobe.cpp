@@ -0,0 +1,280 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvssizeprobe.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+//! alignment of sizes added by refinement
+#define SIZEPROBE_ALIGN 256
+
+/**
+ * @brief Adds sample
+ *
+ * @param Value sample value
+ *
+ */
+void rvs::runstats::add(double Value) {
+  n++;
+  double delta = Value - avg;
+  avg += delta / n;
+  m2 += delta * (Value - avg);
+}
+
+/**
+ * @brief Sample standard deviation
+ *
+ * @return standard deviation, 0 for less than two samples
+ *
+ */
+double rvs::runstats::stddev() const {
+  return n > 1 ? sqrt(m2 / (n - 1)) : 0;
+}
+
+/**
+ * @brief Half width of the 95% confidence interval of the mean
+ *
+ * Uses Student's t distribution for small sample counts.
+ *
+ * @return half width, infinity for less than two samples
+ *
+ */
+double rvs::runstats::ci95() const {
+  // two-sided 95% critical values of t for 1..30 degrees of freedom
+  static const double t95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+  if (n < 2) {
+    return INFINITY;
+  }
+  double t = n - 1 <= 30 ? t95[n - 2] : 1.96;
+  return t * stddev() / sqrt(n);
+}
+
+/**
+ * @brief Half width of the 95% confidence interval relative to the mean
+ *
+ * @return relative half width, infinity if not known
+ *
+ */
+double rvs::runstats::rel_ci95() const {
+  return avg > 0 ? ci95() / avg : INFINITY;
+}
+
+/**
+ * @brief Fits t = alpha + size / beta to measured times
+ *
+ * Weighted least squares with weights 1 / t^2, so that the relative
+ * rather than the absolute error is minimized and small sizes, where
+ * latency dominates, count as much as large ones.
+ *
+ * @param Sizes transfer sizes (bytes)
+ * @param Times transfer times (seconds)
+ * @param pFit [out] fitted model
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ */
+int rvs::fit_alphabeta(const std::vector<double>& Sizes,
+                       const std::vector<double>& Times, alphabeta_t* pFit) {
+  double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+  size_t n = std::min(Sizes.size(), Times.size());
+
+  for (size_t i = 0; i < n; i++) {
+    if (Times[i] <= 0) {
+      return -1;
+    }
+    double w = 1 / (Times[i] * Times[i]);
+    sw += w;
+    sx += w * Sizes[i];
+    sy += w * Times[i];
+    sxx += w * Sizes[i] * Sizes[i];
+    sxy += w * Sizes[i] * Times[i];
+  }
+
+  double det = sw * sxx - sx * sx;
+  if (n < 2 || det <= 0) {
+    return -1;
+  }
+  double slope = (sw * sxy - sx * sy) / det;
+  double alpha = (sy - slope * sx) / sw;
+  if (slope <= 0) {
+    return -1;
+  }
+
+  // weighted coefficient of determination
+  double ymean = sy / sw;
+  double ssres = 0, sstot = 0;
+  for (size_t i = 0; i < n; i++) {
+    double w = 1 / (Times[i] * Times[i]);
+    double r = Times[i] - alpha - slope * Sizes[i];
+    ssres += w * r * r;
+    sstot += w * (Times[i] - ymean) * (Times[i] - ymean);
+  }
+
+  pFit->alpha = alpha;
+  pFit->beta = 1 / slope;
+  pFit->r2 = sstot > 0 ? 1 - ssres / sstot : 1;
+  return 0;
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param MinSize smallest size
+ * @param MaxSize largest size
+ * @param RelCI target relative half width of the 95% confidence interval
+ * @param MinSamples samples taken at each size before checking convergence
+ * @param MaxSamples samples after which a size is given up on
+ * @param MaxPoints limit of measured sizes
+ *
+ */
+rvs::sizeprobe::sizeprobe(size_t MinSize, size_t MaxSize, double RelCI,
+                          unsigned int MinSamples, unsigned int MaxSamples,
+                          unsigned int MaxPoints)
+  : rel_ci(RelCI), min_samples(std::max(MinSamples, 2u)),
+    max_samples(std::max(MaxSamples, std::max(MinSamples, 2u))),
+    max_points(MaxPoints) {
+  MinSize = std::max<size_t>(MinSize, 1);
+  MaxSize = std::max(MaxSize, MinSize);
+
+  for (size_t size = MinSize; size < MaxSize; size *= 4) {
+    pts.push_back(point_t{size, runstats()});
+  }
+  pts.push_back(point_t{MaxSize, runstats()});
+}
+
+/**
+ * @brief Checks if enough samples of a size are taken
+ *
+ * @param Point measured size
+ * @return 'true' if no more samples are needed
+ *
+ */
+bool rvs::sizeprobe::converged(const point_t& Point) const {
+  if (Point.time.count() < min_samples) {
+    return false;
+  }
+  return Point.time.count() >= max_samples ||
+         Point.time.rel_ci95() <= rel_ci;
+}
+
+/**
+ * @brief Adds sizes between neighbours whose bandwidth differs much
+ *
+ * @return 'true' if a size was added
+ *
+ */
+bool rvs::sizeprobe::refine() {
+  double best = 0;
+  for (const auto& p : pts) {
+    best = std::max(best, p.size / p.time.mean());
+  }
+
+  std::vector<point_t> added;
+  for (size_t i = 0; i + 1 < pts.size(); i++) {
+    const point_t& a = pts[i];
+    const point_t& b = pts[i + 1];
+    double bwa = a.size / a.time.mean();
+    double bwb = b.size / b.time.mean();
+    size_t mid = static_cast<size_t>(sqrt(static_cast<double>(a.size)
+                                          * b.size));
+    mid = std::max<size_t>(mid / SIZEPROBE_ALIGN * SIZEPROBE_ALIGN,
+                           SIZEPROBE_ALIGN);
+    if (fabs(bwb - bwa) > 0.1 * best && mid > a.size && mid < b.size &&
+        pts.size() + added.size() < max_points) {
+      added.push_back(point_t{mid, runstats()});
+    }
+  }
+
+  if (added.empty()) {
+    return false;
+  }
+
+  pts.insert(pts.end(), added.begin(), added.end());
+  std::sort(pts.begin(), pts.end(),
+            [](const point_t& a, const point_t& b) { return a.size < b.size; });
+  return true;
+}
+
+/**
+ * @brief Gets next size to measure
+ *
+ * @param pSize [out] size
+ * @return 'true' if a size is returned, 'false' when the sweep is done
+ *
+ */
+bool rvs::sizeprobe::next(size_t* pSize) {
+  do {
+    for (const auto& p : pts) {
+      if (!converged(p)) {
+        *pSize = p.size;
+        return true;
+      }
+    }
+  } while (refine());
+
+  return false;
+}
+
+/**
+ * @brief Records transfer time
+ *
+ * @param Size transfer size as returned by next()
+ * @param Seconds transfer time
+ *
+ */
+void rvs::sizeprobe::add(size_t Size, double Seconds) {
+  for (auto& p : pts) {
+    if (p.size == Size) {
+      p.time.add(Seconds);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Fits alpha-beta model to mean times of measured sizes
+ *
+ * @param pFit [out] fitted model
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ */
+int rvs::sizeprobe::fit(alphabeta_t* pFit) const {
+  std::vector<double> sizes;
+  std::vector<double> times;
+
+  for (const auto& p : pts) {
+    if (p.time.count()) {
+      sizes.push_back(p.size);
+      times.push_back(p.time.mean());
+    }
+  }
+
+  return fit_alphabeta(sizes, times, pFit);
+}
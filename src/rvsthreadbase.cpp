@@ -24,10 +24,15 @@
  *******************************************************************************/
 #include "include/rvsthreadbase.h"
 
+#include <pthread.h>
+#include <sched.h>
+
 #include <chrono>
 
+#include "include/rvsliblogger.h"
+
 //! Default constructor.
-rvs::ThreadBase::ThreadBase() : t() {
+rvs::ThreadBase::ThreadBase() : t(), pcancel(nullptr) {
 }
 
 //! Default destructor.
@@ -42,6 +47,18 @@ rvs::ThreadBase::~ThreadBase() {
  *
  */
 void rvs::ThreadBase::runinternal() {
+  // stop requests of the starting session apply to this thread too
+  rvs::logger::set_cancel_flag(pcancel);
+
+  if (!cpu_affinity.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto it = cpu_affinity.begin(); it != cpu_affinity.end(); ++it) {
+      CPU_SET(*it, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+
   run();
 }
 
@@ -52,9 +69,22 @@ void rvs::ThreadBase::runinternal() {
  *
  */
 void rvs::ThreadBase::start() {
+  pcancel = rvs::logger::cancel_flag();
   t = std::thread(&rvs::ThreadBase::runinternal, this);
 }
 
+/**
+ *  \brief Sets CPUs the thread may run on
+ *
+ * Takes effect when the thread is started.
+ *
+ * @param cpus list of CPUs, empty list for no restriction
+ *
+ */
+void rvs::ThreadBase::set_cpu_affinity(const std::vector<int>& cpus) {
+  cpu_affinity = cpus;
+}
+
 /**
  *  \brief Performs detach() on the underlaying std::thread object.
  *
@@ -80,9 +110,11 @@ void rvs::ThreadBase::join() {
 /**
  * @brief Pauses current thread for the given time period
  *
+ * Returns early if stop is requested (see rvs::logger::WaitStop()).
+ *
  * @param ms Sleep time in milliseconds.
  *
  * */
 void rvs::ThreadBase::sleep(const unsigned int ms) {
-  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  rvs::logger::WaitStop(ms);
 }
@@ -0,0 +1,243 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvstimerservice.h"
+
+#include "include/rvsliblogger.h"
+
+/**
+ * @brief Returns the timer service instance
+ *
+ * Service threads start on first use.
+ *
+ */
+rvs::timerservice& rvs::timerservice::get() {
+  static timerservice instance;
+  return instance;
+}
+
+//! Constructor, starts scheduler and dispatch threads
+rvs::timerservice::timerservice() : last_id(0), brun(true) {
+  sched_thread = std::thread(&rvs::timerservice::scheduler, this);
+  for (int i = 0; i < RVS_TIMER_DISPATCH_THREADS; i++) {
+    pool.push_back(std::thread(&rvs::timerservice::dispatcher, this));
+  }
+}
+
+//! Destructor, stops service threads
+rvs::timerservice::~timerservice() {
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    brun = false;
+    timers.clear();
+    deadlines.clear();
+    due.clear();
+  }
+  cv_sched.notify_all();
+  cv_due.notify_all();
+
+  sched_thread.join();
+  for (auto it = pool.begin(); it != pool.end(); ++it) {
+    it->join();
+  }
+}
+
+/**
+ * @brief Adds a timer
+ *
+ * Callback runs on a service thread with the session stop request flag of
+ * the calling thread, so rvs::lp::Stopping() works in it as it does in the
+ * caller.
+ *
+ * @param interval_ms time (ms) until the first and between later callbacks
+ * @param once true if the timer fires only once
+ * @param cb callback function
+ * @return timer ID
+ *
+ */
+uint64_t rvs::timerservice::add(unsigned int interval_ms, bool once,
+                                const callback_t& cb) {
+  std::lock_guard<std::mutex> lk(mtx);
+
+  uint64_t id = ++last_id;
+  entry_t& entry = timers[id];
+  entry.interval = std::chrono::milliseconds(interval_ms);
+  entry.once = once;
+  entry.cb = cb;
+  entry.scheduled = false;
+  entry.pcancel = rvs::logger::cancel_flag();
+  schedule(id, &entry, clock_t::now() + entry.interval);
+
+  return id;
+}
+
+/**
+ * @brief Cancels a timer
+ *
+ * The timer does not fire once this returns. If its callback is running on
+ * a service thread, waits for it to return (unless called from within the
+ * callback itself).
+ *
+ * @param id timer ID as returned by add()
+ *
+ */
+void rvs::timerservice::cancel(uint64_t id) {
+  std::unique_lock<std::mutex> lk(mtx);
+
+  auto it = timers.find(id);
+  if (it != timers.end()) {
+    if (it->second.scheduled) {
+      deadlines.erase(it->second.deadline);
+    }
+    // an ID still waiting in the dispatch queue is skipped once not found
+    timers.erase(it);
+  }
+
+  cv_done.wait(lk, [this, id]() {
+    auto rit = running.find(id);
+    return rit == running.end() || rit->second == std::this_thread::get_id();
+  });
+}
+
+/**
+ * @brief Checks if timer is active
+ *
+ * @param id timer ID as returned by add()
+ * @return true if the timer has not been cancelled and is going to fire
+ * (again)
+ *
+ */
+bool rvs::timerservice::active(uint64_t id) {
+  std::lock_guard<std::mutex> lk(mtx);
+  return timers.find(id) != timers.end();
+}
+
+//! Number of active timers
+size_t rvs::timerservice::size() {
+  std::lock_guard<std::mutex> lk(mtx);
+  return timers.size();
+}
+
+/**
+ * @brief Sets deadline of a timer (mtx held)
+ *
+ * Wakes the scheduler if the deadline is the earliest one.
+ *
+ */
+void rvs::timerservice::schedule(uint64_t id, entry_t* pentry,
+                                 clock_t::time_point when) {
+  pentry->when = when;
+  pentry->deadline = deadlines.insert(std::make_pair(when, id));
+  pentry->scheduled = true;
+  if (pentry->deadline == deadlines.begin()) {
+    cv_sched.notify_one();
+  }
+}
+
+/**
+ * @brief Scheduler thread function
+ *
+ * Sleeps until the earliest deadline (or until an earlier one is added)
+ * and queues expired timers for dispatch.
+ *
+ */
+void rvs::timerservice::scheduler() {
+  std::unique_lock<std::mutex> lk(mtx);
+
+  while (brun) {
+    if (deadlines.empty()) {
+      cv_sched.wait(lk);
+      continue;
+    }
+
+    clock_t::time_point now = clock_t::now();
+    clock_t::time_point next = deadlines.begin()->first;
+    if (next > now) {
+      cv_sched.wait_until(lk, next);
+      continue;
+    }
+
+    while (!deadlines.empty() && deadlines.begin()->first <= now) {
+      uint64_t id = deadlines.begin()->second;
+      timers[id].scheduled = false;
+      deadlines.erase(deadlines.begin());
+      due.push_back(id);
+    }
+    cv_due.notify_all();
+  }
+}
+
+/**
+ * @brief Dispatch thread function
+ *
+ * Calls callbacks of expired timers. Periodic timers are scheduled again
+ * once the callback returns, one interval after the previous deadline (or
+ * after now if the callback overran it), so ticks do not drift.
+ *
+ */
+void rvs::timerservice::dispatcher() {
+  std::unique_lock<std::mutex> lk(mtx);
+
+  while (brun) {
+    if (due.empty()) {
+      cv_due.wait(lk);
+      continue;
+    }
+
+    uint64_t id = due.front();
+    due.pop_front();
+    auto it = timers.find(id);
+    if (it == timers.end()) {
+      continue;  // cancelled
+    }
+
+    callback_t cb = it->second.cb;
+    clock_t::time_point deadline = it->second.when;
+    std::atomic<bool>* pcancel = it->second.pcancel;
+    bool once = it->second.once;
+    if (once) {
+      timers.erase(it);
+    }
+    running[id] = std::this_thread::get_id();
+
+    lk.unlock();
+    rvs::logger::set_cancel_flag(pcancel);
+    cb();
+    rvs::logger::set_cancel_flag(nullptr);
+    lk.lock();
+
+    running.erase(id);
+    cv_done.notify_all();
+
+    if (!once) {
+      it = timers.find(id);
+      if (it != timers.end() && !it->second.scheduled) {
+        clock_t::time_point next = deadline + it->second.interval;
+        clock_t::time_point now = clock_t::now();
+        schedule(id, &it->second,
+                 next > now ? next : now + it->second.interval);
+      }
+    }
+  }
+}
@@ -0,0 +1,323 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvstopology.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+std::string rvs::topology::root(RVS_SYSFS_ROOT);
+std::shared_ptr<const rvs::topology> rvs::topology::current;
+std::mutex rvs::topology::mtx;
+
+/**
+ * @brief Looks up numeric property
+ *
+ * @param props properties to search
+ * @param name property name
+ * @param pval [out] property value
+ * @return true if found
+ *
+ */
+static bool get_prop(const rvs::topoprops& props, const std::string& name,
+                     uint64_t* pval) {
+  for (const auto& p : props) {
+    if (p.first == name) {
+      *pval = strtoull(p.second.c_str(), nullptr, 0);
+      return true;
+    }
+  }
+  return false;
+}
+
+//! Looks up numeric link property, see get_prop()
+bool rvs::topolink::get(const std::string& name, uint64_t* pval) const {
+  return get_prop(properties, name, pval);
+}
+
+//! Looks up numeric node property, see get_prop()
+bool rvs::toponode::get(const std::string& name, uint64_t* pval) const {
+  return get_prop(properties, name, pval);
+}
+
+//! PCI address of the node ("dddd:bb:dd.f"), as named in sysfs
+std::string rvs::toponode::bdf() const {
+  char buff[32];
+  snprintf(buff, sizeof(buff), "%04x:%02x:%02x.%x",
+           static_cast<unsigned int>(domain),
+           static_cast<unsigned int>((location_id >> 8) & 0xff),
+           static_cast<unsigned int>((location_id >> 3) & 0x1f),
+           static_cast<unsigned int>(location_id & 0x7));
+  return buff;
+}
+
+/**
+ * @brief Returns numeric entries of a directory in ascending order
+ *
+ */
+static std::vector<int> numeric_subdirs(const std::string& path) {
+  std::vector<int> ids;
+  DIR* dirp = opendir(path.c_str());
+  if (!dirp) {
+    return ids;
+  }
+
+  struct dirent* dir;
+  while ((dir = readdir(dirp)) != nullptr) {
+    char* end;
+    long id = strtol(dir->d_name, &end, 10);
+    if (end != dir->d_name && *end == '\0' && id >= 0) {
+      ids.push_back(static_cast<int>(id));
+    }
+  }
+  closedir(dirp);
+
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+/**
+ * @brief Reads small sysfs file in one read()
+ *
+ * @param path file path
+ * @param pbuff [out] file content
+ * @return 0 if successful, non-zero if the file can not be read
+ *
+ */
+static int read_file(const std::string& path, std::string* pbuff) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+
+  char buff[4096];
+  ssize_t n;
+  pbuff->clear();
+  while ((n = read(fd, buff, sizeof(buff))) > 0) {
+    pbuff->append(buff, n);
+  }
+  close(fd);
+
+  return n < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Reads KFD properties file
+ *
+ * @param path file path
+ * @param pprops [out] properties in file order
+ * @return 0 if successful, non-zero if the file can not be read
+ *
+ */
+int rvs::topology::load_props(const std::string& path, topoprops* pprops) {
+  std::string buff;
+  if (read_file(path, &buff)) {
+    return -1;
+  }
+
+  // "name value" per line
+  const char* ws = " \t\n";
+  size_t pos = buff.find_first_not_of(ws);
+  while (pos != std::string::npos) {
+    size_t name_end = buff.find_first_of(ws, pos);
+    size_t val_pos = buff.find_first_not_of(ws, name_end);
+    if (val_pos == std::string::npos) {
+      break;
+    }
+    size_t val_end = buff.find_first_of(ws, val_pos);
+    pprops->emplace_back(buff.substr(pos, name_end - pos),
+                         buff.substr(val_pos, val_end - val_pos));
+    pos = buff.find_first_not_of(ws, val_end);
+  }
+  return 0;
+}
+
+/**
+ * @brief Reads KFD topology
+ *
+ * Nodes, their properties and io_links are read once; GPU nodes (non-zero
+ * gpu_id) are indexed for constant time lookups.
+ *
+ * @param sysfs root of the sysfs tree (e.g. "/sys")
+ * @return number of nodes read, -1 if KFD topology is not available
+ *
+ */
+int rvs::topology::load(const std::string& sysfs) {
+  std::string nodes_path = sysfs + RVS_KFD_NODES_PATH;
+
+  nodelist.clear();
+  gpu_index.clear();
+  node_index.clear();
+  location_index.clear();
+  bdf_index.clear();
+
+  DIR* dirp = opendir(nodes_path.c_str());
+  if (!dirp) {
+    return -1;
+  }
+  closedir(dirp);
+
+  for (int id : numeric_subdirs(nodes_path)) {
+    std::string node_path = nodes_path + "/" + std::to_string(id);
+    toponode node;
+    uint64_t val;
+
+    node.node = static_cast<uint16_t>(id);
+    std::string gpu_id;
+    node.gpu_id = read_file(node_path + "/gpu_id", &gpu_id) ? 0 :
+                  static_cast<uint16_t>(strtoul(gpu_id.c_str(), nullptr, 10));
+
+    load_props(node_path + "/properties", &node.properties);
+    node.location_id = node.get("location_id", &val) ?
+                       static_cast<uint16_t>(val) : 0;
+    node.device_id = node.get("device_id", &val) ?
+                     static_cast<uint16_t>(val) : 0;
+    node.domain = node.get("domain", &val) ? static_cast<uint16_t>(val) : 0;
+
+    for (int link_id : numeric_subdirs(node_path + "/io_links")) {
+      topolink link;
+      link.id = static_cast<uint16_t>(link_id);
+      load_props(node_path + "/io_links/" + std::to_string(link_id) +
+                 "/properties", &link.properties);
+      link.node_to = link.get("node_to", &val) ?
+                     static_cast<uint16_t>(val) : 0;
+      node.io_links.push_back(std::move(link));
+    }
+
+    size_t pos = nodelist.size();
+    node_index[node.node] = pos;
+    if (node.gpu_id) {
+      gpu_index.emplace(node.gpu_id, pos);
+      location_index.emplace(node.location_id, pos);
+      bdf_index[static_cast<uint32_t>(node.domain) << 16 | node.location_id] =
+        pos;
+    }
+    nodelist.push_back(std::move(node));
+  }
+
+  return static_cast<int>(nodelist.size());
+}
+
+//! Returns node at position given by index, nullptr if key is not indexed
+const rvs::toponode* rvs::topology::find(
+    const std::unordered_map<uint32_t, size_t>& index, uint32_t key) const {
+  auto it = index.find(key);
+  return it == index.end() ? nullptr : &nodelist[it->second];
+}
+
+/**
+ * @brief Returns gpu_id of all GPU nodes ordered by node ID
+ *
+ * @param pgpus [out] GPU IDs, appended to
+ *
+ */
+void rvs::topology::gpus(std::vector<uint16_t>* pgpus) const {
+  for (const auto& node : nodelist) {
+    if (node.gpu_id) {
+      pgpus->push_back(node.gpu_id);
+    }
+  }
+}
+
+//! Returns GPU node with given gpu_id, nullptr if not found
+const rvs::toponode* rvs::topology::by_gpu(uint16_t gpu_id) const {
+  return find(gpu_index, gpu_id);
+}
+
+//! Returns node with given node ID, nullptr if not found
+const rvs::toponode* rvs::topology::by_node(uint16_t node) const {
+  return find(node_index, node);
+}
+
+//! Returns first GPU node with given location ID, nullptr if not found
+const rvs::toponode* rvs::topology::by_location(uint16_t location_id) const {
+  return find(location_index, location_id);
+}
+
+//! Returns GPU node with given domain and location ID, nullptr if not found
+const rvs::toponode* rvs::topology::by_bdf(uint16_t domain,
+                                           uint16_t location_id) const {
+  return find(bdf_index, static_cast<uint32_t>(domain) << 16 | location_id);
+}
+
+/**
+ * @brief Returns process wide topology snapshot
+ *
+ * The snapshot is read on first use. It stays valid for as long as the
+ * caller holds it, even if refresh() replaces it in the meantime.
+ *
+ */
+std::shared_ptr<const rvs::topology> rvs::topology::snapshot() {
+  std::lock_guard<std::mutex> lk(mtx);
+  if (!current) {
+    auto t = std::make_shared<topology>();
+    t->load(root);
+    current = t;
+  }
+  return current;
+}
+
+/**
+ * @brief Re-reads process wide topology snapshot
+ *
+ * @return number of nodes read, -1 if KFD topology is not available
+ *
+ */
+int rvs::topology::refresh() {
+  std::string sysfs = sysfs_root();
+  auto t = std::make_shared<topology>();
+  int n = t->load(sysfs);
+
+  std::lock_guard<std::mutex> lk(mtx);
+  current = t;
+  return n;
+}
+
+/**
+ * @brief Redirects sysfs reads to another directory (e.g. a fake tree)
+ *
+ * The snapshot is re-read from the new root on next use.
+ *
+ * @param _root new sysfs root, empty string restores the default
+ *
+ */
+void rvs::topology::set_sysfs_root(const std::string& _root) {
+  std::lock_guard<std::mutex> lk(mtx);
+  root = _root.empty() ? RVS_SYSFS_ROOT : _root;
+  current.reset();
+}
+
+//! Returns current sysfs root
+std::string rvs::topology::sysfs_root() {
+  std::lock_guard<std::mutex> lk(mtx);
+  return root;
+}
@@ -0,0 +1,206 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsxfercache.h"
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+
+/**
+ * @brief class constructor
+ *
+ * @param pAllocator transfer allocator
+ * @param Limit limit of bytes kept in cached transfers
+ *
+ */
+rvs::xfercache::xfercache(xferallocator* pAllocator, size_t Limit)
+  : allocator(pAllocator), stats{0, 0, 0, 0}, limit(Limit), tick(0) {
+}
+
+/**
+ * @brief Get transfer for Key with buffers of at least Size bytes
+ *
+ * @param Key transfer
+ * @param Size size of data to transfer
+ * @param pLease [out] transfer to use, to be returned by release()
+ * @return 0 - if successfull, non-zero otherwise
+ *
+ */
+int rvs::xfercache::acquire(const xferkey_t& Key, size_t Size,
+                            xferlease_t* pLease) {
+  entry_t* pentry = nullptr;
+  void* old = nullptr;
+
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    entry_t& cached = entries[Key];
+    if (!cached.busy) {
+      cached.busy = true;
+      if (cached.data && cached.size >= Size) {
+        stats.hits++;
+        pLease->data = cached.data;
+        pLease->entry = &cached;
+        return 0;
+      }
+      // too small, reallocated below
+      pentry = &cached;
+      old = cached.data;
+      stats.bytes -= cached.bytes;
+      cached.data = nullptr;
+      cached.size = 0;
+      cached.bytes = 0;
+    }
+    stats.misses++;
+  }
+
+  // (re)allocate outside of the lock, other transfers may proceed
+  if (old) {
+    allocator->xfer_free(old);
+  }
+  void* data = nullptr;
+  size_t bytes = 0;
+  int sts = allocator->xfer_alloc(Key, Size, &data, &bytes);
+
+  if (pentry) {
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      if (sts) {
+        pentry->busy = false;
+      } else {
+        pentry->data = data;
+        pentry->size = Size;
+        pentry->bytes = bytes;
+        stats.bytes += bytes;
+      }
+    }
+    evict();
+  }
+
+  if (sts) {
+    return -1;
+  }
+
+  pLease->data = data;
+  pLease->entry = pentry;
+  return 0;
+}
+
+/**
+ * @brief Return transfer obtained from acquire()
+ *
+ * @param pLease transfer returned by acquire()
+ *
+ */
+void rvs::xfercache::release(xferlease_t* pLease) {
+  if (!pLease->entry) {
+    allocator->xfer_free(pLease->data);
+  } else {
+    std::lock_guard<std::mutex> lk(mtx);
+    entry_t* pentry = static_cast<entry_t*>(pLease->entry);
+    pentry->busy = false;
+    pentry->last_use = ++tick;
+  }
+  pLease->data = nullptr;
+  pLease->entry = nullptr;
+}
+
+/**
+ * @brief Free least recently used idle transfers while cached bytes
+ * exceed the limit
+ *
+ */
+void rvs::xfercache::evict() {
+  std::lock_guard<std::mutex> lk(mtx);
+
+  while (stats.bytes > limit) {
+    auto lru = entries.end();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (!it->second.busy && it->second.data &&
+          (lru == entries.end() ||
+           it->second.last_use < lru->second.last_use)) {
+        lru = it;
+      }
+    }
+
+    // everything in use, transfers running now need their buffers
+    if (lru == entries.end()) {
+      break;
+    }
+
+    stats.bytes -= lru->second.bytes;
+    stats.evictions++;
+    allocator->xfer_free(lru->second.data);
+    entries.erase(lru);
+  }
+}
+
+/**
+ * @brief Free all cached transfers not currently in use
+ *
+ */
+void rvs::xfercache::clear() {
+  std::lock_guard<std::mutex> lk(mtx);
+
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (it->second.busy) {
+      ++it;
+      continue;
+    }
+    if (it->second.data) {
+      stats.bytes -= it->second.bytes;
+      allocator->xfer_free(it->second.data);
+    }
+    it = entries.erase(it);
+  }
+}
+
+/**
+ * @brief Set limit of bytes kept in cached transfers
+ *
+ * Idle cached transfers are released, least recently used first, when
+ * the limit is exceeded.
+ *
+ * @param Bytes new limit
+ *
+ */
+void rvs::xfercache::set_limit(size_t Bytes) {
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    limit = Bytes;
+  }
+  evict();
+}
+
+/**
+ * @brief Get cache statistics
+ *
+ * @param pStats [out] statistics
+ *
+ */
+void rvs::xfercache::get_stats(xfercachestats_t* pStats) {
+  std::lock_guard<std::mutex> lk(mtx);
+  *pStats = stats;
+}